@@ -0,0 +1,385 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "checkpoint.h"
+#include "abort.h"
+#include "log.h"
+#include "object.h"
+#include "object-ptr-container.h"
+#include "pointer.h"
+#include "random-variable-stream.h"
+#include "rng-seed-manager.h"
+#include "simulator.h"
+#include "string.h"
+
+#include <fstream>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::Checkpoint implementation.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("Checkpoint");
+
+namespace {
+
+/** Checkpoint file format identifier. */
+const std::string g_magic = "ns3-checkpoint";
+/** Checkpoint file format version. */
+const uint32_t g_version = 1;
+
+/** A registered checkpoint entry. */
+struct Entry
+{
+  Checkpoint::SaveCallback save;        //!< Writes the state.
+  Checkpoint::RestoreCallback restore;  //!< Reads the state back.
+};
+
+/** The registered entries, by name. */
+typedef std::map<std::string, Entry> Entries;
+
+/**
+ * Get the registered entries.
+ * \returns The registered entries.
+ */
+Entries &
+GetEntries (void)
+{
+  static Entries entries;
+  return entries;
+}
+
+/**
+ * Write a string which may contain white space.
+ * \param [in,out] os The output stream.
+ * \param [in] s The string.
+ */
+void
+WriteString (std::ostream &os, const std::string &s)
+{
+  os << s.size () << " " << s << "\n";
+}
+
+/**
+ * Read a string written by WriteString().
+ * \param [in,out] is The input stream.
+ * \param [out] s The string.
+ * \returns \c true if a string could be read.
+ */
+bool
+ReadString (std::istream &is, std::string *s)
+{
+  std::size_t size;
+  if (!(is >> size) || is.get () != ' ')
+    {
+      return false;
+    }
+  s->resize (size);
+  if (size > 0 && !is.read (&(*s)[0], size))
+    {
+      return false;
+    }
+  return is.get () == '\n';
+}
+
+/**
+ * Check if an attribute holds a value, as opposed to a reference to
+ * another object, and can be both read and written.
+ * \param [in] info The attribute.
+ * \returns \c true if the attribute is part of the object state.
+ */
+bool
+IsStateAttribute (const struct TypeId::AttributeInformation &info)
+{
+  if (!(info.flags & TypeId::ATTR_GET) || !(info.flags & TypeId::ATTR_SET)
+      || !info.accessor->HasGetter () || !info.accessor->HasSetter ())
+    {
+      return false;
+    }
+  return dynamic_cast<const PointerChecker *> (PeekPointer (info.checker)) == 0
+         && dynamic_cast<const ObjectPtrContainerChecker *> (PeekPointer (info.checker)) == 0;
+}
+
+/**
+ * Write the attributes of an object and of its aggregates.
+ * \param [in] object The object.
+ * \param [in,out] os The output stream.
+ */
+void
+SaveObject (Ptr<Object> object, std::ostream &os)
+{
+  NS_LOG_FUNCTION (object << &os);
+  std::vector<Ptr<const Object> > aggregates;
+  Object::AggregateIterator it = object->GetAggregateIterator ();
+  while (it.HasNext ())
+    {
+      aggregates.push_back (it.Next ());
+    }
+  os << aggregates.size () << "\n";
+  for (std::vector<Ptr<const Object> >::const_iterator i = aggregates.begin (); i != aggregates.end (); ++i)
+    {
+      TypeId tid = (*i)->GetInstanceTypeId ();
+      std::vector<std::pair<std::string, std::string> > values;
+      TypeId cur = tid;
+      while (true)
+        {
+          for (uint32_t j = 0; j < cur.GetAttributeN (); j++)
+            {
+              struct TypeId::AttributeInformation info = cur.GetAttribute (j);
+              StringValue value;
+              if (IsStateAttribute (info) && (*i)->GetAttributeFailSafe (info.name, value))
+                {
+                  values.push_back (std::make_pair (info.name, value.Get ()));
+                }
+            }
+          if (cur.GetParent () == cur)
+            {
+              break;
+            }
+          cur = cur.GetParent ();
+        }
+
+      WriteString (os, tid.GetName ());
+      os << values.size () << "\n";
+      for (std::vector<std::pair<std::string, std::string> >::const_iterator j = values.begin (); j != values.end (); ++j)
+        {
+          WriteString (os, j->first);
+          WriteString (os, j->second);
+        }
+      const RandomVariableStream *rng = dynamic_cast<const RandomVariableStream *> (PeekPointer (*i));
+      os << (rng != 0) << " ";
+      if (rng != 0)
+        {
+          rng->SaveState (os);
+        }
+      os << "\n";
+    }
+}
+
+/**
+ * Read back the attributes written by SaveObject().
+ * \param [in] object The object.
+ * \param [in,out] is The input stream.
+ */
+void
+RestoreObject (Ptr<Object> object, std::istream &is)
+{
+  NS_LOG_FUNCTION (object << &is);
+  std::size_t nAggregates;
+  if (!(is >> nAggregates) || is.get () != '\n')
+    {
+      NS_FATAL_ERROR ("Corrupted checkpoint state for object " << object);
+    }
+  for (std::size_t i = 0; i < nAggregates; i++)
+    {
+      std::string tidName;
+      std::size_t nValues;
+      if (!ReadString (is, &tidName) || !(is >> nValues) || is.get () != '\n')
+        {
+          NS_FATAL_ERROR ("Corrupted checkpoint state for object " << object);
+        }
+      TypeId tid;
+      Ptr<Object> target = 0;
+      if (TypeId::LookupByNameFailSafe (tidName, &tid))
+        {
+          target = object->GetObject<Object> (tid);
+        }
+      if (target == 0)
+        {
+          NS_LOG_WARN ("No aggregate of type " << tidName << " to restore on " << object);
+        }
+      for (std::size_t j = 0; j < nValues; j++)
+        {
+          std::string name;
+          std::string value;
+          if (!ReadString (is, &name) || !ReadString (is, &value))
+            {
+              NS_FATAL_ERROR ("Corrupted checkpoint state for object " << object);
+            }
+          StringValue current;
+          // Only set what changed: some setters have side effects,
+          // such as RandomVariableStream::SetStream.
+          if (target != 0 && target->GetAttributeFailSafe (name, current)
+              && current.Get () != value
+              && !target->SetAttributeFailSafe (name, StringValue (value)))
+            {
+              NS_LOG_WARN ("Could not restore attribute " << name << "=" << value << " of " << tidName);
+            }
+        }
+      bool hasRng;
+      if (!(is >> hasRng))
+        {
+          NS_FATAL_ERROR ("Corrupted checkpoint state for object " << object);
+        }
+      if (hasRng)
+        {
+          Ptr<RandomVariableStream> rng = DynamicCast<RandomVariableStream> (target);
+          if (rng != 0 && !rng->RestoreState (is))
+            {
+              NS_FATAL_ERROR ("Corrupted checkpoint state for object " << object);
+            }
+        }
+      is.ignore (std::numeric_limits<std::streamsize>::max (), '\n');
+    }
+}
+
+/**
+ * Restore the registered entries from their saved state.
+ * \param [in] states The saved state of each entry, by name.
+ * \param [in] nextStreamIndex The next automatic stream index.
+ */
+void
+DoRestore (std::map<std::string, std::string> states, uint64_t nextStreamIndex)
+{
+  NS_LOG_FUNCTION (&states << nextStreamIndex);
+  RngSeedManager::SetNextStreamIndex (nextStreamIndex);
+  Entries &entries = GetEntries ();
+  for (Entries::const_iterator i = entries.begin (); i != entries.end (); ++i)
+    {
+      std::map<std::string, std::string>::const_iterator state = states.find (i->first);
+      if (state == states.end ())
+        {
+          NS_LOG_WARN ("No saved state for checkpoint entry " << i->first);
+          continue;
+        }
+      std::istringstream iss (state->second);
+      i->second.restore (iss);
+    }
+}
+
+} // unnamed namespace
+
+
+void
+Checkpoint::Register (std::string name, SaveCallback save, RestoreCallback restore)
+{
+  NS_LOG_FUNCTION (name);
+  NS_ABORT_MSG_IF (name.empty () || name.find_first_of (" \t\n") != std::string::npos,
+                   "Invalid checkpoint entry name \"" << name << "\"");
+  Entries &entries = GetEntries ();
+  if (entries.empty ())
+    {
+      // Release the registered objects with the rest of the simulation.
+      Simulator::ScheduleDestroy (&Checkpoint::UnregisterAll);
+    }
+  Entry entry;
+  entry.save = save;
+  entry.restore = restore;
+  entries[name] = entry;
+}
+
+void
+Checkpoint::RegisterObject (std::string name, Ptr<Object> object)
+{
+  NS_LOG_FUNCTION (name << object);
+  Register (name, MakeBoundCallback (&SaveObject, object), MakeBoundCallback (&RestoreObject, object));
+}
+
+void
+Checkpoint::Unregister (std::string name)
+{
+  NS_LOG_FUNCTION (name);
+  GetEntries ().erase (name);
+}
+
+void
+Checkpoint::UnregisterAll (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  GetEntries ().clear ();
+}
+
+void
+Checkpoint::Save (std::string filename)
+{
+  NS_LOG_FUNCTION (filename);
+  std::ofstream os (filename.c_str (), std::ios::out | std::ios::binary);
+  NS_ABORT_MSG_UNLESS (os.is_open (), "Could not open checkpoint file " << filename);
+
+  os << g_magic << " " << g_version << "\n";
+  os << "resolution " << Time::GetResolution () << "\n";
+  os << "time " << Simulator::Now ().GetTimeStep () << "\n";
+  os << "seed " << RngSeedManager::GetSeed () << "\n";
+  os << "run " << RngSeedManager::GetRun () << "\n";
+  os << "stream " << RngSeedManager::PeekNextStreamIndex () << "\n";
+
+  Entries &entries = GetEntries ();
+  os << "entries " << entries.size () << "\n";
+  for (Entries::const_iterator i = entries.begin (); i != entries.end (); ++i)
+    {
+      std::ostringstream state;
+      i->second.save (state);
+      WriteString (os, i->first);
+      WriteString (os, state.str ());
+    }
+  NS_ABORT_MSG_UNLESS (os.good (), "Could not write checkpoint file " << filename);
+}
+
+Time
+Checkpoint::Restore (std::string filename)
+{
+  NS_LOG_FUNCTION (filename);
+  std::ifstream is (filename.c_str (), std::ios::in | std::ios::binary);
+  NS_ABORT_MSG_UNLESS (is.is_open (), "Could not open checkpoint file " << filename);
+
+  std::string magic;
+  uint32_t version;
+  std::string key;
+  int resolution;
+  int64_t ts;
+  uint32_t seed;
+  uint64_t run;
+  uint64_t nextStreamIndex;
+  std::size_t nEntries;
+  is >> magic >> version;
+  NS_ABORT_MSG_UNLESS (is && magic == g_magic && version == g_version,
+                       "Not a version " << g_version << " checkpoint file: " << filename);
+  is >> key >> resolution
+     >> key >> ts
+     >> key >> seed
+     >> key >> run
+     >> key >> nextStreamIndex
+     >> key >> nEntries;
+  NS_ABORT_MSG_UNLESS (is && is.get () == '\n', "Corrupted checkpoint file " << filename);
+  NS_ABORT_MSG_UNLESS (resolution == Time::GetResolution (),
+                       "Checkpoint " << filename << " was saved with another time resolution");
+
+  std::map<std::string, std::string> states;
+  for (std::size_t i = 0; i < nEntries; i++)
+    {
+      std::string name;
+      std::string state;
+      NS_ABORT_MSG_UNLESS (ReadString (is, &name) && ReadString (is, &state),
+                           "Corrupted checkpoint file " << filename);
+      states[name] = state;
+    }
+
+  Time at = TimeStep (ts);
+  NS_ABORT_MSG_IF (at < Simulator::Now (), "Checkpoint " << filename << " is in the past");
+  RngSeedManager::SetSeed (seed);
+  RngSeedManager::SetRun (run);
+  Simulator::Schedule (at - Simulator::Now (), &DoRestore, states, nextStreamIndex);
+  return at;
+}
+
+} // namespace ns3
@@ -0,0 +1,129 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include "callback.h"
+#include "nstime.h"
+#include "ptr.h"
+
+#include <iostream>
+#include <string>
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::Checkpoint declaration.
+ */
+
+namespace ns3 {
+
+class Object;
+
+/**
+ * \ingroup simulator
+ *
+ * \brief Save the state of a running simulation and continue from it
+ * in another run.
+ *
+ * A checkpoint file holds the simulation time at which it was saved,
+ * the random number generator seed, run and next automatic stream
+ * index, and the state of every registered entry.  Entries are either
+ * an Object, whose gettable and settable attributes (and those of its
+ * aggregates) are saved, together with the state of every
+ * RandomVariableStream among them, or a pair of callbacks for state
+ * which is not reachable through attributes, such as the routes saved
+ * by Ipv4StaticRouting::SaveRoutes.
+ *
+ * Pending events are not saved: they are opaque closures.  The restore
+ * callbacks run at the checkpoint time, and are expected to re-arm the
+ * timers of their owner.  Likewise, the packets held in
+ * queues are not saved: a queue only gets its attributes back, and
+ * starts empty.
+ *
+ * A typical use builds the same scenario in both runs, without
+ * starting the applications which were already running when the
+ * checkpoint was saved:
+ * \code
+ *   // warm-up run
+ *   Checkpoint::RegisterObject ("node0", nodes.Get (0));
+ *   Simulator::Schedule (Hours (6), &Checkpoint::Save, "warm.ckpt");
+ *
+ *   // forked run
+ *   Checkpoint::RegisterObject ("node0", nodes.Get (0));
+ *   Time start = Checkpoint::Restore ("warm.ckpt");
+ * \endcode
+ */
+class Checkpoint
+{
+public:
+  /** Callback writing the state of an entry. */
+  typedef Callback<void, std::ostream &> SaveCallback;
+  /** Callback reading back the state written by a SaveCallback. */
+  typedef Callback<void, std::istream &> RestoreCallback;
+
+  /**
+   * Register the state of an entry.
+   *
+   * \param [in] name The name of the entry in the checkpoint file;
+   *             it must not contain white space.
+   * \param [in] save The callback writing the state.
+   * \param [in] restore The callback reading it back.
+   */
+  static void Register (std::string name, SaveCallback save, RestoreCallback restore);
+  /**
+   * Register the attributes of an Object and of its aggregates.
+   *
+   * \param [in] name The name of the entry in the checkpoint file;
+   *             it must not contain white space.
+   * \param [in] object The object.
+   */
+  static void RegisterObject (std::string name, Ptr<Object> object);
+  /**
+   * Remove an entry.
+   *
+   * \param [in] name The name of the entry.
+   */
+  static void Unregister (std::string name);
+  /** Remove all the entries. */
+  static void UnregisterAll (void);
+
+  /**
+   * Write the state of the simulation.
+   *
+   * This is usually scheduled as an event.
+   *
+   * \param [in] filename The checkpoint file.
+   */
+  static void Save (std::string filename);
+  /**
+   * Read the state of the simulation.
+   *
+   * The random number generator seed and run are restored immediately.
+   * The entries are restored by an event at the checkpoint time, which
+   * must not be earlier than the current time.  Entries found in the
+   * file but not registered are ignored.
+   *
+   * \param [in] filename The checkpoint file.
+   * \returns The checkpoint time.
+   */
+  static Time Restore (std::string filename);
+};
+
+} // namespace ns3
+
+#endif /* CHECKPOINT_H */
@@ -25,7 +25,9 @@
 #include "names.h"
 #include "pointer.h"
 #include "log.h"
+#include "simple-ref-count.h"
 
+#include <map>
 #include <sstream>
 
 /**
@@ -296,9 +298,16 @@ ArrayMatcher::StringToUint32 (std::string str, uint32_t *value) const
 
 /**
  * \ingroup config-impl
- * Abstract class to parse Config paths into object references.
+ * Parse Config paths into object references.
+ *
+ * The path is split into its elements once, at construction.  Attribute
+ * lookups are cached per element and instance TypeId, so that resolving
+ * the same element on many objects of the same type walks the TypeId
+ * hierarchy only once.  Exact array indices (such as /NodeList/3) are
+ * resolved directly through ObjectPtrContainerAccessor::Find instead of
+ * enumerating the whole container.
  */
-class Resolver
+class Resolver : public SimpleRefCount<Resolver>
 {
 public:
   /**
@@ -307,36 +316,64 @@ public:
    * \param [in] path The Config path.
    */
   Resolver (std::string path);
-  /** Destructor. */
-  virtual ~Resolver ();
 
   /**
-   * Parse the stored Config path into an object reference,
+   * Parse the stored Config path into object references,
    * beginning at the indicated root object.
    *
    * \param [in] root The object corresponding to the current position in
    *                  in the Config path.
+   * \param [in,out] objects The list of matching objects.
+   * \param [in,out] contexts The matching Config path context of each object.
    */
-  void Resolve (Ptr<Object> root);
+  void Resolve (Ptr<Object> root,
+                std::vector<Ptr<Object> > *objects,
+                std::vector<std::string> *contexts);
 
 private:
+  /** An attribute which can lead to another object on the path. */
+  struct PathAttribute
+  {
+    std::string name;                          //!< Attribute name.
+    Ptr<const AttributeAccessor> accessor;     //!< Attribute accessor.
+    bool isContainer;                          //!< Pointer or container attribute.
+    bool gettable;                             //!< Attribute can be read.
+  };
+  /** The attributes matching an element, keyed by instance TypeId. */
+  typedef std::map<TypeId, std::vector<PathAttribute> > AttributeCache;
+
+  /** One parsed element of the Config path. */
+  struct Element
+  {
+    std::string item;          //!< The path token.
+    bool isIndex;              //!< The token is an exact array index.
+    uint32_t index;            //!< The array index, if \c isIndex.
+    TypeId tid;                //!< The TypeId of a \c $ token, if known.
+    bool hasTid;               //!< \c tid is valid.
+    AttributeCache attributes; //!< Attribute lookups done so far.
+  };
+
   /** Ensure the Config path starts and ends with a '/'. */
   void Canonicalize (void);
+  /** Split the canonical Config path into elements. */
+  void Compile (void);
   /**
    * Parse the next element in the Config path.
    *
-   * \param [in] path The remaining portion of the Config path.
+   * \param [in] element The index of the next element.
    * \param [in] root The object corresponding to the current position
    *                  in the Config path.
    */
-  void DoResolve (std::string path, Ptr<Object> root);
+  void DoResolve (std::size_t element, Ptr<Object> root);
   /**
    * Parse an index on the Config path.
    *
-   * \param [in] path The remaining Config path.
-   * \param [in,out] vector The resulting list of matching objects.
+   * \param [in] element The index of the array index element.
+   * \param [in] root The object holding the container.
+   * \param [in] attribute The container attribute.
    */
-  void DoArrayResolve (std::string path, const ObjectPtrContainerValue &vector);
+  void DoArrayResolve (std::size_t element, Ptr<Object> root,
+                       const PathAttribute &attribute);
   /**
    * Handle one object found on the path.
    *
@@ -344,35 +381,41 @@ private:
    */
   void DoResolveOne (Ptr<Object> object);
   /**
-   * Get the current Config path.
+   * Get the attributes of an object type which match a path element.
    *
-   * \returns The current Config path.
+   * \param [in] element The index of the path element.
+   * \param [in] tid The instance TypeId of the object.
+   * \returns The matching pointer and container attributes.
    */
-  std::string GetResolvedPath (void) const;
+  const std::vector<PathAttribute> & GetAttributes (std::size_t element, TypeId tid);
   /**
-   * Handle one found object.
+   * Get the current Config path.
    *
-   * \param [in] object The found object.
-   * \param [in] path The matching Config path context.
+   * \returns The current Config path.
    */
-  virtual void DoOne (Ptr<Object> object, std::string path) = 0;
+  std::string GetResolvedPath (void) const;
 
   /** Current list of path tokens. */
   std::vector<std::string> m_workStack;
   /** The Config path. */
   std::string m_path;
+  /** The parsed Config path. */
+  std::vector<Element> m_elements;
+  /** The list of matching objects of the current resolution. */
+  std::vector<Ptr<Object> > *m_objects;
+  /** The contexts of the matching objects of the current resolution. */
+  std::vector<std::string> *m_contexts;
 
 };  // class Resolver
 
 Resolver::Resolver (std::string path)
-  : m_path (path)
+  : m_path (path),
+    m_objects (0),
+    m_contexts (0)
 {
   NS_LOG_FUNCTION (this << path);
   Canonicalize ();
-}
-Resolver::~Resolver ()
-{
-  NS_LOG_FUNCTION (this);
+  Compile ();
 }
 void
 Resolver::Canonicalize (void)
@@ -395,11 +438,49 @@ Resolver::Canonicalize (void)
 }
 
 void
-Resolver::Resolve (Ptr<Object> root)
+Resolver::Compile (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  std::string::size_type cur = 0;
+  std::string::size_type next = m_path.find ("/", 1);
+  while (next != std::string::npos)
+    {
+      Element element;
+      element.item = m_path.substr (cur + 1, next - (cur + 1));
+      element.isIndex = false;
+      element.index = 0;
+      element.hasTid = false;
+      if (!element.item.empty ()
+          && element.item.find_first_not_of ("0123456789") == std::string::npos)
+        {
+          std::istringstream iss (element.item);
+          iss >> element.index;
+          element.isIndex = !iss.bad () && !iss.fail ();
+        }
+      if (element.item.find ("$") == 0)
+        {
+          // The lookup is repeated on resolution to report unknown types.
+          element.hasTid = TypeId::LookupByNameFailSafe (element.item.substr (1), &element.tid);
+        }
+      m_elements.push_back (element);
+      cur = next;
+      next = m_path.find ("/", cur + 1);
+    }
+}
+
+void
+Resolver::Resolve (Ptr<Object> root,
+                   std::vector<Ptr<Object> > *objects,
+                   std::vector<std::string> *contexts)
 {
-  NS_LOG_FUNCTION (this << root);
+  NS_LOG_FUNCTION (this << root << objects << contexts);
 
-  DoResolve (m_path, root);
+  m_objects = objects;
+  m_contexts = contexts;
+  DoResolve (0, root);
+  m_objects = 0;
+  m_contexts = 0;
 }
 
 std::string
@@ -421,17 +502,71 @@ Resolver::DoResolveOne (Ptr<Object> object)
   NS_LOG_FUNCTION (this << object);
 
   NS_LOG_DEBUG ("resolved=" << GetResolvedPath ());
-  DoOne (object, GetResolvedPath ());
+  m_objects->push_back (object);
+  m_contexts->push_back (GetResolvedPath ());
+}
+
+const std::vector<Resolver::PathAttribute> &
+Resolver::GetAttributes (std::size_t element, TypeId tid)
+{
+  NS_LOG_FUNCTION (this << element << tid);
+
+  AttributeCache &cache = m_elements[element].attributes;
+  AttributeCache::const_iterator found = cache.find (tid);
+  if (found != cache.end ())
+    {
+      return found->second;
+    }
+
+  const std::string &item = m_elements[element].item;
+  std::vector<PathAttribute> &attributes = cache[tid];
+  TypeId cur;
+  TypeId nextTid = tid;
+  do
+    {
+      cur = nextTid;
+
+      for (uint32_t i = 0; i < cur.GetAttributeN (); i++)
+        {
+          struct TypeId::AttributeInformation info;
+          info = cur.GetAttribute (i);
+          if (info.name != item && item != "*")
+            {
+              continue;
+            }
+          PathAttribute attribute;
+          attribute.name = info.name;
+          attribute.accessor = info.accessor;
+          attribute.gettable = (info.flags & TypeId::ATTR_GET) && info.accessor->HasGetter ();
+          // attempt to cast to a pointer checker.
+          if (dynamic_cast<const PointerChecker *> (PeekPointer (info.checker)) != 0)
+            {
+              attribute.isContainer = false;
+              attributes.push_back (attribute);
+            }
+          // attempt to cast to an object vector.
+          if (dynamic_cast<const ObjectPtrContainerChecker *> (PeekPointer (info.checker)) != 0)
+            {
+              attribute.isContainer = true;
+              attributes.push_back (attribute);
+            }
+          // this could be anything else and we don't know what to do with it.
+          // So, we just ignore it.
+        }
+
+      nextTid = cur.GetParent ();
+    }
+  while (nextTid != cur);
+
+  return attributes;
 }
 
 void
-Resolver::DoResolve (std::string path, Ptr<Object> root)
+Resolver::DoResolve (std::size_t element, Ptr<Object> root)
 {
-  NS_LOG_FUNCTION (this << path << root);
-  NS_ASSERT ((path.find ("/")) == 0);
-  std::string::size_type next = path.find ("/", 1);
+  NS_LOG_FUNCTION (this << element << root);
 
-  if (next == std::string::npos)
+  if (element == m_elements.size ())
     {
       //
       // If root is zero, we're beginning to see if we can use the object name
@@ -447,8 +582,7 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
         }
       return;
     }
-  std::string item = path.substr (1, next - 1);
-  std::string pathLeft = path.substr (next, path.size () - next);
+  const std::string &item = m_elements[element].item;
 
   //
   // If root is zero, we're beginning to see if we can use the object name
@@ -459,11 +593,10 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
   //
   if (root == 0)
     {
-      std::string::size_type offset = path.find ("/Names");
-      if (offset == 0)
+      if (item.find ("Names") == 0)
         {
           m_workStack.push_back (item);
-          DoResolve (pathLeft, root);
+          DoResolve (element + 1, root);
           m_workStack.pop_back ();
           return;
         }
@@ -480,7 +613,7 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
     {
       NS_LOG_DEBUG ("Name system resolved item = " << item << " to " << namedObject);
       m_workStack.push_back (item);
-      DoResolve (pathLeft, namedObject);
+      DoResolve (element + 1, namedObject);
       m_workStack.pop_back ();
       return;
     }
@@ -502,7 +635,8 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
       // This is a call to GetObject
       std::string tidString = item.substr (1, item.size () - 1);
       NS_LOG_DEBUG ("GetObject=" << tidString << " on path=" << GetResolvedPath ());
-      TypeId tid = TypeId::LookupByName (tidString);
+      TypeId tid = m_elements[element].hasTid ? m_elements[element].tid
+        : TypeId::LookupByName (tidString);
       Ptr<Object> object = root->GetObject<Object> (tid);
       if (object == 0)
         {
@@ -510,68 +644,52 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
           return;
         }
       m_workStack.push_back (item);
-      DoResolve (pathLeft, object);
+      DoResolve (element + 1, object);
       m_workStack.pop_back ();
     }
   else
     {
       // this is a normal attribute.
-      TypeId tid;
-      TypeId nextTid = root->GetInstanceTypeId ();
+      TypeId tid = root->GetInstanceTypeId ();
+      const std::vector<PathAttribute> &attributes = GetAttributes (element, tid);
       bool foundMatch = false;
 
-      do
+      for (std::vector<PathAttribute>::const_iterator i = attributes.begin (); i != attributes.end (); ++i)
         {
-          tid = nextTid;
-
-          for (uint32_t i = 0; i < tid.GetAttributeN (); i++)
+          if (!i->gettable)
             {
-              struct TypeId::AttributeInformation info;
-              info = tid.GetAttribute (i);
-              if (info.name != item && item != "*")
-                {
-                  continue;
-                }
-              // attempt to cast to a pointer checker.
-              const PointerChecker *pChecker = dynamic_cast<const PointerChecker *> (PeekPointer (info.checker));
-              if (pChecker != 0)
+              NS_FATAL_ERROR ("Attribute name=" << i->name << " is not gettable for this object: tid=" << tid.GetName ());
+            }
+          if (!i->isContainer)
+            {
+              NS_LOG_DEBUG ("GetAttribute(ptr)=" << i->name << " on path=" << GetResolvedPath ());
+              PointerValue pValue;
+              if (!i->accessor->Get (PeekPointer (root), pValue))
                 {
-                  NS_LOG_DEBUG ("GetAttribute(ptr)=" << info.name << " on path=" << GetResolvedPath ());
-                  PointerValue pValue;
-                  root->GetAttribute (info.name, pValue);
-                  Ptr<Object> object = pValue.Get<Object> ();
-                  if (object == 0)
-                    {
-                      NS_LOG_ERROR ("Requested object name=\"" << item <<
-                                    "\" exists on path=\"" << GetResolvedPath () << "\""
-                                    " but is null.");
-                      continue;
-                    }
-                  foundMatch = true;
-                  m_workStack.push_back (info.name);
-                  DoResolve (pathLeft, object);
-                  m_workStack.pop_back ();
+                  NS_FATAL_ERROR ("Attribute name=" << i->name << " tid=" << tid.GetName () << ": could not get value");
                 }
-              // attempt to cast to an object vector.
-              const ObjectPtrContainerChecker *vectorChecker =
-                dynamic_cast<const ObjectPtrContainerChecker *> (PeekPointer (info.checker));
-              if (vectorChecker != 0)
+              Ptr<Object> object = pValue.Get<Object> ();
+              if (object == 0)
                 {
-                  NS_LOG_DEBUG ("GetAttribute(vector)=" << info.name << " on path=" << GetResolvedPath () << pathLeft);
-                  foundMatch = true;
-                  ObjectPtrContainerValue vector;
-                  root->GetAttribute (info.name, vector);
-                  m_workStack.push_back (info.name);
-                  DoArrayResolve (pathLeft, vector);
-                  m_workStack.pop_back ();
+                  NS_LOG_ERROR ("Requested object name=\"" << item <<
+                                "\" exists on path=\"" << GetResolvedPath () << "\""
+                                " but is null.");
+                  continue;
                 }
-              // this could be anything else and we don't know what to do with it.
-              // So, we just ignore it.
+              foundMatch = true;
+              m_workStack.push_back (i->name);
+              DoResolve (element + 1, object);
+              m_workStack.pop_back ();
+            }
+          else
+            {
+              NS_LOG_DEBUG ("GetAttribute(vector)=" << i->name << " on path=" << GetResolvedPath ());
+              foundMatch = true;
+              m_workStack.push_back (i->name);
+              DoArrayResolve (element + 1, root, *i);
+              m_workStack.pop_back ();
             }
-
-          nextTid = tid.GetParent ();
         }
-      while (nextTid != tid);
 
       if (!foundMatch)
         {
@@ -582,20 +700,36 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
 }
 
 void
-Resolver::DoArrayResolve (std::string path, const ObjectPtrContainerValue &container)
+Resolver::DoArrayResolve (std::size_t element, Ptr<Object> root,
+                          const PathAttribute &attribute)
 {
-  NS_LOG_FUNCTION (this << path << &container);
-  NS_ASSERT (path != "");
-  NS_ASSERT ((path.find ("/")) == 0);
-  std::string::size_type next = path.find ("/", 1);
-  if (next == std::string::npos)
+  NS_LOG_FUNCTION (this << element << root << attribute.name);
+  if (element == m_elements.size ())
     {
       return;
     }
-  std::string item = path.substr (1, next - 1);
-  std::string pathLeft = path.substr (next, path.size () - next);
+  const ObjectPtrContainerAccessor *accessor =
+    dynamic_cast<const ObjectPtrContainerAccessor *> (PeekPointer (attribute.accessor));
 
-  ArrayMatcher matcher = ArrayMatcher (item);
+  if (m_elements[element].isIndex && accessor != 0)
+    {
+      // Fast path: fetch the single matching entry directly.
+      uint32_t index = m_elements[element].index;
+      Ptr<Object> object = accessor->Find (PeekPointer (root), index);
+      if (object)
+        {
+          std::ostringstream oss;
+          oss << index;
+          m_workStack.push_back (oss.str ());
+          DoResolve (element + 1, object);
+          m_workStack.pop_back ();
+        }
+      return;
+    }
+
+  ObjectPtrContainerValue container;
+  attribute.accessor->Get (PeekPointer (root), container);
+  ArrayMatcher matcher = ArrayMatcher (m_elements[element].item);
   ObjectPtrContainerValue::Iterator it;
   for (it = container.Begin (); it != container.End (); ++it)
     {
@@ -604,7 +738,7 @@ Resolver::DoArrayResolve (std::string path, const ObjectPtrContainerValue &conta
           std::ostringstream oss;
           oss << (*it).first;
           m_workStack.push_back (oss.str ());
-          DoResolve (pathLeft, (*it).second);
+          DoResolve (element + 1, (*it).second);
           m_workStack.pop_back ();
         }
     }
@@ -633,6 +767,15 @@ public:
   void Disconnect (std::string path, const CallbackBase &cb);
   /** \copydoc ns3::Config::LookupMatches() */
   MatchContainer LookupMatches (std::string path);
+  /**
+   * Match a Config path which has already been parsed.
+   *
+   * \param [in] path The Config path.
+   * \param [in] resolver The parsed Config path.
+   * \returns A container which contains all the objects which match
+   *          \pname{path}.
+   */
+  MatchContainer LookupMatches (std::string path, Resolver &resolver);
 
   /** \copydoc ns3::Config::RegisterRootNamespaceObject() */
   void RegisterRootNamespaceObject (Ptr<Object> obj);
@@ -751,24 +894,19 @@ MatchContainer
 ConfigImpl::LookupMatches (std::string path)
 {
   NS_LOG_FUNCTION (this << path);
-  class LookupMatchesResolver : public Resolver
-  {
-public:
-    LookupMatchesResolver (std::string path)
-      : Resolver (path)
-    {
-    }
-    virtual void DoOne (Ptr<Object> object, std::string path)
-    {
-      m_objects.push_back (object);
-      m_contexts.push_back (path);
-    }
-    std::vector<Ptr<Object> > m_objects;
-    std::vector<std::string> m_contexts;
-  } resolver = LookupMatchesResolver (path);
+  Resolver resolver = Resolver (path);
+  return LookupMatches (path, resolver);
+}
+
+MatchContainer
+ConfigImpl::LookupMatches (std::string path, Resolver &resolver)
+{
+  NS_LOG_FUNCTION (this << path << &resolver);
+  std::vector<Ptr<Object> > objects;
+  std::vector<std::string> contexts;
   for (Roots::const_iterator i = m_roots.begin (); i != m_roots.end (); i++)
     {
-      resolver.Resolve (*i);
+      resolver.Resolve (*i, &objects, &contexts);
     }
 
   //
@@ -776,9 +914,9 @@ public:
   // the root pointer zeroed indicates to the resolver that it should start
   // looking at the root of the "/Names" namespace during this go.
   //
-  resolver.Resolve (0);
+  resolver.Resolve (0, &objects, &contexts);
 
-  return MatchContainer (resolver.m_objects, resolver.m_contexts, path);
+  return MatchContainer (objects, contexts, path);
 }
 
 void
@@ -816,6 +954,43 @@ ConfigImpl::GetRootNamespaceObject (std::size_t i) const
   return m_roots[i];
 }
 
+CompiledPath::CompiledPath (std::string path)
+  : m_path (path),
+    m_resolver (Create<Resolver> (path))
+{
+  NS_LOG_FUNCTION (this << path);
+}
+CompiledPath::CompiledPath (const CompiledPath &o)
+  : m_path (o.m_path),
+    m_resolver (o.m_resolver)
+{
+  NS_LOG_FUNCTION (this << &o);
+}
+CompiledPath &
+CompiledPath::operator = (const CompiledPath &o)
+{
+  NS_LOG_FUNCTION (this << &o);
+  m_path = o.m_path;
+  m_resolver = o.m_resolver;
+  return *this;
+}
+CompiledPath::~CompiledPath ()
+{
+  NS_LOG_FUNCTION (this);
+}
+std::string
+CompiledPath::GetPath (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_path;
+}
+MatchContainer
+CompiledPath::LookupMatches (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return ConfigImpl::Get ()->LookupMatches (m_path, *m_resolver);
+}
+
 
 void Reset (void)
 {
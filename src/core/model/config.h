@@ -48,6 +48,8 @@ class CallbackBase;
  */
 namespace Config {
 
+class Resolver;
+
 /**
  * \ingroup config
  * Reset the initial value of every attribute as well as the value of every
@@ -344,6 +346,71 @@ private:
  */
 MatchContainer LookupMatches (std::string path);
 
+/**
+ * \ingroup config
+ * \brief A Config path which is parsed once and can be matched many times.
+ *
+ * Config::LookupMatches, Config::Set and Config::Connect parse their
+ * path on every call.  A CompiledPath splits the path into its elements
+ * and looks up the TypeId of its \c $ elements once, and keeps the
+ * attribute lookups done while matching, so that matching it again (or
+ * matching a wildcard over many objects of the same type) skips the
+ * attribute reflection.
+ *
+ * Like every Config path, exact array indices such as \c /NodeList/3
+ * fetch the indexed object directly rather than enumerating the
+ * container.
+ *
+ * The returned MatchContainer can then be used to bulk-connect several
+ * trace sources or set several attributes on all the matched objects:
+ * \code
+ *   Config::CompiledPath path ("/NodeList/2/DeviceList/0/$ns3::PointToPointNetDevice");
+ *   Config::MatchContainer devices = path.LookupMatches ();
+ *   devices.Connect ("MacRx", MakeCallback (&RxTrace));
+ *   devices.Connect ("PhyRxDrop", MakeCallback (&DropTrace));
+ * \endcode
+ */
+class CompiledPath
+{
+public:
+  /**
+   * Parse a Config path.
+   *
+   * \param [in] path The path to perform matches against.
+   */
+  CompiledPath (std::string path);
+  /**
+   * Copy constructor; the parsed path is shared.
+   *
+   * \param [in] o The CompiledPath to copy.
+   */
+  CompiledPath (const CompiledPath &o);
+  /**
+   * Assignment operator; the parsed path is shared.
+   *
+   * \param [in] o The CompiledPath to copy.
+   * \returns This CompiledPath.
+   */
+  CompiledPath & operator = (const CompiledPath &o);
+  ~CompiledPath ();
+
+  /**
+   * \returns The path this CompiledPath was built from.
+   */
+  std::string GetPath (void) const;
+  /**
+   * \returns A container which contains all the objects which currently
+   *          match the path.
+   */
+  MatchContainer LookupMatches (void) const;
+
+private:
+  /** The path this CompiledPath was built from. */
+  std::string m_path;
+  /** The parsed path. */
+  Ptr<Resolver> m_resolver;
+};
+
 /**
  * \ingroup config
  * \param [in] obj A new root object
@@ -21,6 +21,7 @@
 #define EVENT_IMPL_H
 
 #include <stdint.h>
+#include <cstddef>
 #include "simple-ref-count.h"
 
 /**
@@ -65,6 +66,16 @@ public:
    * Checked by the simulation engine before calling Invoke().
    */
   bool IsCancelled (void);
+  /**
+   * \brief Get the function or method pointer this event invokes.
+   *
+   * Profilers use this to tell apart events of the same type which
+   * invoke different functions with the same signature.
+   *
+   * \param [out] size The size of the pointer, in bytes.
+   * \returns The address of the pointer, or 0 if it is not known.
+   */
+  virtual const void * PeekFunction (std::size_t *size) const;
 
 protected:
   /**
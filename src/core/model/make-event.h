@@ -379,6 +379,11 @@ EventImpl * MakeEvent (MEM mem_ptr, OBJ obj)
     {}
     virtual ~EventMemberImpl0 ()
     {}
+    virtual const void * PeekFunction (std::size_t *size) const
+    {
+      *size = sizeof (m_function);
+      return &m_function;
+    }
 
   private:
     virtual void Notify (void)
@@ -410,6 +415,13 @@ EventImpl * MakeEvent (MEM mem_ptr, OBJ obj, T1 a1)
     virtual ~EventMemberImpl1 ()
     {}
 
+  public:
+    virtual const void * PeekFunction (std::size_t *size) const
+    {
+      *size = sizeof (m_function);
+      return &m_function;
+    }
+
   private:
     virtual void Notify (void)
     {
@@ -441,6 +453,13 @@ EventImpl * MakeEvent (MEM mem_ptr, OBJ obj, T1 a1, T2 a2)
     virtual ~EventMemberImpl2 ()
     {}
 
+  public:
+    virtual const void * PeekFunction (std::size_t *size) const
+    {
+      *size = sizeof (m_function);
+      return &m_function;
+    }
+
   private:
     virtual void Notify (void)
     {
@@ -474,6 +493,13 @@ EventImpl * MakeEvent (MEM mem_ptr, OBJ obj, T1 a1, T2 a2, T3 a3)
     virtual ~EventMemberImpl3 ()
     {}
 
+  public:
+    virtual const void * PeekFunction (std::size_t *size) const
+    {
+      *size = sizeof (m_function);
+      return &m_function;
+    }
+
   private:
     virtual void Notify (void)
     {
@@ -509,6 +535,13 @@ EventImpl * MakeEvent (MEM mem_ptr, OBJ obj, T1 a1, T2 a2, T3 a3, T4 a4)
     virtual ~EventMemberImpl4 ()
     {}
 
+  public:
+    virtual const void * PeekFunction (std::size_t *size) const
+    {
+      *size = sizeof (m_function);
+      return &m_function;
+    }
+
   private:
     virtual void Notify (void)
     {
@@ -547,6 +580,13 @@ EventImpl * MakeEvent (MEM mem_ptr, OBJ obj,
     virtual ~EventMemberImpl5 ()
     {}
 
+  public:
+    virtual const void * PeekFunction (std::size_t *size) const
+    {
+      *size = sizeof (m_function);
+      return &m_function;
+    }
+
   private:
     virtual void Notify (void)
     {
@@ -587,6 +627,13 @@ EventImpl * MakeEvent (MEM mem_ptr, OBJ obj,
     virtual ~EventMemberImpl6 ()
     {}
 
+  public:
+    virtual const void * PeekFunction (std::size_t *size) const
+    {
+      *size = sizeof (m_function);
+      return &m_function;
+    }
+
   private:
     virtual void Notify (void)
     {
@@ -623,6 +670,13 @@ EventImpl * MakeEvent (void (*f)(U1), T1 a1)
     virtual ~EventFunctionImpl1 ()
     {}
 
+  public:
+    virtual const void * PeekFunction (std::size_t *size) const
+    {
+      *size = sizeof (m_function);
+      return &m_function;
+    }
+
   private:
     virtual void Notify (void)
     {
@@ -654,6 +708,13 @@ EventImpl * MakeEvent (void (*f)(U1,U2), T1 a1, T2 a2)
     virtual ~EventFunctionImpl2 ()
     {}
 
+  public:
+    virtual const void * PeekFunction (std::size_t *size) const
+    {
+      *size = sizeof (m_function);
+      return &m_function;
+    }
+
   private:
     virtual void Notify (void)
     {
@@ -688,6 +749,13 @@ EventImpl * MakeEvent (void (*f)(U1,U2,U3), T1 a1, T2 a2, T3 a3)
     virtual ~EventFunctionImpl3 ()
     {}
 
+  public:
+    virtual const void * PeekFunction (std::size_t *size) const
+    {
+      *size = sizeof (m_function);
+      return &m_function;
+    }
+
   private:
     virtual void Notify (void)
     {
@@ -724,6 +792,13 @@ EventImpl * MakeEvent (void (*f)(U1,U2,U3,U4), T1 a1, T2 a2, T3 a3, T4 a4)
     virtual ~EventFunctionImpl4 ()
     {}
 
+  public:
+    virtual const void * PeekFunction (std::size_t *size) const
+    {
+      *size = sizeof (m_function);
+      return &m_function;
+    }
+
   private:
     virtual void Notify (void)
     {
@@ -762,6 +837,13 @@ EventImpl * MakeEvent (void (*f)(U1,U2,U3,U4,U5), T1 a1, T2 a2, T3 a3, T4 a4, T5
     virtual ~EventFunctionImpl5 ()
     {}
 
+  public:
+    virtual const void * PeekFunction (std::size_t *size) const
+    {
+      *size = sizeof (m_function);
+      return &m_function;
+    }
+
   private:
     virtual void Notify (void)
     {
@@ -802,6 +884,13 @@ EventImpl * MakeEvent (void (*f)(U1,U2,U3,U4,U5,U6), T1 a1, T2 a2, T3 a3, T4 a4,
     virtual ~EventFunctionImpl6 ()
     {}
 
+  public:
+    virtual const void * PeekFunction (std::size_t *size) const
+    {
+      *size = sizeof (m_function);
+      return &m_function;
+    }
+
   private:
     virtual void Notify (void)
     {
@@ -228,6 +228,16 @@ public:
   virtual bool Get (const ObjectBase * object, AttributeValue &value) const;
   virtual bool HasGetter (void) const;
   virtual bool HasSetter (void) const;
+  /**
+   * Get the instance stored under a specific index, without
+   * enumerating the whole container.
+   *
+   * \param [in] object The container object.
+   * \param [in] index The index of the requested instance, as reported
+   *            by ObjectPtrContainerValue::Begin().
+   * \returns The instance, or 0 if there is no instance at \pname{index}.
+   */
+  Ptr<Object> Find (const ObjectBase *object, std::size_t index) const;
 
 private:
   /**
@@ -247,6 +257,18 @@ private:
    * \returns The index requested.
    */
   virtual Ptr<Object> DoGet (const ObjectBase *object, std::size_t i, std::size_t *index) const = 0;
+  /**
+   * Get an instance from the container, identified by its index.
+   *
+   * The default implementation walks the container with DoGet().
+   * Containers whose index is the position of the instance override
+   * this to return it directly.
+   *
+   * \param [in] object The container object.
+   * \param [in] index The index of the requested instance.
+   * \returns The instance, or 0 if there is no instance at \pname{index}.
+   */
+  virtual Ptr<Object> DoFind (const ObjectBase *object, std::size_t index) const;
 };
 
 template <typename T, typename U, typename INDEX>
@@ -272,6 +294,15 @@ MakeObjectPtrContainerAccessor (Ptr<U> (T::*get)(INDEX) const,
       *index = i;
       return (obj->*m_get)(i);
     }
+    virtual Ptr<Object> DoFind (const ObjectBase *object, std::size_t index) const
+    {
+      const T *obj = dynamic_cast<const T *> (object);
+      if (obj == 0 || index >= static_cast<std::size_t> ((obj->*m_getN)()))
+        {
+          return 0;
+        }
+      return (obj->*m_get)(index);
+    }
     Ptr<U> (T::*m_get)(INDEX) const;
     INDEX (T::*m_getN)(void) const;
   } *spec = new MemberGetters ();
@@ -24,6 +24,7 @@
 #include "ptr.h"
 #include "attribute.h"
 #include "object-ptr-container.h"
+#include <iterator>
 
 /**
  * \file
@@ -111,6 +112,15 @@ MakeObjectVectorAccessor (U T::*memberVector)
       // quiet compiler.
       return 0;
     }
+    virtual Ptr<Object> DoFind (const ObjectBase *object, std::size_t index) const
+    {
+      const T *obj = dynamic_cast<const T *> (object);
+      if (obj == 0 || index >= (obj->*m_memberVector).size ())
+        {
+          return 0;
+        }
+      return *std::next ((obj->*m_memberVector).begin (), index);
+    }
     U T::*m_memberVector;
   } *spec = new MemberStdContainer ();
   spec->m_memberVector = memberVector;
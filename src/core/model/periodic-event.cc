@@ -0,0 +1,227 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "periodic-event.h"
+#include "abort.h"
+#include "log.h"
+#include "simulator.h"
+
+#include <algorithm>
+#include <map>
+#include <tuple>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup timer
+ * ns3::PeriodicEvent implementation.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("PeriodicEvent");
+
+namespace {
+
+/**
+ * Periodic events with the same key expire together:
+ * period, phase and context.
+ */
+typedef std::tuple<int64_t, int64_t, uint32_t> GroupKey;
+
+/** A periodic event of a group. */
+struct Member
+{
+  Ptr<EventImpl> event;  //!< The event.
+  int64_t start;         //!< The first expiration time of the event.
+};
+
+/** A group of periodic events expiring together. */
+struct Group
+{
+  /**
+   * Invoke the events of the group and schedule the next expiration.
+   */
+  void Expire (void);
+
+  GroupKey key;                  //!< The key of the group.
+  int64_t period;                //!< The period.
+  int64_t next;                  //!< The next expiration time.
+  std::vector<Member> members;   //!< The events, in scheduling order.
+  Ptr<EventImpl> expire;         //!< The event invoking Expire().
+};
+
+/** The groups, by key. */
+typedef std::map<GroupKey, Group *> Groups;
+
+/**
+ * Get the groups.
+ * \returns The groups.
+ */
+Groups &
+GetGroups (void)
+{
+  static Groups groups;
+  return groups;
+}
+
+/** Has the release of the groups been scheduled? */
+bool g_destroyScheduled = false;
+
+/**
+ * Release the groups, at the end of the simulation.
+ */
+void
+DestroyGroups (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  Groups &groups = GetGroups ();
+  for (Groups::iterator i = groups.begin (); i != groups.end (); ++i)
+    {
+      Group *group = i->second;
+      for (std::vector<Member>::iterator j = group->members.begin (); j != group->members.end (); ++j)
+        {
+          j->event->Cancel ();
+        }
+      delete group;
+    }
+  groups.clear ();
+  g_destroyScheduled = false;
+}
+
+/**
+ * Check if a member of a group was cancelled.
+ * \param [in] member The member.
+ * \returns \c true if the member was cancelled.
+ */
+bool
+IsCancelled (const Member &member)
+{
+  return member.event->IsCancelled ();
+}
+
+void
+Group::Expire (void)
+{
+  NS_LOG_FUNCTION (this);
+  int64_t now = Simulator::Now ().GetTimeStep ();
+  NS_ASSERT (now == next);
+  // Events scheduled by the events invoked here are appended, and
+  // expire one period from now at the earliest.
+  std::size_t n = members.size ();
+  for (std::size_t i = 0; i < n; i++)
+    {
+      if (!members[i].event->IsCancelled () && members[i].start <= now)
+        {
+          members[i].event->Invoke ();
+        }
+    }
+  members.erase (std::remove_if (members.begin (), members.end (), &IsCancelled), members.end ());
+  if (members.empty ())
+    {
+      NS_LOG_LOGIC ("group " << this << " has no more events");
+      GetGroups ().erase (key);
+      delete this;
+      return;
+    }
+  next += period;
+  Simulator::Schedule (TimeStep (period), expire);
+}
+
+} // unnamed namespace
+
+
+PeriodicEvent::PeriodicEvent ()
+  : m_event (0),
+    m_period (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+PeriodicEvent
+PeriodicEvent::DoSchedule (Time const &period, EventImpl *event)
+{
+  NS_LOG_FUNCTION (period << event);
+  NS_ABORT_MSG_UNLESS (period.IsStrictlyPositive (), "The period of a periodic event must be strictly positive");
+
+  PeriodicEvent handle;
+  handle.m_event = Ptr<EventImpl> (event, false);
+  handle.m_period = period;
+
+  Member member;
+  member.event = handle.m_event;
+  member.start = (Simulator::Now () + period).GetTimeStep ();
+  int64_t ts = period.GetTimeStep ();
+  GroupKey key = std::make_tuple (ts, member.start % ts, Simulator::GetContext ());
+
+  Groups &groups = GetGroups ();
+  Groups::iterator i = groups.find (key);
+  if (i != groups.end ())
+    {
+      NS_LOG_LOGIC ("join group " << i->second);
+      i->second->members.push_back (member);
+      return handle;
+    }
+
+  Group *group = new Group ();
+  group->key = key;
+  group->period = ts;
+  group->next = member.start;
+  group->members.push_back (member);
+  group->expire = Ptr<EventImpl> (MakeEvent (&Group::Expire, group), false);
+  groups.insert (std::make_pair (key, group));
+  NS_LOG_LOGIC ("new group " << group);
+  if (!g_destroyScheduled)
+    {
+      Simulator::ScheduleDestroy (&DestroyGroups);
+      g_destroyScheduled = true;
+    }
+  Simulator::Schedule (period, group->expire);
+  return handle;
+}
+
+void
+PeriodicEvent::Cancel (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_event != 0)
+    {
+      m_event->Cancel ();
+    }
+}
+
+bool
+PeriodicEvent::IsRunning (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_event != 0 && !m_event->IsCancelled ();
+}
+
+Time
+PeriodicEvent::GetPeriod (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_period;
+}
+
+uint32_t
+PeriodicEvent::GetGroupN (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  return GetGroups ().size ();
+}
+
+} // namespace ns3
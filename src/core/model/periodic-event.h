@@ -0,0 +1,130 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef PERIODIC_EVENT_H
+#define PERIODIC_EVENT_H
+
+#include "event-impl.h"
+#include "make-event.h"
+#include "nstime.h"
+#include "ptr.h"
+
+#include <stdint.h>
+
+/**
+ * \file
+ * \ingroup timer
+ * ns3::PeriodicEvent declaration.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup timer
+ * \brief An event which expires repeatedly, with a fixed period.
+ *
+ * Periodic events are kept apart from the main event list.  Events
+ * sharing the same period, the same phase (their expiration times
+ * modulo the period) and the same context are coalesced into a group,
+ * and only the next expiration of each group is in the main event
+ * list.  When the group expires, its events are invoked in the order
+ * they were scheduled, and the group event is scheduled again for the
+ * next period.  The event closures and the group event are reused, but
+ * scheduling the group event again still costs one insertion in the
+ * main event list per group and period, with the allocation that the
+ * scheduler makes for it, such as a node of the default MapScheduler.
+ *
+ * Thousands of satellites sampling their position every second thus
+ * cost a single event per second, rather than one per satellite.
+ *
+ * \code
+ *   PeriodicEvent update = PeriodicEvent::Schedule (Seconds (1), &Model::Update, this);
+ *   ...
+ *   update.Cancel ();
+ * \endcode
+ */
+class PeriodicEvent
+{
+public:
+  /** Constructor, for an event which is not running. */
+  PeriodicEvent ();
+
+  /**
+   * Schedule an event to expire every \p period, starting one period
+   * from now, in the current context.
+   *
+   * \tparam FUNC \deduced Template type for the function to invoke.
+   * \tparam Ts \deduced Argument types.
+   * \param [in] period The period of the event, strictly positive.
+   * \param [in] f The function to invoke.
+   * \param [in] args Arguments to pass to MakeEvent.
+   * \returns The handle of the periodic event.
+   */
+  template <typename FUNC, typename... Ts>
+  static PeriodicEvent Schedule (Time const &period, FUNC f, Ts&&... args);
+
+  /**
+   * Stop the event.  Its group expires once more at most, without
+   * invoking it.
+   */
+  void Cancel (void);
+  /**
+   * \returns \c true if the event was scheduled and not cancelled.
+   */
+  bool IsRunning (void) const;
+  /**
+   * \returns The period of the event.
+   */
+  Time GetPeriod (void) const;
+
+  /**
+   * \returns The number of groups of periodic events, which is also
+   *          the number of periodic events in the main event list.
+   */
+  static uint32_t GetGroupN (void);
+
+private:
+  /**
+   * Implementation of Schedule().
+   * \param [in] period The period of the event.
+   * \param [in] event The event to invoke.
+   * \returns The handle of the periodic event.
+   */
+  static PeriodicEvent DoSchedule (Time const &period, EventImpl *event);
+
+  Ptr<EventImpl> m_event;  //!< The event invoked every period.
+  Time m_period;           //!< The period.
+};
+
+} // namespace ns3
+
+
+/********************************************************************
+ *  Implementation of the templates declared above.
+ ********************************************************************/
+
+namespace ns3 {
+
+template <typename FUNC, typename... Ts>
+PeriodicEvent
+PeriodicEvent::Schedule (Time const &period, FUNC f, Ts&&... args)
+{
+  return DoSchedule (period, MakeEvent (f, std::forward<Ts> (args)...));
+}
+
+} // namespace ns3
+
+#endif /* PERIODIC_EVENT_H */
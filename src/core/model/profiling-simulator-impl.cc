@@ -0,0 +1,415 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "profiling-simulator-impl.h"
+#include "abort.h"
+#include "log.h"
+#include "nstime.h"
+#include "simulator.h"
+#include "string.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <typeinfo>
+
+#if defined (__x86_64__) || defined (__i386__)
+#include <x86intrin.h>
+#endif
+
+#if (__GNUC__ >= 3)
+#include <cstdlib>
+#include <cxxabi.h>
+#endif
+
+#if defined (__unix__) || defined (__APPLE__)
+#include <dlfcn.h>
+#endif
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::ProfilingSimulatorImpl implementation.
+ */
+
+namespace ns3 {
+
+// Note:  as in DefaultSimulatorImpl, logging is avoided on the
+// per-event paths.
+NS_LOG_COMPONENT_DEFINE ("ProfilingSimulatorImpl");
+
+NS_OBJECT_ENSURE_REGISTERED (ProfilingSimulatorImpl);
+
+namespace {
+
+/** Event type charged with the cancelled events. */
+struct Cancelled
+{};
+
+/**
+ * \returns The processor cycle counter, or a nanosecond clock.
+ */
+inline uint64_t
+ReadCycles (void)
+{
+#if defined (__x86_64__) || defined (__i386__)
+  return __rdtsc ();
+#else
+  return std::chrono::duration_cast<std::chrono::nanoseconds>
+           (std::chrono::steady_clock::now ().time_since_epoch ()).count ();
+#endif
+}
+
+/**
+ * Demangle a symbol or type name.
+ * \param [in] mangled The mangled name.
+ * \returns The demangled name, or \p mangled.
+ */
+std::string
+Demangle (const char *mangled)
+{
+  std::string name = mangled;
+#if (__GNUC__ >= 3)
+  int status;
+  char *demangled = abi::__cxa_demangle (mangled, NULL, NULL, &status);
+  if (status == 0)
+    {
+      name = demangled;
+    }
+  std::free (demangled);
+#endif
+  return name;
+}
+
+/**
+ * Get the readable name of the function invoked by events.
+ *
+ * Function addresses are resolved to their symbol where the dynamic
+ * linker knows it, and otherwise shown as an offset in their object
+ * file, for addr2line.
+ *
+ * \param [in] key The event function.
+ * \returns The function name, followed by the event type name.
+ */
+std::string
+GetFunctionName (const ProfilingSimulatorImpl::EventKey &key)
+{
+  if (key.type == std::type_index (typeid (Cancelled)))
+    {
+      return "(cancelled events)";
+    }
+  std::string type = Demangle (key.type.name ());
+  if (key.size == 0)
+    {
+      return type;
+    }
+  uintptr_t address = key.function[0];
+  std::ostringstream oss;
+  if (key.size > sizeof (void *) && (address & 1) != 0)
+    {
+      // Itanium C++ ABI: a pointer to a virtual method holds one plus
+      // its offset in the virtual table.
+      oss << "virtual method at vtable offset " << address - 1;
+    }
+  else
+    {
+#if defined (__unix__) || defined (__APPLE__)
+      Dl_info info;
+      bool found = dladdr (reinterpret_cast<void *> (address), &info) != 0;
+      if (found && info.dli_sname != 0)
+        {
+          oss << Demangle (info.dli_sname);
+        }
+      else if (found && info.dli_fname != 0)
+        {
+          oss << info.dli_fname << "+0x" << std::hex
+              << address - reinterpret_cast<uintptr_t> (info.dli_fbase) << std::dec;
+        }
+      else
+#endif
+        {
+          oss << "0x" << std::hex << address << std::dec;
+        }
+    }
+  oss << " [" << type << "]";
+  return oss.str ();
+}
+
+/**
+ * Order profiles by decreasing cycles.
+ * \param [in] a The first profile.
+ * \param [in] b The second profile.
+ * \returns \c true if \p a comes first.
+ */
+template <typename T>
+bool
+MoreCycles (const std::pair<T, ProfilingSimulatorImpl::Stats> &a,
+            const std::pair<T, ProfilingSimulatorImpl::Stats> &b)
+{
+  return a.second.cycles > b.second.cycles;
+}
+
+/**
+ * Write a table of profiles, by decreasing cycles.
+ * \param [in,out] os The output stream.
+ * \param [in] stats The profiles.
+ * \param [in] cyclesPerSecond The cycle counter frequency.
+ * \param [in] totalCycles The cycles of the whole run.
+ * \param [in] name Function returning the name of a profile key.
+ */
+template <typename T, typename H>
+void
+WriteTable (std::ostream &os, const std::unordered_map<T, ProfilingSimulatorImpl::Stats, H> &stats,
+            double cyclesPerSecond, uint64_t totalCycles, std::string (*name)(const T &))
+{
+  std::vector<std::pair<T, ProfilingSimulatorImpl::Stats> > sorted (stats.begin (), stats.end ());
+  std::sort (sorted.begin (), sorted.end (), &MoreCycles<T>);
+  os << std::setw (12) << "count" << std::setw (12) << "seconds" << std::setw (12) << "mean-ns"
+     << std::setw (8) << "share" << "  name" << std::endl;
+  for (typename std::vector<std::pair<T, ProfilingSimulatorImpl::Stats> >::const_iterator i = sorted.begin ();
+       i != sorted.end (); ++i)
+    {
+      double seconds = i->second.cycles / cyclesPerSecond;
+      os << std::setw (12) << i->second.count
+         << std::setw (12) << std::fixed << std::setprecision (6) << seconds
+         << std::setw (12) << std::setprecision (1) << seconds * 1e9 / i->second.count
+         << std::setw (7) << std::setprecision (2) << 100.0 * i->second.cycles / std::max<uint64_t> (totalCycles, 1)
+         << "%  " << name (i->first) << std::endl;
+    }
+  os.unsetf (std::ios::floatfield);
+}
+
+/**
+ * Get the readable name of a context.
+ * \param [in] context The context.
+ * \returns The name of the context.
+ */
+std::string
+GetContextName (const uint32_t &context)
+{
+  if (context == Simulator::NO_CONTEXT)
+    {
+      return "(no context)";
+    }
+  std::ostringstream oss;
+  oss << "node " << context;
+  return oss.str ();
+}
+
+} // unnamed namespace
+
+
+TypeId
+ProfilingSimulatorImpl::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::ProfilingSimulatorImpl")
+    .SetParent<DefaultSimulatorImpl> ()
+    .SetGroupName ("Core")
+    .AddConstructor<ProfilingSimulatorImpl> ()
+    .AddAttribute ("ReportFile",
+                   "The file the report is written to at Simulator::Destroy.",
+                   StringValue ("simulator-profile.txt"),
+                   MakeStringAccessor (&ProfilingSimulatorImpl::m_reportFile),
+                   MakeStringChecker ())
+    .AddAttribute ("SampleInterval",
+                   "The simulated time between samples of the number of pending events.",
+                   TimeValue (Seconds (1)),
+                   MakeTimeAccessor (&ProfilingSimulatorImpl::m_sampleInterval),
+                   MakeTimeChecker (TimeStep (1)))
+  ;
+  return tid;
+}
+
+ProfilingSimulatorImpl::Stats::Stats ()
+  : count (0),
+    cycles (0)
+{}
+
+ProfilingSimulatorImpl::EventKey::EventKey (std::type_index type)
+  : type (type),
+    size (0)
+{
+  function[0] = 0;
+  function[1] = 0;
+}
+
+bool
+ProfilingSimulatorImpl::EventKey::operator == (const EventKey &other) const
+{
+  return type == other.type && size == other.size
+         && function[0] == other.function[0] && function[1] == other.function[1];
+}
+
+std::size_t
+ProfilingSimulatorImpl::EventKeyHash::operator () (const EventKey &key) const
+{
+  return key.type.hash_code () ^ (key.function[0] * 31) ^ key.function[1];
+}
+
+ProfilingSimulatorImpl::ProfilingSimulatorImpl ()
+  : m_currentFunction (0),
+    m_currentContext (0),
+    m_start (0),
+    m_depth (0),
+    m_nextSample (0),
+    m_runCycles (0),
+    m_runSeconds (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+ProfilingSimulatorImpl::~ProfilingSimulatorImpl ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+ProfilingSimulatorImpl::Destroy ()
+{
+  NS_LOG_FUNCTION (this);
+  if (!m_reportFile.empty ())
+    {
+      std::ofstream os (m_reportFile.c_str ());
+      NS_ABORT_MSG_UNLESS (os.is_open (), "Could not open profile report " << m_reportFile);
+      Report (os);
+    }
+  DefaultSimulatorImpl::Destroy ();
+}
+
+void
+ProfilingSimulatorImpl::Run (void)
+{
+  NS_LOG_FUNCTION (this);
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now ();
+  uint64_t startCycles = ReadCycles ();
+  DefaultSimulatorImpl::Run ();
+  Charge ();
+  m_currentFunction = 0;
+  m_currentContext = 0;
+  m_runCycles += ReadCycles () - startCycles;
+  m_runSeconds += std::chrono::duration<double> (std::chrono::steady_clock::now () - start).count ();
+}
+
+EventId
+ProfilingSimulatorImpl::Schedule (const Time &delay, EventImpl *event)
+{
+  m_depth.fetch_add (1, std::memory_order_relaxed);
+  return DefaultSimulatorImpl::Schedule (delay, event);
+}
+
+void
+ProfilingSimulatorImpl::ScheduleWithContext (uint32_t context, const Time &delay, EventImpl *event)
+{
+  m_depth.fetch_add (1, std::memory_order_relaxed);
+  DefaultSimulatorImpl::ScheduleWithContext (context, delay, event);
+}
+
+void
+ProfilingSimulatorImpl::Remove (const EventId &id)
+{
+  if (id.GetUid () != EventId::UID::DESTROY && !IsExpired (id))
+    {
+      m_depth.fetch_sub (1, std::memory_order_relaxed);
+    }
+  DefaultSimulatorImpl::Remove (id);
+}
+
+void
+ProfilingSimulatorImpl::Charge (void)
+{
+  if (m_currentFunction != 0)
+    {
+      uint64_t cycles = ReadCycles () - m_start;
+      m_currentFunction->cycles += cycles;
+      m_currentContext->cycles += cycles;
+    }
+}
+
+void
+ProfilingSimulatorImpl::PreEventHook (const EventId &id)
+{
+  Charge ();
+
+  EventImpl *event = id.PeekEventImpl ();
+  EventKey key (typeid (Cancelled));
+  if (!event->IsCancelled ())
+    {
+      key.type = typeid (*event);
+      std::size_t size;
+      const void *function = event->PeekFunction (&size);
+      if (function != 0)
+        {
+          key.size = size;
+          std::memcpy (key.function, function, std::min (size, sizeof (key.function)));
+        }
+    }
+  m_currentFunction = &m_functions[key];
+  m_currentFunction->count++;
+  m_currentContext = &m_contexts[id.GetContext ()];
+  m_currentContext->count++;
+
+  if (id.GetTs () >= m_nextSample)
+    {
+      m_depths.push_back (std::make_pair (id.GetTs (), m_depth.load (std::memory_order_relaxed)));
+      uint64_t interval = m_sampleInterval.GetTimeStep ();
+      m_nextSample = id.GetTs () - id.GetTs () % interval + interval;
+    }
+  m_depth.fetch_sub (1, std::memory_order_relaxed);
+
+  m_start = ReadCycles ();
+}
+
+void
+ProfilingSimulatorImpl::Report (std::ostream &os) const
+{
+  NS_LOG_FUNCTION (this << &os);
+  double cyclesPerSecond = m_runSeconds > 0 ? m_runCycles / m_runSeconds : 1e9;
+  uint64_t events = 0;
+  uint64_t cycles = 0;
+  for (std::unordered_map<EventKey, Stats, EventKeyHash>::const_iterator i = m_functions.begin ();
+       i != m_functions.end (); ++i)
+    {
+      events += i->second.count;
+      cycles += i->second.cycles;
+    }
+
+  os << "# ns-3 simulator profile" << std::endl;
+  os << "events " << events << std::endl;
+  os << "run-seconds " << m_runSeconds << std::endl;
+  os << "event-seconds " << cycles / cyclesPerSecond << std::endl;
+  os << "cycles-per-second " << cyclesPerSecond << std::endl;
+  os << std::endl;
+
+  os << "# event functions" << std::endl;
+  WriteTable (os, m_functions, cyclesPerSecond, m_runCycles, &GetFunctionName);
+  os << std::endl;
+
+  os << "# contexts" << std::endl;
+  WriteTable (os, m_contexts, cyclesPerSecond, m_runCycles, &GetContextName);
+  os << std::endl;
+
+  os << "# pending events" << std::endl;
+  os << std::setw (20) << "time-seconds" << std::setw (12) << "events" << std::endl;
+  for (std::vector<std::pair<uint64_t, int64_t> >::const_iterator i = m_depths.begin (); i != m_depths.end (); ++i)
+    {
+      os << std::setw (20) << TimeStep (i->first).GetSeconds () << std::setw (12) << i->second << std::endl;
+    }
+}
+
+} // namespace ns3
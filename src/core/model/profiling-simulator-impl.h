@@ -0,0 +1,154 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef PROFILING_SIMULATOR_IMPL_H
+#define PROFILING_SIMULATOR_IMPL_H
+
+#include "default-simulator-impl.h"
+
+#include <atomic>
+#include <stdint.h>
+#include <string>
+#include <typeindex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::ProfilingSimulatorImpl declaration.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup simulator
+ *
+ * \brief The default simulator implementation, with an event profiler.
+ *
+ * Every event is charged the time elapsed until the next one starts,
+ * measured with the processor cycle counter where available: this
+ * includes the removal of the next event from the scheduler.  The
+ * charges are accumulated per event function, that is per MakeEvent()
+ * target function or method, and per context, that is per node.
+ * The number of pending events is sampled over simulated time.
+ *
+ * The report is written at Simulator::Destroy():
+ * \code
+ *   GlobalValue::Bind ("SimulatorImplementationType",
+ *                      StringValue ("ns3::ProfilingSimulatorImpl"));
+ *   Config::SetDefault ("ns3::ProfilingSimulatorImpl::ReportFile",
+ *                       StringValue ("profile.txt"));
+ * \endcode
+ *
+ * Events scheduled from other threads are counted as pending as soon
+ * as they are scheduled.
+ */
+class ProfilingSimulatorImpl : public DefaultSimulatorImpl
+{
+public:
+  /**
+   *  Register this type.
+   *  \return The object TypeId.
+   */
+  static TypeId GetTypeId (void);
+
+  /** Constructor. */
+  ProfilingSimulatorImpl ();
+  /** Destructor. */
+  ~ProfilingSimulatorImpl ();
+
+  // Inherited
+  virtual void Destroy ();
+  virtual void Run (void);
+  virtual EventId Schedule (const Time &delay, EventImpl *event);
+  virtual void ScheduleWithContext (uint32_t context, const Time &delay, EventImpl *event);
+  virtual void Remove (const EventId &id);
+  virtual void PreEventHook (const EventId &id);
+
+  /** Profile of a set of events. */
+  struct Stats
+  {
+    /** Constructor. */
+    Stats ();
+    uint64_t count;   //!< Number of events.
+    uint64_t cycles;  //!< Cumulative processor cycles.
+  };
+
+  /** Identity of the function invoked by an event. */
+  struct EventKey
+  {
+    /**
+     * Constructor.
+     * \param [in] type The type of the EventImpl.
+     */
+    EventKey (std::type_index type);
+    /**
+     * Equality operator.
+     * \param [in] other The other key.
+     * \returns \c true if both keys identify the same function.
+     */
+    bool operator == (const EventKey &other) const;
+    std::type_index type;   //!< Type of the EventImpl.
+    uint32_t size;          //!< Size of the function pointer, or 0 if unknown.
+    uintptr_t function[2];  //!< Function or method pointer.
+  };
+  /** Hash function of an EventKey. */
+  struct EventKeyHash
+  {
+    /**
+     * \param [in] key The key.
+     * \returns The hash of the key.
+     */
+    std::size_t operator () (const EventKey &key) const;
+  };
+
+  /**
+   * Write the report.
+   * \param [in,out] os The output stream.
+   */
+  void Report (std::ostream &os) const;
+
+private:
+  /** Charge the current event with the cycles elapsed since it started. */
+  void Charge (void);
+
+  /** The profile of each event function. */
+  std::unordered_map<EventKey, Stats, EventKeyHash> m_functions;
+  /** The profile of each context. */
+  std::unordered_map<uint32_t, Stats> m_contexts;
+  /** Samples of the number of pending events, in simulated time. */
+  std::vector<std::pair<uint64_t, int64_t> > m_depths;
+
+  Stats *m_currentFunction; //!< Profile of the event function running.
+  Stats *m_currentContext;  //!< Profile of the context running.
+  uint64_t m_start;         //!< Cycle counter when the event started.
+  /**
+   * Number of pending events.  Events may be scheduled from other
+   * threads, with ScheduleWithContext().
+   */
+  std::atomic<int64_t> m_depth;
+  uint64_t m_nextSample;    //!< Time of the next depth sample.
+  Time m_sampleInterval;    //!< Simulated time between depth samples.
+  std::string m_reportFile; //!< Report file name.
+  uint64_t m_runCycles;     //!< Cycles spent in Run().
+  double m_runSeconds;      //!< Wall clock seconds spent in Run().
+};
+
+} // namespace ns3
+
+#endif /* PROFILING_SIMULATOR_IMPL_H */
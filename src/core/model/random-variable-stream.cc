@@ -36,6 +36,7 @@
 #include <cmath>
 #include <iostream>
 #include <algorithm>    // upper_bound
+#include <cstring>
 
 /**
  * \file
@@ -47,6 +48,41 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("RandomVariableStream");
 
+namespace {
+
+/**
+ * Write a double exactly, as its bit pattern.
+ * \param [in,out] os The output stream.
+ * \param [in] v The value.
+ */
+void
+SaveDouble (std::ostream &os, double v)
+{
+  uint64_t bits;
+  std::memcpy (&bits, &v, sizeof (bits));
+  os << bits << " ";
+}
+
+/**
+ * Read a double written by SaveDouble().
+ * \param [in,out] is The input stream.
+ * \param [out] v The value.
+ * \returns \c true if the value could be read.
+ */
+bool
+RestoreDouble (std::istream &is, double *v)
+{
+  uint64_t bits;
+  if (!(is >> bits))
+    {
+      return false;
+    }
+  std::memcpy (v, &bits, sizeof (bits));
+  return true;
+}
+
+} // unnamed namespace
+
 NS_OBJECT_ENSURE_REGISTERED (RandomVariableStream);
 
 TypeId
@@ -131,6 +167,39 @@ RandomVariableStream::GetStream (void) const
   return m_stream;
 }
 
+void
+RandomVariableStream::SaveState (std::ostream &os) const
+{
+  NS_LOG_FUNCTION (this << &os);
+  NS_ASSERT (m_rng != 0);
+  double state[6];
+  m_rng->GetState (state);
+  // The MRG32k3a state components are integers below 2^32.
+  for (int i = 0; i < 6; ++i)
+    {
+      os << static_cast<uint64_t> (state[i]) << " ";
+    }
+}
+
+bool
+RandomVariableStream::RestoreState (std::istream &is)
+{
+  NS_LOG_FUNCTION (this << &is);
+  NS_ASSERT (m_rng != 0);
+  double state[6];
+  for (int i = 0; i < 6; ++i)
+    {
+      uint64_t v;
+      if (!(is >> v))
+        {
+          return false;
+        }
+      state[i] = static_cast<double> (v);
+    }
+  m_rng->SetState (state);
+  return true;
+}
+
 RngStream *
 RandomVariableStream::Peek (void) const
 {
@@ -363,6 +432,24 @@ SequentialRandomVariable::GetInteger (void)
   return (uint32_t)GetValue ();
 }
 
+void
+SequentialRandomVariable::SaveState (std::ostream &os) const
+{
+  NS_LOG_FUNCTION (this << &os);
+  RandomVariableStream::SaveState (os);
+  os << m_isCurrentSet << " " << m_currentConsecutive << " ";
+  SaveDouble (os, m_current);
+}
+
+bool
+SequentialRandomVariable::RestoreState (std::istream &is)
+{
+  NS_LOG_FUNCTION (this << &is);
+  return RandomVariableStream::RestoreState (is)
+         && (is >> m_isCurrentSet >> m_currentConsecutive)
+         && RestoreDouble (is, &m_current);
+}
+
 NS_OBJECT_ENSURE_REGISTERED (ExponentialRandomVariable);
 
 TypeId
@@ -761,6 +848,26 @@ NormalRandomVariable::GetInteger (void)
   return (uint32_t)GetValue (m_mean, m_variance, m_bound);
 }
 
+void
+NormalRandomVariable::SaveState (std::ostream &os) const
+{
+  NS_LOG_FUNCTION (this << &os);
+  RandomVariableStream::SaveState (os);
+  os << m_nextValid << " ";
+  SaveDouble (os, m_v2);
+  SaveDouble (os, m_y);
+}
+
+bool
+NormalRandomVariable::RestoreState (std::istream &is)
+{
+  NS_LOG_FUNCTION (this << &is);
+  return RandomVariableStream::RestoreState (is)
+         && (is >> m_nextValid)
+         && RestoreDouble (is, &m_v2)
+         && RestoreDouble (is, &m_y);
+}
+
 NS_OBJECT_ENSURE_REGISTERED (LogNormalRandomVariable);
 
 TypeId
@@ -1011,6 +1118,26 @@ GammaRandomVariable::GetInteger (void)
   return (uint32_t)GetValue (m_alpha, m_beta);
 }
 
+void
+GammaRandomVariable::SaveState (std::ostream &os) const
+{
+  NS_LOG_FUNCTION (this << &os);
+  RandomVariableStream::SaveState (os);
+  os << m_nextValid << " ";
+  SaveDouble (os, m_v2);
+  SaveDouble (os, m_y);
+}
+
+bool
+GammaRandomVariable::RestoreState (std::istream &is)
+{
+  NS_LOG_FUNCTION (this << &is);
+  return RandomVariableStream::RestoreState (is)
+         && (is >> m_nextValid)
+         && RestoreDouble (is, &m_v2)
+         && RestoreDouble (is, &m_y);
+}
+
 double
 GammaRandomVariable::GetNormalValue (double mean, double variance, double bound)
 {
@@ -1517,6 +1644,22 @@ DeterministicRandomVariable::GetInteger (void)
   return (uint32_t)GetValue ();
 }
 
+void
+DeterministicRandomVariable::SaveState (std::ostream &os) const
+{
+  NS_LOG_FUNCTION (this << &os);
+  RandomVariableStream::SaveState (os);
+  os << m_next << " ";
+}
+
+bool
+DeterministicRandomVariable::RestoreState (std::istream &is)
+{
+  NS_LOG_FUNCTION (this << &is);
+  return RandomVariableStream::RestoreState (is)
+         && (is >> m_next);
+}
+
 NS_OBJECT_ENSURE_REGISTERED (EmpiricalRandomVariable);
 
 // ValueCDF methods
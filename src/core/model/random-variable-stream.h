@@ -30,6 +30,7 @@
 #include "object.h"
 #include "attribute-helper.h"
 #include <stdint.h>
+#include <iostream>
 
 /**
  * \file
@@ -149,6 +150,24 @@ public:
    */
   virtual uint32_t GetInteger (void) = 0;
 
+  /**
+   * \brief Write the state of this stream.
+   *
+   * The base class writes the position of this stream in its RngStream.
+   * Distributions which keep state between draws, such as a cached
+   * second value, extend this.
+   *
+   * \param [in,out] os The output stream.
+   */
+  virtual void SaveState (std::ostream &os) const;
+
+  /**
+   * \brief Continue this stream from a state written by SaveState().
+   * \param [in,out] is The input stream.
+   * \returns \c true if the state could be read.
+   */
+  virtual bool RestoreState (std::istream &is);
+
 protected:
   /**
    * \brief Get the pointer to the underlying RngStream.
@@ -441,6 +460,16 @@ public:
   virtual double GetValue (void);
   virtual uint32_t GetInteger (void);
 
+  /**
+   * \copydoc RandomVariableStream::SaveState
+   * This includes the current value and its repetitions.
+   */
+  virtual void SaveState (std::ostream &os) const;
+  /**
+   * \copydoc RandomVariableStream::RestoreState
+   */
+  virtual bool RestoreState (std::istream &is);
+
 private:
   /** The first value of the sequence. */
   double m_min;
@@ -1224,6 +1253,16 @@ public:
    */
   virtual uint32_t GetInteger (void);
 
+  /**
+   * \copydoc RandomVariableStream::SaveState
+   * This includes the cached second value.
+   */
+  virtual void SaveState (std::ostream &os) const;
+  /**
+   * \copydoc RandomVariableStream::RestoreState
+   */
+  virtual bool RestoreState (std::istream &is);
+
 private:
   /** The mean value for the normal distribution returned by this RNG stream. */
   double m_mean;
@@ -1585,6 +1624,16 @@ public:
    */
   virtual uint32_t GetInteger (void);
 
+  /**
+   * \copydoc RandomVariableStream::SaveState
+   * This includes the cached normal draw.
+   */
+  virtual void SaveState (std::ostream &os) const;
+  /**
+   * \copydoc RandomVariableStream::RestoreState
+   */
+  virtual bool RestoreState (std::istream &is);
+
 private:
   /**
    * \brief Returns a random double from a normal distribution with the specified mean, variance, and bound.
@@ -2389,6 +2438,16 @@ public:
    */
   virtual uint32_t GetInteger (void);
 
+  /**
+   * \copydoc RandomVariableStream::SaveState
+   * This includes the position in the sequence.
+   */
+  virtual void SaveState (std::ostream &os) const;
+  /**
+   * \copydoc RandomVariableStream::RestoreState
+   */
+  virtual bool RestoreState (std::istream &is);
+
 private:
   /** Size of the array of values. */
   std::size_t   m_count;
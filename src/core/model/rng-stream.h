@@ -70,6 +70,18 @@ public:
    * \returns The next random.
    */
   double RandU01 (void);
+  /**
+   * Get the current state of this stream.
+   *
+   * \param [out] state The RNG state vector.
+   */
+  void GetState (double state[6]) const;
+  /**
+   * Set the state of this stream, as obtained from GetState().
+   *
+   * \param [in] state The RNG state vector.
+   */
+  void SetState (const double state[6]);
 
 private:
   /**
@@ -0,0 +1,403 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "timer-wheel.h"
+#include "assert.h"
+#include "log.h"
+#include "make-event.h"
+#include "simulator.h"
+
+/**
+ * \file
+ * \ingroup timer
+ * ns3::TimerWheel implementation.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("TimerWheel");
+
+bool TimerWheel::m_enabled = false;
+
+TimerWheel::Entry::Entry ()
+  : m_prev (0),
+    m_next (0),
+    m_slot (NO_SLOT),
+    m_context (0),
+    m_ts (0),
+    m_uid (0),
+    m_notify (0),
+    m_object (0)
+{}
+
+TimerWheel::Entry::Entry (const Entry &o)
+  : m_prev (0),
+    m_next (0),
+    m_slot (NO_SLOT),
+    m_context (0),
+    m_ts (0),
+    m_uid (0),
+    m_notify (0),
+    m_object (0)
+{
+  NS_ASSERT_MSG (!o.IsRunning (), "Cannot copy a scheduled timer wheel entry");
+}
+
+TimerWheel::Entry::~Entry ()
+{
+  TimerWheel::Cancel (this);
+}
+
+TimerWheel::Entry &
+TimerWheel::Entry::operator = (const Entry &o)
+{
+  NS_ASSERT_MSG (!o.IsRunning (), "Cannot copy a scheduled timer wheel entry");
+  return *this;
+}
+
+bool
+TimerWheel::Entry::IsRunning (void) const
+{
+  return m_slot != NO_SLOT;
+}
+
+Time
+TimerWheel::Entry::GetDelayLeft (void) const
+{
+  if (!IsRunning ())
+    {
+      return TimeStep (0);
+    }
+  return TimeStep (m_ts) - Simulator::Now ();
+}
+
+
+void
+TimerWheel::Enable (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  m_enabled = true;
+}
+
+void
+TimerWheel::Disable (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  m_enabled = false;
+}
+
+bool
+TimerWheel::IsEnabled (void)
+{
+  return m_enabled;
+}
+
+void
+TimerWheel::Schedule (Entry *entry, const Time &delay, void (*notify)(void *), void *object)
+{
+  NS_LOG_FUNCTION (entry << delay << object);
+  NS_ASSERT_MSG (delay.IsPositive (), "TimerWheel::Schedule(): Negative delay");
+  TimerWheel *wheel = GetWheel ();
+  if (entry->IsRunning ())
+    {
+      wheel->Unlink (entry);
+    }
+  Time now = Simulator::Now ();
+  wheel->Advance (now.GetTimeStep () >> TICK_SHIFT);
+  entry->m_context = Simulator::GetContext ();
+  entry->m_ts = (now + delay).GetTimeStep ();
+  entry->m_uid = wheel->m_uid++;
+  entry->m_notify = notify;
+  entry->m_object = object;
+  wheel->Link (entry);
+  if (!wheel->m_expiring && (wheel->m_eventTs < 0 || entry->m_ts < wheel->m_eventTs))
+    {
+      // Without a pending main event the wheel was empty: either way,
+      // the entry is the earliest one.
+      wheel->ScheduleEvent (entry);
+    }
+}
+
+void
+TimerWheel::Cancel (Entry *entry)
+{
+  if (entry->IsRunning ())
+    {
+      NS_LOG_FUNCTION (entry);
+      // The main event is left alone: if it was for this entry,
+      // it finds nothing to expire and moves on to the next one.
+      (*PeekWheel ())->Unlink (entry);
+    }
+}
+
+TimerWheel::TimerWheel ()
+  : m_tick (0),
+    m_uid (0),
+    m_event (0),
+    m_eventId (),
+    m_eventTs (-1),
+    m_eventContext (0),
+    m_expiring (false)
+{
+  NS_LOG_FUNCTION (this);
+  for (uint32_t i = 0; i < LEVELS * SLOTS; i++)
+    {
+      m_slots[i] = 0;
+    }
+  for (uint32_t i = 0; i < LEVELS; i++)
+    {
+      m_occupied[i] = 0;
+    }
+}
+
+TimerWheel::~TimerWheel ()
+{
+  NS_LOG_FUNCTION (this);
+  for (uint32_t i = 0; i < LEVELS * SLOTS; i++)
+    {
+      Entry *entry = m_slots[i];
+      while (entry != 0)
+        {
+          Entry *next = entry->m_next;
+          entry->m_prev = 0;
+          entry->m_next = 0;
+          entry->m_slot = NO_SLOT;
+          entry = next;
+        }
+    }
+}
+
+TimerWheel **
+TimerWheel::PeekWheel (void)
+{
+  static TimerWheel *wheel = 0;
+  return &wheel;
+}
+
+TimerWheel *
+TimerWheel::GetWheel (void)
+{
+  TimerWheel **wheel = PeekWheel ();
+  if (*wheel == 0)
+    {
+      *wheel = new TimerWheel ();
+      Simulator::ScheduleDestroy (&TimerWheel::DestroyWheel);
+    }
+  return *wheel;
+}
+
+void
+TimerWheel::DestroyWheel (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  TimerWheel **wheel = PeekWheel ();
+  delete *wheel;
+  *wheel = 0;
+}
+
+void
+TimerWheel::Link (Entry *entry)
+{
+  uint64_t tick = entry->m_ts >> TICK_SHIFT;
+  // The level is the first one whose wheel, aligned on its own span,
+  // holds both the current tick and the expiration tick.
+  uint64_t diff = tick ^ m_tick;
+  uint32_t level = 0;
+  while ((diff >> (LEVEL_SHIFT * (level + 1))) != 0)
+    {
+      level++;
+    }
+  NS_ASSERT (level < LEVELS);
+  uint32_t index = (tick >> (LEVEL_SHIFT * level)) & (SLOTS - 1);
+  uint32_t slot = level * SLOTS + index;
+  entry->m_slot = slot;
+  entry->m_prev = 0;
+  entry->m_next = m_slots[slot];
+  if (entry->m_next != 0)
+    {
+      entry->m_next->m_prev = entry;
+    }
+  m_slots[slot] = entry;
+  m_occupied[level] |= (uint64_t)1 << index;
+}
+
+void
+TimerWheel::Unlink (Entry *entry)
+{
+  uint32_t slot = entry->m_slot;
+  if (entry->m_prev != 0)
+    {
+      entry->m_prev->m_next = entry->m_next;
+    }
+  else
+    {
+      m_slots[slot] = entry->m_next;
+    }
+  if (entry->m_next != 0)
+    {
+      entry->m_next->m_prev = entry->m_prev;
+    }
+  if (m_slots[slot] == 0)
+    {
+      m_occupied[slot / SLOTS] &= ~((uint64_t)1 << (slot % SLOTS));
+    }
+  entry->m_prev = 0;
+  entry->m_next = 0;
+  entry->m_slot = NO_SLOT;
+}
+
+void
+TimerWheel::Advance (uint64_t tick)
+{
+  if (tick <= m_tick)
+    {
+      return;
+    }
+  m_tick = tick;
+  // No entry expires before tick, so the only slots to cascade are the
+  // current ones, from the top level down.
+  for (uint32_t level = LEVELS - 1; level > 0; level--)
+    {
+      uint32_t index = (tick >> (LEVEL_SHIFT * level)) & (SLOTS - 1);
+      if ((m_occupied[level] & ((uint64_t)1 << index)) == 0)
+        {
+          continue;
+        }
+      uint32_t slot = level * SLOTS + index;
+      Entry *entry = m_slots[slot];
+      m_slots[slot] = 0;
+      m_occupied[level] &= ~((uint64_t)1 << index);
+      while (entry != 0)
+        {
+          Entry *next = entry->m_next;
+          Link (entry);
+          entry = next;
+        }
+    }
+}
+
+TimerWheel::Entry *
+TimerWheel::GetFirst (void) const
+{
+  for (uint32_t level = 0; level < LEVELS; level++)
+    {
+      uint64_t occupied = m_occupied[level];
+      if (occupied == 0)
+        {
+          continue;
+        }
+      // The slots before the current one are empty: the first
+      // non-empty slot of the lowest level holds the earliest entry.
+      uint32_t index = 0;
+      while ((occupied & 1) == 0)
+        {
+          occupied >>= 1;
+          index++;
+        }
+      Entry *first = m_slots[level * SLOTS + index];
+      for (Entry *entry = first->m_next; entry != 0; entry = entry->m_next)
+        {
+          if (entry->m_ts < first->m_ts
+              || (entry->m_ts == first->m_ts && entry->m_uid < first->m_uid))
+            {
+              first = entry;
+            }
+        }
+      return first;
+    }
+  return 0;
+}
+
+void
+TimerWheel::Update (void)
+{
+  Entry *first = GetFirst ();
+  if (first == 0 || (m_eventTs >= 0 && m_eventTs <= first->m_ts))
+    {
+      return;
+    }
+  ScheduleEvent (first);
+}
+
+void
+TimerWheel::ScheduleEvent (Entry *first)
+{
+  if (m_event == 0)
+    {
+      m_event = Ptr<EventImpl> (MakeEvent (&TimerWheel::Expire, this), false);
+    }
+  if (m_eventTs >= 0 && !m_eventId.IsExpired ())
+    {
+      // Simulator::Remove also cancels the event, for good.
+      NS_LOG_LOGIC ("remove main event at " << m_eventTs);
+      Simulator::Remove (m_eventId);
+      m_event = Ptr<EventImpl> (MakeEvent (&TimerWheel::Expire, this), false);
+    }
+  // A main event scheduled in another context has no EventId: it stays
+  // in the main event list, and Expire() ignores it when it comes.
+  m_eventTs = first->m_ts;
+  m_eventContext = first->m_context;
+  Time delay = TimeStep (m_eventTs) - Simulator::Now ();
+  if (m_eventContext == Simulator::GetContext ())
+    {
+      m_eventId = Simulator::Schedule (delay, m_event);
+    }
+  else
+    {
+      m_eventId = EventId ();
+      Simulator::ScheduleWithContext (m_eventContext, delay, GetPointer (m_event));
+    }
+}
+
+void
+TimerWheel::Expire (void)
+{
+  NS_LOG_FUNCTION (this);
+  int64_t now = Simulator::Now ().GetTimeStep ();
+  uint32_t context = Simulator::GetContext ();
+  if (now != m_eventTs || context != m_eventContext)
+    {
+      NS_LOG_LOGIC ("ignore main event moved to " << m_eventTs);
+      return;
+    }
+  m_eventTs = -1;
+  m_expiring = true;
+  Advance (now >> TICK_SHIFT);
+  // Entries due now are in the current slot of the lowest level.
+  uint32_t slot = m_tick & (SLOTS - 1);
+  while (true)
+    {
+      Entry *due = 0;
+      for (Entry *entry = m_slots[slot]; entry != 0; entry = entry->m_next)
+        {
+          if (entry->m_ts == now && entry->m_context == context
+              && (due == 0 || entry->m_uid < due->m_uid))
+            {
+              due = entry;
+            }
+        }
+      if (due == 0)
+        {
+          break;
+        }
+      Unlink (due);
+      due->m_notify (due->m_object);
+    }
+  m_expiring = false;
+  Update ();
+}
+
+} // namespace ns3
@@ -0,0 +1,215 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include "event-id.h"
+#include "event-impl.h"
+#include "nstime.h"
+#include "ptr.h"
+
+#include <stdint.h>
+
+/**
+ * \file
+ * \ingroup timer
+ * ns3::TimerWheel declaration.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup timer
+ * \brief A hierarchical timing wheel for timers which are rescheduled
+ * or cancelled much more often than they expire.
+ *
+ * Retransmission, hold and cache timers are typically pushed back on
+ * every packet.  Through the main event list, each push leaves a
+ * cancelled event behind until its expiration time comes.  The wheel
+ * keeps such timers in intrusive lists instead, one list per slot of
+ * a hierarchy of 64-slot wheels, so that scheduling, rescheduling and
+ * cancelling a timer is O(1) in the wheel.  Only the earliest timer of
+ * the wheel is in the main event list, through one persistent event;
+ * the other slots are cascaded to the lower levels as the simulation
+ * time advances.
+ *
+ * A timer which becomes the earliest one moves the main event earlier.
+ * If the main event was scheduled from the current context, it is
+ * removed from the main event list, and replaced with a new event since
+ * Simulator::Remove() cancels it.  Otherwise, without an EventId to
+ * remove it, it stays in the main event list and does nothing when it
+ * comes.
+ *
+ * Timers still expire at their exact time, and in their own context.
+ * Timers expiring at the same time and in the same context expire in
+ * the order they were scheduled, but the wheel does not interleave them
+ * with the other events of the main event list at that same time.
+ *
+ * The wheel is used by Timer and Watchdog once enabled with Enable():
+ * \code
+ *   TimerWheel::Enable ();
+ * \endcode
+ */
+class TimerWheel
+{
+public:
+  /**
+   * A timer of the wheel, embedded in its owner.
+   *
+   * An entry must not move while it is scheduled, and cannot be copied
+   * then either: its copy could not expire in place of the original.
+   * A running Timer or Watchdog cannot be copied anyway, as the copy
+   * would share and then delete the bound function of the original.
+   */
+  class Entry
+  {
+  public:
+    /** Constructor. */
+    Entry ();
+    /**
+     * Copy constructor: the copy is not scheduled.
+     * \param [in] o The entry to copy, which must not be scheduled.
+     */
+    Entry (const Entry &o);
+    /** Destructor: cancel the entry. */
+    ~Entry ();
+    /**
+     * Assignment: leaves this entry as it is.
+     * \param [in] o The entry to copy, which must not be scheduled.
+     * \returns This entry.
+     */
+    Entry & operator = (const Entry &o);
+    /**
+     * \returns \c true if the entry is scheduled.
+     */
+    bool IsRunning (void) const;
+    /**
+     * \returns The time left until the entry expires, or zero if
+     *          the entry is not scheduled.
+     */
+    Time GetDelayLeft (void) const;
+
+  private:
+    friend class TimerWheel;
+
+    Entry *m_prev;               //!< Previous entry of the slot.
+    Entry *m_next;               //!< Next entry of the slot.
+    uint32_t m_slot;             //!< The slot, or NO_SLOT.
+    uint32_t m_context;          //!< Expiration context.
+    int64_t m_ts;                //!< Expiration time.
+    uint64_t m_uid;              //!< Scheduling order.
+    void (*m_notify)(void *);    //!< Function invoked on expiration.
+    void *m_object;              //!< Argument of m_notify.
+  };
+
+  /** Use the wheel for the Timer and Watchdog instances scheduled from now on. */
+  static void Enable (void);
+  /** Stop using the wheel for the Timer and Watchdog instances scheduled from now on. */
+  static void Disable (void);
+  /**
+   * \returns \c true if Timer and Watchdog use the wheel.
+   */
+  static bool IsEnabled (void);
+
+  /**
+   * Schedule an entry to expire after \p delay, in the current context.
+   * If the entry is already scheduled, it is moved.
+   *
+   * \param [in] entry The entry.
+   * \param [in] delay The delay.
+   * \param [in] notify The function to invoke on expiration.
+   * \param [in] object The argument of \p notify.
+   */
+  static void Schedule (Entry *entry, const Time &delay, void (*notify)(void *), void *object);
+  /**
+   * Cancel an entry.  Nothing happens if it is not scheduled.
+   *
+   * \param [in] entry The entry.
+   */
+  static void Cancel (Entry *entry);
+
+private:
+  /** Constructor. */
+  TimerWheel ();
+  /** Destructor: unlink all the entries. */
+  ~TimerWheel ();
+
+  /**
+   * \returns The wheel of the current simulation, created on demand.
+   */
+  static TimerWheel * GetWheel (void);
+  /**
+   * \returns The wheel of the current simulation, if any.
+   */
+  static TimerWheel ** PeekWheel (void);
+  /** Release the wheel, at the end of the simulation. */
+  static void DestroyWheel (void);
+
+  /**
+   * Link an entry into the slot of its expiration time.
+   * \param [in] entry The entry.
+   */
+  void Link (Entry *entry);
+  /**
+   * Unlink an entry from its slot.
+   * \param [in] entry The entry.
+   */
+  void Unlink (Entry *entry);
+  /**
+   * Advance the wheel, cascading the slots reached by \p tick.
+   * \param [in] tick The new current tick.
+   */
+  void Advance (uint64_t tick);
+  /**
+   * \returns The earliest entry of the wheel, if any.
+   */
+  Entry * GetFirst (void) const;
+  /** Schedule the main event at the earliest entry, if needed. */
+  void Update (void);
+  /**
+   * Schedule the main event, moving it if needed.
+   * \param [in] first The earliest entry.
+   */
+  void ScheduleEvent (Entry *first);
+  /** Expire the entries due now, in the current context. */
+  void Expire (void);
+
+  /** Wheel parameters. */
+  enum
+  {
+    TICK_SHIFT = 10,        //!< Time steps per tick, as a power of 2.
+    LEVEL_SHIFT = 6,        //!< Slots per level, as a power of 2.
+    SLOTS = 1 << LEVEL_SHIFT, //!< Slots per level.
+    LEVELS = 9,             //!< Levels, enough for any time.
+    NO_SLOT = 0xffffffff    //!< Slot of entries not scheduled.
+  };
+
+  Entry *m_slots[LEVELS * SLOTS];  //!< The slots, level after level.
+  uint64_t m_occupied[LEVELS];     //!< Non-empty slots of each level.
+  uint64_t m_tick;                 //!< The current tick.
+  uint64_t m_uid;                  //!< Next scheduling order.
+  Ptr<EventImpl> m_event;          //!< The main event, invoking Expire().
+  EventId m_eventId;               //!< The main event, if in the context it was scheduled from.
+  int64_t m_eventTs;               //!< Time of the main event, or -1.
+  uint32_t m_eventContext;         //!< Context of the main event.
+  bool m_expiring;                 //!< Is Expire() running?
+  static bool m_enabled;           //!< Is the wheel used?
+};
+
+} // namespace ns3
+
+#endif /* TIMER_WHEEL_H */
@@ -55,7 +55,7 @@ Timer::~Timer ()
   NS_LOG_FUNCTION (this);
   if (m_flags & CHECK_ON_DESTROY)
     {
-      if (m_event.IsRunning ())
+      if (m_event.IsRunning () || m_entry.IsRunning ())
         {
           NS_FATAL_ERROR ("Event is still running while destroying.");
         }
@@ -68,6 +68,7 @@ Timer::~Timer ()
     {
       m_event.Remove ();
     }
+  TimerWheel::Cancel (&m_entry);
   delete m_impl;
 }
 
@@ -90,6 +91,10 @@ Timer::GetDelayLeft (void) const
   switch (GetState ())
     {
     case Timer::RUNNING:
+      if (m_entry.IsRunning ())
+        {
+          return m_entry.GetDelayLeft ();
+        }
       return Simulator::GetDelayLeft (m_event);
       break;
     case Timer::EXPIRED:
@@ -110,24 +115,26 @@ Timer::Cancel (void)
 {
   NS_LOG_FUNCTION (this);
   m_event.Cancel ();
+  TimerWheel::Cancel (&m_entry);
 }
 void
 Timer::Remove (void)
 {
   NS_LOG_FUNCTION (this);
   m_event.Remove ();
+  TimerWheel::Cancel (&m_entry);
 }
 bool
 Timer::IsExpired (void) const
 {
   NS_LOG_FUNCTION (this);
-  return !IsSuspended () && m_event.IsExpired ();
+  return !IsSuspended () && m_event.IsExpired () && !m_entry.IsRunning ();
 }
 bool
 Timer::IsRunning (void) const
 {
   NS_LOG_FUNCTION (this);
-  return !IsSuspended () && m_event.IsRunning ();
+  return !IsSuspended () && (m_event.IsRunning () || m_entry.IsRunning ());
 }
 bool
 Timer::IsSuspended (void) const
@@ -166,10 +173,15 @@ Timer::Schedule (Time delay)
 {
   NS_LOG_FUNCTION (this << delay);
   NS_ASSERT (m_impl != 0);
-  if (m_event.IsRunning ())
+  if (m_event.IsRunning () || m_entry.IsRunning ())
     {
       NS_FATAL_ERROR ("Event is still running while re-scheduling.");
     }
+  if (TimerWheel::IsEnabled ())
+    {
+      TimerWheel::Schedule (&m_entry, delay, &Timer::WheelExpire, this);
+      return;
+    }
   m_event = m_impl->Schedule (delay);
 }
 
@@ -178,7 +190,7 @@ Timer::Suspend (void)
 {
   NS_LOG_FUNCTION (this);
   NS_ASSERT (IsRunning ());
-  m_delayLeft = Simulator::GetDelayLeft (m_event);
+  m_delayLeft = GetDelayLeft ();
   if (m_flags & CANCEL_ON_DESTROY)
     {
       m_event.Cancel ();
@@ -187,6 +199,7 @@ Timer::Suspend (void)
     {
       m_event.Remove ();
     } 
+  TimerWheel::Cancel (&m_entry);
   m_flags |= TIMER_SUSPENDED;
 }
 
@@ -195,10 +208,24 @@ Timer::Resume (void)
 {
   NS_LOG_FUNCTION (this);
   NS_ASSERT (m_flags & TIMER_SUSPENDED);
-  m_event = m_impl->Schedule (m_delayLeft);
+  if (TimerWheel::IsEnabled ())
+    {
+      TimerWheel::Schedule (&m_entry, m_delayLeft, &Timer::WheelExpire, this);
+    }
+  else
+    {
+      m_event = m_impl->Schedule (m_delayLeft);
+    }
   m_flags &= ~TIMER_SUSPENDED;
 }
 
+void
+Timer::WheelExpire (void *timer)
+{
+  NS_LOG_FUNCTION (timer);
+  static_cast<Timer *> (timer)->m_impl->Invoke ();
+}
+
 
 } // namespace ns3
 
@@ -24,6 +24,7 @@
 #include "nstime.h"
 #include "event-id.h"
 #include "int-to-type.h"
+#include "timer-wheel.h"
 
 /**
  * \file
@@ -68,6 +69,9 @@ class TimerImpl;
  * management policies. These policies are specified at construction time
  * and cannot be changed after.
  *
+ * Once TimerWheel is enabled, timers are scheduled in the timer wheel
+ * rather than in the main event list.
+ *
  * \see Watchdog for a simpler interface for a watchdog timer.
  */
 class Timer
@@ -232,6 +236,12 @@ public:
   void Resume (void);
 
 private:
+  /**
+   * Invoke the function of the timer, when its timer wheel entry expires.
+   * \param [in] timer The timer.
+   */
+  static void WheelExpire (void *timer);
+
   /** Internal bit marking the suspended state. */
   enum InternalSuspended
   {
@@ -252,6 +262,8 @@ private:
   Time m_delay;
   /** The future event scheduled to expire the timer. */
   EventId m_event;
+  /** The timer wheel entry of the timer, when TimerWheel is enabled. */
+  TimerWheel::Entry m_entry;
   /**
    * The timer implementation, which contains the bound callback
    * function and arguments.
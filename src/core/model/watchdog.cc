@@ -43,6 +43,7 @@ Watchdog::~Watchdog ()
 {
   NS_LOG_FUNCTION (this);
   m_event.Cancel ();
+  TimerWheel::Cancel (&m_entry);
   delete m_impl;
 }
 
@@ -51,11 +52,25 @@ Watchdog::Ping (Time delay)
 {
   NS_LOG_FUNCTION (this << delay);
   Time end = Simulator::Now () + delay;
+  if (m_entry.IsRunning ())
+    {
+      if (end > m_end)
+        {
+          m_end = end;
+          TimerWheel::Schedule (&m_entry, delay, &Watchdog::WheelExpire, this);
+        }
+      return;
+    }
   m_end = std::max (m_end, end);
   if (m_event.IsRunning ())
     {
       return;
     }
+  if (TimerWheel::IsEnabled ())
+    {
+      TimerWheel::Schedule (&m_entry, m_end - Now (), &Watchdog::WheelExpire, this);
+      return;
+    }
   m_event = Simulator::Schedule (m_end - Now (), &Watchdog::Expire, this);
 }
 
@@ -73,5 +88,12 @@ Watchdog::Expire (void)
     }
 }
 
+void
+Watchdog::WheelExpire (void *watchdog)
+{
+  NS_LOG_FUNCTION (watchdog);
+  static_cast<Watchdog *> (watchdog)->m_impl->Invoke ();
+}
+
 } // namespace ns3
 
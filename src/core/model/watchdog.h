@@ -22,6 +22,7 @@
 
 #include "nstime.h"
 #include "event-id.h"
+#include "timer-wheel.h"
 
 /**
  * \file
@@ -51,6 +52,10 @@ class TimerImpl;
  * If you don't ping the watchdog sufficiently often, it triggers its
  * listening function.
  *
+ * Once TimerWheel is enabled, a Ping moves the watchdog in the timer
+ * wheel, rather than letting the pending event expire and schedule
+ * another one.
+ *
  * \see Timer for a more sophisticated general purpose timer.
  */
 class Watchdog
@@ -112,6 +117,11 @@ public:
 private:
   /** Internal callback invoked when the timer expires. */
   void Expire (void);
+  /**
+   * Invoke the function of the watchdog, when its timer wheel entry expires.
+   * \param [in] watchdog The watchdog.
+   */
+  static void WheelExpire (void *watchdog);
   /**
    * The timer implementation, which contains the bound callback
    * function and arguments.
@@ -121,6 +131,8 @@ private:
   EventId m_event;
   /** The absolute time when the timer will expire. */
   Time m_end;
+  /** The timer wheel entry of the watchdog, when TimerWheel is enabled. */
+  TimerWheel::Entry m_entry;
 };
 
 } // namespace ns3
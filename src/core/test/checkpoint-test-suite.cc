@@ -0,0 +1,165 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "ns3/checkpoint.h"
+#include "ns3/double.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/simulator.h"
+#include "ns3/test.h"
+
+#include <vector>
+
+/**
+ * \file
+ * \ingroup core-tests
+ * \ingroup simulator
+ * Checkpoint test suite.
+ */
+
+namespace ns3 {
+
+namespace tests {
+
+
+/**
+ * \ingroup core-tests
+ * Save a checkpoint in one run and continue from it in another.
+ */
+class CheckpointTestCase : public TestCase
+{
+public:
+  /** Constructor. */
+  CheckpointTestCase ();
+  virtual void DoRun (void);
+  /**
+   * Save callback of the test entry.
+   * \param os The output stream.
+   */
+  void Save (std::ostream &os);
+  /**
+   * Restore callback of the test entry.
+   * \param is The input stream.
+   */
+  void Restore (std::istream &is);
+  uint32_t m_counter;     //!< State of the test entry.
+  Time m_restoredTime;    //!< Time at which the test entry was restored.
+};
+
+CheckpointTestCase::CheckpointTestCase ()
+  : TestCase ("Check that a checkpoint restores time, random streams and registered state")
+{}
+
+void
+CheckpointTestCase::Save (std::ostream &os)
+{
+  os << m_counter;
+}
+
+void
+CheckpointTestCase::Restore (std::istream &is)
+{
+  is >> m_counter;
+  m_restoredTime = Simulator::Now ();
+}
+
+void
+CheckpointTestCase::DoRun (void)
+{
+  std::string filename = CreateTempDirFilename ("checkpoint-test.ckpt");
+
+  //
+  // First run: draw some values, save, and record what comes next.
+  //
+  Ptr<UniformRandomVariable> first = CreateObject<UniformRandomVariable> ();
+  first->SetAttribute ("Min", DoubleValue (2));
+  first->SetAttribute ("Max", DoubleValue (7));
+  for (uint32_t i = 0; i < 3; i++)
+    {
+      first->GetValue ();
+    }
+  // An odd number of draws leaves a cached normal value.
+  Ptr<NormalRandomVariable> firstNormal = CreateObject<NormalRandomVariable> ();
+  firstNormal->GetValue ();
+  m_counter = 42;
+  Checkpoint::RegisterObject ("uniform", first);
+  Checkpoint::RegisterObject ("normal", firstNormal);
+  Checkpoint::Register ("counter",
+                        MakeCallback (&CheckpointTestCase::Save, this),
+                        MakeCallback (&CheckpointTestCase::Restore, this));
+  Simulator::Schedule (Seconds (1), &Checkpoint::Save, filename);
+  Simulator::Run ();
+  std::vector<double> expected;
+  std::vector<double> expectedNormal;
+  for (uint32_t i = 0; i < 5; i++)
+    {
+      expected.push_back (first->GetValue ());
+      expectedNormal.push_back (firstNormal->GetValue ());
+    }
+  Simulator::Destroy ();
+
+  //
+  // Second run: same scenario with fresh state, forked from the checkpoint.
+  //
+  Ptr<UniformRandomVariable> second = CreateObject<UniformRandomVariable> ();
+  Ptr<NormalRandomVariable> secondNormal = CreateObject<NormalRandomVariable> ();
+  m_counter = 0;
+  m_restoredTime = Seconds (0);
+  Checkpoint::RegisterObject ("uniform", second);
+  Checkpoint::RegisterObject ("normal", secondNormal);
+  Checkpoint::Register ("counter",
+                        MakeCallback (&CheckpointTestCase::Save, this),
+                        MakeCallback (&CheckpointTestCase::Restore, this));
+  Time at = Checkpoint::Restore (filename);
+  NS_TEST_ASSERT_MSG_EQ (at, Seconds (1), "Wrong checkpoint time");
+  Simulator::Run ();
+  NS_TEST_ASSERT_MSG_EQ (m_counter, 42, "Registered state not restored");
+  NS_TEST_ASSERT_MSG_EQ (m_restoredTime, Seconds (1), "State not restored at the checkpoint time");
+  NS_TEST_ASSERT_MSG_EQ (second->GetMax (), 7, "Attribute not restored");
+  for (uint32_t i = 0; i < expected.size (); i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (second->GetValue (), expected[i], "Random stream not restored");
+      NS_TEST_ASSERT_MSG_EQ (secondNormal->GetValue (), expectedNormal[i], "Cached normal value not restored");
+    }
+  Simulator::Destroy ();
+}
+
+
+/**
+ * \ingroup core-tests
+ * Checkpoint test suite.
+ */
+class CheckpointTestSuite : public TestSuite
+{
+public:
+  /** Constructor. */
+  CheckpointTestSuite ();
+};
+
+CheckpointTestSuite::CheckpointTestSuite ()
+  : TestSuite ("checkpoint", UNIT)
+{
+  AddTestCase (new CheckpointTestCase ());
+}
+
+/**
+ * \ingroup core-tests
+ * CheckpointTestSuite instance variable.
+ */
+static CheckpointTestSuite g_checkpointTestSuite;
+
+
+}    // namespace tests
+
+}  // namespace ns3
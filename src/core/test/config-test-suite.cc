@@ -832,6 +832,96 @@ SearchAttributesOfParentObjectsTestCase::DoRun (void)
 
 }
 
+/**
+ * \ingroup config-tests
+ * Test for paths parsed once with Config::CompiledPath.
+ */
+class CompiledPathConfigTestCase : public TestCase
+{
+public:
+  /** Constructor. */
+  CompiledPathConfigTestCase ();
+  /** Destructor. */
+  virtual ~CompiledPathConfigTestCase ()
+  {}
+
+private:
+  virtual void DoRun (void);
+};
+
+CompiledPathConfigTestCase::CompiledPathConfigTestCase ()
+  : TestCase ("Check matching and reuse of compiled Config paths")
+{}
+
+void
+CompiledPathConfigTestCase::DoRun (void)
+{
+  IntegerValue iv;
+
+  //
+  // Use the name service so that the root namespace objects registered
+  // by the other test cases do not add matches.
+  //
+  Ptr<ConfigTestObject> root = CreateObject<ConfigTestObject> ();
+  Names::Add ("CompiledPathRoot", root);
+
+  std::vector<Ptr<ConfigTestObject> > objs;
+  for (uint32_t i = 0; i < 4; i++)
+    {
+      objs.push_back (CreateObject<ConfigTestObject> ());
+      root->AddNodeA (objs.back ());
+    }
+
+  //
+  // An exact index matches exactly one object, with the same context
+  // string as an uncompiled lookup.
+  //
+  Config::CompiledPath path ("/Names/CompiledPathRoot/NodesA/2");
+  Config::MatchContainer matches = path.LookupMatches ();
+  NS_TEST_ASSERT_MSG_EQ (matches.GetN (), 1, "Exact index did not match one object");
+  NS_TEST_ASSERT_MSG_EQ (matches.Get (0), objs[2], "Exact index matched the wrong object");
+  NS_TEST_ASSERT_MSG_EQ (matches.GetMatchedPath (0),
+                         Config::LookupMatches ("/Names/CompiledPathRoot/NodesA/2").GetMatchedPath (0),
+                         "Compiled and uncompiled contexts differ");
+
+  //
+  // Indices past the end of the container do not match.
+  //
+  NS_TEST_ASSERT_MSG_EQ (Config::CompiledPath ("/Names/CompiledPathRoot/NodesA/7").LookupMatches ().GetN (), 0,
+                         "Index past the end unexpectedly matched");
+  NS_TEST_ASSERT_MSG_EQ (Config::LookupMatches ("/Names/CompiledPathRoot/NodesA/7").GetN (), 0,
+                         "Index past the end unexpectedly matched");
+
+  //
+  // A compiled wildcard picks up objects added after compilation.
+  //
+  Config::CompiledPath all ("/Names/CompiledPathRoot/NodesA/*");
+  NS_TEST_ASSERT_MSG_EQ (all.LookupMatches ().GetN (), 4, "Wildcard did not match all objects");
+  objs.push_back (CreateObject<ConfigTestObject> ());
+  root->AddNodeA (objs.back ());
+  NS_TEST_ASSERT_MSG_EQ (all.LookupMatches ().GetN (), 5, "Wildcard did not match the new object");
+
+  //
+  // Bulk set through the matches of the compiled path.
+  //
+  all.LookupMatches ().Set ("A", IntegerValue (-3));
+  for (uint32_t i = 0; i < objs.size (); i++)
+    {
+      objs[i]->GetAttribute ("A", iv);
+      NS_TEST_ASSERT_MSG_EQ (iv.Get (), -3, "Object Attribute \"A\" not set as expected");
+    }
+  Config::CompiledPath ranged ("/Names/CompiledPathRoot/NodesA/[1-2]|4");
+  ranged.LookupMatches ().Set ("A", IntegerValue (5));
+  objs[0]->GetAttribute ("A", iv);
+  NS_TEST_ASSERT_MSG_EQ (iv.Get (), -3, "Object Attribute \"A\" unexpectedly set");
+  objs[2]->GetAttribute ("A", iv);
+  NS_TEST_ASSERT_MSG_EQ (iv.Get (), 5, "Object Attribute \"A\" not set as expected");
+  objs[4]->GetAttribute ("A", iv);
+  NS_TEST_ASSERT_MSG_EQ (iv.Get (), 5, "Object Attribute \"A\" not set as expected");
+
+  Names::Clear ();
+}
+
 /**
  * \ingroup config-tests
  * The Test Suite that glues all of the Test Cases together.
@@ -850,6 +940,7 @@ ConfigTestSuite::ConfigTestSuite ()
   AddTestCase (new UnderRootNamespaceConfigTestCase);
   AddTestCase (new ObjectVectorConfigTestCase);
   AddTestCase (new SearchAttributesOfParentObjectsTestCase);
+  AddTestCase (new CompiledPathConfigTestCase);
 }
 
 /**
@@ -0,0 +1,144 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "ns3/periodic-event.h"
+#include "ns3/simulator.h"
+#include "ns3/test.h"
+
+#include <vector>
+
+/**
+ * \file
+ * \ingroup core-tests
+ * \ingroup timer
+ * \ingroup timer-tests
+ * PeriodicEvent test suite.
+ */
+
+namespace ns3 {
+
+namespace tests {
+
+
+/**
+ * \ingroup timer-tests
+ * Check the expiration times and the coalescing of periodic events.
+ */
+class PeriodicEventTestCase : public TestCase
+{
+public:
+  /** Constructor. */
+  PeriodicEventTestCase ();
+  virtual void DoRun (void);
+  /**
+   * Function invoked by the periodic events.
+   * \param index The index of the event.
+   */
+  void Expire (uint32_t index);
+  /** Schedule a periodic event with index 3, from within an event. */
+  void ScheduleLate (void);
+  /** Number of group events in the main event list when ScheduleLate() ran. */
+  uint32_t m_groupsBefore;
+  uint32_t m_groupsAfter;  //!< And after ScheduleLate() ran.
+  std::vector<std::vector<Time> > m_expirations;  //!< Expiration times, by event index.
+  PeriodicEvent m_late;  //!< The event scheduled by ScheduleLate().
+};
+
+PeriodicEventTestCase::PeriodicEventTestCase ()
+  : TestCase ("Check that periodic events expire on time and share their group event")
+{}
+
+void
+PeriodicEventTestCase::Expire (uint32_t index)
+{
+  m_expirations[index].push_back (Simulator::Now ());
+}
+
+void
+PeriodicEventTestCase::ScheduleLate (void)
+{
+  m_groupsBefore = PeriodicEvent::GetGroupN ();
+  m_late = PeriodicEvent::Schedule (Seconds (1), &PeriodicEventTestCase::Expire, this, 3);
+  m_groupsAfter = PeriodicEvent::GetGroupN ();
+}
+
+void
+PeriodicEventTestCase::DoRun (void)
+{
+  m_expirations.resize (4);
+
+  PeriodicEvent a = PeriodicEvent::Schedule (Seconds (1), &PeriodicEventTestCase::Expire, this, 0);
+  PeriodicEvent b = PeriodicEvent::Schedule (Seconds (1), &PeriodicEventTestCase::Expire, this, 1);
+  NS_TEST_ASSERT_MSG_EQ (PeriodicEvent::GetGroupN (), 1, "Events with the same period and phase not coalesced");
+  PeriodicEvent c = PeriodicEvent::Schedule (Seconds (2), &PeriodicEventTestCase::Expire, this, 2);
+  NS_TEST_ASSERT_MSG_EQ (PeriodicEvent::GetGroupN (), 2, "Events with another period coalesced");
+  NS_TEST_ASSERT_MSG_EQ (a.IsRunning (), true, "Event not running");
+  NS_TEST_ASSERT_MSG_EQ (a.GetPeriod (), Seconds (1), "Wrong period");
+
+  // Same period, same phase, scheduled while the group expires.
+  Simulator::Schedule (Seconds (2), &PeriodicEventTestCase::ScheduleLate, this);
+  Simulator::Schedule (Seconds (3.5), &PeriodicEvent::Cancel, &b);
+  Simulator::Schedule (Seconds (4.5), &PeriodicEvent::Cancel, &c);
+  Simulator::Stop (Seconds (5.5));
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_groupsBefore, 2, "Wrong number of groups");
+  NS_TEST_ASSERT_MSG_EQ (m_groupsAfter, 2, "Event with the same period and phase not coalesced");
+  NS_TEST_ASSERT_MSG_EQ (b.IsRunning (), false, "Event still running");
+
+  NS_TEST_ASSERT_MSG_EQ (m_expirations[0].size (), 5, "Wrong number of expirations");
+  for (uint32_t i = 0; i < m_expirations[0].size (); i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (m_expirations[0][i], Seconds (i + 1), "Wrong expiration time");
+    }
+  NS_TEST_ASSERT_MSG_EQ (m_expirations[1].size (), 3, "Cancelled event expired");
+  NS_TEST_ASSERT_MSG_EQ (m_expirations[2].size (), 2, "Cancelled event expired");
+  NS_TEST_ASSERT_MSG_EQ (m_expirations[2][1], Seconds (4), "Wrong expiration time");
+  NS_TEST_ASSERT_MSG_EQ (m_expirations[3].size (), 3, "Event scheduled during expiration");
+  NS_TEST_ASSERT_MSG_EQ (m_expirations[3][0], Seconds (3), "Event scheduled during expiration");
+
+  Simulator::Destroy ();
+  NS_TEST_ASSERT_MSG_EQ (PeriodicEvent::GetGroupN (), 0, "Groups not released");
+  NS_TEST_ASSERT_MSG_EQ (a.IsRunning (), false, "Event running after the simulation");
+}
+
+
+/**
+ * \ingroup timer-tests
+ * PeriodicEvent test suite.
+ */
+class PeriodicEventTestSuite : public TestSuite
+{
+public:
+  /** Constructor. */
+  PeriodicEventTestSuite ();
+};
+
+PeriodicEventTestSuite::PeriodicEventTestSuite ()
+  : TestSuite ("periodic-event", UNIT)
+{
+  AddTestCase (new PeriodicEventTestCase ());
+}
+
+/**
+ * \ingroup timer-tests
+ * PeriodicEventTestSuite instance variable.
+ */
+static PeriodicEventTestSuite g_periodicEventTestSuite;
+
+
+}    // namespace tests
+
+}  // namespace ns3
@@ -0,0 +1,193 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "ns3/config.h"
+#include "ns3/global-value.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/test.h"
+
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+/**
+ * \file
+ * \ingroup core-tests
+ * \ingroup simulator-tests
+ * ProfilingSimulatorImpl test suite.
+ */
+
+namespace ns3 {
+
+namespace tests {
+
+
+/**
+ * \ingroup simulator-tests
+ * Run a few events under the profiling simulator and check the report.
+ */
+class ProfilingSimulatorImplTestCase : public TestCase
+{
+public:
+  /** Constructor. */
+  ProfilingSimulatorImplTestCase ();
+  virtual void DoRun (void);
+  /** Event profiled under its own function. */
+  void Tick (void);
+  /** Event with the same signature as Tick(), profiled separately. */
+  void Tock (void);
+  /** Schedule Tock() events from another thread. */
+  void ScheduleTocks (void);
+  /** Event which is cancelled before it runs. */
+  void Never (void);
+
+  uint32_t m_ticks;  //!< Number of Tick() events.
+  uint32_t m_tocks;  //!< Number of Tock() events.
+};
+
+ProfilingSimulatorImplTestCase::ProfilingSimulatorImplTestCase ()
+  : TestCase ("Check the profiling simulator report")
+{}
+
+void
+ProfilingSimulatorImplTestCase::Tick (void)
+{
+  m_ticks++;
+}
+
+void
+ProfilingSimulatorImplTestCase::Tock (void)
+{
+  m_tocks++;
+}
+
+void
+ProfilingSimulatorImplTestCase::ScheduleTocks (void)
+{
+  for (uint32_t i = 0; i < 5; i++)
+    {
+      Simulator::ScheduleWithContext (4, Seconds (i + 0.5), &ProfilingSimulatorImplTestCase::Tock, this);
+    }
+}
+
+void
+ProfilingSimulatorImplTestCase::Never (void)
+{}
+
+void
+ProfilingSimulatorImplTestCase::DoRun (void)
+{
+  std::string filename = CreateTempDirFilename ("simulator-profile.txt");
+  Simulator::Destroy ();
+  GlobalValue::Bind ("SimulatorImplementationType", StringValue ("ns3::ProfilingSimulatorImpl"));
+  Config::SetDefault ("ns3::ProfilingSimulatorImpl::ReportFile", StringValue (filename));
+
+  m_ticks = 0;
+  m_tocks = 0;
+  for (uint32_t i = 0; i < 10; i++)
+    {
+      Simulator::ScheduleWithContext (3, Seconds (i), &ProfilingSimulatorImplTestCase::Tick, this);
+    }
+  std::thread other (&ProfilingSimulatorImplTestCase::ScheduleTocks, this);
+  other.join ();
+  EventId never = Simulator::Schedule (Seconds (5), &ProfilingSimulatorImplTestCase::Never, this);
+  Simulator::Cancel (never);
+  EventId removed = Simulator::Schedule (Seconds (5), &ProfilingSimulatorImplTestCase::Never, this);
+  Simulator::Remove (removed);
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  GlobalValue::Bind ("SimulatorImplementationType", StringValue ("ns3::DefaultSimulatorImpl"));
+  Config::SetDefault ("ns3::ProfilingSimulatorImpl::ReportFile", StringValue ("simulator-profile.txt"));
+
+  NS_TEST_ASSERT_MSG_EQ (m_ticks, 10, "Events lost");
+  NS_TEST_ASSERT_MSG_EQ (m_tocks, 5, "Events from another thread lost");
+  std::ifstream is (filename.c_str ());
+  NS_TEST_ASSERT_MSG_EQ (is.is_open (), true, "No report written");
+  std::stringstream report;
+  report << is.rdbuf ();
+  std::string text = report.str ();
+  NS_TEST_ASSERT_MSG_NE (text.find ("events 16\n"), std::string::npos, "Wrong event count");
+  NS_TEST_ASSERT_MSG_NE (text.find ("ProfilingSimulatorImplTestCase"), std::string::npos,
+                         "Event type missing");
+  NS_TEST_ASSERT_MSG_NE (text.find ("(cancelled events)"), std::string::npos,
+                         "Cancelled events missing");
+  NS_TEST_ASSERT_MSG_NE (text.find ("node 3\n"), std::string::npos, "Context missing");
+
+  // Tick() and Tock() are profiled on lines of their own.
+  std::string line;
+  report.seekg (text.find ("# event functions"));
+  std::getline (report, line);
+  std::getline (report, line);
+  bool ticks = false;
+  bool tocks = false;
+  while (std::getline (report, line) && !line.empty ())
+    {
+      uint64_t count;
+      std::istringstream (line) >> count;
+      ticks = ticks || count == 10;
+      tocks = tocks || count == 5;
+    }
+  NS_TEST_ASSERT_MSG_EQ (ticks && tocks, true, "Event functions not told apart");
+
+  // Ten samples, one per simulated second; the cancelled and removed
+  // events are pending until the fifth second, and the Tock() events
+  // half a second after each of the first five.
+  report.clear ();
+  report.seekg (text.find ("# pending events"));
+  std::getline (report, line);
+  std::getline (report, line);
+  uint32_t samples = 0;
+  double seconds;
+  int64_t depth;
+  while (report >> seconds >> depth)
+    {
+      NS_TEST_ASSERT_MSG_EQ (seconds, samples, "Wrong sample time");
+      NS_TEST_ASSERT_MSG_EQ (depth, 10 - samples + (samples < 5 ? 5 - samples : 0) + (samples <= 5 ? 1 : 0),
+                             "Wrong pending events");
+      samples++;
+    }
+  NS_TEST_ASSERT_MSG_EQ (samples, 10, "Wrong number of samples");
+}
+
+
+/**
+ * \ingroup simulator-tests
+ * ProfilingSimulatorImpl test suite.
+ */
+class ProfilingSimulatorImplTestSuite : public TestSuite
+{
+public:
+  /** Constructor. */
+  ProfilingSimulatorImplTestSuite ();
+};
+
+ProfilingSimulatorImplTestSuite::ProfilingSimulatorImplTestSuite ()
+  : TestSuite ("profiling-simulator-impl", UNIT)
+{
+  AddTestCase (new ProfilingSimulatorImplTestCase ());
+}
+
+/**
+ * \ingroup simulator-tests
+ * ProfilingSimulatorImplTestSuite instance variable.
+ */
+static ProfilingSimulatorImplTestSuite g_profilingSimulatorImplTestSuite;
+
+
+}    // namespace tests
+
+}  // namespace ns3
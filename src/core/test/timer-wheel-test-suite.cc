@@ -0,0 +1,385 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "ns3/timer-wheel.h"
+#include "ns3/timer.h"
+#include "ns3/watchdog.h"
+#include "ns3/simulator.h"
+#include "ns3/test.h"
+
+#include <vector>
+
+/**
+ * \file
+ * \ingroup core-tests
+ * \ingroup timer
+ * \ingroup timer-tests
+ * TimerWheel test suite.
+ */
+
+namespace ns3 {
+
+namespace tests {
+
+
+/**
+ * \ingroup timer-tests
+ * Schedule, move and cancel many entries over all the wheel levels,
+ * and check that each one expires exactly on time.
+ */
+class TimerWheelOrderTestCase : public TestCase
+{
+public:
+  /** Constructor. */
+  TimerWheelOrderTestCase ();
+  virtual void DoRun (void);
+
+private:
+  /** Test entry. */
+  struct Item
+  {
+    TimerWheel::Entry entry;     //!< The wheel entry.
+    TimerWheelOrderTestCase *test; //!< The test case.
+    uint32_t index;              //!< Index of the item.
+    int64_t expected;            //!< Expected expiration time, or -1.
+    uint32_t expirations;        //!< Number of expirations.
+  };
+
+  /**
+   * Expiration of an item.
+   * \param item The item.
+   */
+  static void Expire (void *item);
+  /**
+   * \returns A pseudo-random delay, from nanoseconds to days.
+   */
+  Time NextDelay (void);
+  /** Move or cancel some of the items, then do it again later. */
+  void Shuffle (void);
+  /**
+   * Schedule an item.
+   * \param item The item.
+   * \param delay The delay.
+   */
+  void Schedule (Item *item, Time delay);
+
+  std::vector<Item> m_items;  //!< The items.
+  uint64_t m_state;           //!< Pseudo-random generator state.
+  uint32_t m_shuffles;        //!< Remaining calls to Shuffle().
+  int64_t m_last;             //!< Last expiration time.
+  bool m_ordered;             //!< Did the items expire in time order?
+  bool m_onTime;              //!< Did the items expire when expected?
+  uint32_t m_cancelled;       //!< Number of cancelled items.
+};
+
+TimerWheelOrderTestCase::TimerWheelOrderTestCase ()
+  : TestCase ("Check that timer wheel entries expire on time")
+{}
+
+void
+TimerWheelOrderTestCase::Expire (void *p)
+{
+  Item *item = static_cast<Item *> (p);
+  int64_t now = Simulator::Now ().GetTimeStep ();
+  item->test->m_ordered = item->test->m_ordered && now >= item->test->m_last;
+  item->test->m_last = now;
+  item->test->m_onTime = item->test->m_onTime && now == item->expected;
+  item->expected = -1;
+  item->expirations++;
+}
+
+Time
+TimerWheelOrderTestCase::NextDelay (void)
+{
+  m_state = m_state * 6364136223846793005ULL + 1442695040888963407ULL;
+  uint32_t magnitude = (m_state >> 59) % 17;  // up to 10^16 ns
+  int64_t delay = 1;
+  for (uint32_t i = 0; i < magnitude; i++)
+    {
+      delay *= 10;
+    }
+  return NanoSeconds (static_cast<int64_t> ((m_state >> 20) % delay));
+}
+
+void
+TimerWheelOrderTestCase::Schedule (Item *item, Time delay)
+{
+  item->expected = (Simulator::Now () + delay).GetTimeStep ();
+  TimerWheel::Schedule (&item->entry, delay, &TimerWheelOrderTestCase::Expire, item);
+}
+
+void
+TimerWheelOrderTestCase::Shuffle (void)
+{
+  for (uint32_t i = 0; i < m_items.size (); i += 3)
+    {
+      Item *item = &m_items[i];
+      if (!item->entry.IsRunning ())
+        {
+          continue;
+        }
+      if ((i / 3) % 2 == 0)
+        {
+          Schedule (item, NextDelay ());
+        }
+      else
+        {
+          TimerWheel::Cancel (&item->entry);
+          item->expected = -1;
+          m_cancelled++;
+        }
+    }
+  if (--m_shuffles > 0)
+    {
+      Simulator::Schedule (NextDelay (), &TimerWheelOrderTestCase::Shuffle, this);
+    }
+}
+
+void
+TimerWheelOrderTestCase::DoRun (void)
+{
+  TimerWheel::Enable ();
+  m_state = 1;
+  m_shuffles = 5;
+  m_last = 0;
+  m_ordered = true;
+  m_onTime = true;
+  m_cancelled = 0;
+  m_items.resize (2000);
+  for (uint32_t i = 0; i < m_items.size (); i++)
+    {
+      m_items[i].test = this;
+      m_items[i].index = i;
+      m_items[i].expected = -1;
+      m_items[i].expirations = 0;
+      Schedule (&m_items[i], NextDelay ());
+    }
+  // Same time, scheduling order.
+  Schedule (&m_items[0], Seconds (1));
+  Schedule (&m_items[1], Seconds (1));
+  Simulator::Schedule (NextDelay (), &TimerWheelOrderTestCase::Shuffle, this);
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_ordered, true, "Entries expired out of order");
+  NS_TEST_ASSERT_MSG_EQ (m_onTime, true, "Entries expired at the wrong time");
+  NS_TEST_ASSERT_MSG_GT (m_cancelled, 0, "No entry cancelled");
+  uint32_t expired = 0;
+  for (uint32_t i = 0; i < m_items.size (); i++)
+    {
+      expired += m_items[i].expirations;
+      NS_TEST_ASSERT_MSG_EQ (m_items[i].expected, -1, "Entry " << i << " did not expire on time");
+      NS_TEST_ASSERT_MSG_LT_OR_EQ (m_items[i].expirations, 1, "Entry " << i << " expired more than once");
+      NS_TEST_ASSERT_MSG_EQ (m_items[i].entry.IsRunning (), false, "Entry " << i << " still running");
+    }
+  NS_TEST_ASSERT_MSG_EQ (expired + m_cancelled, m_items.size (), "Entries lost");
+  Simulator::Destroy ();
+  TimerWheel::Disable ();
+}
+
+
+/**
+ * \ingroup timer-tests
+ * Check Timer and Watchdog on top of the timer wheel.
+ */
+class TimerWheelTimerTestCase : public TestCase
+{
+public:
+  /** Constructor. */
+  TimerWheelTimerTestCase ();
+  virtual void DoRun (void);
+  /**
+   * Function invoked by the timers.
+   * \param index Index of the timer.
+   */
+  void Expire (int index);
+  /**
+   * Schedule a timer from another context.
+   * \param timer The timer.
+   */
+  void ScheduleTimer (Timer *timer);
+
+  std::vector<Time> m_times;           //!< Expiration times, by index.
+  std::vector<uint32_t> m_contexts;    //!< Expiration contexts, by index.
+};
+
+TimerWheelTimerTestCase::TimerWheelTimerTestCase ()
+  : TestCase ("Check Timer and Watchdog with the timer wheel enabled")
+{}
+
+void
+TimerWheelTimerTestCase::Expire (int index)
+{
+  m_times[index] = Simulator::Now ();
+  m_contexts[index] = Simulator::GetContext ();
+}
+
+void
+TimerWheelTimerTestCase::ScheduleTimer (Timer *timer)
+{
+  timer->Schedule (MilliSeconds (5));
+}
+
+void
+TimerWheelTimerTestCase::DoRun (void)
+{
+  TimerWheel::Enable ();
+  m_times.resize (5, Seconds (-1));
+  m_contexts.resize (5, 0);
+
+  Timer timer (Timer::CANCEL_ON_DESTROY);
+  timer.SetFunction (&TimerWheelTimerTestCase::Expire, this);
+  timer.SetArguments (0);
+  timer.Schedule (Seconds (10));
+  NS_TEST_ASSERT_MSG_EQ (timer.IsRunning (), true, "Timer not running");
+  NS_TEST_ASSERT_MSG_EQ (timer.GetDelayLeft (), Seconds (10), "Wrong delay left");
+  timer.Cancel ();
+  NS_TEST_ASSERT_MSG_EQ (timer.IsExpired (), true, "Timer not cancelled");
+  timer.Schedule (Seconds (2));
+
+  Timer suspended (Timer::CANCEL_ON_DESTROY);
+  suspended.SetFunction (&TimerWheelTimerTestCase::Expire, this);
+  suspended.SetArguments (1);
+  suspended.Schedule (Seconds (3));
+  Simulator::Schedule (Seconds (1), &Timer::Suspend, &suspended);
+  Simulator::Schedule (Seconds (4), &Timer::Resume, &suspended);
+
+  Timer other (Timer::CANCEL_ON_DESTROY);
+  other.SetFunction (&TimerWheelTimerTestCase::Expire, this);
+  other.SetArguments (2);
+  Simulator::ScheduleWithContext (7, Seconds (1), &TimerWheelTimerTestCase::ScheduleTimer, this, &other);
+
+  Watchdog watchdog;
+  watchdog.SetFunction (&TimerWheelTimerTestCase::Expire, this);
+  watchdog.SetArguments (3);
+  watchdog.Ping (MicroSeconds (10));
+  Simulator::Schedule (MicroSeconds ( 5), &Watchdog::Ping, &watchdog, MicroSeconds (20));
+  Simulator::Schedule (MicroSeconds (20), &Watchdog::Ping, &watchdog, MicroSeconds ( 2));
+  Simulator::Schedule (MicroSeconds (23), &Watchdog::Ping, &watchdog, MicroSeconds (17));
+
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_times[0], Seconds (2), "Wrong expiration time");
+  NS_TEST_ASSERT_MSG_EQ (m_times[1], Seconds (6), "Suspended timer resumed at the wrong time");
+  NS_TEST_ASSERT_MSG_EQ (m_times[2], Seconds (1) + MilliSeconds (5), "Wrong expiration time");
+  NS_TEST_ASSERT_MSG_EQ (m_contexts[2], 7, "Timer expired in the wrong context");
+  NS_TEST_ASSERT_MSG_EQ (m_times[3], MicroSeconds (40), "Wrong watchdog expiration time");
+  NS_TEST_ASSERT_MSG_EQ (timer.IsExpired (), true, "Timer still running");
+  Simulator::Destroy ();
+  TimerWheel::Disable ();
+}
+
+
+/**
+ * \ingroup timer-tests
+ * Move the main event earlier, from its own context and from another
+ * one, and check that it is removed from the main event list when it
+ * can be, and ignored otherwise.
+ */
+class TimerWheelMoveTestCase : public TestCase
+{
+public:
+  /** Constructor. */
+  TimerWheelMoveTestCase ();
+  virtual void DoRun (void);
+  /**
+   * Expiration of an entry.
+   * \param test The test case.
+   */
+  static void Expire (void *test);
+  /**
+   * Schedule the entries, each one earlier than the previous one.
+   * \param first Index of the first entry to schedule.
+   * \param n Number of entries to schedule.
+   */
+  void ScheduleEntries (uint32_t first, uint32_t n);
+
+  TimerWheel::Entry m_entries[20];  //!< The entries.
+  uint32_t m_expirations;           //!< Number of expirations.
+};
+
+TimerWheelMoveTestCase::TimerWheelMoveTestCase ()
+  : TestCase ("Check that the timer wheel moves its main event")
+{}
+
+void
+TimerWheelMoveTestCase::Expire (void *test)
+{
+  static_cast<TimerWheelMoveTestCase *> (test)->m_expirations++;
+}
+
+void
+TimerWheelMoveTestCase::ScheduleEntries (uint32_t first, uint32_t n)
+{
+  for (uint32_t i = 0; i < n; i++)
+    {
+      TimerWheel::Schedule (&m_entries[first + i], Seconds (100 - i),
+                            &TimerWheelMoveTestCase::Expire, this);
+    }
+}
+
+void
+TimerWheelMoveTestCase::DoRun (void)
+{
+  TimerWheel::Enable ();
+  m_expirations = 0;
+
+  // Each entry moves the main event earlier, in the same context.
+  ScheduleEntries (0, 10);
+  Simulator::Run ();
+  NS_TEST_ASSERT_MSG_EQ (m_expirations, 10, "Entries lost");
+  NS_TEST_ASSERT_MSG_EQ (Simulator::GetEventCount (), 10, "Main event not removed when moved");
+  Simulator::Destroy ();
+
+  // The main event is scheduled in another context: each old
+  // occurrence stays in the main event list, and does nothing.
+  m_expirations = 0;
+  Simulator::ScheduleWithContext (3, Seconds (0), &TimerWheelMoveTestCase::ScheduleEntries, this, 0, 1);
+  Simulator::Schedule (Seconds (1), &TimerWheelMoveTestCase::ScheduleEntries, this, 10, 10);
+  Simulator::Run ();
+  NS_TEST_ASSERT_MSG_EQ (m_expirations, 11, "Entries lost");
+  Simulator::Destroy ();
+  TimerWheel::Disable ();
+}
+
+
+/**
+ * \ingroup timer-tests
+ * TimerWheel test suite.
+ */
+class TimerWheelTestSuite : public TestSuite
+{
+public:
+  /** Constructor. */
+  TimerWheelTestSuite ();
+};
+
+TimerWheelTestSuite::TimerWheelTestSuite ()
+  : TestSuite ("timer-wheel", UNIT)
+{
+  AddTestCase (new TimerWheelOrderTestCase ());
+  AddTestCase (new TimerWheelTimerTestCase ());
+  AddTestCase (new TimerWheelMoveTestCase ());
+}
+
+/**
+ * \ingroup timer-tests
+ * TimerWheelTestSuite instance variable.
+ */
+static TimerWheelTestSuite g_timerWheelTestSuite;
+
+
+}    // namespace tests
+
+}  // namespace ns3
@@ -47,6 +47,7 @@
 #include "ns3/icmpv6-l4-protocol.h"
 #include "ns3/global-router-interface.h"
 #include "ns3/traffic-control-layer.h"
+#include "ns3/binary-trace-stream.h"
 #include <limits>
 #include <map>
 
@@ -618,6 +619,10 @@ Ipv4L3ProtocolDropSinkWithoutContext (Ptr<OutputStreamWrapper> stream, Ipv4Heade
 
   Ptr<Packet> p = packet->Copy ();
   p->AddHeader (header);
+  if (BinaryTraceStream::TryRecord (stream, 'd', std::string (), p))
+    {
+      return;
+    }
   *stream->GetStream () << "d " << Simulator::Now ().GetSeconds () << " " << *p << std::endl;
 }
 
@@ -639,6 +644,10 @@ Ipv4L3ProtocolTxSinkWithoutContext (Ptr<OutputStreamWrapper> stream, Ptr<const P
       return;
     }
 
+  if (BinaryTraceStream::TryRecord (stream, 't', std::string (), packet))
+    {
+      return;
+    }
   *stream->GetStream () << "t " << Simulator::Now ().GetSeconds () << " " << *packet << std::endl;
 }
 
@@ -660,6 +669,10 @@ Ipv4L3ProtocolRxSinkWithoutContext (Ptr<OutputStreamWrapper> stream, Ptr<const P
       return;
     }
 
+  if (BinaryTraceStream::TryRecord (stream, 'r', std::string (), packet))
+    {
+      return;
+    }
   *stream->GetStream () << "r " << Simulator::Now ().GetSeconds () << " " << *packet << std::endl;
 }
 
@@ -694,6 +707,10 @@ Ipv4L3ProtocolDropSinkWithContext (Ptr<OutputStreamWrapper> stream, std::string
 
   Ptr<Packet> p = packet->Copy ();
   p->AddHeader (header);
+  if (BinaryTraceStream::TryRecord (stream, 'd', context, p))
+    {
+      return;
+    }
 #ifdef INTERFACE_CONTEXT
   *stream->GetStream () << "d " << Simulator::Now ().GetSeconds () << " " << context << "("
                         << interface << ") " << *p << std::endl;
@@ -722,6 +739,10 @@ Ipv4L3ProtocolTxSinkWithContext (Ptr<OutputStreamWrapper> stream, std::string co
       return;
     }
 
+  if (BinaryTraceStream::TryRecord (stream, 't', context, packet))
+    {
+      return;
+    }
 #ifdef INTERFACE_CONTEXT
   *stream->GetStream () << "t " << Simulator::Now ().GetSeconds () << " " << context << "("
                         << interface << ") " << *packet << std::endl;
@@ -750,6 +771,10 @@ Ipv4L3ProtocolRxSinkWithContext (Ptr<OutputStreamWrapper> stream, std::string co
       return;
     }
 
+  if (BinaryTraceStream::TryRecord (stream, 'r', context, packet))
+    {
+      return;
+    }
 #ifdef INTERFACE_CONTEXT
   *stream->GetStream () << "r " << Simulator::Now ().GetSeconds () << " " << context << "("
                         << interface << ") " << *packet << std::endl;
@@ -935,6 +960,10 @@ Ipv6L3ProtocolDropSinkWithoutContext (Ptr<OutputStreamWrapper> stream, Ipv6Heade
 
   Ptr<Packet> p = packet->Copy ();
   p->AddHeader (header);
+  if (BinaryTraceStream::TryRecord (stream, 'd', std::string (), p))
+    {
+      return;
+    }
   *stream->GetStream () << "d " << Simulator::Now ().GetSeconds () << " " << *p << std::endl;
 }
 
@@ -956,6 +985,10 @@ Ipv6L3ProtocolTxSinkWithoutContext (Ptr<OutputStreamWrapper> stream, Ptr<const P
       return;
     }
 
+  if (BinaryTraceStream::TryRecord (stream, 't', std::string (), packet))
+    {
+      return;
+    }
   *stream->GetStream () << "t " << Simulator::Now ().GetSeconds () << " " << *packet << std::endl;
 }
 
@@ -977,6 +1010,10 @@ Ipv6L3ProtocolRxSinkWithoutContext (Ptr<OutputStreamWrapper> stream, Ptr<const P
       return;
     }
 
+  if (BinaryTraceStream::TryRecord (stream, 'r', std::string (), packet))
+    {
+      return;
+    }
   *stream->GetStream () << "r " << Simulator::Now ().GetSeconds () << " " << *packet << std::endl;
 }
 
@@ -1011,6 +1048,10 @@ Ipv6L3ProtocolDropSinkWithContext (Ptr<OutputStreamWrapper> stream, std::string
 
   Ptr<Packet> p = packet->Copy ();
   p->AddHeader (header);
+  if (BinaryTraceStream::TryRecord (stream, 'd', context, p))
+    {
+      return;
+    }
 #ifdef INTERFACE_CONTEXT
   *stream->GetStream () << "d " << Simulator::Now ().GetSeconds () << " " << context << "("
                         << interface << ") " << *p << std::endl;
@@ -1039,6 +1080,10 @@ Ipv6L3ProtocolTxSinkWithContext (Ptr<OutputStreamWrapper> stream, std::string co
       return;
     }
 
+  if (BinaryTraceStream::TryRecord (stream, 't', context, packet))
+    {
+      return;
+    }
 #ifdef INTERFACE_CONTEXT
   *stream->GetStream () << "t " << Simulator::Now ().GetSeconds () << " " << context << "("
                         << interface << ") " << *packet << std::endl;
@@ -1067,6 +1112,10 @@ Ipv6L3ProtocolRxSinkWithContext (Ptr<OutputStreamWrapper> stream, std::string co
       return;
     }
 
+  if (BinaryTraceStream::TryRecord (stream, 'r', context, packet))
+    {
+      return;
+    }
 #ifdef INTERFACE_CONTEXT
   *stream->GetStream () << "r " << Simulator::Now ().GetSeconds () << " " << context << "("
                         << interface << ") " << *packet << std::endl;
@@ -28,6 +28,21 @@
 #include "ns3/names.h"
 #include "ns3/net-device.h"
 #include "ns3/pcap-file-wrapper.h"
+#include "ns3/header-decoder.h"
+#include "ns3/arp-header.h"
+#include "ns3/arp-l3-protocol.h"
+#include "ns3/icmpv4.h"
+#include "ns3/icmpv4-l4-protocol.h"
+#include "ns3/icmpv6-header.h"
+#include "ns3/icmpv6-l4-protocol.h"
+#include "ns3/ipv4-header.h"
+#include "ns3/ipv4-l3-protocol.h"
+#include "ns3/ipv6-header.h"
+#include "ns3/ipv6-l3-protocol.h"
+#include "ns3/tcp-header.h"
+#include "ns3/tcp-l4-protocol.h"
+#include "ns3/udp-header.h"
+#include "ns3/udp-l4-protocol.h"
 
 #include "internet-trace-helper.h"
 
@@ -35,6 +50,67 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("InternetTraceHelper");
 
+namespace {
+
+/**
+ * Tell which header follows an IPv4 header.
+ * \param [in] header The Ipv4Header.
+ * \param [out] tid The TypeId of the next header.
+ * \returns \c true if a known header follows.
+ */
+bool
+Ipv4Next (const Header &header, TypeId *tid)
+{
+  const Ipv4Header &ipv4 = static_cast<const Ipv4Header &> (header);
+  if (ipv4.GetFragmentOffset () != 0)
+    {
+      return false;
+    }
+  return HeaderDecoder::LookupProtocol ("ip", ipv4.GetProtocol (), tid);
+}
+
+/**
+ * Tell which header follows an IPv6 header.
+ * \param [in] header The Ipv6Header.
+ * \param [out] tid The TypeId of the next header.
+ * \returns \c true if a known header follows.
+ */
+bool
+Ipv6Next (const Header &header, TypeId *tid)
+{
+  const Ipv6Header &ipv6 = static_cast<const Ipv6Header &> (header);
+  return HeaderDecoder::LookupProtocol ("ip", ipv6.GetNextHeader (), tid);
+}
+
+/**
+ * Register the headers of the internet module with HeaderDecoder.
+ * Extension headers are not registered: the payload follows them.
+ */
+struct InternetHeaders
+{
+  InternetHeaders ()
+  {
+    HeaderDecoder::NextHeaderCallback payload;
+    HeaderDecoder::RegisterHeader (Ipv4Header::GetTypeId (), MakeCallback (&Ipv4Next));
+    HeaderDecoder::RegisterHeader (Ipv6Header::GetTypeId (), MakeCallback (&Ipv6Next));
+    HeaderDecoder::RegisterHeader (ArpHeader::GetTypeId (), payload);
+    HeaderDecoder::RegisterHeader (Icmpv4Header::GetTypeId (), payload);
+    HeaderDecoder::RegisterHeader (Icmpv6Header::GetTypeId (), payload);
+    HeaderDecoder::RegisterHeader (UdpHeader::GetTypeId (), payload);
+    HeaderDecoder::RegisterHeader (TcpHeader::GetTypeId (), payload);
+
+    HeaderDecoder::RegisterProtocol ("ethertype", Ipv4L3Protocol::PROT_NUMBER, Ipv4Header::GetTypeId ());
+    HeaderDecoder::RegisterProtocol ("ethertype", Ipv6L3Protocol::PROT_NUMBER, Ipv6Header::GetTypeId ());
+    HeaderDecoder::RegisterProtocol ("ethertype", ArpL3Protocol::PROT_NUMBER, ArpHeader::GetTypeId ());
+    HeaderDecoder::RegisterProtocol ("ip", Icmpv4L4Protocol::PROT_NUMBER, Icmpv4Header::GetTypeId ());
+    HeaderDecoder::RegisterProtocol ("ip", Icmpv6L4Protocol::PROT_NUMBER, Icmpv6Header::GetTypeId ());
+    HeaderDecoder::RegisterProtocol ("ip", UdpL4Protocol::PROT_NUMBER, UdpHeader::GetTypeId ());
+    HeaderDecoder::RegisterProtocol ("ip", TcpL4Protocol::PROT_NUMBER, TcpHeader::GetTypeId ());
+  }
+} g_internetHeaders; //!< Registers the headers of the internet module
+
+} // unnamed namespace
+
 void 
 PcapHelperForIpv4::EnablePcapIpv4 (std::string prefix, Ptr<Ipv4> ipv4, uint32_t interface, bool explicitFilename)
 {
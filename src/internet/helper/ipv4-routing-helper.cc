@@ -38,9 +38,9 @@ Ipv4RoutingHelper::~Ipv4RoutingHelper ()
 void
 Ipv4RoutingHelper::PrintRoutingTableAllAt (Time printTime, Ptr<OutputStreamWrapper> stream, Time::Unit unit)
 {
-  for (uint32_t i = 0; i < NodeList::GetNNodes (); i++)
+  for (NodeList::Iterator i = NodeList::Begin (); i != NodeList::End (); ++i)
     {
-      Ptr<Node> node = NodeList::GetNode (i);
+      Ptr<Node> node = *i;
       Simulator::Schedule (printTime, &Ipv4RoutingHelper::Print, node, stream, unit);
     }
 }
@@ -48,9 +48,9 @@ Ipv4RoutingHelper::PrintRoutingTableAllAt (Time printTime, Ptr<OutputStreamWrapp
 void
 Ipv4RoutingHelper::PrintRoutingTableAllEvery (Time printInterval, Ptr<OutputStreamWrapper> stream, Time::Unit unit)
 {
-  for (uint32_t i = 0; i < NodeList::GetNNodes (); i++)
+  for (NodeList::Iterator i = NodeList::Begin (); i != NodeList::End (); ++i)
     {
-      Ptr<Node> node = NodeList::GetNode (i);
+      Ptr<Node> node = *i;
       Simulator::Schedule (printInterval, &Ipv4RoutingHelper::PrintEvery, printInterval, node, stream, unit);
     }
 }
@@ -95,9 +95,9 @@ Ipv4RoutingHelper::PrintEvery (Time printInterval, Ptr<Node> node, Ptr<OutputStr
 void
 Ipv4RoutingHelper::PrintNeighborCacheAllAt (Time printTime, Ptr<OutputStreamWrapper> stream, Time::Unit unit /* = Time::S */)
 {
-  for (uint32_t i = 0; i < NodeList::GetNNodes (); i++)
+  for (NodeList::Iterator i = NodeList::Begin (); i != NodeList::End (); ++i)
     {
-      Ptr<Node> node = NodeList::GetNode (i);
+      Ptr<Node> node = *i;
       Simulator::Schedule (printTime, &Ipv4RoutingHelper::PrintArpCache, node, stream, unit);
     }
 }
@@ -105,9 +105,9 @@ Ipv4RoutingHelper::PrintNeighborCacheAllAt (Time printTime, Ptr<OutputStreamWrap
 void
 Ipv4RoutingHelper::PrintNeighborCacheAllEvery (Time printInterval, Ptr<OutputStreamWrapper> stream, Time::Unit unit)
 {
-  for (uint32_t i = 0; i < NodeList::GetNNodes (); i++)
+  for (NodeList::Iterator i = NodeList::Begin (); i != NodeList::End (); ++i)
     {
-      Ptr<Node> node = NodeList::GetNode (i);
+      Ptr<Node> node = *i;
       Simulator::Schedule (printInterval, &Ipv4RoutingHelper::PrintArpCacheEvery, printInterval, node, stream, unit);
     }
 }
@@ -38,9 +38,9 @@ Ipv6RoutingHelper::~Ipv6RoutingHelper ()
 void
 Ipv6RoutingHelper::PrintRoutingTableAllAt (Time printTime, Ptr<OutputStreamWrapper> stream, Time::Unit unit)
 {
-  for (uint32_t i = 0; i < NodeList::GetNNodes (); i++)
+  for (NodeList::Iterator i = NodeList::Begin (); i != NodeList::End (); ++i)
     {
-      Ptr<Node> node = NodeList::GetNode (i);
+      Ptr<Node> node = *i;
       Simulator::Schedule (printTime, &Ipv6RoutingHelper::Print, node, stream, unit);
     }
 }
@@ -48,9 +48,9 @@ Ipv6RoutingHelper::PrintRoutingTableAllAt (Time printTime, Ptr<OutputStreamWrapp
 void
 Ipv6RoutingHelper::PrintRoutingTableAllEvery (Time printInterval, Ptr<OutputStreamWrapper> stream, Time::Unit unit)
 {
-  for (uint32_t i = 0; i < NodeList::GetNNodes (); i++)
+  for (NodeList::Iterator i = NodeList::Begin (); i != NodeList::End (); ++i)
     {
-      Ptr<Node> node = NodeList::GetNode (i);
+      Ptr<Node> node = *i;
       Simulator::Schedule (printInterval, &Ipv6RoutingHelper::PrintEvery, printInterval, node, stream, unit);
     }
 }
@@ -95,9 +95,9 @@ Ipv6RoutingHelper::PrintEvery (Time printInterval, Ptr<Node> node, Ptr<OutputStr
 void
 Ipv6RoutingHelper::PrintNeighborCacheAllAt (Time printTime, Ptr<OutputStreamWrapper> stream, Time::Unit unit /* = Time::S */)
 {
-  for (uint32_t i = 0; i < NodeList::GetNNodes (); i++)
+  for (NodeList::Iterator i = NodeList::Begin (); i != NodeList::End (); ++i)
     {
-      Ptr<Node> node = NodeList::GetNode (i);
+      Ptr<Node> node = *i;
       Simulator::Schedule (printTime, &Ipv6RoutingHelper::PrintNdiscCache, node, stream, unit);
     }
 }
@@ -105,9 +105,9 @@ Ipv6RoutingHelper::PrintNeighborCacheAllAt (Time printTime, Ptr<OutputStreamWrap
 void
 Ipv6RoutingHelper::PrintNeighborCacheAllEvery (Time printInterval, Ptr<OutputStreamWrapper> stream, Time::Unit unit /* = Time::S */)
 {
-  for (uint32_t i = 0; i < NodeList::GetNNodes (); i++)
+  for (NodeList::Iterator i = NodeList::Begin (); i != NodeList::End (); ++i)
     {
-      Ptr<Node> node = NodeList::GetNode (i);
+      Ptr<Node> node = *i;
       Simulator::Schedule (printInterval, &Ipv6RoutingHelper::PrintNdiscCacheEvery, printInterval, node, stream, unit);
     }
 }
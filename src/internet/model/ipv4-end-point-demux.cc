@@ -21,8 +21,11 @@
 #include "ipv4-end-point-demux.h"
 #include "ipv4-end-point.h"
 #include "ipv4-interface-address.h"
+#include "ns3/assert.h"
 #include "ns3/log.h"
 
+#include <algorithm>
+
 
 namespace ns3 {
 
@@ -40,30 +43,125 @@ Ipv4EndPointDemux::~Ipv4EndPointDemux ()
   for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
     {
       Ipv4EndPoint *endPoint = *i;
+      endPoint->m_demux = 0;
       delete endPoint;
     }
   m_endPoints.clear ();
+  m_connected.clear ();
+  m_ports.clear ();
 }
 
 bool
-Ipv4EndPointDemux::LookupPortLocal (uint16_t port)
+Ipv4EndPointDemux::FourTuple::operator == (const FourTuple &other) const
 {
-  NS_LOG_FUNCTION (this << port);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
+  return localAddress == other.localAddress && peerAddress == other.peerAddress
+         && localPort == other.localPort && peerPort == other.peerPort;
+}
+
+std::size_t
+Ipv4EndPointDemux::FourTupleHash::operator () (const FourTuple &tuple) const
+{
+  uint64_t hash = (static_cast<uint64_t> (tuple.localAddress.Get ()) << 32) | tuple.peerAddress.Get ();
+  hash ^= ((static_cast<uint64_t> (tuple.localPort) << 16) | tuple.peerPort) * 0x9e3779b97f4a7c15ULL;
+  hash ^= hash >> 32;
+  hash *= 0xd6e8feb86659fd93ULL;
+  hash ^= hash >> 32;
+  return hash;
+}
+
+bool
+Ipv4EndPointDemux::IsConnected (Ipv4EndPoint *endPoint)
+{
+  return endPoint->GetLocalAddress () != Ipv4Address::GetAny ()
+         && endPoint->GetPeerAddress () != Ipv4Address::GetAny ()
+         && endPoint->GetPeerPort () != 0;
+}
+
+Ipv4EndPoint *
+Ipv4EndPointDemux::Insert (Ipv4EndPoint *endPoint)
+{
+  NS_LOG_FUNCTION (this << endPoint);
+  endPoint->m_demux = this;
+  endPoint->m_demuxPosition = m_endPoints.insert (m_endPoints.end (), endPoint);
+  m_ports[endPoint->GetLocalPort ()].endPoints++;
+  Index (endPoint);
+  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
+  return endPoint;
+}
+
+void
+Ipv4EndPointDemux::Index (Ipv4EndPoint *endPoint)
+{
+  NS_LOG_FUNCTION (this << endPoint);
+  if (IsConnected (endPoint))
+    {
+      FourTuple tuple = { endPoint->GetLocalAddress (), endPoint->GetPeerAddress (),
+                          endPoint->GetLocalPort (), endPoint->GetPeerPort () };
+      m_connected.insert (std::make_pair (tuple, endPoint));
+    }
+  else
     {
-      if ((*i)->GetLocalPort  () == port) 
+      m_ports[endPoint->GetLocalPort ()].wildcards.push_back (endPoint);
+    }
+}
+
+void
+Ipv4EndPointDemux::Unindex (Ipv4EndPoint *endPoint)
+{
+  NS_LOG_FUNCTION (this << endPoint);
+  if (IsConnected (endPoint))
+    {
+      FourTuple tuple = { endPoint->GetLocalAddress (), endPoint->GetPeerAddress (),
+                          endPoint->GetLocalPort (), endPoint->GetPeerPort () };
+      typedef std::unordered_multimap<FourTuple, Ipv4EndPoint *, FourTupleHash>::iterator ConnectedI;
+      std::pair<ConnectedI, ConnectedI> range = m_connected.equal_range (tuple);
+      for (ConnectedI i = range.first; i != range.second; i++)
         {
-          return true;
+          if (i->second == endPoint)
+            {
+              m_connected.erase (i);
+              return;
+            }
         }
+      NS_ASSERT_MSG (false, "End point " << endPoint << " is not indexed");
     }
-  return false;
+  else
+    {
+      m_ports[endPoint->GetLocalPort ()].wildcards.remove (endPoint);
+    }
+}
+
+void
+Ipv4EndPointDemux::FindConnected (const FourTuple &tuple, std::vector<Ipv4EndPoint *> &endPoints)
+{
+  typedef std::unordered_multimap<FourTuple, Ipv4EndPoint *, FourTupleHash>::iterator ConnectedI;
+  std::pair<ConnectedI, ConnectedI> range = m_connected.equal_range (tuple);
+  for (ConnectedI i = range.first; i != range.second; i++)
+    {
+      endPoints.push_back (i->second);
+    }
+}
+
+bool
+Ipv4EndPointDemux::LookupPortLocal (uint16_t port)
+{
+  NS_LOG_FUNCTION (this << port);
+  return m_ports.find (port) != m_ports.end ();
 }
 
 bool
 Ipv4EndPointDemux::LookupLocal (Ptr<NetDevice> boundNetDevice, Ipv4Address addr, uint16_t port)
 {
   NS_LOG_FUNCTION (this << addr << port);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
+  std::unordered_map<uint16_t, Port>::iterator p = m_ports.find (port);
+  if (p == m_ports.end ())
+    {
+      return false;
+    }
+  // the connected end points are only indexed by four-tuple: look at
+  // all the end points if the port has some
+  EndPoints &endPoints = p->second.endPoints == p->second.wildcards.size () ? p->second.wildcards : m_endPoints;
+  for (EndPointsI i = endPoints.begin (); i != endPoints.end (); i++) 
     {
       if ((*i)->GetLocalPort () == port &&
           (*i)->GetLocalAddress () == addr &&
@@ -85,10 +183,7 @@ Ipv4EndPointDemux::Allocate (void)
       NS_LOG_WARN ("Ephemeral port allocation failed.");
       return 0;
     }
-  Ipv4EndPoint *endPoint = new Ipv4EndPoint (Ipv4Address::GetAny (), port);
-  m_endPoints.push_back (endPoint);
-  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
-  return endPoint;
+  return Insert (new Ipv4EndPoint (Ipv4Address::GetAny (), port));
 }
 
 Ipv4EndPoint *
@@ -101,10 +196,7 @@ Ipv4EndPointDemux::Allocate (Ipv4Address address)
       NS_LOG_WARN ("Ephemeral port allocation failed.");
       return 0;
     }
-  Ipv4EndPoint *endPoint = new Ipv4EndPoint (address, port);
-  m_endPoints.push_back (endPoint);
-  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
-  return endPoint;
+  return Insert (new Ipv4EndPoint (address, port));
 }
 
 Ipv4EndPoint *
@@ -124,10 +216,7 @@ Ipv4EndPointDemux::Allocate (Ptr<NetDevice> boundNetDevice, Ipv4Address address,
       NS_LOG_WARN ("Duplicated endpoint.");
       return 0;
     }
-  Ipv4EndPoint *endPoint = new Ipv4EndPoint (address, port);
-  m_endPoints.push_back (endPoint);
-  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
-  return endPoint;
+  return Insert (new Ipv4EndPoint (address, port));
 }
 
 Ipv4EndPoint *
@@ -136,7 +225,15 @@ Ipv4EndPointDemux::Allocate (Ptr<NetDevice> boundNetDevice,
                              Ipv4Address peerAddress, uint16_t peerPort)
 {
   NS_LOG_FUNCTION (this << localAddress << localPort << peerAddress << peerPort << boundNetDevice);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
+  std::vector<Ipv4EndPoint *> endPoints;
+  FourTuple tuple = { localAddress, peerAddress, localPort, peerPort };
+  FindConnected (tuple, endPoints);
+  std::unordered_map<uint16_t, Port>::iterator p = m_ports.find (localPort);
+  if (p != m_ports.end ())
+    {
+      endPoints.insert (endPoints.end (), p->second.wildcards.begin (), p->second.wildcards.end ());
+    }
+  for (std::vector<Ipv4EndPoint *>::iterator i = endPoints.begin (); i != endPoints.end (); i++)
     {
       if ((*i)->GetLocalPort () == localPort &&
           (*i)->GetLocalAddress () == localAddress &&
@@ -150,26 +247,26 @@ Ipv4EndPointDemux::Allocate (Ptr<NetDevice> boundNetDevice,
     }
   Ipv4EndPoint *endPoint = new Ipv4EndPoint (localAddress, localPort);
   endPoint->SetPeer (peerAddress, peerPort);
-  m_endPoints.push_back (endPoint);
-
-  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
-
-  return endPoint;
+  return Insert (endPoint);
 }
 
 void 
 Ipv4EndPointDemux::DeAllocate (Ipv4EndPoint *endPoint)
 {
   NS_LOG_FUNCTION (this << endPoint);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
+  if (endPoint->m_demux != this)
     {
-      if (*i == endPoint)
-        {
-          delete endPoint;
-          m_endPoints.erase (i);
-          break;
-        }
+      return;
     }
+  Unindex (endPoint);
+  std::unordered_map<uint16_t, Port>::iterator p = m_ports.find (endPoint->GetLocalPort ());
+  if (--p->second.endPoints == 0)
+    {
+      m_ports.erase (p);
+    }
+  m_endPoints.erase (endPoint->m_demuxPosition);
+  endPoint->m_demux = 0;
+  delete endPoint;
 }
 
 /*
@@ -208,7 +305,36 @@ Ipv4EndPointDemux::Lookup (Ipv4Address daddr, uint16_t dport,
   EndPoints retval4; // Exact match on all 4
 
   NS_LOG_DEBUG ("Looking up endpoint for destination address " << daddr << ":" << dport);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
+
+  // The candidates are the connected end points of the four-tuple, those
+  // bound to the subnet-directed address of the destination, and the
+  // other end points of the local port.
+  std::vector<Ipv4EndPoint *> endPoints;
+  if (!m_connected.empty ())
+    {
+      FourTuple tuple = { daddr, saddr, dport, sport };
+      FindConnected (tuple, endPoints);
+      std::vector<Ipv4Address> subnets;
+      for (uint32_t i = 0; incomingInterface && i < incomingInterface->GetNAddresses (); i++)
+        {
+          Ipv4InterfaceAddress addr = incomingInterface->GetAddress (i);
+          Ipv4Address addrNetpart = addr.GetLocal ().CombineMask (addr.GetMask ());
+          if (addrNetpart != daddr && daddr.CombineMask (addr.GetMask ()) == addrNetpart
+              && std::find (subnets.begin (), subnets.end (), addrNetpart) == subnets.end ())
+            {
+              subnets.push_back (addrNetpart);
+              tuple.localAddress = addrNetpart;
+              FindConnected (tuple, endPoints);
+            }
+        }
+    }
+  std::unordered_map<uint16_t, Port>::iterator p = m_ports.find (dport);
+  if (p != m_ports.end ())
+    {
+      endPoints.insert (endPoints.end (), p->second.wildcards.begin (), p->second.wildcards.end ());
+    }
+
+  for (std::vector<Ipv4EndPoint *>::iterator i = endPoints.begin (); i != endPoints.end (); i++)
     {
       Ipv4EndPoint* endP = *i;
 
@@ -343,6 +469,20 @@ Ipv4EndPointDemux::SimpleLookup (Ipv4Address daddr,
 {
   NS_LOG_FUNCTION (this << daddr << dport << saddr << sport);
 
+  // a single connected end point of the four-tuple is the first exact
+  // match: the other end points have a wildcard, which does not match
+  // such a four-tuple
+  if (daddr != Ipv4Address::GetAny () && saddr != Ipv4Address::GetAny () && sport != 0)
+    {
+      FourTuple tuple = { daddr, saddr, dport, sport };
+      std::vector<Ipv4EndPoint *> endPoints;
+      FindConnected (tuple, endPoints);
+      if (endPoints.size () == 1)
+        {
+          return endPoints.front ();
+        }
+    }
+
   // this code is a copy/paste version of an old BSD ip stack lookup
   // function.
   uint32_t genericity = 3;
@@ -23,6 +23,8 @@
 
 #include <stdint.h>
 #include <list>
+#include <unordered_map>
+#include <vector>
 #include "ns3/ipv4-address.h"
 #include "ipv4-interface.h"
 
@@ -40,6 +42,12 @@ class Ipv4EndPoint;
  * of endpoints, and has APIs to add and find endpoints in this demux.  This
  * code is shared in common to TCP and UDP protocols in ns3.  This demux
  * sits between ns3's layer four and the socket layer
+ *
+ * The endpoints are also indexed for the lookups: the connected endpoints
+ * (with a local address, a peer address and a peer port) by four-tuple in
+ * a hash table, and the other endpoints by local port, so that a lookup
+ * does not depend on the number of connections.  The endpoints update the
+ * index when their addresses change.
  */
 
 class Ipv4EndPointDemux {
@@ -166,6 +174,7 @@ public:
   void DeAllocate (Ipv4EndPoint *endPoint);
 
 private:
+  friend class Ipv4EndPoint;
 
   /**
    * \brief Allocate an ephemeral port.
@@ -173,6 +182,78 @@ private:
    */
   uint16_t AllocateEphemeralPort (void);
 
+  /**
+   * \brief Add a new end point to the demux.
+   * \param endPoint the end point
+   * \returns the end point
+   */
+  Ipv4EndPoint *Insert (Ipv4EndPoint *endPoint);
+
+  /**
+   * \brief Index an end point by its four-tuple if it is connected, else
+   * by its local port.
+   * \param endPoint the end point
+   */
+  void Index (Ipv4EndPoint *endPoint);
+
+  /**
+   * \brief Remove an end point from the index.
+   * \param endPoint the end point
+   */
+  void Unindex (Ipv4EndPoint *endPoint);
+
+  /**
+   * \brief A four-tuple.
+   */
+  struct FourTuple
+  {
+    Ipv4Address localAddress; //!< the local address
+    Ipv4Address peerAddress;  //!< the peer address
+    uint16_t localPort;       //!< the local port
+    uint16_t peerPort;        //!< the peer port
+
+    /**
+     * \param other the other four-tuple
+     * \returns true if the four-tuples are equal
+     */
+    bool operator == (const FourTuple &other) const;
+  };
+
+  /**
+   * \brief Hash function of the four-tuples.
+   */
+  struct FourTupleHash
+  {
+    /**
+     * \param tuple the four-tuple
+     * \returns the hash of the four-tuple
+     */
+    std::size_t operator () (const FourTuple &tuple) const;
+  };
+
+  /**
+   * \brief The end points of a local port.
+   */
+  struct Port
+  {
+    uint32_t endPoints;  //!< the number of end points of the port
+    EndPoints wildcards; //!< the end points which are not connected
+  };
+
+  /**
+   * \param endPoint the end point
+   * \returns true if the end point is connected, that is if it has a
+   * local address, a peer address and a peer port
+   */
+  static bool IsConnected (Ipv4EndPoint *endPoint);
+
+  /**
+   * \brief Add the connected end points of a four-tuple to a list.
+   * \param tuple the four-tuple
+   * \param endPoints the list
+   */
+  void FindConnected (const FourTuple &tuple, std::vector<Ipv4EndPoint *> &endPoints);
+
   /**
    * \brief The ephemeral port.
    */
@@ -192,6 +273,16 @@ private:
    * \brief A list of IPv4 end points.
    */
   EndPoints m_endPoints;
+
+  /**
+   * \brief The connected end points, by four-tuple.
+   */
+  std::unordered_multimap<FourTuple, Ipv4EndPoint *, FourTupleHash> m_connected;
+
+  /**
+   * \brief The end points, by local port.
+   */
+  std::unordered_map<uint16_t, Port> m_ports;
 };
 
 } // namespace ns3
@@ -22,6 +22,7 @@
 #define IPV4_END_POINT_H
 
 #include <stdint.h>
+#include <list>
 #include "ns3/ipv4-address.h"
 #include "ns3/callback.h"
 #include "ns3/net-device.h"
@@ -31,6 +32,7 @@
 namespace ns3 {
 
 class Header;
+class Ipv4EndPointDemux;
 class Packet;
 
 /**
@@ -183,6 +185,8 @@ public:
   bool IsRxEnabled (void);
 
 private:
+  friend class Ipv4EndPointDemux;
+
   /**
    * \brief The local address.
    */
@@ -227,6 +231,16 @@ private:
    * \brief true if the endpoint can receive packets.
    */
   bool m_rxEnabled;
+
+  /**
+   * \brief The demux which indexes the endpoint, if any.
+   */
+  Ipv4EndPointDemux *m_demux;
+
+  /**
+   * \brief The position of the endpoint in the list of its demux.
+   */
+  std::list<Ipv4EndPoint *>::iterator m_demuxPosition;
 };
 
 } // namespace ns3
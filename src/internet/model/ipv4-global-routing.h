@@ -21,12 +21,14 @@
 #define IPV4_GLOBAL_ROUTING_H
 
 #include <list>
+#include <vector>
 #include <stdint.h>
 #include "ns3/ipv4-address.h"
 #include "ns3/ipv4-header.h"
 #include "ns3/ptr.h"
 #include "ns3/ipv4.h"
 #include "ns3/ipv4-routing-protocol.h"
+#include "ns3/ipv4-routing-table-index.h"
 #include "ns3/random-variable-stream.h"
 
 namespace ns3 {
@@ -268,10 +270,25 @@ private:
    */
   Ptr<Ipv4Route> LookupGlobal (Ipv4Address dest, Ptr<NetDevice> oif = 0);
 
+  /**
+   * \brief Get the routes of the longest prefix of an index which
+   * matches a destination, and which are on the requested interface.
+   * \param index the index of the routes
+   * \param dest destination address
+   * \param oif output interface if any (put 0 otherwise)
+   * \param routes the routes found, or empty if none
+   */
+  void LookupIndex (const Ipv4RoutingTableIndex &index, Ipv4Address dest,
+                    Ptr<NetDevice> oif, std::vector<Ipv4RoutingTableEntry*> &routes);
+
   HostRoutes m_hostRoutes;             //!< Routes to hosts
   NetworkRoutes m_networkRoutes;       //!< Routes to networks
   ASExternalRoutes m_ASexternalRoutes; //!< External routes imported
 
+  Ipv4RoutingTableIndex m_hostIndex;       //!< Index of the routes to hosts
+  Ipv4RoutingTableIndex m_networkIndex;    //!< Index of the routes to networks
+  Ipv4RoutingTableIndex m_ASexternalIndex; //!< Index of the external routes
+
   Ptr<Ipv4> m_ipv4; //!< associated IPv4 instance
 };
 
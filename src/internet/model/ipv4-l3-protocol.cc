@@ -1506,11 +1506,6 @@ Ipv4L3Protocol::DoFragmentation (Ptr<Packet> packet, const Ipv4Header & ipv4Head
       NS_LOG_LOGIC ("Fragment check - " << fragmentHeader.GetFragmentOffset ()  );
 
       NS_LOG_LOGIC ("New fragment Header " << fragmentHeader);
-
-      std::ostringstream oss;
-      oss << fragmentHeader;
-      fragment->Print (oss);
-
       NS_LOG_LOGIC ("New fragment " << *fragment);
 
       listFragments.emplace_back (fragment, fragmentHeader);
@@ -1585,14 +1580,13 @@ Ipv4L3Protocol::Fragments::AddFragment (Ptr<Packet> fragment, uint16_t fragmentO
 {
   NS_LOG_FUNCTION (this << fragment << fragmentOffset << moreFragment);
 
-  std::list<std::pair<Ptr<Packet>, uint16_t> >::iterator it;
+  // The fragments usually arrive in order: look for the place of the
+  // fragment from the end of the list
+  std::list<std::pair<Ptr<Packet>, uint16_t> >::iterator it = m_fragments.end ();
 
-  for (it = m_fragments.begin (); it != m_fragments.end (); it++)
+  while (it != m_fragments.begin () && std::prev (it)->second > fragmentOffset)
     {
-      if (it->second > fragmentOffset)
-        {
-          break;
-        }
+      it--;
     }
 
   if (it == m_fragments.end ())
@@ -0,0 +1,134 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ipv4-routing-table-index.h"
+#include "ipv4-routing-table-entry.h"
+#include "ns3/assert.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("Ipv4RoutingTableIndex");
+
+Ipv4RoutingTableIndex::Ipv4RoutingTableIndex ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+uint64_t
+Ipv4RoutingTableIndex::GetKey (Ipv4Address network, Ipv4Mask mask)
+{
+  return (static_cast<uint64_t> (mask.Get ()) << 32) | (network.Get () & mask.Get ());
+}
+
+void
+Ipv4RoutingTableIndex::Add (Ipv4RoutingTableEntry *route, uint32_t metric)
+{
+  NS_LOG_FUNCTION (this << route << metric);
+  Ipv4Mask mask = route->GetDestNetworkMask ();
+  Routes &routes = m_prefixes[GetKey (route->GetDestNetwork (), mask)];
+  if (routes.empty ())
+    {
+      std::vector<Mask>::iterator i = m_masks.begin ();
+      uint16_t length = mask.GetPrefixLength ();
+      while (i != m_masks.end () && i->length > length)
+        {
+          i++;
+        }
+      while (i != m_masks.end () && i->length == length && i->mask != mask)
+        {
+          i++;
+        }
+      if (i == m_masks.end () || i->mask != mask)
+        {
+          Mask m;
+          m.mask = mask;
+          m.length = length;
+          m.prefixes = 0;
+          i = m_masks.insert (i, m);
+        }
+      i->prefixes++;
+    }
+  routes.push_back (std::make_pair (route, metric));
+}
+
+void
+Ipv4RoutingTableIndex::Remove (Ipv4RoutingTableEntry *route)
+{
+  NS_LOG_FUNCTION (this << route);
+  Ipv4Mask mask = route->GetDestNetworkMask ();
+  std::unordered_map<uint64_t, Routes>::iterator prefix =
+    m_prefixes.find (GetKey (route->GetDestNetwork (), mask));
+  NS_ASSERT_MSG (prefix != m_prefixes.end (), "Route " << *route << " is not in the index");
+  Routes &routes = prefix->second;
+  for (Routes::iterator i = routes.begin (); i != routes.end (); i++)
+    {
+      if (i->first == route)
+        {
+          routes.erase (i);
+          break;
+        }
+    }
+  if (!routes.empty ())
+    {
+      return;
+    }
+  m_prefixes.erase (prefix);
+  for (std::vector<Mask>::iterator i = m_masks.begin (); i != m_masks.end (); i++)
+    {
+      if (i->mask == mask)
+        {
+          if (--i->prefixes == 0)
+            {
+              m_masks.erase (i);
+            }
+          return;
+        }
+    }
+  NS_ASSERT_MSG (false, "Mask " << mask << " is not in the index");
+}
+
+void
+Ipv4RoutingTableIndex::Clear (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_prefixes.clear ();
+  m_masks.clear ();
+}
+
+const Ipv4RoutingTableIndex::Routes *
+Ipv4RoutingTableIndex::Find (Ipv4Address network, Ipv4Mask mask) const
+{
+  std::unordered_map<uint64_t, Routes>::const_iterator prefix =
+    m_prefixes.find (GetKey (network, mask));
+  return prefix != m_prefixes.end () ? &prefix->second : 0;
+}
+
+const Ipv4RoutingTableIndex::Routes *
+Ipv4RoutingTableIndex::Lookup (Ipv4Address dest, uint32_t &position) const
+{
+  while (position < m_masks.size ())
+    {
+      const Routes *routes = Find (dest, m_masks[position++].mask);
+      if (routes != 0)
+        {
+          return routes;
+        }
+    }
+  return 0;
+}
+
+} // namespace ns3
@@ -0,0 +1,115 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef IPV4_ROUTING_TABLE_INDEX_H
+#define IPV4_ROUTING_TABLE_INDEX_H
+
+#include <stdint.h>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "ns3/ipv4-address.h"
+
+namespace ns3 {
+
+class Ipv4RoutingTableEntry;
+
+/**
+ * \ingroup ipv4Routing
+ *
+ * \brief Longest prefix match index of the unicast routes of
+ * Ipv4StaticRouting and Ipv4GlobalRouting.
+ *
+ * The index groups the routes by prefix, that is by network and
+ * mask, in a hash table, and keeps the list of the masks in use,
+ * sorted from the longest prefix to the shortest.  A lookup probes
+ * the hash table once per mask in use, from the longest prefix, which
+ * is a few probes for the routes of the usual topologies (host routes,
+ * routes to the links, default route), whatever the number of
+ * routes.  The routes of a prefix are kept in the order of their
+ * insertion, so that the routing protocols break the ties as with
+ * their route lists, and select among equal-cost multipath routes.
+ *
+ * The index does not own the routes: the routing protocols add and
+ * remove them along with their route lists.
+ */
+class Ipv4RoutingTableIndex
+{
+public:
+  /// A route and its metric
+  typedef std::pair<Ipv4RoutingTableEntry *, uint32_t> Route;
+  /// The routes of a prefix, in the order of their insertion
+  typedef std::vector<Route> Routes;
+
+  Ipv4RoutingTableIndex ();
+
+  /**
+   * \brief Add a route after the other routes of its prefix.
+   * \param route the route
+   * \param metric the metric of the route
+   */
+  void Add (Ipv4RoutingTableEntry *route, uint32_t metric = 0);
+  /**
+   * \brief Remove a route.
+   * \param route the route, which must be in the index
+   */
+  void Remove (Ipv4RoutingTableEntry *route);
+  /**
+   * \brief Remove all the routes.
+   */
+  void Clear (void);
+  /**
+   * \param network the network of the prefix
+   * \param mask the mask of the prefix
+   * \returns the routes of the prefix, or 0 if there is none
+   */
+  const Routes *Find (Ipv4Address network, Ipv4Mask mask) const;
+  /**
+   * \brief Get the routes of the next prefix which matches a destination.
+   *
+   * The first call, with a position of 0, returns the routes of the
+   * longest matching prefix; the next calls return those of the
+   * shorter matching prefixes.
+   *
+   * \param dest the destination
+   * \param [in,out] position the position of the lookup in the masks
+   * \returns the routes of the prefix, or 0 if no other prefix matches
+   */
+  const Routes *Lookup (Ipv4Address dest, uint32_t &position) const;
+
+private:
+  /**
+   * \param network the network of the prefix
+   * \param mask the mask of the prefix
+   * \returns the key of the prefix in the hash table
+   */
+  static uint64_t GetKey (Ipv4Address network, Ipv4Mask mask);
+
+  /// A mask in use, and its number of prefixes
+  struct Mask
+  {
+    Ipv4Mask mask;        //!< the mask
+    uint16_t length;      //!< the prefix length of the mask
+    uint32_t prefixes;    //!< the number of prefixes with this mask
+  };
+
+  std::unordered_map<uint64_t, Routes> m_prefixes; //!< the routes of each prefix
+  std::vector<Mask> m_masks; //!< the masks in use, from the longest prefix
+};
+
+} // namespace ns3
+
+#endif /* IPV4_ROUTING_TABLE_INDEX_H */
@@ -77,6 +77,7 @@ Ipv4StaticRouting::AddNetworkRouteTo (Ipv4Address network,
     {
       Ipv4RoutingTableEntry *routePtr = new Ipv4RoutingTableEntry (route);
       m_networkRoutes.push_back (make_pair (routePtr, metric));
+      m_networkIndex.Add (routePtr, metric);
     }
 }
 
@@ -96,6 +97,7 @@ Ipv4StaticRouting::AddNetworkRouteTo (Ipv4Address network,
       Ipv4RoutingTableEntry *routePtr = new Ipv4RoutingTableEntry (route);
 
       m_networkRoutes.push_back (make_pair (routePtr, metric));
+      m_networkIndex.Add (routePtr, metric);
     }
 }
 
@@ -154,6 +156,7 @@ Ipv4StaticRouting::SetDefaultMulticastRoute (uint32_t outputInterface)
                                                         networkMask,
                                                         outputInterface);
   m_networkRoutes.push_back (make_pair (route,0));
+  m_networkIndex.Add (route);
 }
 
 uint32_t 
@@ -232,7 +235,13 @@ Ipv4StaticRouting::RemoveMulticastRoute (uint32_t index)
 bool
 Ipv4StaticRouting::LookupRoute (const Ipv4RoutingTableEntry &route, uint32_t metric)
 {
-  for (NetworkRoutesI j = m_networkRoutes.begin (); j != m_networkRoutes.end (); j++)
+  const Ipv4RoutingTableIndex::Routes *routes =
+    m_networkIndex.Find (route.GetDestNetwork (), route.GetDestNetworkMask ());
+  if (routes == 0)
+    {
+      return false;
+    }
+  for (Ipv4RoutingTableIndex::Routes::const_iterator j = routes->begin (); j != routes->end (); j++)
     {
       Ipv4RoutingTableEntry* rtentry = j->first;
 
@@ -253,8 +262,6 @@ Ipv4StaticRouting::LookupStatic (Ipv4Address dest, Ptr<NetDevice> oif)
 {
   NS_LOG_FUNCTION (this << dest << " " << oif);
   Ptr<Ipv4Route> rtentry = 0;
-  uint16_t longest_mask = 0;
-  uint32_t shortest_metric = 0xffffffff;
   /* when sending on local multicast, there have to be interface specified */
   if (dest.IsLocalMulticast ())
     {
@@ -269,19 +276,23 @@ Ipv4StaticRouting::LookupStatic (Ipv4Address dest, Ptr<NetDevice> oif)
     }
 
 
-  for (NetworkRoutesI i = m_networkRoutes.begin (); 
-       i != m_networkRoutes.end (); 
-       i++) 
+  // The index returns the routes of the matching prefixes from the
+  // longest one; a shorter prefix is only used when no route of the
+  // longer ones is on the requested interface.
+  Ipv4RoutingTableEntry *route = 0;
+  uint32_t position = 0;
+  const Ipv4RoutingTableIndex::Routes *routes;
+  while (route == 0 && (routes = m_networkIndex.Lookup (dest, position)) != 0)
     {
-      Ipv4RoutingTableEntry *j=i->first;
-      uint32_t metric =i->second;
-      Ipv4Mask mask = (j)->GetDestNetworkMask ();
-      uint16_t masklen = mask.GetPrefixLength ();
-      Ipv4Address entry = (j)->GetDestNetwork ();
-      NS_LOG_LOGIC ("Searching for route to " << dest << ", checking against route to " << entry << "/" << masklen);
-      if (mask.IsMatch (dest, entry)) 
+      uint32_t shortest_metric = 0xffffffff;
+      for (Ipv4RoutingTableIndex::Routes::const_iterator i = routes->begin ();
+           i != routes->end ();
+           i++)
         {
-          NS_LOG_LOGIC ("Found global network route " << j << ", mask length " << masklen << ", metric " << metric);
+          Ipv4RoutingTableEntry *j = i->first;
+          uint32_t metric = i->second;
+          NS_LOG_LOGIC ("Found global network route " << j << ", mask length " <<
+                        j->GetDestNetworkMask ().GetPrefixLength () << ", metric " << metric);
           if (oif != 0)
             {
               if (oif != m_ipv4->GetNetDevice (j->GetInterface ()))
@@ -290,35 +301,28 @@ Ipv4StaticRouting::LookupStatic (Ipv4Address dest, Ptr<NetDevice> oif)
                   continue;
                 }
             }
-          if (masklen < longest_mask) // Not interested if got shorter mask
-            {
-              NS_LOG_LOGIC ("Previous match longer, skipping");
-              continue;
-            }
-          if (masklen > longest_mask) // Reset metric if longer masklen
-            {
-              shortest_metric = 0xffffffff;
-            }
-          longest_mask = masklen;
           if (metric > shortest_metric)
             {
               NS_LOG_LOGIC ("Equal mask length, but previous metric shorter, skipping");
               continue;
             }
           shortest_metric = metric;
-          Ipv4RoutingTableEntry* route = (j);
-          uint32_t interfaceIdx = route->GetInterface ();
-          rtentry = Create<Ipv4Route> ();
-          rtentry->SetDestination (route->GetDest ());
-          rtentry->SetSource (m_ipv4->SourceAddressSelection (interfaceIdx, route->GetDest ()));
-          rtentry->SetGateway (route->GetGateway ());
-          rtentry->SetOutputDevice (m_ipv4->GetNetDevice (interfaceIdx));
-          if (masklen == 32)
+          route = j;
+          if (j->IsHost ())
             {
               break;
             }
         }
     }
+  if (route != 0)
+    {
+      uint32_t interfaceIdx = route->GetInterface ();
+      rtentry = Create<Ipv4Route> ();
+      rtentry->SetDestination (route->GetDest ());
+      rtentry->SetSource (m_ipv4->SourceAddressSelection (interfaceIdx, route->GetDest ()));
+      rtentry->SetGateway (route->GetGateway ());
+      rtentry->SetOutputDevice (m_ipv4->GetNetDevice (interfaceIdx));
+    }
   if (rtentry != 0)
     {
       NS_LOG_LOGIC ("Matching route via " << rtentry->GetGateway () << " at the end");
@@ -397,24 +401,20 @@ Ipv4StaticRouting::GetDefaultRoute ()
   Ipv4Address dest ("0.0.0.0");
   uint32_t shortest_metric = 0xffffffff;
   Ipv4RoutingTableEntry *result = 0;
-  for (NetworkRoutesI i = m_networkRoutes.begin (); 
-       i != m_networkRoutes.end (); 
-       i++) 
+  const Ipv4RoutingTableIndex::Routes *routes = m_networkIndex.Find (dest, Ipv4Mask::GetZero ());
+  if (routes != 0)
     {
-      Ipv4RoutingTableEntry *j = i->first;
-      uint32_t metric = i->second;
-      Ipv4Mask mask = (j)->GetDestNetworkMask ();
-      uint16_t masklen = mask.GetPrefixLength ();
-      if (masklen != 0)
-        {
-          continue;
-        }
-      if (metric > shortest_metric)
+      for (Ipv4RoutingTableIndex::Routes::const_iterator i = routes->begin ();
+           i != routes->end ();
+           i++)
         {
-          continue;
+          if (i->second > shortest_metric)
+            {
+              continue;
+            }
+          shortest_metric = i->second;
+          result = i->first;
         }
-      shortest_metric = metric;
-      result = j;
     }
   if (result)
     {
@@ -476,6 +476,7 @@ Ipv4StaticRouting::RemoveRoute (uint32_t index)
     {
       if (tmp == index)
         {
+          m_networkIndex.Remove (j->first);
           delete j->first;
           m_networkRoutes.erase (j);
           return;
@@ -485,6 +486,57 @@ Ipv4StaticRouting::RemoveRoute (uint32_t index)
   NS_ASSERT (false);
 }
 
+void
+Ipv4StaticRouting::SaveRoutes (std::ostream &os) const
+{
+  NS_LOG_FUNCTION (this << &os);
+  os << m_networkRoutes.size ();
+  for (NetworkRoutesCI j = m_networkRoutes.begin (); j != m_networkRoutes.end (); j++)
+    {
+      Ipv4RoutingTableEntry *route = j->first;
+      os << " " << route->GetDestNetwork ().Get ()
+         << " " << route->GetDestNetworkMask ().Get ()
+         << " " << route->IsGateway ()
+         << " " << route->GetGateway ().Get ()
+         << " " << route->GetInterface ()
+         << " " << j->second;
+    }
+}
+
+void
+Ipv4StaticRouting::RestoreRoutes (std::istream &is)
+{
+  NS_LOG_FUNCTION (this << &is);
+  std::size_t n;
+  if (!(is >> n))
+    {
+      NS_FATAL_ERROR ("Corrupted routes");
+    }
+  for (NetworkRoutesI j = m_networkRoutes.begin (); j != m_networkRoutes.end (); j++)
+    {
+      delete j->first;
+    }
+  m_networkRoutes.clear ();
+  m_networkIndex.Clear ();
+  for (std::size_t i = 0; i < n; i++)
+    {
+      uint32_t network, mask, gateway, interface, metric;
+      bool isGateway;
+      if (!(is >> network >> mask >> isGateway >> gateway >> interface >> metric))
+        {
+          NS_FATAL_ERROR ("Corrupted routes");
+        }
+      if (isGateway)
+        {
+          AddNetworkRouteTo (Ipv4Address (network), Ipv4Mask (mask), Ipv4Address (gateway), interface, metric);
+        }
+      else
+        {
+          AddNetworkRouteTo (Ipv4Address (network), Ipv4Mask (mask), interface, metric);
+        }
+    }
+}
+
 Ptr<Ipv4Route> 
 Ipv4StaticRouting::RouteOutput (Ptr<Packet> p, const Ipv4Header &header, Ptr<NetDevice> oif, Socket::SocketErrno &sockerr)
 {
@@ -604,6 +656,7 @@ Ipv4StaticRouting::DoDispose (void)
     {
       delete (j->first);
     }
+  m_networkIndex.Clear ();
   for (MulticastRoutesI i = m_multicastRoutes.begin (); 
        i != m_multicastRoutes.end (); 
        i = m_multicastRoutes.erase (i)) 
@@ -642,6 +695,7 @@ Ipv4StaticRouting::NotifyInterfaceDown (uint32_t i)
     {
       if (it->first->GetInterface () == i)
         {
+          m_networkIndex.Remove (it->first);
           delete it->first;
           it = m_networkRoutes.erase (it);
         }
@@ -689,6 +743,7 @@ Ipv4StaticRouting::NotifyRemoveAddress (uint32_t interface, Ipv4InterfaceAddress
           && it->first->GetDestNetwork () == networkAddress
           && it->first->GetDestNetworkMask () == networkMask)
         {
+          m_networkIndex.Remove (it->first);
           delete it->first;
           it = m_networkRoutes.erase (it);
         }
@@ -31,6 +31,7 @@
 #include "ns3/ptr.h"
 #include "ns3/ipv4.h"
 #include "ns3/ipv4-routing-protocol.h"
+#include "ns3/ipv4-routing-table-index.h"
 
 namespace ns3 {
 
@@ -230,6 +231,24 @@ public:
  */
   void RemoveRoute (uint32_t i);
 
+/**
+ * \brief Write the unicast routes and their metrics.
+ *
+ * This and RestoreRoutes () can be registered as a Checkpoint entry.
+ *
+ * \param os The output stream.
+ *
+ * \see Checkpoint::Register
+ */
+  void SaveRoutes (std::ostream &os) const;
+
+/**
+ * \brief Replace the unicast routes by those written by SaveRoutes ().
+ *
+ * \param is The input stream.
+ */
+  void RestoreRoutes (std::istream &is);
+
 /**
  * \brief Add a multicast route to the static routing table.
  *
@@ -407,6 +426,11 @@ private:
    */
   NetworkRoutes m_networkRoutes;
 
+  /**
+   * \brief the longest prefix match index of m_networkRoutes.
+   */
+  Ipv4RoutingTableIndex m_networkIndex;
+
   /**
    * \brief the forwarding table for multicast.
    */
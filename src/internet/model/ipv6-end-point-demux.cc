@@ -20,6 +20,7 @@
 
 #include "ipv6-end-point-demux.h"
 #include "ipv6-end-point.h"
+#include "ns3/assert.h"
 #include "ns3/log.h"
 
 namespace ns3 {
@@ -40,28 +41,113 @@ Ipv6EndPointDemux::~Ipv6EndPointDemux ()
   for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++)
     {
       Ipv6EndPoint *endPoint = *i;
+      endPoint->m_demux = 0;
       delete endPoint;
     }
   m_endPoints.clear ();
+  m_connected.clear ();
+  m_ports.clear ();
 }
 
-bool Ipv6EndPointDemux::LookupPortLocal (uint16_t port)
+bool Ipv6EndPointDemux::FourTuple::operator == (const FourTuple &other) const
 {
-  NS_LOG_FUNCTION (this << port);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++)
+  return localAddress == other.localAddress && peerAddress == other.peerAddress
+         && localPort == other.localPort && peerPort == other.peerPort;
+}
+
+std::size_t Ipv6EndPointDemux::FourTupleHash::operator () (const FourTuple &tuple) const
+{
+  Ipv6AddressHash hash;
+  return hash (tuple.localAddress) * 31 + hash (tuple.peerAddress)
+         + ((static_cast<std::size_t> (tuple.localPort) << 16) | tuple.peerPort) * 0x9e3779b97f4a7c15ULL;
+}
+
+bool Ipv6EndPointDemux::IsConnected (Ipv6EndPoint *endPoint)
+{
+  return endPoint->GetLocalAddress () != Ipv6Address::GetAny ()
+         && endPoint->GetPeerAddress () != Ipv6Address::GetAny ()
+         && endPoint->GetPeerPort () != 0;
+}
+
+Ipv6EndPoint* Ipv6EndPointDemux::Insert (Ipv6EndPoint *endPoint)
+{
+  NS_LOG_FUNCTION (this << endPoint);
+  endPoint->m_demux = this;
+  endPoint->m_demuxPosition = m_endPoints.insert (m_endPoints.end (), endPoint);
+  m_ports[endPoint->GetLocalPort ()].endPoints++;
+  Index (endPoint);
+  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
+  return endPoint;
+}
+
+void Ipv6EndPointDemux::Index (Ipv6EndPoint *endPoint)
+{
+  NS_LOG_FUNCTION (this << endPoint);
+  if (IsConnected (endPoint))
+    {
+      FourTuple tuple = { endPoint->GetLocalAddress (), endPoint->GetPeerAddress (),
+                          endPoint->GetLocalPort (), endPoint->GetPeerPort () };
+      m_connected.insert (std::make_pair (tuple, endPoint));
+    }
+  else
     {
-      if ((*i)->GetLocalPort  () == port)
+      m_ports[endPoint->GetLocalPort ()].wildcards.push_back (endPoint);
+    }
+}
+
+void Ipv6EndPointDemux::Unindex (Ipv6EndPoint *endPoint)
+{
+  NS_LOG_FUNCTION (this << endPoint);
+  if (IsConnected (endPoint))
+    {
+      FourTuple tuple = { endPoint->GetLocalAddress (), endPoint->GetPeerAddress (),
+                          endPoint->GetLocalPort (), endPoint->GetPeerPort () };
+      typedef std::unordered_multimap<FourTuple, Ipv6EndPoint *, FourTupleHash>::iterator ConnectedI;
+      std::pair<ConnectedI, ConnectedI> range = m_connected.equal_range (tuple);
+      for (ConnectedI i = range.first; i != range.second; i++)
         {
-          return true;
+          if (i->second == endPoint)
+            {
+              m_connected.erase (i);
+              return;
+            }
         }
+      NS_ASSERT_MSG (false, "End point " << endPoint << " is not indexed");
+    }
+  else
+    {
+      m_ports[endPoint->GetLocalPort ()].wildcards.remove (endPoint);
     }
-  return false;
+}
+
+void Ipv6EndPointDemux::FindConnected (const FourTuple &tuple, std::vector<Ipv6EndPoint *> &endPoints)
+{
+  typedef std::unordered_multimap<FourTuple, Ipv6EndPoint *, FourTupleHash>::iterator ConnectedI;
+  std::pair<ConnectedI, ConnectedI> range = m_connected.equal_range (tuple);
+  for (ConnectedI i = range.first; i != range.second; i++)
+    {
+      endPoints.push_back (i->second);
+    }
+}
+
+bool Ipv6EndPointDemux::LookupPortLocal (uint16_t port)
+{
+  NS_LOG_FUNCTION (this << port);
+  return m_ports.find (port) != m_ports.end ();
 }
 
 bool Ipv6EndPointDemux::LookupLocal (Ptr<NetDevice> boundNetDevice, Ipv6Address addr, uint16_t port)
 {
   NS_LOG_FUNCTION (this << addr << port);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++)
+  std::unordered_map<uint16_t, Port>::iterator p = m_ports.find (port);
+  if (p == m_ports.end ())
+    {
+      return false;
+    }
+  /* the connected end points are only indexed by four-tuple: look at
+     all the end points if the port has some */
+  EndPoints &endPoints = p->second.endPoints == p->second.wildcards.size () ? p->second.wildcards : m_endPoints;
+  for (EndPointsI i = endPoints.begin (); i != endPoints.end (); i++)
     {
       if ((*i)->GetLocalPort () == port &&
           (*i)->GetLocalAddress () == addr &&
@@ -82,10 +168,7 @@ Ipv6EndPoint* Ipv6EndPointDemux::Allocate ()
       NS_LOG_WARN ("Ephemeral port allocation failed.");
       return 0;
     }
-  Ipv6EndPoint *endPoint = new Ipv6EndPoint (Ipv6Address::GetAny (), port);
-  m_endPoints.push_back (endPoint);
-  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
-  return endPoint;
+  return Insert (new Ipv6EndPoint (Ipv6Address::GetAny (), port));
 }
 
 Ipv6EndPoint* Ipv6EndPointDemux::Allocate (Ipv6Address address)
@@ -97,10 +180,7 @@ Ipv6EndPoint* Ipv6EndPointDemux::Allocate (Ipv6Address address)
       NS_LOG_WARN ("Ephemeral port allocation failed.");
       return 0;
     }
-  Ipv6EndPoint *endPoint = new Ipv6EndPoint (address, port);
-  m_endPoints.push_back (endPoint);
-  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
-  return endPoint;
+  return Insert (new Ipv6EndPoint (address, port));
 }
 
 Ipv6EndPoint* Ipv6EndPointDemux::Allocate (Ptr<NetDevice> boundNetDevice, uint16_t port)
@@ -118,10 +198,7 @@ Ipv6EndPoint* Ipv6EndPointDemux::Allocate (Ptr<NetDevice> boundNetDevice, Ipv6Ad
       NS_LOG_WARN ("Duplicated endpoint.");
       return 0;
     }
-  Ipv6EndPoint *endPoint = new Ipv6EndPoint (address, port);
-  m_endPoints.push_back (endPoint);
-  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
-  return endPoint;
+  return Insert (new Ipv6EndPoint (address, port));
 }
 
 Ipv6EndPoint* Ipv6EndPointDemux::Allocate (Ptr<NetDevice> boundNetDevice,
@@ -129,7 +206,15 @@ Ipv6EndPoint* Ipv6EndPointDemux::Allocate (Ptr<NetDevice> boundNetDevice,
                                            Ipv6Address peerAddress, uint16_t peerPort)
 {
   NS_LOG_FUNCTION (this << boundNetDevice << localAddress << localPort << peerAddress << peerPort);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++)
+  std::vector<Ipv6EndPoint *> endPoints;
+  FourTuple tuple = { localAddress, peerAddress, localPort, peerPort };
+  FindConnected (tuple, endPoints);
+  std::unordered_map<uint16_t, Port>::iterator p = m_ports.find (localPort);
+  if (p != m_ports.end ())
+    {
+      endPoints.insert (endPoints.end (), p->second.wildcards.begin (), p->second.wildcards.end ());
+    }
+  for (std::vector<Ipv6EndPoint *>::iterator i = endPoints.begin (); i != endPoints.end (); i++)
     {
       if ((*i)->GetLocalPort () == localPort &&
           (*i)->GetLocalAddress () == localAddress &&
@@ -143,25 +228,25 @@ Ipv6EndPoint* Ipv6EndPointDemux::Allocate (Ptr<NetDevice> boundNetDevice,
     }
   Ipv6EndPoint *endPoint = new Ipv6EndPoint (localAddress, localPort);
   endPoint->SetPeer (peerAddress, peerPort);
-  m_endPoints.push_back (endPoint);
-
-  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
-
-  return endPoint;
+  return Insert (endPoint);
 }
 
 void Ipv6EndPointDemux::DeAllocate (Ipv6EndPoint *endPoint)
 {
   NS_LOG_FUNCTION (this);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++)
+  if (endPoint->m_demux != this)
     {
-      if (*i == endPoint)
-        {
-          delete endPoint;
-          m_endPoints.erase (i);
-          break;
-        }
+      return;
     }
+  Unindex (endPoint);
+  std::unordered_map<uint16_t, Port>::iterator p = m_ports.find (endPoint->GetLocalPort ());
+  if (--p->second.endPoints == 0)
+    {
+      m_ports.erase (p);
+    }
+  m_endPoints.erase (endPoint->m_demuxPosition);
+  endPoint->m_demux = 0;
+  delete endPoint;
 }
 
 /*
@@ -181,7 +266,22 @@ Ipv6EndPointDemux::EndPoints Ipv6EndPointDemux::Lookup (Ipv6Address daddr, uint1
   EndPoints retval4; /* Exact match on all 4 */
 
   NS_LOG_DEBUG ("Looking up endpoint for destination address " << daddr);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++)
+
+  /* The candidates are the connected end points of the four-tuple, and
+     the other end points of the local port. */
+  std::vector<Ipv6EndPoint *> endPoints;
+  if (!m_connected.empty ())
+    {
+      FourTuple tuple = { daddr, saddr, dport, sport };
+      FindConnected (tuple, endPoints);
+    }
+  std::unordered_map<uint16_t, Port>::iterator p = m_ports.find (dport);
+  if (p != m_ports.end ())
+    {
+      endPoints.insert (endPoints.end (), p->second.wildcards.begin (), p->second.wildcards.end ());
+    }
+
+  for (std::vector<Ipv6EndPoint *>::iterator i = endPoints.begin (); i != endPoints.end (); i++)
     {
       Ipv6EndPoint* endP = *i;
 
@@ -290,6 +390,20 @@ Ipv6EndPointDemux::EndPoints Ipv6EndPointDemux::Lookup (Ipv6Address daddr, uint1
 
 Ipv6EndPoint* Ipv6EndPointDemux::SimpleLookup (Ipv6Address dst, uint16_t dport, Ipv6Address src, uint16_t sport)
 {
+  /* a single connected end point of the four-tuple is the first exact
+     match: the other end points have a wildcard, which does not match
+     such a four-tuple */
+  if (dst != Ipv6Address::GetAny () && src != Ipv6Address::GetAny () && sport != 0)
+    {
+      FourTuple tuple = { dst, src, dport, sport };
+      std::vector<Ipv6EndPoint *> endPoints;
+      FindConnected (tuple, endPoints);
+      if (endPoints.size () == 1)
+        {
+          return endPoints.front ();
+        }
+    }
+
   uint32_t genericity = 3;
   Ipv6EndPoint *generic = 0;
 
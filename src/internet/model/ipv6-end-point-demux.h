@@ -23,6 +23,8 @@
 
 #include <stdint.h>
 #include <list>
+#include <unordered_map>
+#include <vector>
 #include "ns3/ipv6-address.h"
 #include "ipv6-interface.h"
 
@@ -34,6 +36,12 @@ class Ipv6EndPoint;
  * \ingroup ipv6
  *
  * \brief Demultiplexer for end points.
+ *
+ * The end points are indexed for the lookups: the connected end points
+ * (with a local address, a peer address and a peer port) by four-tuple in
+ * a hash table, and the other end points by local port, so that a lookup
+ * does not depend on the number of connections.  The end points update
+ * the index when their addresses change.
  */
 class Ipv6EndPointDemux
 {
@@ -153,12 +161,86 @@ public:
   EndPoints GetEndPoints () const;
 
 private:
+  friend class Ipv6EndPoint;
+
   /**
    * \brief Allocate a ephemeral port.
    * \return a port
    */
   uint16_t AllocateEphemeralPort ();
 
+  /**
+   * \brief Add a new end point to the demux.
+   * \param endPoint the end point
+   * \return the end point
+   */
+  Ipv6EndPoint *Insert (Ipv6EndPoint *endPoint);
+
+  /**
+   * \brief Index an end point by its four-tuple if it is connected, else
+   * by its local port.
+   * \param endPoint the end point
+   */
+  void Index (Ipv6EndPoint *endPoint);
+
+  /**
+   * \brief Remove an end point from the index.
+   * \param endPoint the end point
+   */
+  void Unindex (Ipv6EndPoint *endPoint);
+
+  /**
+   * \brief A four-tuple.
+   */
+  struct FourTuple
+  {
+    Ipv6Address localAddress; //!< the local address
+    Ipv6Address peerAddress;  //!< the peer address
+    uint16_t localPort;       //!< the local port
+    uint16_t peerPort;        //!< the peer port
+
+    /**
+     * \param other the other four-tuple
+     * \return true if the four-tuples are equal
+     */
+    bool operator == (const FourTuple &other) const;
+  };
+
+  /**
+   * \brief Hash function of the four-tuples.
+   */
+  struct FourTupleHash
+  {
+    /**
+     * \param tuple the four-tuple
+     * \return the hash of the four-tuple
+     */
+    std::size_t operator () (const FourTuple &tuple) const;
+  };
+
+  /**
+   * \brief The end points of a local port.
+   */
+  struct Port
+  {
+    uint32_t endPoints;  //!< the number of end points of the port
+    EndPoints wildcards; //!< the end points which are not connected
+  };
+
+  /**
+   * \param endPoint the end point
+   * \return true if the end point is connected, that is if it has a
+   * local address, a peer address and a peer port
+   */
+  static bool IsConnected (Ipv6EndPoint *endPoint);
+
+  /**
+   * \brief Add the connected end points of a four-tuple to a list.
+   * \param tuple the four-tuple
+   * \param endPoints the list
+   */
+  void FindConnected (const FourTuple &tuple, std::vector<Ipv6EndPoint *> &endPoints);
+
   /**
    * \brief The ephemeral port.
    */
@@ -178,6 +260,16 @@ private:
    * \brief A list of IPv6 end points.
    */
   EndPoints m_endPoints;
+
+  /**
+   * \brief The connected end points, by four-tuple.
+   */
+  std::unordered_multimap<FourTuple, Ipv6EndPoint *, FourTupleHash> m_connected;
+
+  /**
+   * \brief The end points, by local port.
+   */
+  std::unordered_map<uint16_t, Port> m_ports;
 };
 
 } /* namespace ns3 */
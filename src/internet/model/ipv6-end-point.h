@@ -22,6 +22,7 @@
 #define IPV6_END_POINT_H
 
 #include <stdint.h>
+#include <list>
 
 #include "ns3/ipv6-address.h"
 #include "ns3/callback.h"
@@ -33,6 +34,7 @@ namespace ns3
 {
 
 class Header;
+class Ipv6EndPointDemux;
 class Packet;
 
 /**
@@ -192,6 +194,8 @@ public:
   bool IsRxEnabled (void);
 
 private:
+  friend class Ipv6EndPointDemux;
+
   /**
    * \brief The local address.
    */
@@ -236,6 +240,16 @@ private:
    * \brief true if the endpoint can receive packets.
    */
   bool m_rxEnabled;
+
+  /**
+   * \brief The demux which indexes the endpoint, if any.
+   */
+  Ipv6EndPointDemux *m_demux;
+
+  /**
+   * \brief The position of the endpoint in the list of its demux.
+   */
+  std::list<Ipv6EndPoint *>::iterator m_demuxPosition;
 };
 
 } /* namespace ns3 */
@@ -572,10 +572,7 @@ void Ipv6ExtensionFragment::GetFragments (Ptr<Packet> packet, Ipv6Header ipv6Hea
         }
 
       ipv6Header.SetPayloadLength (fragment->GetSize ());
-
-      std::ostringstream oss;
-      oss << ipv6Header;
-      fragment->Print (oss);
+      NS_LOG_LOGIC ("New fragment " << ipv6Header << " " << *fragment);
 
       listFragments.emplace_back (fragment, ipv6Header);
     }
@@ -679,14 +676,13 @@ Ipv6ExtensionFragment::Fragments::~Fragments ()
 void Ipv6ExtensionFragment::Fragments::AddFragment (Ptr<Packet> fragment, uint16_t fragmentOffset, bool moreFragment)
 {
   NS_LOG_FUNCTION (this << fragment << fragmentOffset << moreFragment);
-  std::list<std::pair<Ptr<Packet>, uint16_t> >::iterator it;
+  // The fragments usually arrive in order: look for the place of the
+  // fragment from the end of the list
+  std::list<std::pair<Ptr<Packet>, uint16_t> >::iterator it = m_packetFragments.end ();
 
-  for (it = m_packetFragments.begin (); it != m_packetFragments.end (); it++)
+  while (it != m_packetFragments.begin () && std::prev (it)->second > fragmentOffset)
     {
-      if (it->second > fragmentOffset)
-        {
-          break;
-        }
+      it--;
     }
 
   if (it == m_packetFragments.end ())
@@ -0,0 +1,148 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ipv6-routing-table-index.h"
+#include "ipv6-routing-table-entry.h"
+#include "ns3/assert.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("Ipv6RoutingTableIndex");
+
+Ipv6RoutingTableIndex::Ipv6RoutingTableIndex ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+uint32_t
+Ipv6RoutingTableIndex::GetPosition (Ipv6Prefix prefix) const
+{
+  uint32_t position = 0;
+  while (position < m_prefixes.size () && m_prefixes[position].prefix != prefix)
+    {
+      position++;
+    }
+  return position;
+}
+
+void
+Ipv6RoutingTableIndex::Add (Ipv6RoutingTableEntry *route, uint32_t metric)
+{
+  NS_LOG_FUNCTION (this << route << metric);
+  Ipv6Prefix prefix = route->GetDestNetworkPrefix ();
+  uint32_t position = GetPosition (prefix);
+  if (position == m_prefixes.size ())
+    {
+      uint8_t length = prefix.GetPrefixLength ();
+      position = 0;
+      while (position < m_prefixes.size () && m_prefixes[position].length >= length)
+        {
+          position++;
+        }
+      Prefix p;
+      p.prefix = prefix;
+      p.length = length;
+      m_prefixes.insert (m_prefixes.begin () + position, p);
+    }
+  Networks &networks = m_prefixes[position].networks;
+  networks[route->GetDestNetwork ().CombinePrefix (prefix)].push_back (std::make_pair (route, metric));
+}
+
+void
+Ipv6RoutingTableIndex::Remove (Ipv6RoutingTableEntry *route)
+{
+  NS_LOG_FUNCTION (this << route);
+  Ipv6Prefix prefix = route->GetDestNetworkPrefix ();
+  uint32_t position = GetPosition (prefix);
+  NS_ASSERT_MSG (position < m_prefixes.size (), "Prefix " << prefix << " is not in the index");
+  Networks &networks = m_prefixes[position].networks;
+  Networks::iterator network = networks.find (route->GetDestNetwork ().CombinePrefix (prefix));
+  NS_ASSERT_MSG (network != networks.end (), "Route " << *route << " is not in the index");
+  Routes &routes = network->second;
+  for (Routes::iterator i = routes.begin (); i != routes.end (); i++)
+    {
+      if (i->first == route)
+        {
+          routes.erase (i);
+          break;
+        }
+    }
+  if (!routes.empty ())
+    {
+      return;
+    }
+  networks.erase (network);
+  if (networks.empty ())
+    {
+      m_prefixes.erase (m_prefixes.begin () + position);
+    }
+}
+
+void
+Ipv6RoutingTableIndex::Clear (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_prefixes.clear ();
+}
+
+const Ipv6RoutingTableIndex::Routes *
+Ipv6RoutingTableIndex::Find (Ipv6Address network, Ipv6Prefix prefix) const
+{
+  uint32_t position = GetPosition (prefix);
+  if (position == m_prefixes.size ())
+    {
+      return 0;
+    }
+  const Networks &networks = m_prefixes[position].networks;
+  Networks::const_iterator i = networks.find (network.CombinePrefix (prefix));
+  return i != networks.end () ? &i->second : 0;
+}
+
+const Ipv6RoutingTableIndex::Routes *
+Ipv6RoutingTableIndex::Lookup (Ipv6Address dest, uint32_t &position) const
+{
+  while (position < m_prefixes.size ())
+    {
+      const Prefix &prefix = m_prefixes[position++];
+      Networks::const_iterator i = prefix.networks.find (dest.CombinePrefix (prefix.prefix));
+      if (i != prefix.networks.end ())
+        {
+          return &i->second;
+        }
+    }
+  return 0;
+}
+
+std::size_t
+Ipv6RoutingTableIndex::GetMemoryUsage (void) const
+{
+  // a node of the hash tables holds its value, the next node, and the
+  // cached hash of its key
+  std::size_t node = sizeof (Networks::value_type) + sizeof (void *) + sizeof (std::size_t);
+  std::size_t memory = sizeof (*this) + m_prefixes.capacity () * sizeof (Prefix);
+  for (std::vector<Prefix>::const_iterator i = m_prefixes.begin (); i != m_prefixes.end (); i++)
+    {
+      memory += i->networks.bucket_count () * sizeof (void *) + i->networks.size () * node;
+      for (Networks::const_iterator j = i->networks.begin (); j != i->networks.end (); j++)
+        {
+          memory += j->second.capacity () * sizeof (Route);
+        }
+    }
+  return memory;
+}
+
+} // namespace ns3
@@ -0,0 +1,126 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef IPV6_ROUTING_TABLE_INDEX_H
+#define IPV6_ROUTING_TABLE_INDEX_H
+
+#include <stdint.h>
+#include <cstddef>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "ns3/ipv6-address.h"
+
+namespace ns3 {
+
+class Ipv6RoutingTableEntry;
+
+/**
+ * \ingroup ipv6Routing
+ *
+ * \brief Longest prefix match index of the unicast routes of
+ * Ipv6StaticRouting.
+ *
+ * The index keeps one hash table of networks per prefix in use, the
+ * prefixes being sorted from the longest to the shortest.  A lookup
+ * probes the hash tables from the longest prefix, which is a few
+ * probes for the routes of the usual topologies (host routes, routes
+ * to the links, default route), whatever the number of routes.  The
+ * routes of a network are kept in the order of their insertion, so
+ * that Ipv6StaticRouting breaks the ties as with its route list.
+ *
+ * The index does not own the routes: Ipv6StaticRouting adds and
+ * removes them along with its route list.
+ */
+class Ipv6RoutingTableIndex
+{
+public:
+  /// A route and its metric
+  typedef std::pair<Ipv6RoutingTableEntry *, uint32_t> Route;
+  /// The routes of a network, in the order of their insertion
+  typedef std::vector<Route> Routes;
+
+  Ipv6RoutingTableIndex ();
+
+  /**
+   * \brief Add a route after the other routes of its network.
+   * \param route the route
+   * \param metric the metric of the route
+   */
+  void Add (Ipv6RoutingTableEntry *route, uint32_t metric = 0);
+  /**
+   * \brief Remove a route.
+   * \param route the route, which must be in the index
+   */
+  void Remove (Ipv6RoutingTableEntry *route);
+  /**
+   * \brief Remove all the routes.
+   */
+  void Clear (void);
+  /**
+   * \param network the network
+   * \param prefix the prefix of the network
+   * \returns the routes of the network, or 0 if there is none
+   */
+  const Routes *Find (Ipv6Address network, Ipv6Prefix prefix) const;
+  /**
+   * \brief Get the routes of the next network which matches a destination.
+   *
+   * The first call, with a position of 0, returns the routes of the
+   * longest matching prefix; the next calls return those of the
+   * shorter matching prefixes.
+   *
+   * \param dest the destination
+   * \param [in,out] position the position of the lookup in the prefixes
+   * \returns the routes of the network, or 0 if no other network matches
+   */
+  const Routes *Lookup (Ipv6Address dest, uint32_t &position) const;
+  /**
+   * \brief Get the memory used by the index.
+   *
+   * The memory is estimated from the sizes and capacities of the
+   * containers, without the overhead of the allocator, and without
+   * the routes themselves.
+   *
+   * \returns the memory used by the index, in bytes
+   */
+  std::size_t GetMemoryUsage (void) const;
+
+private:
+  /// The routes of each network of a prefix
+  typedef std::unordered_map<Ipv6Address, Routes, Ipv6AddressHash> Networks;
+
+  /// A prefix in use, and its networks
+  struct Prefix
+  {
+    Ipv6Prefix prefix;    //!< the prefix
+    uint8_t length;       //!< the length of the prefix
+    Networks networks;    //!< the routes of each network
+  };
+
+  /**
+   * \param prefix the prefix
+   * \returns the position of the prefix, or the number of prefixes if
+   * it is not in use
+   */
+  uint32_t GetPosition (Ipv6Prefix prefix) const;
+
+  std::vector<Prefix> m_prefixes; //!< the prefixes in use, from the longest
+};
+
+} // namespace ns3
+
+#endif /* IPV6_ROUTING_TABLE_INDEX_H */
@@ -163,6 +163,7 @@ void Ipv6StaticRouting::AddNetworkRouteTo (Ipv6Address network, Ipv6Prefix netwo
     {
       Ipv6RoutingTableEntry* routePtr = new Ipv6RoutingTableEntry (route);
       m_networkRoutes.push_back (std::make_pair (routePtr, metric));
+      m_networkIndex.Add (routePtr, metric);
     }
 }
 
@@ -179,6 +180,7 @@ void Ipv6StaticRouting::AddNetworkRouteTo (Ipv6Address network, Ipv6Prefix netwo
     {
       Ipv6RoutingTableEntry* routePtr = new Ipv6RoutingTableEntry (route);
       m_networkRoutes.push_back (std::make_pair (routePtr, metric));
+      m_networkIndex.Add (routePtr, metric);
     }
 }
 
@@ -191,6 +193,7 @@ void Ipv6StaticRouting::AddNetworkRouteTo (Ipv6Address network, Ipv6Prefix netwo
     {
       Ipv6RoutingTableEntry* routePtr = new Ipv6RoutingTableEntry (route);
       m_networkRoutes.push_back (std::make_pair (routePtr, metric));
+      m_networkIndex.Add (routePtr, metric);
     }
 }
 
@@ -216,6 +219,7 @@ void Ipv6StaticRouting::SetDefaultMulticastRoute (uint32_t outputInterface)
   Ipv6Prefix networkMask = Ipv6Prefix (8);
   *route = Ipv6RoutingTableEntry::CreateNetworkRouteTo (network, networkMask, outputInterface);
   m_networkRoutes.push_back (std::make_pair (route, 0));
+  m_networkIndex.Add (route, 0);
 }
 
 uint32_t Ipv6StaticRouting::GetNMulticastRoutes () const
@@ -284,15 +288,16 @@ bool Ipv6StaticRouting::HasNetworkDest (Ipv6Address network, uint32_t interfaceI
   NS_LOG_FUNCTION (this << network << interfaceIndex);
 
   /* in the network table */
-  for (NetworkRoutesI j = m_networkRoutes.begin (); j != m_networkRoutes.end (); j++)
+  uint32_t position = 0;
+  const Ipv6RoutingTableIndex::Routes *routes;
+  while ((routes = m_networkIndex.Lookup (network, position)) != 0)
     {
-      Ipv6RoutingTableEntry* rtentry = j->first;
-      Ipv6Prefix prefix = rtentry->GetDestNetworkPrefix ();
-      Ipv6Address entry = rtentry->GetDestNetwork ();
-
-      if (prefix.IsMatch (network, entry) && rtentry->GetInterface () == interfaceIndex)
+      for (Ipv6RoutingTableIndex::Routes::const_iterator j = routes->begin (); j != routes->end (); j++)
         {
-          return true;
+          if (j->first->GetInterface () == interfaceIndex)
+            {
+              return true;
+            }
         }
     }
 
@@ -302,12 +307,17 @@ bool Ipv6StaticRouting::HasNetworkDest (Ipv6Address network, uint32_t interfaceI
 
 bool Ipv6StaticRouting::LookupRoute (const Ipv6RoutingTableEntry &route, uint32_t metric)
 {
-  for (NetworkRoutesI j = m_networkRoutes.begin (); j != m_networkRoutes.end (); j++)
+  const Ipv6RoutingTableIndex::Routes *routes =
+    m_networkIndex.Find (route.GetDest (), route.GetDestNetworkPrefix ());
+  if (routes == 0)
+    {
+      return false;
+    }
+  for (Ipv6RoutingTableIndex::Routes::const_iterator j = routes->begin (); j != routes->end (); j++)
     {
       Ipv6RoutingTableEntry* rtentry = j->first;
 
       if (rtentry->GetDest () == route.GetDest () &&
-          rtentry->GetDestNetworkPrefix () == route.GetDestNetworkPrefix () &&
           rtentry->GetGateway () == route.GetGateway () &&
           rtentry->GetInterface () == route.GetInterface () &&
           rtentry->GetPrefixToUse () == route.GetPrefixToUse () &&
@@ -323,7 +333,6 @@ Ptr<Ipv6Route> Ipv6StaticRouting::LookupStatic (Ipv6Address dst, Ptr<NetDevice>
 {
   NS_LOG_FUNCTION (this << dst << interface);
   Ptr<Ipv6Route> rtentry = 0;
-  uint16_t longestMask = 0;
   uint32_t shortestMetric = 0xffffffff;
 
   /* when sending on link-local multicast, there have to be interface specified */
@@ -338,68 +347,63 @@ Ptr<Ipv6Route> Ipv6StaticRouting::LookupStatic (Ipv6Address dst, Ptr<NetDevice>
       return rtentry;
     }
 
-  for (NetworkRoutesI it = m_networkRoutes.begin (); it != m_networkRoutes.end (); it++)
+  /* the index returns the matching networks from the longest prefix:
+   * the first one with a route on the requested interface wins */
+  Ipv6RoutingTableEntry* route = 0;
+  uint32_t position = 0;
+  const Ipv6RoutingTableIndex::Routes *routes;
+  while (route == 0 && (routes = m_networkIndex.Lookup (dst, position)) != 0)
     {
-      Ipv6RoutingTableEntry* j = it->first;
-      uint32_t metric = it->second;
-      Ipv6Prefix mask = j->GetDestNetworkPrefix ();
-      uint16_t maskLen = mask.GetPrefixLength ();
-      Ipv6Address entry = j->GetDestNetwork ();
-
-      NS_LOG_LOGIC ("Searching for route to " << dst << ", mask length " << maskLen << ", metric " << metric);
-
-      if (mask.IsMatch (dst, entry))
+      for (Ipv6RoutingTableIndex::Routes::const_iterator it = routes->begin (); it != routes->end (); it++)
         {
+          Ipv6RoutingTableEntry* j = it->first;
+          uint32_t metric = it->second;
+          uint16_t maskLen = j->GetDestNetworkPrefix ().GetPrefixLength ();
+
           NS_LOG_LOGIC ("Found global network route " << *j << ", mask length " << maskLen << ", metric " << metric);
 
           /* if interface is given, check the route will output on this interface */
-          if (!interface || interface == m_ipv6->GetNetDevice (j->GetInterface ()))
+          if (interface && interface != m_ipv6->GetNetDevice (j->GetInterface ()))
             {
-              if (maskLen < longestMask)
-                {
-                  NS_LOG_LOGIC ("Previous match longer, skipping");
-                  continue;
-                }
-
-              if (maskLen > longestMask)
-                {
-                  shortestMetric = 0xffffffff;
-                }
+              continue;
+            }
 
-              longestMask = maskLen;
-              if (metric > shortestMetric)
-                {
-                  NS_LOG_LOGIC ("Equal mask length, but previous metric shorter, skipping");
-                  continue;
-                }
+          if (metric > shortestMetric)
+            {
+              NS_LOG_LOGIC ("Equal mask length, but previous metric shorter, skipping");
+              continue;
+            }
 
-              shortestMetric = metric;
-              Ipv6RoutingTableEntry* route = j;
-              uint32_t interfaceIdx = route->GetInterface ();
-              rtentry = Create<Ipv6Route> ();
+          shortestMetric = metric;
+          route = j;
+          if (maskLen == 128)
+            {
+              break;
+            }
+        }
+    }
 
-              if (route->GetGateway ().IsAny ())
-                {
-                  rtentry->SetSource (m_ipv6->SourceAddressSelection (interfaceIdx, route->GetDest ()));
-                }
-              else if (route->GetDest ().IsAny ()) /* default route */
-                {
-                  rtentry->SetSource (m_ipv6->SourceAddressSelection (interfaceIdx, route->GetPrefixToUse ().IsAny () ? dst : route->GetPrefixToUse ()));
-                }
-              else
-                {
-                  rtentry->SetSource (m_ipv6->SourceAddressSelection (interfaceIdx, route->GetGateway ()));
-                }
+  if (route)
+    {
+      uint32_t interfaceIdx = route->GetInterface ();
+      rtentry = Create<Ipv6Route> ();
 
-              rtentry->SetDestination (route->GetDest ());
-              rtentry->SetGateway (route->GetGateway ());
-              rtentry->SetOutputDevice (m_ipv6->GetNetDevice (interfaceIdx));
-              if (maskLen == 128)
-                {
-                  break;
-                }
-            }
+      if (route->GetGateway ().IsAny ())
+        {
+          rtentry->SetSource (m_ipv6->SourceAddressSelection (interfaceIdx, route->GetDest ()));
+        }
+      else if (route->GetDest ().IsAny ()) /* default route */
+        {
+          rtentry->SetSource (m_ipv6->SourceAddressSelection (interfaceIdx, route->GetPrefixToUse ().IsAny () ? dst : route->GetPrefixToUse ()));
+        }
+      else
+        {
+          rtentry->SetSource (m_ipv6->SourceAddressSelection (interfaceIdx, route->GetGateway ()));
         }
+
+      rtentry->SetDestination (route->GetDest ());
+      rtentry->SetGateway (route->GetGateway ());
+      rtentry->SetOutputDevice (m_ipv6->GetNetDevice (interfaceIdx));
     }
 
   if (rtentry)
@@ -418,6 +422,7 @@ void Ipv6StaticRouting::DoDispose ()
       delete j->first;
     }
   m_networkRoutes.clear ();
+  m_networkIndex.Clear ();
 
   for (MulticastRoutesI i = m_multicastRoutes.begin (); i != m_multicastRoutes.end (); i = m_multicastRoutes.erase (i))
     {
@@ -483,6 +488,11 @@ uint32_t Ipv6StaticRouting::GetNRoutes () const
   return m_networkRoutes.size ();
 }
 
+std::size_t Ipv6StaticRouting::GetIndexMemoryUsage () const
+{
+  return m_networkIndex.GetMemoryUsage ();
+}
+
 Ipv6RoutingTableEntry Ipv6StaticRouting::GetDefaultRoute ()
 {
   NS_LOG_FUNCTION (this);
@@ -566,6 +576,7 @@ void Ipv6StaticRouting::RemoveRoute (uint32_t index)
     {
       if (tmp == index)
         {
+          m_networkIndex.Remove (it->first);
           delete it->first;
           m_networkRoutes.erase (it);
           return;
@@ -585,6 +596,7 @@ void Ipv6StaticRouting::RemoveRoute (Ipv6Address network, Ipv6Prefix prefix, uin
       if (network == rtentry->GetDest () && rtentry->GetInterface () == ifIndex
           && rtentry->GetPrefixToUse () == prefixToUse)
         {
+          m_networkIndex.Remove (it->first);
           delete it->first;
           m_networkRoutes.erase (it);
           return;
@@ -715,6 +727,7 @@ void Ipv6StaticRouting::NotifyInterfaceDown (uint32_t i)
     {
       if (it->first->GetInterface () == i)
         {
+          m_networkIndex.Remove (it->first);
           delete it->first;
           it = m_networkRoutes.erase (it);
         }
@@ -752,6 +765,7 @@ void Ipv6StaticRouting::NotifyRemoveAddress (uint32_t interface, Ipv6InterfaceAd
           && it->first->GetDestNetwork () == networkAddress
           && it->first->GetDestNetworkPrefix () == networkMask)
         {
+          m_networkIndex.Remove (it->first);
           delete it->first;
           it = m_networkRoutes.erase (it);
         }
@@ -800,6 +814,7 @@ void Ipv6StaticRouting::NotifyRemoveRoute (Ipv6Address dst, Ipv6Prefix mask, Ipv
 
           if (dst == entry && prefix == mask && rtentry->GetInterface () == interface)
             {
+              m_networkIndex.Remove (j->first);
               delete j->first;
               j = m_networkRoutes.erase (j);
             }
@@ -30,6 +30,7 @@
 #include "ns3/ipv6.h"
 #include "ns3/ipv6-header.h"
 #include "ns3/ipv6-routing-protocol.h"
+#include "ns3/ipv6-routing-table-index.h"
 
 namespace ns3 {
 
@@ -135,6 +136,13 @@ public:
    */
   uint32_t GetNRoutes () const;
 
+  /**
+   * \brief Get the memory used by the lookup index of the routing table.
+   * \return the memory used by the index, in bytes
+   * \see Ipv6RoutingTableIndex::GetMemoryUsage
+   */
+  std::size_t GetIndexMemoryUsage () const;
+
   /**
    * \brief Get the default route.
    *
@@ -294,6 +302,11 @@ private:
    */
   NetworkRoutes m_networkRoutes;
 
+  /**
+   * \brief the longest prefix match index of the network routes.
+   */
+  Ipv6RoutingTableIndex m_networkIndex;
+
   /**
    * \brief the forwarding table for multicast.
    */
@@ -0,0 +1,208 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/ipv4-end-point.h"
+#include "ns3/ipv4-end-point-demux.h"
+#include "ns3/ipv4-interface.h"
+#include "ns3/ipv4-interface-address.h"
+#include "ns3/ipv6-end-point.h"
+#include "ns3/ipv6-end-point-demux.h"
+#include "ns3/ipv6-interface.h"
+#include "ns3/test.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Ipv4EndPointDemux lookups of connected and listening end points.
+ */
+class Ipv4EndPointDemuxTestCase : public TestCase
+{
+public:
+  Ipv4EndPointDemuxTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * \param demux the demux
+   * \param daddr the destination address
+   * \param dport the destination port
+   * \param saddr the source address
+   * \param sport the source port
+   * \returns the end point of the packet, or 0 if none
+   */
+  Ipv4EndPoint *Lookup (Ipv4EndPointDemux &demux, Ipv4Address daddr, uint16_t dport,
+                        Ipv4Address saddr, uint16_t sport);
+
+  Ptr<Ipv4Interface> m_interface; //!< the incoming interface
+};
+
+Ipv4EndPointDemuxTestCase::Ipv4EndPointDemuxTestCase ()
+  : TestCase ("Check the most specific match of the Ipv4EndPointDemux")
+{
+}
+
+Ipv4EndPoint *
+Ipv4EndPointDemuxTestCase::Lookup (Ipv4EndPointDemux &demux, Ipv4Address daddr, uint16_t dport,
+                                   Ipv4Address saddr, uint16_t sport)
+{
+  Ipv4EndPointDemux::EndPoints endPoints = demux.Lookup (daddr, dport, saddr, sport, m_interface);
+  return endPoints.empty () ? 0 : endPoints.front ();
+}
+
+void
+Ipv4EndPointDemuxTestCase::DoRun (void)
+{
+  m_interface = CreateObject<Ipv4Interface> ();
+  m_interface->AddAddress (Ipv4InterfaceAddress ("10.0.0.1", "255.255.255.0"));
+
+  Ipv4EndPointDemux demux;
+  Ipv4EndPoint *listening = demux.Allocate (0, Ipv4Address::GetAny (), 80);
+  Ipv4EndPoint *local = demux.Allocate (0, "10.0.0.1", 80);
+  Ipv4EndPoint *connected = demux.Allocate (0, "10.0.0.1", 80, "11.0.0.1", 1024);
+  Ipv4EndPoint *subnet = demux.Allocate (0, "10.0.0.0", 80, "11.0.0.2", 1024);
+  NS_TEST_ASSERT_MSG_NE (connected, 0, "End point not allocated");
+  NS_TEST_EXPECT_MSG_EQ (demux.Allocate (0, "10.0.0.1", 80, "11.0.0.1", 1024), 0, "Duplicated end point");
+  NS_TEST_EXPECT_MSG_EQ (demux.Allocate (0, "10.0.0.1", 80), 0, "Duplicated end point");
+
+  // the most specific match
+  NS_TEST_EXPECT_MSG_EQ (Lookup (demux, "10.0.0.1", 80, "11.0.0.1", 1024), connected, "Wrong end point");
+  NS_TEST_EXPECT_MSG_EQ (Lookup (demux, "10.0.0.1", 80, "11.0.0.1", 1025), local, "Wrong end point");
+  NS_TEST_EXPECT_MSG_EQ (Lookup (demux, "10.0.0.2", 80, "11.0.0.1", 1024), listening, "Wrong end point");
+  NS_TEST_EXPECT_MSG_EQ (Lookup (demux, "10.0.0.1", 81, "11.0.0.1", 1024), 0, "Wrong end point");
+  // the subnet-directed broadcast
+  NS_TEST_EXPECT_MSG_EQ (Lookup (demux, "10.0.0.255", 80, "11.0.0.2", 1024), subnet, "Wrong end point");
+  NS_TEST_EXPECT_MSG_EQ (Lookup (demux, "10.0.0.255", 80, "11.0.0.1", 1024), listening, "Wrong end point");
+  NS_TEST_EXPECT_MSG_EQ (demux.SimpleLookup ("10.0.0.1", 80, "11.0.0.1", 1024), connected, "Wrong end point");
+
+  // the end points which can not receive are skipped
+  connected->SetRxEnabled (false);
+  NS_TEST_EXPECT_MSG_EQ (Lookup (demux, "10.0.0.1", 80, "11.0.0.1", 1024), local, "Wrong end point");
+  connected->SetRxEnabled (true);
+
+  // an end point is indexed again when it connects
+  Ipv4EndPoint *client = demux.Allocate ();
+  uint16_t port = client->GetLocalPort ();
+  NS_TEST_EXPECT_MSG_EQ (demux.LookupPortLocal (port), true, "Ephemeral port not allocated");
+  NS_TEST_EXPECT_MSG_EQ (Lookup (demux, "10.0.0.1", port, "12.0.0.1", 80), client, "Wrong end point");
+  client->SetLocalAddress ("10.0.0.1");
+  client->SetPeer ("12.0.0.1", 80);
+  NS_TEST_EXPECT_MSG_EQ (Lookup (demux, "10.0.0.1", port, "12.0.0.1", 80), client, "Wrong end point");
+  NS_TEST_EXPECT_MSG_EQ (Lookup (demux, "10.0.0.1", port, "12.0.0.2", 80), 0, "Wrong end point");
+  NS_TEST_EXPECT_MSG_EQ (demux.LookupLocal (0, "10.0.0.1", port), true, "Connected end point not found");
+  NS_TEST_EXPECT_MSG_NE (demux.Allocate ()->GetLocalPort (), port, "Ephemeral port allocated twice");
+
+  demux.DeAllocate (connected);
+  NS_TEST_EXPECT_MSG_EQ (Lookup (demux, "10.0.0.1", 80, "11.0.0.1", 1024), local, "End point not removed");
+  demux.DeAllocate (client);
+  NS_TEST_EXPECT_MSG_EQ (demux.LookupPortLocal (port), false, "End point not removed");
+  NS_TEST_EXPECT_MSG_EQ (demux.GetAllEndPoints ().size (), 4, "Wrong number of end points");
+  m_interface = 0;
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Ipv6EndPointDemux lookups of connected and listening end points.
+ */
+class Ipv6EndPointDemuxTestCase : public TestCase
+{
+public:
+  Ipv6EndPointDemuxTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * \param demux the demux
+   * \param daddr the destination address
+   * \param dport the destination port
+   * \param saddr the source address
+   * \param sport the source port
+   * \returns the end point of the packet, or 0 if none
+   */
+  Ipv6EndPoint *Lookup (Ipv6EndPointDemux &demux, Ipv6Address daddr, uint16_t dport,
+                        Ipv6Address saddr, uint16_t sport);
+};
+
+Ipv6EndPointDemuxTestCase::Ipv6EndPointDemuxTestCase ()
+  : TestCase ("Check the most specific match of the Ipv6EndPointDemux")
+{
+}
+
+Ipv6EndPoint *
+Ipv6EndPointDemuxTestCase::Lookup (Ipv6EndPointDemux &demux, Ipv6Address daddr, uint16_t dport,
+                                   Ipv6Address saddr, uint16_t sport)
+{
+  Ipv6EndPointDemux::EndPoints endPoints = demux.Lookup (daddr, dport, saddr, sport, 0);
+  return endPoints.empty () ? 0 : endPoints.front ();
+}
+
+void
+Ipv6EndPointDemuxTestCase::DoRun (void)
+{
+  Ipv6EndPointDemux demux;
+  Ipv6EndPoint *listening = demux.Allocate (0, Ipv6Address::GetAny (), 80);
+  Ipv6EndPoint *local = demux.Allocate (0, "2001::1", 80);
+  Ipv6EndPoint *connected = demux.Allocate (0, "2001::1", 80, "2001:1::1", 1024);
+  NS_TEST_ASSERT_MSG_NE (connected, 0, "End point not allocated");
+  NS_TEST_EXPECT_MSG_EQ (demux.Allocate (0, "2001::1", 80, "2001:1::1", 1024), 0, "Duplicated end point");
+  NS_TEST_EXPECT_MSG_EQ (demux.Allocate (0, "2001::1", 80), 0, "Duplicated end point");
+
+  // the most specific match
+  NS_TEST_EXPECT_MSG_EQ (Lookup (demux, "2001::1", 80, "2001:1::1", 1024), connected, "Wrong end point");
+  NS_TEST_EXPECT_MSG_EQ (Lookup (demux, "2001::1", 80, "2001:1::1", 1025), local, "Wrong end point");
+  NS_TEST_EXPECT_MSG_EQ (Lookup (demux, "2001::2", 80, "2001:1::1", 1024), listening, "Wrong end point");
+  NS_TEST_EXPECT_MSG_EQ (Lookup (demux, "2001::1", 81, "2001:1::1", 1024), 0, "Wrong end point");
+  NS_TEST_EXPECT_MSG_EQ (demux.SimpleLookup ("2001::1", 80, "2001:1::1", 1024), connected, "Wrong end point");
+
+  // an end point is indexed again when it connects
+  Ipv6EndPoint *client = demux.Allocate ();
+  uint16_t port = client->GetLocalPort ();
+  NS_TEST_EXPECT_MSG_EQ (Lookup (demux, "2001::1", port, "2001:2::1", 80), client, "Wrong end point");
+  client->SetLocalAddress ("2001::1");
+  client->SetPeer ("2001:2::1", 80);
+  NS_TEST_EXPECT_MSG_EQ (Lookup (demux, "2001::1", port, "2001:2::1", 80), client, "Wrong end point");
+  NS_TEST_EXPECT_MSG_EQ (Lookup (demux, "2001::1", port, "2001:2::2", 80), 0, "Wrong end point");
+  NS_TEST_EXPECT_MSG_EQ (demux.LookupLocal (0, "2001::1", port), true, "Connected end point not found");
+
+  demux.DeAllocate (connected);
+  NS_TEST_EXPECT_MSG_EQ (Lookup (demux, "2001::1", 80, "2001:1::1", 1024), local, "End point not removed");
+  demux.DeAllocate (client);
+  NS_TEST_EXPECT_MSG_EQ (demux.LookupPortLocal (port), false, "End point not removed");
+  NS_TEST_EXPECT_MSG_EQ (demux.GetEndPoints ().size (), 2, "Wrong number of end points");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief End point demux TestSuite
+ */
+class EndPointDemuxTestSuite : public TestSuite
+{
+public:
+  EndPointDemuxTestSuite ()
+    : TestSuite ("end-point-demux", UNIT)
+  {
+    AddTestCase (new Ipv4EndPointDemuxTestCase (), TestCase::QUICK);
+    AddTestCase (new Ipv6EndPointDemuxTestCase (), TestCase::QUICK);
+  }
+};
+
+static EndPointDemuxTestSuite g_endPointDemuxTestSuite; //!< Static variable for test initialization
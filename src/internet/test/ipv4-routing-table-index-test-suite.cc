@@ -0,0 +1,261 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/boolean.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4.h"
+#include "ns3/ipv4-global-routing.h"
+#include "ns3/ipv4-route.h"
+#include "ns3/ipv4-routing-table-entry.h"
+#include "ns3/ipv4-routing-table-index.h"
+#include "ns3/ipv4-static-routing.h"
+#include "ns3/node.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/simulator.h"
+#include "ns3/test.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Ipv4RoutingTableIndex lookups, additions and removals.
+ */
+class Ipv4RoutingTableIndexTestCase : public TestCase
+{
+public:
+  Ipv4RoutingTableIndexTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * \param index the index
+   * \param dest the destination
+   * \returns the prefix lengths of the prefixes which match dest
+   */
+  std::vector<uint16_t> Lookup (const Ipv4RoutingTableIndex &index, Ipv4Address dest);
+};
+
+Ipv4RoutingTableIndexTestCase::Ipv4RoutingTableIndexTestCase ()
+  : TestCase ("Check the longest prefix match of the Ipv4RoutingTableIndex")
+{
+}
+
+std::vector<uint16_t>
+Ipv4RoutingTableIndexTestCase::Lookup (const Ipv4RoutingTableIndex &index, Ipv4Address dest)
+{
+  std::vector<uint16_t> lengths;
+  uint32_t position = 0;
+  const Ipv4RoutingTableIndex::Routes *routes;
+  while ((routes = index.Lookup (dest, position)) != 0)
+    {
+      lengths.push_back (routes->front ().first->GetDestNetworkMask ().GetPrefixLength ());
+    }
+  return lengths;
+}
+
+void
+Ipv4RoutingTableIndexTestCase::DoRun (void)
+{
+  Ipv4RoutingTableEntry slash0 = Ipv4RoutingTableEntry::CreateDefaultRoute ("10.0.0.1", 1);
+  Ipv4RoutingTableEntry slash16 =
+    Ipv4RoutingTableEntry::CreateNetworkRouteTo ("10.1.0.0", "255.255.0.0", "10.0.0.2", 1);
+  // the network of a route does not have to be masked
+  Ipv4RoutingTableEntry slash24 =
+    Ipv4RoutingTableEntry::CreateNetworkRouteTo ("10.1.2.3", "255.255.255.0", "10.0.0.3", 1);
+  Ipv4RoutingTableEntry slash24b =
+    Ipv4RoutingTableEntry::CreateNetworkRouteTo ("10.1.2.0", "255.255.255.0", "10.0.0.4", 2);
+  Ipv4RoutingTableEntry slash32 = Ipv4RoutingTableEntry::CreateHostRouteTo ("10.1.2.5", "10.0.0.5", 1);
+
+  Ipv4RoutingTableIndex index;
+  index.Add (&slash16);
+  index.Add (&slash24, 5);
+  index.Add (&slash0);
+  index.Add (&slash32);
+  index.Add (&slash24b, 1);
+
+  std::vector<uint16_t> lengths = Lookup (index, "10.1.2.5");
+  NS_TEST_ASSERT_MSG_EQ (lengths.size (), 4, "Wrong number of matching prefixes");
+  NS_TEST_EXPECT_MSG_EQ (lengths[0], 32, "Wrong prefix");
+  NS_TEST_EXPECT_MSG_EQ (lengths[1], 24, "Wrong prefix");
+  NS_TEST_EXPECT_MSG_EQ (lengths[2], 16, "Wrong prefix");
+  NS_TEST_EXPECT_MSG_EQ (lengths[3], 0, "Wrong prefix");
+  lengths = Lookup (index, "10.1.3.1");
+  NS_TEST_ASSERT_MSG_EQ (lengths.size (), 2, "Wrong number of matching prefixes");
+  NS_TEST_EXPECT_MSG_EQ (lengths[0], 16, "Wrong prefix");
+  NS_TEST_EXPECT_MSG_EQ (lengths[1], 0, "Wrong prefix");
+
+  // the routes of a prefix are in the order of their insertion
+  const Ipv4RoutingTableIndex::Routes *routes = index.Find ("10.1.2.0", "255.255.255.0");
+  NS_TEST_ASSERT_MSG_EQ ((routes != 0), true, "Prefix not found");
+  NS_TEST_ASSERT_MSG_EQ (routes->size (), 2, "Wrong number of routes");
+  NS_TEST_EXPECT_MSG_EQ ((*routes)[0].first, &slash24, "Wrong route order");
+  NS_TEST_EXPECT_MSG_EQ ((*routes)[0].second, 5, "Wrong metric");
+  NS_TEST_EXPECT_MSG_EQ ((*routes)[1].first, &slash24b, "Wrong route order");
+
+  index.Remove (&slash24);
+  index.Remove (&slash32);
+  NS_TEST_EXPECT_MSG_EQ (index.Find ("10.1.2.0", "255.255.255.0")->size (), 1, "Route not removed");
+  NS_TEST_EXPECT_MSG_EQ (Lookup (index, "10.1.2.5").size (), 3, "Prefix not removed");
+  index.Remove (&slash24b);
+  NS_TEST_EXPECT_MSG_EQ ((index.Find ("10.1.2.0", "255.255.255.0") == 0), true, "Prefix not removed");
+  NS_TEST_EXPECT_MSG_EQ (Lookup (index, "10.1.2.5").size (), 2, "Prefix not removed");
+  index.Clear ();
+  NS_TEST_EXPECT_MSG_EQ (Lookup (index, "10.1.2.5").size (), 0, "Index not cleared");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Route selection of Ipv4StaticRouting and Ipv4GlobalRouting
+ * with the longest prefix match index.
+ */
+class Ipv4RoutingLongestPrefixTestCase : public TestCase
+{
+public:
+  Ipv4RoutingLongestPrefixTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * \param routing the routing protocol
+   * \param dest the destination
+   * \param oif the output device, or 0
+   * \returns the gateway of the route to dest, or 0.0.0.0 if none
+   */
+  Ipv4Address Route (Ptr<Ipv4RoutingProtocol> routing, Ipv4Address dest, Ptr<NetDevice> oif = 0);
+};
+
+Ipv4RoutingLongestPrefixTestCase::Ipv4RoutingLongestPrefixTestCase ()
+  : TestCase ("Check the route selection of the static and global routing")
+{
+}
+
+Ipv4Address
+Ipv4RoutingLongestPrefixTestCase::Route (Ptr<Ipv4RoutingProtocol> routing, Ipv4Address dest,
+                                         Ptr<NetDevice> oif)
+{
+  Ipv4Header header;
+  header.SetDestination (dest);
+  Socket::SocketErrno error;
+  Ptr<Ipv4Route> route = routing->RouteOutput (Create<Packet> (), header, oif, error);
+  return route != 0 ? route->GetGateway () : Ipv4Address::GetZero ();
+}
+
+void
+Ipv4RoutingLongestPrefixTestCase::DoRun (void)
+{
+  Ptr<Node> node = CreateObject<Node> ();
+  InternetStackHelper stack;
+  stack.Install (node);
+  Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      Ptr<SimpleNetDevice> device = CreateObject<SimpleNetDevice> ();
+      device->SetAddress (Mac48Address::Allocate ());
+      node->AddDevice (device);
+      uint32_t interface = ipv4->AddInterface (device);
+      ipv4->AddAddress (interface, Ipv4InterfaceAddress (Ipv4Address (0x0a000001 + (i << 8)),
+                                                         Ipv4Mask ("/24")));
+      ipv4->SetUp (interface);
+    }
+  Ptr<NetDevice> if2 = ipv4->GetNetDevice (2);
+
+  Ptr<Ipv4StaticRouting> staticRouting = CreateObject<Ipv4StaticRouting> ();
+  staticRouting->SetIpv4 (ipv4);
+  staticRouting->SetDefaultRoute ("10.0.0.100", 1);
+  staticRouting->AddNetworkRouteTo ("10.1.2.0", "255.255.255.0", "10.0.1.24", 2, 5);
+  staticRouting->AddNetworkRouteTo ("10.1.0.0", "255.255.0.0", "10.0.0.16", 1);
+  staticRouting->AddNetworkRouteTo ("10.1.2.0", "255.255.255.0", "10.0.0.24", 1, 1);
+  staticRouting->AddNetworkRouteTo ("10.1.2.0", "255.255.255.0", "10.0.0.25", 1, 1);
+
+  // the longest prefix, whatever the order of the routes, then the
+  // lowest metric, and the last route of the lowest metric
+  NS_TEST_EXPECT_MSG_EQ (Route (staticRouting, "10.1.2.1"), Ipv4Address ("10.0.0.25"), "Wrong route");
+  NS_TEST_EXPECT_MSG_EQ (Route (staticRouting, "10.1.3.1"), Ipv4Address ("10.0.0.16"), "Wrong route");
+  NS_TEST_EXPECT_MSG_EQ (Route (staticRouting, "11.0.0.1"), Ipv4Address ("10.0.0.100"), "Wrong route");
+  NS_TEST_EXPECT_MSG_EQ (Route (staticRouting, "10.1.2.1", if2), Ipv4Address ("10.0.1.24"), "Wrong route");
+  // no route of the longest prefix on the interface
+  NS_TEST_EXPECT_MSG_EQ (Route (staticRouting, "10.1.3.1", if2), Ipv4Address::GetZero (), "Wrong route");
+  NS_TEST_EXPECT_MSG_EQ (staticRouting->GetDefaultRoute ().GetGateway (), Ipv4Address ("10.0.0.100"),
+                         "Wrong default route");
+
+  // the routes are after the routes of the connected networks
+  uint32_t n = staticRouting->GetNRoutes ();
+  NS_TEST_EXPECT_MSG_EQ (staticRouting->GetRoute (n - 1).GetGateway (), Ipv4Address ("10.0.0.25"),
+                         "Wrong route");
+  staticRouting->RemoveRoute (n - 1);
+  NS_TEST_EXPECT_MSG_EQ (Route (staticRouting, "10.1.2.1"), Ipv4Address ("10.0.0.24"), "Route not removed");
+  // an existing route is not added twice
+  staticRouting->AddNetworkRouteTo ("10.1.2.0", "255.255.255.0", "10.0.0.24", 1, 1);
+  NS_TEST_EXPECT_MSG_EQ (staticRouting->GetNRoutes (), n - 1, "Route added twice");
+  staticRouting->NotifyInterfaceDown (1);
+  NS_TEST_EXPECT_MSG_EQ (Route (staticRouting, "10.1.2.1"), Ipv4Address ("10.0.1.24"), "Routes not removed");
+
+  Ptr<Ipv4GlobalRouting> globalRouting = CreateObject<Ipv4GlobalRouting> ();
+  globalRouting->SetIpv4 (ipv4);
+  globalRouting->AddNetworkRouteTo ("10.1.0.0", "255.255.0.0", "10.0.0.16", 1);
+  globalRouting->AddNetworkRouteTo ("10.1.2.0", "255.255.255.0", "10.0.0.24", 1);
+  globalRouting->AddNetworkRouteTo ("10.1.2.0", "255.255.255.0", "10.0.1.24", 2);
+  globalRouting->AddHostRouteTo ("10.1.2.7", "10.0.0.32", 1);
+  globalRouting->AddASExternalRouteTo ("12.0.0.0", "255.0.0.0", "10.0.0.8", 1);
+
+  // the host routes, then the first of the equal-cost routes of the
+  // longest prefix
+  NS_TEST_EXPECT_MSG_EQ (Route (globalRouting, "10.1.2.7"), Ipv4Address ("10.0.0.32"), "Wrong route");
+  NS_TEST_EXPECT_MSG_EQ (Route (globalRouting, "10.1.2.1"), Ipv4Address ("10.0.0.24"), "Wrong route");
+  NS_TEST_EXPECT_MSG_EQ (Route (globalRouting, "10.1.2.1", if2), Ipv4Address ("10.0.1.24"), "Wrong route");
+  NS_TEST_EXPECT_MSG_EQ (Route (globalRouting, "10.1.3.1"), Ipv4Address ("10.0.0.16"), "Wrong route");
+  NS_TEST_EXPECT_MSG_EQ (Route (globalRouting, "12.1.1.1"), Ipv4Address ("10.0.0.8"), "Wrong route");
+  NS_TEST_EXPECT_MSG_EQ (Route (globalRouting, "13.1.1.1"), Ipv4Address::GetZero (), "Wrong route");
+
+  // random ECMP selects among the routes of the longest prefix only
+  globalRouting->SetAttribute ("RandomEcmpRouting", BooleanValue (true));
+  for (uint32_t i = 0; i < 20; i++)
+    {
+      Ipv4Address gateway = Route (globalRouting, "10.1.2.1");
+      NS_TEST_EXPECT_MSG_EQ ((gateway == "10.0.0.24" || gateway == "10.0.1.24"), true, "Wrong route");
+    }
+  globalRouting->SetAttribute ("RandomEcmpRouting", BooleanValue (false));
+
+  globalRouting->RemoveRoute (0);
+  NS_TEST_EXPECT_MSG_EQ (Route (globalRouting, "10.1.2.7"), Ipv4Address ("10.0.0.24"), "Route not removed");
+  globalRouting->RemoveRoute (1);
+  NS_TEST_EXPECT_MSG_EQ (Route (globalRouting, "10.1.2.1"), Ipv4Address ("10.0.1.24"), "Route not removed");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Ipv4RoutingTableIndex TestSuite
+ */
+class Ipv4RoutingTableIndexTestSuite : public TestSuite
+{
+public:
+  Ipv4RoutingTableIndexTestSuite ()
+    : TestSuite ("ipv4-routing-table-index", UNIT)
+  {
+    AddTestCase (new Ipv4RoutingTableIndexTestCase (), TestCase::QUICK);
+    AddTestCase (new Ipv4RoutingLongestPrefixTestCase (), TestCase::QUICK);
+  }
+};
+
+static Ipv4RoutingTableIndexTestSuite g_ipv4RoutingTableIndexTestSuite; //!< Static variable for test initialization
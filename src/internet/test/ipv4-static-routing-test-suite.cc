@@ -21,6 +21,8 @@
 #include "ns3/inet-socket-address.h"
 #include "ns3/internet-stack-helper.h"
 #include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv4-routing-table-entry.h"
+#include "ns3/ipv4-static-routing.h"
 #include "ns3/ipv4-static-routing-helper.h"
 #include "ns3/node.h"
 #include "ns3/node-container.h"
@@ -36,6 +38,8 @@
 #include "ns3/socket-factory.h"
 #include "ns3/udp-socket-factory.h"
 
+#include <sstream>
+
 using namespace ns3;
 
 /**
@@ -201,6 +205,55 @@ Ipv4StaticRoutingSlash32TestCase::DoRun (void)
   Simulator::Destroy ();
 }
 
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief IPv4 StaticRouting save and restore of the routes
+ */
+class Ipv4StaticRoutingSaveRestoreTestCase : public TestCase
+{
+public:
+  Ipv4StaticRoutingSaveRestoreTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+Ipv4StaticRoutingSaveRestoreTestCase::Ipv4StaticRoutingSaveRestoreTestCase ()
+  : TestCase ("Save and restore the static routes")
+{
+}
+
+void
+Ipv4StaticRoutingSaveRestoreTestCase::DoRun (void)
+{
+  Ptr<Ipv4StaticRouting> first = CreateObject<Ipv4StaticRouting> ();
+  first->AddNetworkRouteTo (Ipv4Address ("10.1.0.0"), Ipv4Mask ("255.255.0.0"), 1, 5);
+  first->AddNetworkRouteTo (Ipv4Address ("10.2.0.0"), Ipv4Mask ("255.255.255.0"), Ipv4Address ("10.1.0.2"), 1);
+  first->AddHostRouteTo (Ipv4Address ("10.3.0.1"), Ipv4Address ("10.1.0.3"), 2, 7);
+  first->SetDefaultRoute (Ipv4Address ("10.1.0.1"), 1);
+  std::stringstream state;
+  first->SaveRoutes (state);
+
+  Ptr<Ipv4StaticRouting> second = CreateObject<Ipv4StaticRouting> ();
+  second->AddNetworkRouteTo (Ipv4Address ("192.168.0.0"), Ipv4Mask ("255.255.0.0"), 1);
+  second->RestoreRoutes (state);
+
+  NS_TEST_ASSERT_MSG_EQ (second->GetNRoutes (), first->GetNRoutes (), "Wrong number of restored routes");
+  for (uint32_t i = 0; i < first->GetNRoutes (); i++)
+    {
+      Ipv4RoutingTableEntry expected = first->GetRoute (i);
+      Ipv4RoutingTableEntry route = second->GetRoute (i);
+      NS_TEST_EXPECT_MSG_EQ (route.GetDestNetwork (), expected.GetDestNetwork (), "Wrong network of route " << i);
+      NS_TEST_EXPECT_MSG_EQ (route.GetDestNetworkMask (), expected.GetDestNetworkMask (), "Wrong mask of route " << i);
+      NS_TEST_EXPECT_MSG_EQ (route.IsGateway (), expected.IsGateway (), "Wrong gateway of route " << i);
+      NS_TEST_EXPECT_MSG_EQ (route.GetGateway (), expected.GetGateway (), "Wrong gateway of route " << i);
+      NS_TEST_EXPECT_MSG_EQ (route.GetInterface (), expected.GetInterface (), "Wrong interface of route " << i);
+      NS_TEST_EXPECT_MSG_EQ (second->GetMetric (i), first->GetMetric (i), "Wrong metric of route " << i);
+    }
+}
+
 /**
  * \ingroup internet-test
  * \ingroup tests
@@ -217,6 +270,7 @@ Ipv4StaticRoutingTestSuite::Ipv4StaticRoutingTestSuite ()
   : TestSuite ("ipv4-static-routing", UNIT)
 {
   AddTestCase (new Ipv4StaticRoutingSlash32TestCase, TestCase::QUICK);
+  AddTestCase (new Ipv4StaticRoutingSaveRestoreTestCase, TestCase::QUICK);
 }
 
 static Ipv4StaticRoutingTestSuite ipv4StaticRoutingTestSuite; //!< Static variable for test initialization
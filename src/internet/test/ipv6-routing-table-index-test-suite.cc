@@ -0,0 +1,238 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv6.h"
+#include "ns3/ipv6-route.h"
+#include "ns3/ipv6-routing-table-entry.h"
+#include "ns3/ipv6-routing-table-index.h"
+#include "ns3/ipv6-static-routing.h"
+#include "ns3/node.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/simulator.h"
+#include "ns3/test.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Ipv6RoutingTableIndex lookups, additions and removals.
+ */
+class Ipv6RoutingTableIndexTestCase : public TestCase
+{
+public:
+  Ipv6RoutingTableIndexTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * \param index the index
+   * \param dest the destination
+   * \returns the prefix lengths of the networks which match dest
+   */
+  std::vector<uint16_t> Lookup (const Ipv6RoutingTableIndex &index, Ipv6Address dest);
+};
+
+Ipv6RoutingTableIndexTestCase::Ipv6RoutingTableIndexTestCase ()
+  : TestCase ("Check the longest prefix match of the Ipv6RoutingTableIndex")
+{
+}
+
+std::vector<uint16_t>
+Ipv6RoutingTableIndexTestCase::Lookup (const Ipv6RoutingTableIndex &index, Ipv6Address dest)
+{
+  std::vector<uint16_t> lengths;
+  uint32_t position = 0;
+  const Ipv6RoutingTableIndex::Routes *routes;
+  while ((routes = index.Lookup (dest, position)) != 0)
+    {
+      lengths.push_back (routes->front ().first->GetDestNetworkPrefix ().GetPrefixLength ());
+    }
+  return lengths;
+}
+
+void
+Ipv6RoutingTableIndexTestCase::DoRun (void)
+{
+  Ipv6RoutingTableEntry slash0 = Ipv6RoutingTableEntry::CreateDefaultRoute ("2001::1", 1);
+  Ipv6RoutingTableEntry slash32 =
+    Ipv6RoutingTableEntry::CreateNetworkRouteTo ("2001:db8::", Ipv6Prefix (32), "2001::2", 1);
+  // the network of a route does not have to be masked
+  Ipv6RoutingTableEntry slash64 =
+    Ipv6RoutingTableEntry::CreateNetworkRouteTo ("2001:db8:0:1::3", Ipv6Prefix (64), "2001::3", 1);
+  Ipv6RoutingTableEntry slash64b =
+    Ipv6RoutingTableEntry::CreateNetworkRouteTo ("2001:db8:0:1::", Ipv6Prefix (64), "2001::4", 2);
+  Ipv6RoutingTableEntry slash128 =
+    Ipv6RoutingTableEntry::CreateHostRouteTo ("2001:db8:0:1::5", "2001::5", 1);
+
+  Ipv6RoutingTableIndex index;
+  index.Add (&slash32);
+  index.Add (&slash64, 5);
+  index.Add (&slash0);
+  index.Add (&slash128);
+  index.Add (&slash64b, 1);
+
+  std::vector<uint16_t> lengths = Lookup (index, "2001:db8:0:1::5");
+  NS_TEST_ASSERT_MSG_EQ (lengths.size (), 4, "Wrong number of matching prefixes");
+  NS_TEST_EXPECT_MSG_EQ (lengths[0], 128, "Wrong prefix");
+  NS_TEST_EXPECT_MSG_EQ (lengths[1], 64, "Wrong prefix");
+  NS_TEST_EXPECT_MSG_EQ (lengths[2], 32, "Wrong prefix");
+  NS_TEST_EXPECT_MSG_EQ (lengths[3], 0, "Wrong prefix");
+  lengths = Lookup (index, "2001:db8:0:2::1");
+  NS_TEST_ASSERT_MSG_EQ (lengths.size (), 2, "Wrong number of matching prefixes");
+  NS_TEST_EXPECT_MSG_EQ (lengths[0], 32, "Wrong prefix");
+  NS_TEST_EXPECT_MSG_EQ (lengths[1], 0, "Wrong prefix");
+
+  // the routes of a network are in the order of their insertion
+  const Ipv6RoutingTableIndex::Routes *routes = index.Find ("2001:db8:0:1::", Ipv6Prefix (64));
+  NS_TEST_ASSERT_MSG_EQ ((routes != 0), true, "Network not found");
+  NS_TEST_ASSERT_MSG_EQ (routes->size (), 2, "Wrong number of routes");
+  NS_TEST_EXPECT_MSG_EQ ((*routes)[0].first, &slash64, "Wrong route order");
+  NS_TEST_EXPECT_MSG_EQ ((*routes)[0].second, 5, "Wrong metric");
+  NS_TEST_EXPECT_MSG_EQ ((*routes)[1].first, &slash64b, "Wrong route order");
+  NS_TEST_EXPECT_MSG_EQ ((index.GetMemoryUsage () > 5 * sizeof (Ipv6RoutingTableIndex::Route)), true,
+                         "Memory usage not accounted");
+
+  index.Remove (&slash64);
+  index.Remove (&slash128);
+  NS_TEST_EXPECT_MSG_EQ (index.Find ("2001:db8:0:1::", Ipv6Prefix (64))->size (), 1, "Route not removed");
+  NS_TEST_EXPECT_MSG_EQ (Lookup (index, "2001:db8:0:1::5").size (), 3, "Prefix not removed");
+  index.Remove (&slash64b);
+  NS_TEST_EXPECT_MSG_EQ ((index.Find ("2001:db8:0:1::", Ipv6Prefix (64)) == 0), true, "Network not removed");
+  NS_TEST_EXPECT_MSG_EQ (Lookup (index, "2001:db8:0:1::5").size (), 2, "Prefix not removed");
+  index.Clear ();
+  NS_TEST_EXPECT_MSG_EQ (Lookup (index, "2001:db8:0:1::5").size (), 0, "Index not cleared");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Route selection of Ipv6StaticRouting with the longest prefix
+ * match index.
+ */
+class Ipv6StaticRoutingLongestPrefixTestCase : public TestCase
+{
+public:
+  Ipv6StaticRoutingLongestPrefixTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * \param routing the routing protocol
+   * \param dest the destination
+   * \param oif the output device, or 0
+   * \returns the gateway of the route to dest, or :: if none
+   */
+  Ipv6Address Route (Ptr<Ipv6RoutingProtocol> routing, Ipv6Address dest, Ptr<NetDevice> oif = 0);
+};
+
+Ipv6StaticRoutingLongestPrefixTestCase::Ipv6StaticRoutingLongestPrefixTestCase ()
+  : TestCase ("Check the route selection of the IPv6 static routing")
+{
+}
+
+Ipv6Address
+Ipv6StaticRoutingLongestPrefixTestCase::Route (Ptr<Ipv6RoutingProtocol> routing, Ipv6Address dest,
+                                               Ptr<NetDevice> oif)
+{
+  Ipv6Header header;
+  header.SetDestination (dest);
+  Socket::SocketErrno error;
+  Ptr<Ipv6Route> route = routing->RouteOutput (Create<Packet> (), header, oif, error);
+  return route != 0 ? route->GetGateway () : Ipv6Address::GetZero ();
+}
+
+void
+Ipv6StaticRoutingLongestPrefixTestCase::DoRun (void)
+{
+  Ptr<Node> node = CreateObject<Node> ();
+  InternetStackHelper stack;
+  stack.Install (node);
+  Ptr<Ipv6> ipv6 = node->GetObject<Ipv6> ();
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      Ptr<SimpleNetDevice> device = CreateObject<SimpleNetDevice> ();
+      device->SetAddress (Mac48Address::Allocate ());
+      node->AddDevice (device);
+      uint32_t interface = ipv6->AddInterface (device);
+      ipv6->AddAddress (interface, Ipv6InterfaceAddress (i == 0 ? "2001::1" : "2001:0:0:1::1",
+                                                         Ipv6Prefix (64)));
+      ipv6->SetUp (interface);
+    }
+  Ptr<NetDevice> if2 = ipv6->GetNetDevice (2);
+
+  Ptr<Ipv6StaticRouting> staticRouting = CreateObject<Ipv6StaticRouting> ();
+  staticRouting->SetIpv6 (ipv6);
+  staticRouting->SetDefaultRoute ("2001::100", 1);
+  staticRouting->AddNetworkRouteTo ("2001:db8:0:1::", Ipv6Prefix (64), "2001:0:0:1::24", 2, 5);
+  staticRouting->AddNetworkRouteTo ("2001:db8::", Ipv6Prefix (32), "2001::16", 1);
+  staticRouting->AddNetworkRouteTo ("2001:db8:0:1::", Ipv6Prefix (64), "2001::24", 1, 1);
+  staticRouting->AddNetworkRouteTo ("2001:db8:0:1::", Ipv6Prefix (64), "2001::25", 1, 1);
+  staticRouting->AddHostRouteTo ("2001:db8:0:1::7", "2001::32", 1);
+
+  // the longest prefix, whatever the order of the routes, then the
+  // lowest metric, and the last route of the lowest metric
+  NS_TEST_EXPECT_MSG_EQ (Route (staticRouting, "2001:db8:0:1::7"), Ipv6Address ("2001::32"), "Wrong route");
+  NS_TEST_EXPECT_MSG_EQ (Route (staticRouting, "2001:db8:0:1::1"), Ipv6Address ("2001::25"), "Wrong route");
+  NS_TEST_EXPECT_MSG_EQ (Route (staticRouting, "2001:db8:0:2::1"), Ipv6Address ("2001::16"), "Wrong route");
+  NS_TEST_EXPECT_MSG_EQ (Route (staticRouting, "2002::1"), Ipv6Address ("2001::100"), "Wrong route");
+  // the host route is not on the interface, nor the best routes of its network
+  NS_TEST_EXPECT_MSG_EQ (Route (staticRouting, "2001:db8:0:1::7", if2), Ipv6Address ("2001:0:0:1::24"),
+                         "Wrong route");
+  // no route of the longest prefix on the interface
+  NS_TEST_EXPECT_MSG_EQ (Route (staticRouting, "2001:db8:0:2::1", if2), Ipv6Address::GetZero (),
+                         "Wrong route");
+
+  // the routes are after the routes of the connected networks
+  uint32_t n = staticRouting->GetNRoutes ();
+  NS_TEST_EXPECT_MSG_EQ (staticRouting->GetRoute (n - 1).GetGateway (), Ipv6Address ("2001::32"),
+                         "Wrong route");
+  staticRouting->RemoveRoute (n - 1);
+  staticRouting->RemoveRoute (n - 2);
+  NS_TEST_EXPECT_MSG_EQ (Route (staticRouting, "2001:db8:0:1::7"), Ipv6Address ("2001::24"),
+                         "Route not removed");
+  // an existing route is not added twice
+  staticRouting->AddNetworkRouteTo ("2001:db8:0:1::", Ipv6Prefix (64), "2001::24", 1, 1);
+  NS_TEST_EXPECT_MSG_EQ (staticRouting->GetNRoutes (), n - 2, "Route added twice");
+  staticRouting->NotifyInterfaceDown (1);
+  NS_TEST_EXPECT_MSG_EQ (Route (staticRouting, "2001:db8:0:1::1"), Ipv6Address ("2001:0:0:1::24"),
+                         "Routes not removed");
+  NS_TEST_EXPECT_MSG_EQ (Route (staticRouting, "2002::1"), Ipv6Address::GetZero (), "Routes not removed");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Ipv6RoutingTableIndex TestSuite
+ */
+class Ipv6RoutingTableIndexTestSuite : public TestSuite
+{
+public:
+  Ipv6RoutingTableIndexTestSuite ()
+    : TestSuite ("ipv6-routing-table-index", UNIT)
+  {
+    AddTestCase (new Ipv6RoutingTableIndexTestCase (), TestCase::QUICK);
+    AddTestCase (new Ipv6StaticRoutingLongestPrefixTestCase (), TestCase::QUICK);
+  }
+};
+
+static Ipv6RoutingTableIndexTestSuite g_ipv6RoutingTableIndexTestSuite; //!< Static variable for test initialization
@@ -27,6 +27,8 @@
 #include "ns3/packet.h"
 #include "ns3/names.h"
 #include "ns3/trace-helper.h"
+#include "ns3/ascii-snapshot-stream.h"
+#include "ns3/ethernet-header.h"
 #include "ns3/string.h"
 
 #include "../model/mock-net-device.h"
@@ -38,6 +40,7 @@ namespace ns3 {
 NS_LOG_COMPONENT_DEFINE ("IslHelper");
 
 IslHelper::IslHelper ()
+  : m_asciiSnapshots (false)
 {
   m_queueFactory.SetTypeId ("ns3::DropTailQueue<Packet>");
   m_deviceFactory.SetTypeId ("ns3::MockNetDevice");
@@ -74,6 +77,12 @@ IslHelper::SetChannelAttribute (std::string n1, const AttributeValue &v1)
   m_channelFactory.Set (n1, v1);
 }
 
+void
+IslHelper::SetAsciiSnapshots (bool snapshots)
+{
+  m_asciiSnapshots = snapshots;
+}
+
 void
 IslHelper::EnablePcapInternal (std::string prefix, Ptr<NetDevice> nd, bool promiscuous, bool explicitFilename)
 {
@@ -128,9 +137,13 @@ IslHelper::EnableAsciiInternal (
 
   //
   // Our default trace sinks are going to use packet printing, so we have to
-  // make sure that is turned on.
+  // make sure that is turned on.  The snapshot sinks decode the packet bytes
+  // instead.
   //
-  Packet::EnablePrinting ();
+  if (!m_asciiSnapshots)
+    {
+      Packet::EnablePrinting ();
+    }
 
   //
   // If we are not provided an OutputStreamWrapper, we are expected to create
@@ -159,6 +172,19 @@ IslHelper::EnableAsciiInternal (
 
       Ptr<OutputStreamWrapper> theStream = asciiTraceHelper.CreateFileStream (filename);
 
+      if (m_asciiSnapshots)
+        {
+          Ptr<AsciiSnapshotStream> snapshots = AsciiSnapshotStream::Get (theStream, EthernetHeader::GetTypeId ());
+          Ptr<Queue<Packet> > queue = device->GetQueue ();
+          bool result = device->TraceConnectWithoutContext ("MacRx", MakeBoundCallback (&AsciiSnapshotStream::SinkWithoutContext, snapshots, 'r'))
+            && queue->TraceConnectWithoutContext ("Enqueue", MakeBoundCallback (&AsciiSnapshotStream::SinkWithoutContext, snapshots, '+'))
+            && queue->TraceConnectWithoutContext ("Drop", MakeBoundCallback (&AsciiSnapshotStream::SinkWithoutContext, snapshots, 'd'))
+            && queue->TraceConnectWithoutContext ("Dequeue", MakeBoundCallback (&AsciiSnapshotStream::SinkWithoutContext, snapshots, '-'))
+            && device->TraceConnectWithoutContext ("PhyRxDrop", MakeBoundCallback (&AsciiSnapshotStream::SinkWithoutContext, snapshots, 'd'));
+          NS_ASSERT_MSG (result, "IslHelper::EnableAsciiInternal(): Unable to hook the snapshot sinks");
+          return;
+        }
+
       //
       // The MacRx trace source provides our "r" event.
       //
@@ -183,7 +209,7 @@ IslHelper::EnableAsciiInternal (
   // If we are provided an OutputStreamWrapper, we are expected to use it, and
   // to providd a context.  We are free to come up with our own context if we
   // want, and use the AsciiTraceHelper Hook*WithContext functions, but for
-  // compatibility and simplicity, we just use Config::Connect and let it deal
+  // compatibility and simplicity, we just use the Config system and let it deal
   // with the context.
   //
   // Note that we are going to use the default trace sinks provided by the
@@ -191,28 +217,34 @@ IslHelper::EnableAsciiInternal (
   // but the default trace sinks are actually publicly available static
   // functions that are always there waiting for just such a case.
   //
-  uint32_t nodeid = nd->GetNode ()->GetId ();
-  uint32_t deviceid = nd->GetIfIndex ();
+  // The device and its transmit queue are each matched once, and all of
+  // their trace sources are connected on the matched objects.
+  //
   std::ostringstream oss;
+  oss << "/NodeList/" << nd->GetNode ()->GetId () << "/DeviceList/" << nd->GetIfIndex () << "/$ns3::MockNetDevice";
+  Config::MatchContainer devices = Config::LookupMatches (oss.str ());
+  NS_ASSERT_MSG (devices.GetN () == 1, "IslHelper::EnableAsciiInternal(): Could not match " << oss.str ());
 
-  oss << "/NodeList/" << nd->GetNode ()->GetId () << "/DeviceList/" << deviceid << "/$ns3::MockNetDevice/MacRx";
-  Config::Connect (oss.str (), MakeBoundCallback (&AsciiTraceHelper::DefaultReceiveSinkWithContext, stream));
-
-  oss.str ("");
-  oss << "/NodeList/" << nodeid << "/DeviceList/" << deviceid << "/$ns3::MockNetDevice/TxQueue/Enqueue";
-  Config::Connect (oss.str (), MakeBoundCallback (&AsciiTraceHelper::DefaultEnqueueSinkWithContext, stream));
-
-  oss.str ("");
-  oss << "/NodeList/" << nodeid << "/DeviceList/" << deviceid << "/$ns3::MockNetDevice/TxQueue/Dequeue";
-  Config::Connect (oss.str (), MakeBoundCallback (&AsciiTraceHelper::DefaultDequeueSinkWithContext, stream));
+  oss << "/TxQueue";
+  Config::MatchContainer queues = Config::LookupMatches (oss.str ());
+  NS_ASSERT_MSG (queues.GetN () == 1, "IslHelper::EnableAsciiInternal(): Could not match " << oss.str ());
 
-  oss.str ("");
-  oss << "/NodeList/" << nodeid << "/DeviceList/" << deviceid << "/$ns3::MockNetDevice/TxQueue/Drop";
-  Config::Connect (oss.str (), MakeBoundCallback (&AsciiTraceHelper::DefaultDropSinkWithContext, stream));
+  if (m_asciiSnapshots)
+    {
+      Ptr<AsciiSnapshotStream> snapshots = AsciiSnapshotStream::Get (stream, EthernetHeader::GetTypeId ());
+      devices.Connect ("MacRx", MakeBoundCallback (&AsciiSnapshotStream::SinkWithContext, snapshots, 'r'));
+      devices.Connect ("PhyRxDrop", MakeBoundCallback (&AsciiSnapshotStream::SinkWithContext, snapshots, 'd'));
+      queues.Connect ("Enqueue", MakeBoundCallback (&AsciiSnapshotStream::SinkWithContext, snapshots, '+'));
+      queues.Connect ("Dequeue", MakeBoundCallback (&AsciiSnapshotStream::SinkWithContext, snapshots, '-'));
+      queues.Connect ("Drop", MakeBoundCallback (&AsciiSnapshotStream::SinkWithContext, snapshots, 'd'));
+      return;
+    }
 
-  oss.str ("");
-  oss << "/NodeList/" << nodeid << "/DeviceList/" << deviceid << "/$ns3::MockNetDevice/PhyRxDrop";
-  Config::Connect (oss.str (), MakeBoundCallback (&AsciiTraceHelper::DefaultDropSinkWithContext, stream));
+  devices.Connect ("MacRx", MakeBoundCallback (&AsciiTraceHelper::DefaultReceiveSinkWithContext, stream));
+  devices.Connect ("PhyRxDrop", MakeBoundCallback (&AsciiTraceHelper::DefaultDropSinkWithContext, stream));
+  queues.Connect ("Enqueue", MakeBoundCallback (&AsciiTraceHelper::DefaultEnqueueSinkWithContext, stream));
+  queues.Connect ("Dequeue", MakeBoundCallback (&AsciiTraceHelper::DefaultDequeueSinkWithContext, stream));
+  queues.Connect ("Drop", MakeBoundCallback (&AsciiTraceHelper::DefaultDropSinkWithContext, stream));
 }
 
 NetDeviceContainer
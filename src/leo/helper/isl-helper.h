@@ -101,6 +101,20 @@ public:
    */
   void SetChannelAttribute (std::string name, const AttributeValue &value);
 
+  /**
+   * Write the ascii traces from packet snapshots, without packet metadata.
+   *
+   * By default, the ascii traces turn on Packet::EnablePrinting, so that
+   * the trace sinks can print the packet headers, and packet metadata is
+   * then recorded for every packet of the simulation, traced or not.
+   * With snapshots, the trace sinks copy the first bytes of each traced
+   * packet instead, and AsciiSnapshotStream prints their headers later,
+   * with HeaderDecoder.  Pcap traces never need packet metadata.
+   *
+   * \param snapshots Use snapshots for the ascii traces enabled from now on
+   */
+  void SetAsciiSnapshots (bool snapshots);
+
   /**
    * \param c a set of nodes
    * \return a NetDeviceContainer for nodes
@@ -164,6 +178,7 @@ private:
   ObjectFactory m_queueFactory;         //!< Queue Factory
   ObjectFactory m_channelFactory;       //!< Channel Factory
   ObjectFactory m_deviceFactory;        //!< Device Factory
+  bool m_asciiSnapshots;                //!< Write the ascii traces from packet snapshots
 };
 
 } // namespace ns3
@@ -65,6 +65,7 @@ LeoCircularOrbitMobilityModel::LeoCircularOrbitMobilityModel() : MobilityModel (
 
 LeoCircularOrbitMobilityModel::~LeoCircularOrbitMobilityModel()
 {
+  m_updateEvent.Cancel ();
 }
 
 Vector3D
@@ -160,9 +161,13 @@ Vector LeoCircularOrbitMobilityModel::Update ()
   m_position = CalcPosition (Simulator::Now ());
   NotifyCourseChange ();
 
-  if (m_precision > Seconds (0))
+  // Every setter calls Update (): keep a single periodic update, which
+  // shares its group event with the other satellites of the same precision
+  if (m_precision > Seconds (0)
+      && (!m_updateEvent.IsRunning () || m_updateEvent.GetPeriod () != m_precision))
     {
-      Simulator::Schedule (m_precision, &LeoCircularOrbitMobilityModel::Update, this);
+      m_updateEvent.Cancel ();
+      m_updateEvent = PeriodicEvent::Schedule (m_precision, &LeoCircularOrbitMobilityModel::Update, this);
     }
 
   return m_position;
@@ -24,6 +24,7 @@
 #include "ns3/log.h"
 #include "ns3/mobility-model.h"
 #include "ns3/nstime.h"
+#include "ns3/periodic-event.h"
 
 /**
  * \file
@@ -118,6 +119,11 @@ private:
    */
   Time m_precision;
 
+  /**
+   * Periodic position update
+   */
+  PeriodicEvent m_updateEvent;
+
   /**
    * \return the current position.
    */
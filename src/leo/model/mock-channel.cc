@@ -59,7 +59,7 @@ MockChannel::GetTypeId (void)
 //
 // By default, you get a channel that
 // has an "infitely" fast transmission speed and zero processing delay.
-MockChannel::MockChannel() : Channel (), m_link (0)
+MockChannel::MockChannel() : Channel (), m_batching (false), m_link (0)
 {
   NS_LOG_FUNCTION_NOARGS ();
 }
@@ -194,6 +194,23 @@ MockChannel::Deliver (
       NS_LOG_DEBUG ("delay = "<<delay);
     }
 
+  if (m_batching)
+    {
+      // gather the packets of the train sent to the same receiver
+      std::vector<BatchDelivery>::iterator it = m_deliveries.begin ();
+      while (it != m_deliveries.end () && (it->dst != dst || it->src != src))
+        {
+          ++it;
+        }
+      if (it == m_deliveries.end ())
+        {
+          it = m_deliveries.insert (it, BatchDelivery {src, dst, rxPower, delay, {}});
+        }
+      it->packets.push_back (p->Copy ());
+      m_txrxMock (p, src, dst, txTime, delay);
+      return true;
+    }
+
   Simulator::ScheduleWithContext (dst->GetNode ()->GetId (),
         			  delay,
         			  &MockNetDevice::Receive,
@@ -207,6 +224,39 @@ MockChannel::Deliver (
   return true;
 }
 
+bool
+MockChannel::TransmitBatch (const std::vector<Ptr<Packet> > &packets,
+                            uint32_t devId,
+                            Address dst,
+                            Time txTime)
+{
+  NS_LOG_FUNCTION (this << packets.size () << devId << dst << txTime);
+
+  m_batching = true;
+  bool result = true;
+  for (const Ptr<Packet> &p : packets)
+    {
+      if (!TransmitStart (p, devId, dst, txTime))
+        {
+          result = false;
+        }
+    }
+  m_batching = false;
+
+  for (BatchDelivery &delivery : m_deliveries)
+    {
+      Simulator::ScheduleWithContext (delivery.dst->GetNode ()->GetId (),
+                                      delivery.delay,
+                                      &MockNetDevice::ReceiveBatch,
+                                      delivery.dst,
+                                      delivery.packets,
+                                      delivery.src,
+                                      delivery.rxPower);
+    }
+  m_deliveries.clear ();
+  return result;
+}
+
 void
 MockChannel::SetPropagationDelay (Ptr<PropagationDelayModel> delay)
 {
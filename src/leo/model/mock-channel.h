@@ -96,6 +96,20 @@ public:
    */
   virtual bool TransmitStart (Ptr<const Packet> p, uint32_t devId, Address dst, Time txTime) = 0;
 
+  /**
+   * \brief Start to transmit a train of packets
+   *
+   * Each packet is routed by TransmitStart, and every receiver gets the
+   * packets of the train in a single event.
+   *
+   * \param packets the packets
+   * \param devId index of the sending device
+   * \param dst destination of the packets
+   * \param txTime transmission time of the whole train
+   * \return true iff all the packets have been transmitted
+   */
+  virtual bool TransmitBatch (const std::vector<Ptr<Packet> > &packets, uint32_t devId, Address dst, Time txTime);
+
   /**
    * \brief Get the propagation loss model
    * \return propagation loss in dBm
@@ -156,6 +170,22 @@ protected:
 
 private:
 
+  /// The packets of a train delivered to a device
+  struct BatchDelivery
+  {
+    Ptr<MockNetDevice> src;            //!< The sender
+    Ptr<MockNetDevice> dst;            //!< The receiver
+    double rxPower;                    //!< The RX power
+    Time delay;                        //!< The delivery delay
+    std::vector<Ptr<Packet> > packets; //!< The packets
+  };
+
+  /// Whether Deliver gathers the packets of a train
+  bool m_batching;
+
+  /// The deliveries of the train being transmitted
+  std::vector<BatchDelivery> m_deliveries;
+
   /// All devices that are attached to the channel
   std::vector<Ptr<MockNetDevice> > m_link;
 
@@ -70,6 +70,13 @@ MockNetDevice::GetTypeId (void)
                    TimeValue (Seconds (0.0)),
                    MakeTimeAccessor (&MockNetDevice::m_tInterframeGap),
                    MakeTimeChecker ())
+    .AddAttribute ("TxBatchSize",
+                   "The maximum number of queued packets transmitted back to back "
+                   "as a single train, received at once by the other devices. "
+                   "One disables the trains",
+                   UintegerValue (1),
+                   MakeUintegerAccessor (&MockNetDevice::m_txBatchSize),
+                   MakeUintegerChecker<uint32_t> (1))
     .AddAttribute ("RxThreshold",
                    "Receive threshold in dBm",
                    DoubleValue (-1000.0),
@@ -293,6 +300,7 @@ MockNetDevice::DoDispose ()
   m_channel = 0;
   m_receiveErrorModel = 0;
   m_currentPkt = 0;
+  m_currentTrain.clear ();
   m_queue = 0;
   m_queueInterface = 0;
   NetDevice::DoDispose ();
@@ -325,6 +333,10 @@ MockNetDevice::TransmitStart (Ptr<Packet> p, const Address &dest)
   //
   NS_ASSERT_MSG (m_txMachineState == READY, "Must be READY to transmit");
   m_txMachineState = BUSY;
+  if (m_txBatchSize > 1 && !m_queue->IsEmpty ())
+    {
+      return TransmitTrain (p, dest);
+    }
   m_currentPkt = p;
   m_phyTxBeginTrace (m_currentPkt);
 
@@ -346,6 +358,58 @@ MockNetDevice::TransmitStart (Ptr<Packet> p, const Address &dest)
   return result;
 }
 
+bool
+MockNetDevice::TransmitTrain (Ptr<Packet> p, const Address &dest)
+{
+  NS_LOG_FUNCTION (this << p);
+
+  m_currentPkt = p;
+  m_currentTrain.assign (1, p);
+  while (m_currentTrain.size () < m_txBatchSize)
+    {
+      Ptr<Packet> next = m_queue->Dequeue ();
+      if (next == 0)
+        {
+          break;
+        }
+      m_promiscSnifferTrace (next);
+      m_snifferTrace (next);
+      m_currentTrain.push_back (next);
+    }
+
+  //
+  // The packets are sent back to back, each followed by an interframe gap,
+  // so that the train ends when the last one would have.
+  //
+  Time txTime = Time (0);
+  for (const Ptr<Packet> &packet : m_currentTrain)
+    {
+      m_phyTxBeginTrace (packet);
+      txTime += m_bps.CalculateBytesTxTime (packet->GetSize ()) + m_tInterframeGap;
+    }
+  txTime -= m_tInterframeGap;
+  Time txCompleteTime = txTime + m_tInterframeGap;
+
+  NS_LOG_LOGIC ("Schedule TransmitCompleteEvent of " << m_currentTrain.size ()
+                << " packets in " << txCompleteTime.GetNanoSeconds () << " nsec");
+  Simulator::Schedule (txCompleteTime, &MockNetDevice::TransmitComplete, this, dest);
+
+  bool result = m_channel->TransmitBatch (m_currentTrain, m_channelDevId, dest, txTime);
+  if (result == false)
+    {
+      for (const Ptr<Packet> &packet : m_currentTrain)
+        {
+          m_phyTxDropTrace (packet);
+        }
+    }
+  else
+    {
+      NS_LOG_INFO ("[node " << m_node->GetId () << "] send " << m_currentTrain.size ()
+                   << " packets on " << m_ifIndex << " to " << dest);
+    }
+  return result;
+}
+
 void
 MockNetDevice::TransmitComplete (const Address &dest)
 {
@@ -362,7 +426,18 @@ MockNetDevice::TransmitComplete (const Address &dest)
 
   NS_ASSERT_MSG (m_currentPkt != 0, "MockNetDevice::TransmitComplete(): m_currentPkt zero");
 
-  m_phyTxEndTrace (m_currentPkt);
+  if (m_currentTrain.empty ())
+    {
+      m_phyTxEndTrace (m_currentPkt);
+    }
+  else
+    {
+      for (const Ptr<Packet> &packet : m_currentTrain)
+        {
+          m_phyTxEndTrace (packet);
+        }
+      m_currentTrain.clear ();
+    }
   m_currentPkt = 0;
 
   Ptr<Packet> p = m_queue->Dequeue ();
@@ -530,6 +605,18 @@ MockNetDevice::Receive (Ptr<Packet> packet,
   }
 }
 
+void
+MockNetDevice::ReceiveBatch (std::vector<Ptr<Packet> > packets,
+                             Ptr<MockNetDevice> senderDevice,
+                             double rxPower)
+{
+  NS_LOG_FUNCTION (this << packets.size () << senderDevice << rxPower);
+  for (Ptr<Packet> &packet : packets)
+    {
+      Receive (packet, senderDevice, rxPower);
+    }
+}
+
 Ptr<Queue<Packet> >
 MockNetDevice::GetQueue (void) const
 {
@@ -713,6 +800,55 @@ MockNetDevice::Send (Ptr<Packet> packet,
   return false;
 }
 
+uint32_t
+MockNetDevice::SendBatch (const std::vector<Ptr<Packet> > &packets,
+                          const Address &dest,
+                          uint16_t protocolNumber)
+{
+  NS_LOG_FUNCTION (this << packets.size () << dest << protocolNumber);
+
+  if (IsLinkUp () == false)
+    {
+      for (const Ptr<Packet> &packet : packets)
+        {
+          m_macTxDropTrace (packet);
+        }
+      return 0;
+    }
+
+  Mac48Address destination = Mac48Address::ConvertFrom (dest);
+  Mac48Address source = Mac48Address::ConvertFrom (m_address);
+
+  //
+  // Enqueue the whole batch before starting the transmission, so that the
+  // packets can be transmitted as a single train.
+  //
+  uint32_t sent = 0;
+  for (const Ptr<Packet> &packet : packets)
+    {
+      AddHeader (packet, source, destination, protocolNumber);
+      m_macTxTrace (packet);
+      if (m_queue->Enqueue (packet))
+        {
+          sent++;
+        }
+      else
+        {
+          NS_LOG_WARN ("queue overflowed: " << m_queue->GetCurrentSize () << "/" << m_queue->GetMaxSize ());
+          m_macTxDropTrace (packet);
+        }
+    }
+
+  if (sent > 0 && m_txMachineState == READY)
+    {
+      Ptr<Packet> packet = m_queue->Dequeue ();
+      m_promiscSnifferTrace (packet);
+      m_snifferTrace (packet);
+      TransmitStart (packet, dest);
+    }
+  return sent;
+}
+
 bool
 MockNetDevice::SendFrom (Ptr<Packet> packet,
                                  const Address &source,
@@ -52,6 +52,10 @@ class ErrorModel;
 /**
  * \ingroup leo
  * \brief Network device for use with MockChannel
+ *
+ * As PointToPointNetDevice, the device transmits the packets waiting in its
+ * queue as a single train when TxBatchSize is greater than one: the channel
+ * delivers the train to each receiver in a single event.
  */
 class MockNetDevice : public NetDevice
 {
@@ -165,6 +169,16 @@ public:
    */
   void Receive (Ptr<Packet> p, Ptr<MockNetDevice> senderDevice, double rxPower);
 
+  /**
+   * Receive a train of packets from a connected MockChannel, each packet
+   * being forwarded as by Receive.
+   *
+   * \param packets the received packets
+   * \param senderDevice sender
+   * \param rxPower RX power excluding receiver gain and loss
+   */
+  void ReceiveBatch (std::vector<Ptr<Packet> > packets, Ptr<MockNetDevice> senderDevice, double rxPower);
+
   // The remaining methods are documented in ns3::NetDevice*
 
   virtual void SetIfIndex (const uint32_t index);
@@ -194,6 +208,7 @@ public:
   virtual bool IsPointToPoint() const;
 
   virtual bool Send (Ptr<Packet> packet, const Address &dest, uint16_t protocolNumber);
+  virtual uint32_t SendBatch (const std::vector<Ptr<Packet> > &packets, const Address &dest, uint16_t protocolNumber);
   virtual bool SendFrom (Ptr<Packet> packet, const Address& source, const Address& dest, uint16_t protocolNumber);
 
   virtual Ptr<Node> GetNode (void) const;
@@ -294,6 +309,20 @@ private:
    */
   bool TransmitStart (Ptr<Packet> p, const Address &dest);
 
+  /**
+   * Start Sending a Train of Packets Down the Wire.
+   *
+   * Called by TransmitStart when packets are waiting in the queue and
+   * trains are enabled: up to TxBatchSize packets, starting with the given
+   * one, are sent to the channel at once.
+   *
+   * \see MockChannel::TransmitBatch ()
+   * \param p the first packet of the train
+   * \param dest the destination of the train
+   * \returns true if success, false on failure
+   */
+  bool TransmitTrain (Ptr<Packet> p, const Address &dest);
+
   /**
    * Stop Sending a Packet Down the Wire and Begin the Interframe Gap.
    *
@@ -501,6 +530,8 @@ private:
   uint32_t m_channelDevId;
 
   Ptr<Packet> m_currentPkt; //!< Current packet processed
+  uint32_t m_txBatchSize;   //!< Maximum number of packets transmitted as a train
+  std::vector<Ptr<Packet> > m_currentTrain; //!< Current train of packets processed, if any
 };
 
 } // namespace ns3
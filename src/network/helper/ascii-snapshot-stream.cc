@@ -0,0 +1,171 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ascii-snapshot-stream.h"
+#include "ns3/assert.h"
+#include "ns3/header-decoder.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+
+#include <algorithm>
+#include <map>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("AsciiSnapshotStream");
+
+namespace {
+
+/** The shared snapshot streams, by output stream. */
+typedef std::map<OutputStreamWrapper *, Ptr<AsciiSnapshotStream> > SharedStreams;
+
+/**
+ * \returns The shared snapshot streams.
+ */
+SharedStreams &
+GetSharedStreams (void)
+{
+  static SharedStreams streams;
+  return streams;
+}
+
+} // unnamed namespace
+
+
+Ptr<AsciiSnapshotStream>
+AsciiSnapshotStream::Get (Ptr<OutputStreamWrapper> stream, TypeId first)
+{
+  NS_LOG_FUNCTION (stream << first);
+  SharedStreams &streams = GetSharedStreams ();
+  SharedStreams::const_iterator i = streams.find (PeekPointer (stream));
+  if (i != streams.end ())
+    {
+      NS_ASSERT_MSG (i->second->m_first == first,
+                     "Packets starting with " << first.GetName () << " and "
+                     << i->second->m_first.GetName () << " traced to the same stream");
+      return i->second;
+    }
+  if (streams.empty ())
+    {
+      Simulator::ScheduleDestroy (&AsciiSnapshotStream::FlushAll);
+    }
+  Ptr<AsciiSnapshotStream> snapshots = Create<AsciiSnapshotStream> (stream, first);
+  streams[PeekPointer (stream)] = snapshots;
+  return snapshots;
+}
+
+void
+AsciiSnapshotStream::FlushAll (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  SharedStreams &streams = GetSharedStreams ();
+  for (SharedStreams::const_iterator i = streams.begin (); i != streams.end (); ++i)
+    {
+      i->second->Flush ();
+    }
+  streams.clear ();
+}
+
+AsciiSnapshotStream::AsciiSnapshotStream (Ptr<OutputStreamWrapper> stream, TypeId first)
+  : m_stream (stream),
+    m_first (first),
+    m_snapLength (128)
+{
+  NS_LOG_FUNCTION (this << stream << first);
+}
+
+AsciiSnapshotStream::~AsciiSnapshotStream ()
+{
+  NS_LOG_FUNCTION (this);
+  Flush ();
+}
+
+void
+AsciiSnapshotStream::SetSnapLength (uint32_t snapLength)
+{
+  NS_LOG_FUNCTION (this << snapLength);
+  m_snapLength = snapLength;
+}
+
+void
+AsciiSnapshotStream::Capture (char event, const std::string &context, Ptr<const Packet> p)
+{
+  NS_LOG_FUNCTION (this << event << context << p);
+  Record record;
+  record.event = event;
+  record.context = NO_CONTEXT;
+  if (!context.empty ())
+    {
+      std::pair<std::unordered_map<std::string, uint32_t>::iterator, bool> inserted =
+        m_contextIndex.insert (std::make_pair (context, static_cast<uint32_t> (m_contexts.size ())));
+      if (inserted.second)
+        {
+          m_contexts.push_back (context);
+        }
+      record.context = inserted.first->second;
+    }
+  record.ts = Simulator::Now ().GetTimeStep ();
+  record.packetSize = p->GetSize ();
+  record.size = std::min (m_snapLength, record.packetSize);
+  record.offset = m_bytes.size ();
+  m_bytes.resize (record.offset + record.size);
+  p->CopyData (m_bytes.data () + record.offset, record.size);
+  m_records.push_back (record);
+  if (m_bytes.size () >= BATCH_BYTES)
+    {
+      Flush ();
+    }
+}
+
+void
+AsciiSnapshotStream::Flush (void)
+{
+  NS_LOG_FUNCTION (this << m_records.size ());
+  if (m_records.empty ())
+    {
+      return;
+    }
+  std::ostream &os = *m_stream->GetStream ();
+  for (std::vector<Record>::const_iterator i = m_records.begin (); i != m_records.end (); ++i)
+    {
+      os << i->event << " " << TimeStep (i->ts).GetSeconds () << " ";
+      if (i->context != NO_CONTEXT)
+        {
+          os << m_contexts[i->context] << " ";
+        }
+      HeaderDecoder::Print (os, m_first, m_bytes.data () + i->offset, i->size, i->packetSize);
+      os << "\n";
+    }
+  os.flush ();
+  m_records.clear ();
+  m_bytes.clear ();
+}
+
+void
+AsciiSnapshotStream::SinkWithContext (Ptr<AsciiSnapshotStream> stream, char event,
+                                      std::string context, Ptr<const Packet> p)
+{
+  stream->Capture (event, context, p);
+}
+
+void
+AsciiSnapshotStream::SinkWithoutContext (Ptr<AsciiSnapshotStream> stream, char event,
+                                         Ptr<const Packet> p)
+{
+  stream->Capture (event, std::string (), p);
+}
+
+} // namespace ns3
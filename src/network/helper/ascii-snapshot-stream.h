@@ -0,0 +1,140 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef ASCII_SNAPSHOT_STREAM_H
+#define ASCII_SNAPSHOT_STREAM_H
+
+#include "ns3/output-stream-wrapper.h"
+#include "ns3/packet.h"
+#include "ns3/ptr.h"
+#include "ns3/simple-ref-count.h"
+#include "ns3/type-id.h"
+
+#include <stdint.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \brief Write ascii traces without packet metadata.
+ *
+ * The default sinks of AsciiTraceHelper print packets with
+ * Packet::Print, which needs Packet::EnablePrinting, and thus packet
+ * metadata for every packet of the simulation, traced or not.  The sinks
+ * of this class copy the first bytes of each traced packet instead, and
+ * print them later with HeaderDecoder, in batches, in the same format as
+ * the default sinks.  Trailers are printed as part of the payload.
+ *
+ * All the sinks writing to the same OutputStreamWrapper must share the
+ * same AsciiSnapshotStream, from Get(), so that the lines stay in time
+ * order.  The snapshots are written out when the batch is full, on
+ * Flush(), and when the simulation is destroyed.
+ *
+ * \code
+ *   Ptr<AsciiSnapshotStream> snapshots = AsciiSnapshotStream::Get (stream, EthernetHeader::GetTypeId ());
+ *   queue->TraceConnectWithoutContext ("Enqueue", MakeBoundCallback (&AsciiSnapshotStream::SinkWithoutContext, snapshots, '+'));
+ * \endcode
+ */
+class AsciiSnapshotStream : public SimpleRefCount<AsciiSnapshotStream>
+{
+public:
+  /**
+   * Get the snapshot stream of an output stream, created on first use.
+   * \param [in] stream The output stream.
+   * \param [in] first The TypeId of the first header of the traced packets.
+   * \returns The snapshot stream.
+   */
+  static Ptr<AsciiSnapshotStream> Get (Ptr<OutputStreamWrapper> stream, TypeId first);
+
+  /**
+   * Constructor.  Prefer Get(), which shares the snapshot stream of an
+   * output stream.
+   * \param [in] stream The output stream.
+   * \param [in] first The TypeId of the first header of the traced packets.
+   */
+  AsciiSnapshotStream (Ptr<OutputStreamWrapper> stream, TypeId first);
+  /** Destructor: write out the pending snapshots. */
+  ~AsciiSnapshotStream ();
+
+  /**
+   * Set the number of bytes copied from each packet.
+   * \param [in] snapLength The number of bytes, 128 by default.
+   */
+  void SetSnapLength (uint32_t snapLength);
+  /**
+   * Record a packet.
+   * \param [in] event The event: '+', '-', 'd' or 'r'.
+   * \param [in] context The trace context, or an empty string.
+   * \param [in] p The packet.
+   */
+  void Capture (char event, const std::string &context, Ptr<const Packet> p);
+  /** Write out the pending snapshots. */
+  void Flush (void);
+
+  /**
+   * Trace sink with a context, to bind to a snapshot stream and an event.
+   * \param [in] stream The snapshot stream.
+   * \param [in] event The event: '+', '-', 'd' or 'r'.
+   * \param [in] context The trace context.
+   * \param [in] p The packet.
+   */
+  static void SinkWithContext (Ptr<AsciiSnapshotStream> stream, char event,
+                               std::string context, Ptr<const Packet> p);
+  /**
+   * Trace sink without a context, to bind to a snapshot stream and an event.
+   * \param [in] stream The snapshot stream.
+   * \param [in] event The event: '+', '-', 'd' or 'r'.
+   * \param [in] p The packet.
+   */
+  static void SinkWithoutContext (Ptr<AsciiSnapshotStream> stream, char event,
+                                  Ptr<const Packet> p);
+
+private:
+  /** Write out the pending snapshots of all the shared snapshot streams, and release them. */
+  static void FlushAll (void);
+
+  /** A traced packet. */
+  struct Record
+  {
+    char event;          //!< The event.
+    uint32_t context;    //!< Index of the context, or NO_CONTEXT.
+    int64_t ts;          //!< Time of the event.
+    uint32_t offset;     //!< Offset of the bytes in m_bytes.
+    uint32_t size;       //!< Number of bytes copied.
+    uint32_t packetSize; //!< Size of the packet.
+  };
+
+  /** Snapshot stream parameters. */
+  enum
+  {
+    NO_CONTEXT = 0xffffffff,   //!< Context of records without one.
+    BATCH_BYTES = 1 << 20      //!< Bytes copied before the batch is written out.
+  };
+
+  Ptr<OutputStreamWrapper> m_stream;     //!< The output stream.
+  TypeId m_first;                        //!< The first header of the packets.
+  uint32_t m_snapLength;                 //!< Bytes copied from each packet.
+  std::vector<Record> m_records;         //!< The pending records.
+  std::vector<uint8_t> m_bytes;          //!< The bytes of the pending records.
+  std::vector<std::string> m_contexts;   //!< The contexts, by index.
+  std::unordered_map<std::string, uint32_t> m_contextIndex; //!< The context indexes.
+};
+
+} // namespace ns3
+
+#endif /* ASCII_SNAPSHOT_STREAM_H */
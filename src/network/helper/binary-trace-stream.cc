@@ -0,0 +1,666 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "binary-trace-stream.h"
+#include "ns3/assert.h"
+#include "ns3/header-decoder.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("BinaryTraceStream");
+
+namespace {
+
+/** The magic number at the start of a binary trace. */
+const char MAGIC[8] = { 'n', 's', '3', 'b', 't', 'r', 'c', '1' };
+
+/** The columns of a chunk. */
+enum Column
+{
+  TIME,     //!< Time deltas, zigzag encoded
+  EVENT,    //!< Event characters
+  CONTEXT,  //!< Context indexes, 0 for none
+  UID,      //!< Uid deltas, zigzag encoded
+  SIZE,     //!< Packet sizes
+  TYPE,     //!< Header type indexes, 0 for none
+  LENGTH,   //!< Numbers of bytes copied
+  BYTES,    //!< Bytes copied, xored with those of the previous event, in runs
+  COLUMNS   //!< Number of columns
+};
+
+/** The attached binary trace streams, by output stream. */
+typedef std::map<OutputStreamWrapper *, Ptr<BinaryTraceStream> > AttachedStreams;
+
+/**
+ * \returns The attached binary trace streams.
+ */
+AttachedStreams &
+GetAttachedStreams (void)
+{
+  static AttachedStreams streams;
+  return streams;
+}
+
+/**
+ * Append a variable length integer: 7 bits per byte, least significant
+ * first, with the high bit set on all the bytes but the last.
+ * \param [in,out] column The column.
+ * \param [in] v The integer.
+ */
+void
+PutVarint (std::vector<uint8_t> &column, uint64_t v)
+{
+  while (v >= 0x80)
+    {
+      column.push_back (static_cast<uint8_t> (v) | 0x80);
+      v >>= 7;
+    }
+  column.push_back (static_cast<uint8_t> (v));
+}
+
+/**
+ * Append a signed difference, zigzag encoded so that small negative
+ * differences stay short.
+ * \param [in,out] column The column.
+ * \param [in] delta The difference.
+ */
+void
+PutDelta (std::vector<uint8_t> &column, int64_t delta)
+{
+  PutVarint (column, (static_cast<uint64_t> (delta) << 1) ^ static_cast<uint64_t> (delta >> 63));
+}
+
+/**
+ * Append a string, prefixed with its length.
+ * \param [in,out] column The column.
+ * \param [in] s The string.
+ */
+void
+PutString (std::vector<uint8_t> &column, const std::string &s)
+{
+  PutVarint (column, s.size ());
+  column.insert (column.end (), s.begin (), s.end ());
+}
+
+/**
+ * Read a variable length integer.
+ * \param [in,out] p The read position, advanced past the integer.
+ * \param [in] end The end of the data.
+ * \param [out] v The integer.
+ * \returns \c false if the data ends first.
+ */
+bool
+GetVarint (const uint8_t *&p, const uint8_t *end, uint64_t *v)
+{
+  *v = 0;
+  for (uint32_t shift = 0; p != end && shift < 64; shift += 7)
+    {
+      uint8_t byte = *p++;
+      *v |= static_cast<uint64_t> (byte & 0x7f) << shift;
+      if ((byte & 0x80) == 0)
+        {
+          return true;
+        }
+    }
+  return false;
+}
+
+/**
+ * Read a zigzag encoded difference.
+ * \param [in,out] p The read position, advanced past the difference.
+ * \param [in] end The end of the data.
+ * \param [out] delta The difference.
+ * \returns \c false if the data ends first.
+ */
+bool
+GetDelta (const uint8_t *&p, const uint8_t *end, int64_t *delta)
+{
+  uint64_t v;
+  if (!GetVarint (p, end, &v))
+    {
+      return false;
+    }
+  *delta = static_cast<int64_t> (v >> 1) ^ -static_cast<int64_t> (v & 1);
+  return true;
+}
+
+/**
+ * Read a string prefixed with its length.
+ * \param [in,out] p The read position, advanced past the string.
+ * \param [in] end The end of the data.
+ * \param [out] s The string.
+ * \returns \c false if the data ends first.
+ */
+bool
+GetString (const uint8_t *&p, const uint8_t *end, std::string *s)
+{
+  uint64_t size;
+  if (!GetVarint (p, end, &size) || size > static_cast<uint64_t> (end - p))
+    {
+      return false;
+    }
+  s->assign (reinterpret_cast<const char *> (p), size);
+  p += size;
+  return true;
+}
+
+/**
+ * Append bytes xored with those of the previous event, as tokens: an even
+ * token 2n stands for n zero bytes, and an odd token 2n+1 for the n bytes
+ * that follow it.  Consecutive packets mostly differ in a few header
+ * fields, which leaves long runs of zeros.
+ * \param [in,out] column The column.
+ * \param [in] bytes The bytes.
+ * \param [in] previous The bytes of the previous event, at least as many.
+ * \param [in] length The number of bytes.
+ */
+void
+PutXorRuns (std::vector<uint8_t> &column, const uint8_t *bytes, const uint8_t *previous, uint32_t length)
+{
+  uint32_t i = 0;
+  while (i < length)
+    {
+      uint32_t start = i;
+      while (i < length && bytes[i] == previous[i])
+        {
+          ++i;
+        }
+      if (i > start)
+        {
+          PutVarint (column, static_cast<uint64_t> (i - start) << 1);
+        }
+      start = i;
+      // A literal run ends at two equal bytes, which are cheaper as zeros.
+      while (i < length && (bytes[i] != previous[i]
+                            || (i + 1 < length && bytes[i + 1] != previous[i + 1])))
+        {
+          ++i;
+        }
+      if (i > start)
+        {
+          PutVarint (column, (static_cast<uint64_t> (i - start) << 1) | 1);
+          for (uint32_t j = start; j < i; ++j)
+            {
+              column.push_back (bytes[j] ^ previous[j]);
+            }
+        }
+    }
+}
+
+/**
+ * Read bytes written by PutXorRuns.
+ * \param [in,out] p The read position, advanced past the bytes.
+ * \param [in] end The end of the data.
+ * \param [in,out] bytes The bytes of the previous event, at least as many,
+ *        replaced with those of this event.
+ * \param [in] length The number of bytes.
+ * \returns \c false if the data is malformed.
+ */
+bool
+GetXorRuns (const uint8_t *&p, const uint8_t *end, uint8_t *bytes, uint32_t length)
+{
+  uint32_t i = 0;
+  while (i < length)
+    {
+      uint64_t token;
+      if (!GetVarint (p, end, &token) || (token >> 1) == 0 || (token >> 1) > length - i)
+        {
+          return false;
+        }
+      uint32_t n = token >> 1;
+      if (token & 1)
+        {
+          if (n > static_cast<uint64_t> (end - p))
+            {
+              return false;
+            }
+          for (uint32_t j = 0; j < n; ++j)
+            {
+              bytes[i + j] ^= *p++;
+            }
+        }
+      i += n;
+    }
+  return true;
+}
+
+/**
+ * Find an index in a context.
+ * \param [in] context The context.
+ * \param [in] list The list preceding the index, e.g. "/NodeList/".
+ * \returns The index, or BinaryTraceReader::NO_INDEX.
+ */
+uint32_t
+GetContextIndex (const std::string &context, const std::string &list)
+{
+  std::string::size_type start = context.find (list);
+  if (start == std::string::npos)
+    {
+      return BinaryTraceReader::NO_INDEX;
+    }
+  const char *digits = context.c_str () + start + list.size ();
+  char *end;
+  unsigned long index = std::strtoul (digits, &end, 10);
+  return end == digits ? BinaryTraceReader::NO_INDEX : index;
+}
+
+} // unnamed namespace
+
+
+Ptr<BinaryTraceStream>
+BinaryTraceStream::Attach (Ptr<OutputStreamWrapper> stream)
+{
+  NS_LOG_FUNCTION (stream);
+  AttachedStreams &streams = GetAttachedStreams ();
+  NS_ASSERT_MSG (streams.find (PeekPointer (stream)) == streams.end (),
+                 "Binary trace stream already attached");
+  if (streams.empty ())
+    {
+      Simulator::ScheduleDestroy (&BinaryTraceStream::FlushAll);
+    }
+  Ptr<BinaryTraceStream> binary = Create<BinaryTraceStream> (stream);
+  streams[PeekPointer (stream)] = binary;
+  return binary;
+}
+
+Ptr<BinaryTraceStream>
+BinaryTraceStream::Find (Ptr<OutputStreamWrapper> stream)
+{
+  AttachedStreams &streams = GetAttachedStreams ();
+  if (streams.empty ())
+    {
+      return 0;
+    }
+  AttachedStreams::const_iterator i = streams.find (PeekPointer (stream));
+  return i == streams.end () ? 0 : i->second;
+}
+
+bool
+BinaryTraceStream::TryRecord (Ptr<OutputStreamWrapper> stream, char event,
+                              const std::string &context, Ptr<const Packet> p)
+{
+  Ptr<BinaryTraceStream> binary = Find (stream);
+  if (binary == 0)
+    {
+      return false;
+    }
+  binary->Record (event, context, p);
+  return true;
+}
+
+void
+BinaryTraceStream::FlushAll (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  AttachedStreams &streams = GetAttachedStreams ();
+  for (AttachedStreams::const_iterator i = streams.begin (); i != streams.end (); ++i)
+    {
+      i->second->Flush ();
+    }
+  streams.clear ();
+}
+
+BinaryTraceStream::BinaryTraceStream (Ptr<OutputStreamWrapper> stream)
+  : m_stream (stream),
+    m_snapLength (64),
+    m_count (0),
+    m_lastTs (0),
+    m_lastUid (0),
+    m_columns (COLUMNS)
+{
+  NS_LOG_FUNCTION (this << stream);
+  std::ostream &os = *m_stream->GetStream ();
+  os.write (MAGIC, sizeof (MAGIC));
+  os.put (static_cast<char> (Time::GetResolution ()));
+}
+
+BinaryTraceStream::~BinaryTraceStream ()
+{
+  NS_LOG_FUNCTION (this);
+  Flush ();
+}
+
+void
+BinaryTraceStream::SetSnapLength (uint32_t snapLength)
+{
+  NS_LOG_FUNCTION (this << snapLength);
+  m_snapLength = snapLength;
+}
+
+void
+BinaryTraceStream::Record (char event, const std::string &context, Ptr<const Packet> p)
+{
+  NS_LOG_FUNCTION (this << event << context << p);
+  uint32_t contextIndex = 0;
+  if (!context.empty ())
+    {
+      std::pair<std::unordered_map<std::string, uint32_t>::iterator, bool> inserted =
+        m_contexts.insert (std::make_pair (context, static_cast<uint32_t> (m_contexts.size () + 1)));
+      if (inserted.second)
+        {
+          m_newContexts.push_back (context);
+        }
+      contextIndex = inserted.first->second;
+    }
+  uint32_t typeIndex = 0;
+  PacketMetadata::ItemIterator items = p->BeginItem ();
+  if (items.HasNext ())
+    {
+      PacketMetadata::Item item = items.Next ();
+      if (item.type == PacketMetadata::Item::HEADER && !item.isFragment)
+        {
+          std::pair<std::unordered_map<uint16_t, uint32_t>::iterator, bool> inserted =
+            m_types.insert (std::make_pair (item.tid.GetUid (), static_cast<uint32_t> (m_types.size () + 1)));
+          if (inserted.second)
+            {
+              m_newTypes.push_back (item.tid.GetName ());
+            }
+          typeIndex = inserted.first->second;
+        }
+    }
+
+  int64_t ts = Simulator::Now ().GetTimeStep ();
+  uint64_t uid = p->GetUid ();
+  uint32_t size = p->GetSize ();
+  // The bytes are only decoded from a known first header.
+  uint32_t length = typeIndex == 0 ? 0 : std::min (m_snapLength, size);
+  PutDelta (m_columns[TIME], ts - m_lastTs);
+  m_columns[EVENT].push_back (event);
+  PutVarint (m_columns[CONTEXT], contextIndex);
+  PutDelta (m_columns[UID], static_cast<int64_t> (uid - m_lastUid));
+  PutVarint (m_columns[SIZE], size);
+  PutVarint (m_columns[TYPE], typeIndex);
+  PutVarint (m_columns[LENGTH], length);
+  if (length > 0)
+    {
+      m_snapshot.resize (std::max<std::size_t> (m_snapshot.size (), length));
+      m_previous.resize (m_snapshot.size ());
+      p->CopyData (m_snapshot.data (), length);
+      PutXorRuns (m_columns[BYTES], m_snapshot.data (), m_previous.data (), length);
+      m_snapshot.swap (m_previous);
+    }
+  m_lastTs = ts;
+  m_lastUid = uid;
+  m_count++;
+  if (m_columns[BYTES].size () >= CHUNK_BYTES || m_count >= CHUNK_EVENTS)
+    {
+      Flush ();
+    }
+}
+
+void
+BinaryTraceStream::Flush (void)
+{
+  NS_LOG_FUNCTION (this << m_count);
+  if (m_count == 0)
+    {
+      return;
+    }
+  std::vector<uint8_t> header;
+  PutVarint (header, m_count);
+  PutVarint (header, m_newContexts.size ());
+  for (std::vector<std::string>::const_iterator i = m_newContexts.begin (); i != m_newContexts.end (); ++i)
+    {
+      PutString (header, *i);
+    }
+  PutVarint (header, m_newTypes.size ());
+  for (std::vector<std::string>::const_iterator i = m_newTypes.begin (); i != m_newTypes.end (); ++i)
+    {
+      PutString (header, *i);
+    }
+  for (uint32_t i = 0; i < COLUMNS; ++i)
+    {
+      PutVarint (header, m_columns[i].size ());
+    }
+  uint64_t body = header.size ();
+  for (uint32_t i = 0; i < COLUMNS; ++i)
+    {
+      body += m_columns[i].size ();
+    }
+  std::vector<uint8_t> prefix;
+  PutVarint (prefix, body);
+
+  std::ostream &os = *m_stream->GetStream ();
+  os.write (reinterpret_cast<const char *> (prefix.data ()), prefix.size ());
+  os.write (reinterpret_cast<const char *> (header.data ()), header.size ());
+  for (uint32_t i = 0; i < COLUMNS; ++i)
+    {
+      os.write (reinterpret_cast<const char *> (m_columns[i].data ()), m_columns[i].size ());
+      m_columns[i].clear ();
+    }
+  os.flush ();
+  m_newContexts.clear ();
+  m_newTypes.clear ();
+  m_previous.assign (m_previous.size (), 0);
+  m_count = 0;
+}
+
+
+BinaryTraceReader::BinaryTraceReader (std::istream &is)
+  : m_is (is),
+    m_failed (false),
+    m_unit (Time::NS),
+    m_columns (COLUMNS),
+    m_ends (COLUMNS),
+    m_remaining (0),
+    m_lastTs (0),
+    m_lastUid (0)
+{
+  NS_LOG_FUNCTION (this << &is);
+  char magic[sizeof (MAGIC)];
+  m_is.read (magic, sizeof (magic));
+  int unit = m_is.get ();
+  if (!m_is || std::memcmp (magic, MAGIC, sizeof (MAGIC)) != 0 || unit > Time::FS)
+    {
+      NS_LOG_LOGIC ("not a binary trace");
+      m_failed = true;
+      return;
+    }
+  m_unit = static_cast<Time::Unit> (unit);
+  // Index 0 stands for no context and no header type.
+  Context none = { "", NO_INDEX, NO_INDEX };
+  m_contexts.push_back (none);
+  m_types.push_back ("");
+}
+
+bool
+BinaryTraceReader::Fail (void) const
+{
+  return m_failed;
+}
+
+bool
+BinaryTraceReader::ReadChunk (void)
+{
+  NS_LOG_FUNCTION (this);
+  uint64_t size = 0;
+  for (uint32_t shift = 0; ; shift += 7)
+    {
+      int byte = m_is.get ();
+      if (byte == std::char_traits<char>::eof ())
+        {
+          // A clean end of the trace, unless within the chunk size.
+          m_failed = shift != 0;
+          return false;
+        }
+      size |= static_cast<uint64_t> (byte & 0x7f) << shift;
+      if ((byte & 0x80) == 0)
+        {
+          break;
+        }
+      if (shift >= 56)
+        {
+          m_failed = true;
+          return false;
+        }
+    }
+  m_chunk.resize (size);
+  m_is.read (reinterpret_cast<char *> (m_chunk.data ()), size);
+  if (static_cast<uint64_t> (m_is.gcount ()) != size)
+    {
+      m_failed = true;
+      return false;
+    }
+
+  const uint8_t *p = m_chunk.data ();
+  const uint8_t *end = p + size;
+  uint64_t count;
+  uint64_t n;
+  m_failed = true;
+  if (!GetVarint (p, end, &count) || count == 0 || !GetVarint (p, end, &n))
+    {
+      return false;
+    }
+  for (uint64_t i = 0; i < n; ++i)
+    {
+      Context context;
+      if (!GetString (p, end, &context.name))
+        {
+          return false;
+        }
+      context.node = GetContextIndex (context.name, "/NodeList/");
+      context.device = GetContextIndex (context.name, "/DeviceList/");
+      m_contexts.push_back (context);
+    }
+  if (!GetVarint (p, end, &n))
+    {
+      return false;
+    }
+  for (uint64_t i = 0; i < n; ++i)
+    {
+      std::string type;
+      if (!GetString (p, end, &type))
+        {
+          return false;
+        }
+      m_types.push_back (type);
+    }
+  uint64_t sizes[COLUMNS];
+  for (uint32_t i = 0; i < COLUMNS; ++i)
+    {
+      if (!GetVarint (p, end, &sizes[i]))
+        {
+          return false;
+        }
+    }
+  for (uint32_t i = 0; i < COLUMNS; ++i)
+    {
+      if (sizes[i] > static_cast<uint64_t> (end - p))
+        {
+          return false;
+        }
+      m_columns[i] = p;
+      p += sizes[i];
+      m_ends[i] = p;
+    }
+  m_failed = p != end;
+  m_remaining = count;
+  m_previous.assign (m_previous.size (), 0);
+  return !m_failed;
+}
+
+bool
+BinaryTraceReader::Read (Event *event)
+{
+  NS_LOG_FUNCTION (this << event);
+  if (m_failed || (m_remaining == 0 && !ReadChunk ()))
+    {
+      return false;
+    }
+  int64_t dt;
+  int64_t duid;
+  uint64_t context;
+  uint64_t size;
+  uint64_t type;
+  uint64_t length;
+  m_failed = true;
+  if (m_columns[EVENT] == m_ends[EVENT]
+      || !GetDelta (m_columns[TIME], m_ends[TIME], &dt)
+      || !GetVarint (m_columns[CONTEXT], m_ends[CONTEXT], &context)
+      || !GetDelta (m_columns[UID], m_ends[UID], &duid)
+      || !GetVarint (m_columns[SIZE], m_ends[SIZE], &size)
+      || !GetVarint (m_columns[TYPE], m_ends[TYPE], &type)
+      || !GetVarint (m_columns[LENGTH], m_ends[LENGTH], &length)
+      || context >= m_contexts.size () || type >= m_types.size ()
+      || length > size)
+    {
+      return false;
+    }
+  if (length > m_previous.size ())
+    {
+      m_previous.resize (length);
+    }
+  if (!GetXorRuns (m_columns[BYTES], m_ends[BYTES], m_previous.data (), length))
+    {
+      return false;
+    }
+  m_failed = false;
+  m_lastTs += dt;
+  m_lastUid += duid;
+  event->time = Time::FromInteger (m_lastTs, m_unit);
+  event->event = *m_columns[EVENT]++;
+  event->context = m_contexts[context].name;
+  event->node = m_contexts[context].node;
+  event->device = m_contexts[context].device;
+  event->uid = m_lastUid;
+  event->size = size;
+  event->type = m_types[type];
+  event->bytes.assign (m_previous.begin (), m_previous.begin () + length);
+  m_remaining--;
+  return true;
+}
+
+void
+BinaryTraceReader::PrintAscii (std::ostream &os, const Event &event)
+{
+  os << event.event << " " << event.time.GetSeconds () << " ";
+  if (!event.context.empty ())
+    {
+      os << event.context << " ";
+    }
+  TypeId tid;
+  if (!event.type.empty () && TypeId::LookupByNameFailSafe (event.type, &tid))
+    {
+      HeaderDecoder::Print (os, tid, event.bytes.data (), event.bytes.size (), event.size);
+    }
+  else if (event.size > 0)
+    {
+      os << "Payload (size=" << event.size << ")";
+    }
+  os << std::endl;
+}
+
+bool
+BinaryTraceReader::ConvertToAscii (std::istream &is, std::ostream &os)
+{
+  NS_LOG_FUNCTION (&is << &os);
+  BinaryTraceReader reader (is);
+  Event event;
+  while (reader.Read (&event))
+    {
+      PrintAscii (os, event);
+    }
+  return !reader.Fail ();
+}
+
+} // namespace ns3
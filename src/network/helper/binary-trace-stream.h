@@ -0,0 +1,218 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef BINARY_TRACE_STREAM_H
+#define BINARY_TRACE_STREAM_H
+
+#include "ns3/nstime.h"
+#include "ns3/output-stream-wrapper.h"
+#include "ns3/packet.h"
+#include "ns3/ptr.h"
+#include "ns3/simple-ref-count.h"
+
+#include <istream>
+#include <stdint.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \brief Write the events of the default ascii trace sinks in a compact
+ * columnar binary format.
+ *
+ * Each event is recorded as its time, event type (e.g. '+', '-', 'd', 'r'),
+ * trace context, packet uid, packet size, the TypeId of the first header
+ * of the packet when packet printing is enabled, and then the first bytes
+ * of the packet.  The events are gathered in chunks of one column per
+ * field: times and uids are delta encoded, the bytes are xored with those
+ * of the previous event and run length encoded, and all the integers are
+ * written as variable length integers, so that a typical event takes a
+ * dozen bytes plus the header fields that changed.  Each chunk also holds the contexts and header types
+ * seen for the first time, which later chunks refer to by index.
+ *
+ * When AsciiTraceHelper::EnableBinaryFormat is on, the streams of
+ * AsciiTraceHelper::CreateFileStream get a BinaryTraceStream, which the
+ * default sinks of AsciiTraceHelper fill instead of printing the
+ * packets, so that the EnableAscii methods of the helpers write binary
+ * traces.  BinaryTraceReader reads them back, and converts them to the
+ * text of the default sinks.
+ */
+class BinaryTraceStream : public SimpleRefCount<BinaryTraceStream>
+{
+public:
+  /**
+   * Create the binary trace stream of an output stream, and write the file
+   * header.  The output stream should be opened in binary mode.
+   * \param [in] stream The output stream.
+   * \returns The binary trace stream.
+   */
+  static Ptr<BinaryTraceStream> Attach (Ptr<OutputStreamWrapper> stream);
+  /**
+   * \param [in] stream An output stream.
+   * \returns The binary trace stream attached to it, if any.
+   */
+  static Ptr<BinaryTraceStream> Find (Ptr<OutputStreamWrapper> stream);
+  /**
+   * Record an event if an output stream has a binary trace stream, for the
+   * ascii sinks to call before printing the event.
+   * \param [in] stream The output stream.
+   * \param [in] event The event.
+   * \param [in] context The trace context, or an empty string.
+   * \param [in] p The packet.
+   * \returns \c true if the event was recorded, and must not be printed.
+   */
+  static bool TryRecord (Ptr<OutputStreamWrapper> stream, char event,
+                         const std::string &context, Ptr<const Packet> p);
+
+  /**
+   * Constructor.  Prefer Attach(), which lets the default sinks find the
+   * binary trace stream.
+   * \param [in] stream The output stream.
+   */
+  BinaryTraceStream (Ptr<OutputStreamWrapper> stream);
+  /** Destructor: write out the pending chunk. */
+  ~BinaryTraceStream ();
+
+  /**
+   * Set the number of bytes copied from each packet.
+   * \param [in] snapLength The number of bytes, 64 by default.
+   */
+  void SetSnapLength (uint32_t snapLength);
+  /**
+   * Record an event.
+   * \param [in] event The event: '+', '-', 'd' or 'r' for the default
+   *        sinks, or any other character.
+   * \param [in] context The trace context, or an empty string.
+   * \param [in] p The packet.
+   */
+  void Record (char event, const std::string &context, Ptr<const Packet> p);
+  /** Write out the pending chunk. */
+  void Flush (void);
+
+private:
+  /** Write out the pending chunks of all the attached streams, and detach them. */
+  static void FlushAll (void);
+
+  /** Binary trace stream parameters. */
+  enum
+  {
+    CHUNK_BYTES = 1 << 20,  //!< Bytes copied before the chunk is written out.
+    CHUNK_EVENTS = 1 << 16  //!< Events recorded before the chunk is written out.
+  };
+
+  Ptr<OutputStreamWrapper> m_stream;     //!< The output stream.
+  uint32_t m_snapLength;                 //!< Bytes copied from each packet.
+  uint32_t m_count;                      //!< Events in the pending chunk.
+  int64_t m_lastTs;                      //!< Time of the last event.
+  uint64_t m_lastUid;                    //!< Uid of the last event.
+  std::vector<std::vector<uint8_t> > m_columns; //!< The columns of the pending chunk.
+  std::unordered_map<std::string, uint32_t> m_contexts; //!< The indexes of the contexts.
+  std::unordered_map<uint16_t, uint32_t> m_types;       //!< The indexes of the header types, by TypeId uid.
+  std::vector<std::string> m_newContexts; //!< The contexts first seen in the pending chunk.
+  std::vector<std::string> m_newTypes;    //!< The header types first seen in the pending chunk.
+  std::vector<uint8_t> m_snapshot;        //!< The bytes of the event being recorded.
+  std::vector<uint8_t> m_previous;        //!< The bytes of the previous event, zero padded.
+};
+
+/**
+ * \brief Read the binary traces of BinaryTraceStream.
+ */
+class BinaryTraceReader
+{
+public:
+  /** An event read back. */
+  struct Event
+  {
+    Time time;                   //!< Time of the event.
+    char event;                  //!< The event, e.g. '+', '-', 'd' or 'r'.
+    std::string context;         //!< The trace context, or an empty string.
+    uint32_t node;               //!< The node of the context, or NO_INDEX.
+    uint32_t device;             //!< The device of the context, or NO_INDEX.
+    uint64_t uid;                //!< The packet uid.
+    uint32_t size;               //!< The packet size.
+    std::string type;            //!< The first header of the packet, if known.
+    std::vector<uint8_t> bytes;  //!< The first bytes of the packet.
+  };
+
+  /** The node or device of an event without one. */
+  static const uint32_t NO_INDEX = 0xffffffff;
+
+  /**
+   * Constructor.
+   * \param [in] is The binary trace, opened in binary mode.
+   */
+  BinaryTraceReader (std::istream &is);
+
+  /**
+   * Read the next event.
+   * \param [out] event The event.
+   * \returns \c false at the end of the trace, or if it is malformed.
+   */
+  bool Read (Event *event);
+  /**
+   * \returns \c true if the trace was found malformed.
+   */
+  bool Fail (void) const;
+
+  /**
+   * Print an event as the default ascii sinks do, decoding its headers
+   * with HeaderDecoder.
+   * \param [in] os The output stream.
+   * \param [in] event The event.
+   */
+  static void PrintAscii (std::ostream &os, const Event &event);
+  /**
+   * Convert a binary trace to the text of the default ascii sinks.
+   * \param [in] is The binary trace.
+   * \param [in] os The text output.
+   * \returns \c false if the binary trace is malformed.
+   */
+  static bool ConvertToAscii (std::istream &is, std::ostream &os);
+
+private:
+  /**
+   * Read the next chunk.
+   * \returns \c false at the end of the trace, or if it is malformed.
+   */
+  bool ReadChunk (void);
+
+  /** A trace context. */
+  struct Context
+  {
+    std::string name;  //!< The context.
+    uint32_t node;     //!< Its node, or NO_INDEX.
+    uint32_t device;   //!< Its device, or NO_INDEX.
+  };
+
+  std::istream &m_is;                    //!< The binary trace.
+  bool m_failed;                         //!< Whether the trace is malformed.
+  Time::Unit m_unit;                     //!< The unit of the times.
+  std::vector<Context> m_contexts;       //!< The contexts, by index.
+  std::vector<std::string> m_types;      //!< The header types, by index.
+  std::vector<uint8_t> m_chunk;          //!< The current chunk.
+  std::vector<const uint8_t *> m_columns; //!< The read positions in the columns of the chunk.
+  std::vector<const uint8_t *> m_ends;   //!< The ends of the columns of the chunk.
+  uint32_t m_remaining;                  //!< Events left in the chunk.
+  int64_t m_lastTs;                      //!< Time of the last event.
+  uint64_t m_lastUid;                    //!< Uid of the last event.
+  std::vector<uint8_t> m_previous;       //!< The bytes of the last event, zero padded.
+};
+
+} // namespace ns3
+
+#endif /* BINARY_TRACE_STREAM_H */
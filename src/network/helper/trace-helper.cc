@@ -19,6 +19,7 @@
 #include <stdint.h>
 #include <string>
 #include <fstream>
+#include <vector>
 
 #include "ns3/abort.h"
 #include "ns3/assert.h"
@@ -28,6 +29,9 @@
 #include "ns3/names.h"
 #include "ns3/net-device.h"
 #include "ns3/pcap-file-wrapper.h"
+#include "ns3/pcap-writer.h"
+#include "ns3/binary-trace-stream.h"
+#include "ns3/enum.h"
 
 #include "trace-helper.h"
 
@@ -35,6 +39,73 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("TraceHelper");
 
+namespace {
+
+/** Whether the pcap files are written through a PcapWriter. */
+bool g_bufferedPcapFiles = false;
+
+/**
+ * \returns The writer of the shared pcapng file, if any.
+ */
+Ptr<PcapWriter> &
+GetSharedPcapWriter (void)
+{
+  static Ptr<PcapWriter> writer;
+  return writer;
+}
+
+/**
+ * \returns The writers created by PcapHelper, closed by Simulator::Destroy.
+ */
+std::vector<Ptr<PcapWriter> > &
+GetPcapWriters (void)
+{
+  static std::vector<Ptr<PcapWriter> > writers;
+  return writers;
+}
+
+/**
+ * Close the writers created by PcapHelper, so that their files are
+ * complete when the simulation is destroyed.
+ */
+void
+ClosePcapWriters (void)
+{
+  std::vector<Ptr<PcapWriter> > &writers = GetPcapWriters ();
+  for (std::vector<Ptr<PcapWriter> >::iterator i = writers.begin (); i != writers.end (); ++i)
+    {
+      (*i)->Close ();
+    }
+  writers.clear ();
+  GetSharedPcapWriter () = 0;
+}
+
+/**
+ * Create and open a writer, which Simulator::Destroy will close.
+ * \param filename The name of the file.
+ * \param format The format of the file.
+ * \returns The writer.
+ */
+Ptr<PcapWriter>
+CreatePcapWriter (std::string filename, PcapWriter::Format format)
+{
+  Ptr<PcapWriter> writer = CreateObject<PcapWriter> ();
+  writer->SetAttribute ("Format", EnumValue (format));
+  NS_ABORT_MSG_UNLESS (writer->Open (filename), "Unable to Open " << filename);
+  std::vector<Ptr<PcapWriter> > &writers = GetPcapWriters ();
+  if (writers.empty ())
+    {
+      Simulator::ScheduleDestroy (&ClosePcapWriters);
+    }
+  writers.push_back (writer);
+  return writer;
+}
+
+/** Whether the ascii trace files are written in the binary format. */
+bool g_binaryAsciiFiles = false;
+
+} // unnamed namespace
+
 PcapHelper::PcapHelper ()
 {
   NS_LOG_FUNCTION_NOARGS ();
@@ -56,6 +127,26 @@ PcapHelper::CreateFile (
   NS_LOG_FUNCTION (filename << filemode << dataLinkType << snapLen << tzCorrection);
 
   Ptr<PcapFileWrapper> file = CreateObject<PcapFileWrapper> ();
+  Ptr<PcapWriter> writer = GetSharedPcapWriter ();
+  if ((g_bufferedPcapFiles || writer) && !(filemode & (std::ios::in | std::ios::app)))
+    {
+      std::string name = filename;
+      if (writer)
+        {
+          std::string::size_type extension = name.rfind (".pcap");
+          if (extension != std::string::npos && extension + 5 == name.size ())
+            {
+              name.erase (extension);
+            }
+        }
+      else
+        {
+          writer = CreatePcapWriter (filename, PcapWriter::PCAP);
+        }
+      file->SetWriter (writer, writer->AddInterface (name, dataLinkType, snapLen, tzCorrection));
+      return file;
+    }
+
   file->Open (filename, filemode);
   NS_ABORT_MSG_IF (file->Fail (), "Unable to Open " << filename << " for mode " << filemode);
 
@@ -76,6 +167,20 @@ PcapHelper::CreateFile (
   return file;
 }
 
+void
+PcapHelper::EnableBufferedFiles (bool enable)
+{
+  NS_LOG_FUNCTION (enable);
+  g_bufferedPcapFiles = enable;
+}
+
+void
+PcapHelper::EnableSharedFile (std::string filename)
+{
+  NS_LOG_FUNCTION (filename);
+  GetSharedPcapWriter () = filename.empty () ? 0 : CreatePcapWriter (filename, PcapWriter::PCAPNG);
+}
+
 std::string
 PcapHelper::GetFilenameFromDevice (std::string prefix, Ptr<NetDevice> device, bool useObjectNames)
 {
@@ -187,11 +292,25 @@ AsciiTraceHelper::~AsciiTraceHelper ()
   NS_LOG_FUNCTION_NOARGS ();
 }
 
+void
+AsciiTraceHelper::EnableBinaryFormat (bool enable)
+{
+  NS_LOG_FUNCTION (enable);
+  g_binaryAsciiFiles = enable;
+}
+
 Ptr<OutputStreamWrapper>
 AsciiTraceHelper::CreateFileStream (std::string filename, std::ios::openmode filemode)
 {
   NS_LOG_FUNCTION (filename << filemode);
 
+  if (g_binaryAsciiFiles)
+    {
+      Ptr<OutputStreamWrapper> stream = Create<OutputStreamWrapper> (filename, filemode | std::ios::binary);
+      BinaryTraceStream::Attach (stream);
+      return stream;
+    }
+
   Ptr<OutputStreamWrapper> StreamWrapper = Create<OutputStreamWrapper> (filename, filemode);
 
   //
@@ -310,6 +429,10 @@ void
 AsciiTraceHelper::DefaultEnqueueSinkWithoutContext (Ptr<OutputStreamWrapper> stream, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (stream << p);
+  if (BinaryTraceStream::TryRecord (stream, '+', std::string (), p))
+    {
+      return;
+    }
   *stream->GetStream () << "+ " << Simulator::Now ().GetSeconds () << " " << *p << std::endl;
 }
 
@@ -317,6 +440,10 @@ void
 AsciiTraceHelper::DefaultEnqueueSinkWithContext (Ptr<OutputStreamWrapper> stream, std::string context, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (stream << p);
+  if (BinaryTraceStream::TryRecord (stream, '+', context, p))
+    {
+      return;
+    }
   *stream->GetStream () << "+ " << Simulator::Now ().GetSeconds () << " " << context << " " << *p << std::endl;
 }
 
@@ -336,6 +463,10 @@ void
 AsciiTraceHelper::DefaultDropSinkWithoutContext (Ptr<OutputStreamWrapper> stream, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (stream << p);
+  if (BinaryTraceStream::TryRecord (stream, 'd', std::string (), p))
+    {
+      return;
+    }
   *stream->GetStream () << "d " << Simulator::Now ().GetSeconds () << " " << *p << std::endl;
 }
 
@@ -343,6 +474,10 @@ void
 AsciiTraceHelper::DefaultDropSinkWithContext (Ptr<OutputStreamWrapper> stream, std::string context, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (stream << p);
+  if (BinaryTraceStream::TryRecord (stream, 'd', context, p))
+    {
+      return;
+    }
   *stream->GetStream () << "d " << Simulator::Now ().GetSeconds () << " " << context << " " << *p << std::endl;
 }
 
@@ -363,6 +498,10 @@ void
 AsciiTraceHelper::DefaultDequeueSinkWithoutContext (Ptr<OutputStreamWrapper> stream, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (stream << p);
+  if (BinaryTraceStream::TryRecord (stream, '-', std::string (), p))
+    {
+      return;
+    }
   *stream->GetStream () << "- " << Simulator::Now ().GetSeconds () << " " << *p << std::endl;
 }
 
@@ -370,6 +509,10 @@ void
 AsciiTraceHelper::DefaultDequeueSinkWithContext (Ptr<OutputStreamWrapper> stream, std::string context, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (stream << p);
+  if (BinaryTraceStream::TryRecord (stream, '-', context, p))
+    {
+      return;
+    }
   *stream->GetStream () << "- " << Simulator::Now ().GetSeconds () << " " << context << " " << *p << std::endl;
 }
 
@@ -387,6 +530,10 @@ void
 AsciiTraceHelper::DefaultReceiveSinkWithoutContext (Ptr<OutputStreamWrapper> stream, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (stream << p);
+  if (BinaryTraceStream::TryRecord (stream, 'r', std::string (), p))
+    {
+      return;
+    }
   *stream->GetStream () << "r " << Simulator::Now ().GetSeconds () << " " << *p << std::endl;
 }
 
@@ -394,6 +541,10 @@ void
 AsciiTraceHelper::DefaultReceiveSinkWithContext (Ptr<OutputStreamWrapper> stream, std::string context, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (stream << p);
+  if (BinaryTraceStream::TryRecord (stream, 'r', context, p))
+    {
+      return;
+    }
   *stream->GetStream () << "r " << Simulator::Now ().GetSeconds () << " " << context << " " << *p << std::endl;
 }
 
@@ -110,6 +110,29 @@ public:
                                    DataLinkType dataLinkType,
                                    uint32_t snapLen = std::numeric_limits<uint32_t>::max (),
                                    int32_t tzCorrection = 0);
+
+  /**
+   * @brief Write the pcap files created from now on through a PcapWriter,
+   * which buffers their records and writes them out from a background
+   * thread.  Simulator::Destroy closes the files.
+   *
+   * The "CaptureSize", "BufferSize" and "NanosecMode" attributes of
+   * ns3::PcapWriter then apply instead of those of ns3::PcapFileWrapper.
+   *
+   * @param enable whether to buffer the pcap files
+   */
+  static void EnableBufferedFiles (bool enable);
+
+  /**
+   * @brief Write the traces of the pcap files created from now on to a
+   * single pcapng file, as one interface per trace, named after the file
+   * it replaces.  Simulator::Destroy closes the file.
+   *
+   * @param filename name of the pcapng file, or an empty string to create
+   * one file per trace again
+   */
+  static void EnableSharedFile (std::string filename);
+
   /**
    * @brief Hook a trace source to the default trace sink
    * 
@@ -223,6 +246,18 @@ public:
   Ptr<OutputStreamWrapper> CreateFileStream (std::string filename, 
                                              std::ios::openmode filemode = std::ios::out);
 
+  /**
+   * @brief Write the trace files created from now on by CreateFileStream in
+   * the columnar binary format of BinaryTraceStream.  The default sinks
+   * record the events of these files instead of printing the packets, as
+   * do the ascii sinks of InternetStackHelper, and BinaryTraceReader
+   * converts them back to text.  Helpers with sinks of their own, such as
+   * those of wifi, keep printing text and must not trace to binary files.
+   *
+   * @param enable whether to write binary trace files
+   */
+  static void EnableBinaryFormat (bool enable);
+
   /**
    * @brief Hook a trace source to the default enqueue operation trace sink that
    * does not accept nor log a trace context.
@@ -18,6 +18,7 @@
  * Author: Mathieu Lacage <mathieu.lacage@sophia.inria.fr>
  */
 #include "buffer.h"
+#include "data-pool.h"
 #include "ns3/assert.h"
 #include "ns3/log.h"
 
@@ -51,98 +52,7 @@ NS_LOG_COMPONENT_DEFINE ("Buffer");
 
 
 uint32_t Buffer::g_recommendedStart = 0;
-#ifdef BUFFER_FREE_LIST
-/* The following macros are pretty evil but they are needed to allow us to
- * keep track of 3 possible states for the g_freeList variable:
- *  - uninitialized means that no one has created a buffer yet
- *    so no one has created the associated free list (it is created
- *    on-demand when the first buffer is created)
- *  - initialized means that the free list exists and is valid
- *  - destroyed means that the static destructors of this compilation unit
- *    have run so, the free list has been cleared from its content
- * The key is that in destroyed state, we are careful not re-create it
- * which is a typical weakness of lazy evaluation schemes which use 
- * '0' as a special value to indicate both un-initialized and destroyed.
- * Note that it is important to use '0' as the marker for un-initialized state
- * because the variable holding this state information is initialized to zero
- * which the compiler assigns to zero-memory which is initialized to _zero_
- * before the constructors run so this ensures perfect handling of crazy 
- * constructor orderings.
- */
-#define MAGIC_DESTROYED (~(long) 0)
-#define IS_UNINITIALIZED(x) (x == (Buffer::FreeList*)0)
-#define IS_DESTROYED(x) (x == (Buffer::FreeList*)MAGIC_DESTROYED)
-#define IS_INITIALIZED(x) (!IS_UNINITIALIZED (x) && !IS_DESTROYED (x))
-#define DESTROYED ((Buffer::FreeList*)MAGIC_DESTROYED)
-#define UNINITIALIZED ((Buffer::FreeList*)0)
-uint32_t Buffer::g_maxSize = 0;
-Buffer::FreeList *Buffer::g_freeList = 0;
-struct Buffer::LocalStaticDestructor Buffer::g_localStaticDestructor;
-
-Buffer::LocalStaticDestructor::~LocalStaticDestructor(void)
-{
-  NS_LOG_FUNCTION (this);
-  if (IS_INITIALIZED (g_freeList))
-    {
-      for (Buffer::FreeList::iterator i = g_freeList->begin ();
-           i != g_freeList->end (); i++)
-        {
-          Buffer::Deallocate (*i);
-        }
-      delete g_freeList;
-      g_freeList = DESTROYED;
-    }
-}
 
-void
-Buffer::Recycle (struct Buffer::Data *data)
-{
-  NS_LOG_FUNCTION (data);
-  NS_ASSERT (data->m_count == 0);
-  NS_ASSERT (!IS_UNINITIALIZED (g_freeList));
-  g_maxSize = std::max (g_maxSize, data->m_size);
-  /* feed into free list */
-  if (data->m_size < g_maxSize ||
-      IS_DESTROYED (g_freeList) ||
-      g_freeList->size () > 1000)
-    {
-      Buffer::Deallocate (data);
-    }
-  else
-    {
-      NS_ASSERT (IS_INITIALIZED (g_freeList));
-      g_freeList->push_back (data);
-    }
-}
-
-Buffer::Data *
-Buffer::Create (uint32_t dataSize)
-{
-  NS_LOG_FUNCTION (dataSize);
-  /* try to find a buffer correctly sized. */
-  if (IS_UNINITIALIZED (g_freeList))
-    {
-      g_freeList = new Buffer::FreeList ();
-    }
-  else if (IS_INITIALIZED (g_freeList))
-    {
-      while (!g_freeList->empty ()) 
-        {
-          struct Buffer::Data *data = g_freeList->back ();
-          g_freeList->pop_back ();
-          if (data->m_size >= dataSize) 
-            {
-              data->m_count = 1;
-              return data;
-            }
-          Buffer::Deallocate (data);
-        }
-    }
-  struct Buffer::Data *data = Buffer::Allocate (dataSize);
-  NS_ASSERT (data->m_count == 1);
-  return data;
-}
-#else /* BUFFER_FREE_LIST */
 void
 Buffer::Recycle (struct Buffer::Data *data)
 {
@@ -157,7 +67,6 @@ Buffer::Create (uint32_t size)
   NS_LOG_FUNCTION (size);
   return Allocate (size);
 }
-#endif /* BUFFER_FREE_LIST */
 
 struct Buffer::Data *
 Buffer::Allocate (uint32_t reqSize)
@@ -169,9 +78,14 @@ Buffer::Allocate (uint32_t reqSize)
     }
   NS_ASSERT (reqSize >= 1);
   uint32_t size = reqSize - 1 + sizeof (struct Buffer::Data);
+#ifdef BUFFER_DATA_POOL
+  size = DataPool::GetBlockSize (size);
+  uint8_t *b = static_cast<uint8_t *> (DataPool::Allocate (size));
+#else
   uint8_t *b = new uint8_t [size];
+#endif
   struct Buffer::Data *data = reinterpret_cast<struct Buffer::Data*>(b);
-  data->m_size = reqSize;
+  data->m_size = size + 1 - sizeof (struct Buffer::Data);
   data->m_count = 1;
   return data;
 }
@@ -182,7 +96,11 @@ Buffer::Deallocate (struct Buffer::Data *data)
   NS_LOG_FUNCTION (data);
   NS_ASSERT (data->m_count == 0);
   uint8_t *buf = reinterpret_cast<uint8_t *> (data);
+#ifdef BUFFER_DATA_POOL
+  DataPool::Deallocate (buf, data->m_size - 1 + sizeof (struct Buffer::Data));
+#else
   delete [] buf;
+#endif
 }
 
 Buffer::Buffer ()
@@ -327,7 +245,13 @@ Buffer::AddAtStart (uint32_t start)
     {
       uint32_t newSize = GetInternalSize () + start;
       struct Buffer::Data *newData = Buffer::Create (newSize);
-      memcpy (newData->m_data + start, m_data->m_data + m_start, GetInternalSize ());
+      /* Keep the spare bytes of the new data in front of the buffer, up to
+       * the recommended start, so that the headers added next, e.g. the
+       * lower layer headers of a fragment which shared the data of its
+       * packet, do not copy the buffer again.
+       */
+      uint32_t headroom = std::min (newData->m_size - newSize, g_recommendedStart);
+      memcpy (newData->m_data + headroom + start, m_data->m_data + m_start, GetInternalSize ());
       m_data->m_count--;
       if (m_data->m_count == 0)
         {
@@ -335,7 +259,7 @@ Buffer::AddAtStart (uint32_t start)
         }
       m_data = newData;
 
-      int32_t delta = start - m_start;
+      int32_t delta = headroom + start - m_start;
       m_start += delta;
       m_zeroAreaStart += delta;
       m_zeroAreaEnd += delta;
@@ -401,9 +325,17 @@ Buffer::AddAtEnd (const Buffer &o)
 {
   NS_LOG_FUNCTION (this << &o);
 
-  if (m_data->m_count == 1 &&
-      (m_end == m_zeroAreaEnd || m_zeroAreaStart == m_zeroAreaEnd) &&
-      m_end == m_data->m_dirtyEnd &&
+  if (o.m_data == m_data && LinkAtEnd (o))
+    {
+      /**
+       * The two buffers are adjacent slices of the same data, e.g.
+       * two consecutive fragments of a packet: no copy is needed.
+       */
+      NS_ASSERT (CheckInternalState ());
+      return;
+    }
+
+  if ((m_end == m_zeroAreaEnd || m_zeroAreaStart == m_zeroAreaEnd) &&
       o.m_start == o.m_zeroAreaStart &&
       o.m_zeroAreaEnd - o.m_zeroAreaStart > 0)
     {
@@ -412,6 +344,23 @@ Buffer::AddAtEnd (const Buffer &o)
        * we attempt to aggregate two buffers which contain
        * adjacent zero areas.
        */
+      if (m_data->m_count != 1 || m_end != m_data->m_dirtyEnd)
+        {
+          /* The data is shared, e.g. with the packet this buffer is a
+           * fragment of: copy the real bytes to data of its own, but
+           * keep the zero area virtual.
+           */
+          Buffer tmp (m_zeroAreaEnd - m_zeroAreaStart);
+          uint32_t dataStart = m_zeroAreaStart - m_start;
+          tmp.AddAtStart (dataStart);
+          tmp.Begin ().Write (m_data->m_data + m_start, dataStart);
+          uint32_t dataEnd = m_end - m_zeroAreaEnd;
+          tmp.AddAtEnd (dataEnd);
+          Buffer::Iterator i = tmp.End ();
+          i.Prev (dataEnd);
+          i.Write (m_data->m_data + m_zeroAreaStart, dataEnd);
+          *this = tmp;
+        }
       if (m_zeroAreaStart == m_zeroAreaEnd)
         {
           m_zeroAreaStart = m_end;
@@ -439,6 +388,47 @@ Buffer::AddAtEnd (const Buffer &o)
   NS_ASSERT (CheckInternalState ());
 }
 
+bool
+Buffer::LinkAtEnd (const Buffer &o)
+{
+  NS_LOG_FUNCTION (this << &o);
+  NS_ASSERT (o.m_data == m_data);
+  if (o.m_zeroAreaStart == o.m_zeroAreaEnd)
+    {
+      /* The real bytes of o must follow those of this buffer:
+       * This:   |xxxx0000....|
+       * o:                   |......|
+       * After:  |xxxx0000..........|
+       */
+      if (o.m_start != GetInternalEnd ())
+        {
+          return false;
+        }
+      m_end += o.m_end - o.m_start;
+      return true;
+    }
+  /* The zero area of o must continue that of this buffer, at the
+   * same place in the data:
+   * This:   |xxxx0000|
+   * o:               |0000....|
+   * After:  |xxxx00000000....|
+   */
+  if (o.m_start != o.m_zeroAreaStart
+      || (m_end != m_zeroAreaEnd && m_zeroAreaStart != m_zeroAreaEnd)
+      || o.m_zeroAreaStart != GetInternalEnd ())
+    {
+      return false;
+    }
+  if (m_zeroAreaStart == m_zeroAreaEnd)
+    {
+      m_zeroAreaStart = m_end;
+    }
+  m_zeroAreaEnd = m_end + (o.m_zeroAreaEnd - o.m_zeroAreaStart);
+  m_end = m_zeroAreaEnd + (o.m_end - o.m_zeroAreaEnd);
+  m_maxZeroAreaStart = std::max (m_maxZeroAreaStart, m_zeroAreaStart);
+  return true;
+}
+
 void 
 Buffer::RemoveAtStart (uint32_t start)
 {
@@ -1143,11 +1133,29 @@ Buffer::Iterator::CalculateIpChecksum (uint16_t size, uint32_t initialChecksum)
   NS_LOG_FUNCTION (this << size << initialChecksum);
   /* see RFC 1071 to understand this code. */
   uint32_t sum = initialChecksum;
+  uint32_t left = size;
 
-  for (int j = 0; j < size/2; j++)
-    sum += ReadU16 ();
+  while (left >= 2)
+    {
+      if (m_current >= m_zeroStart && m_current < m_zeroEnd)
+        {
+          /* The virtual zero bytes do not change the sum: skip them
+           * (an even number of them, to keep the byte order of the
+           * 16-bit words which follow).
+           */
+          uint32_t zeroes = std::min (m_zeroEnd - m_current, left) & ~1U;
+          if (zeroes > 0)
+            {
+              Next (zeroes);
+              left -= zeroes;
+              continue;
+            }
+        }
+      sum += ReadU16 ();
+      left -= 2;
+    }
 
-  if (size & 1)
+  if (left == 1)
     sum += ReadU8 ();
 
   while (sum >> 16)
@@ -25,7 +25,8 @@
 #include <ostream>
 #include "ns3/assert.h"
 
-#define BUFFER_FREE_LIST 1
+/// Allocate the buffer data storage from the DataPool
+#define BUFFER_DATA_POOL 1
 
 namespace ns3 {
 
@@ -358,6 +359,9 @@ public:
 
     /**
      * \brief Calculate the checksum.
+     *
+     * The virtual zero bytes of the buffer are skipped rather than read.
+     *
      * \param size size of the buffer.
      * \return checksum
      */
@@ -524,7 +528,11 @@ private:
   /**
    * \param o the buffer to append to the end of this buffer.
    *
-   * Add bytes at the end of the Buffer.
+   * Add bytes at the end of the Buffer.  If the two buffers
+   * reference adjacent bytes of the same data, e.g. if they are
+   * consecutive fragments of the same buffer, no byte is copied.
+   * If the zero area of o follows the end of this buffer, the
+   * zero areas are merged and stay virtual.
    * Any call to this method invalidates any Iterator
    * pointing to this Buffer.
    */
@@ -551,7 +559,7 @@ private:
    * \param length
    *
    * \return a fragment of size length starting at offset
-   * start.
+   * start.  The fragment shares the data of this buffer.
    */
   Buffer CreateFragment (uint32_t start, uint32_t length) const;
 
@@ -693,6 +701,16 @@ private:
    */
   Buffer CreateFullCopy (void) const;
 
+  /**
+   * \brief Append a buffer which references the same data without
+   * copying it, if the bytes of the buffer follow those of this buffer
+   * in the data.
+   *
+   * \param o the buffer to append, which references the same data
+   * \returns true if the buffer was appended
+   */
+  bool LinkAtEnd (const Buffer &o);
+
   /**
    * \brief Transform a "Virtual byte buffer" into a "Real byte buffer"
    */
@@ -789,19 +807,6 @@ private:
    * instance from the start of m_data->m_data
    */
   uint32_t m_end;
-
-#ifdef BUFFER_FREE_LIST
-  /// Container for buffer data
-  typedef std::vector<struct Buffer::Data*> FreeList;
-  /// Local static destructor structure
-  struct LocalStaticDestructor 
-  {
-    ~LocalStaticDestructor ();
-  };
-  static uint32_t g_maxSize; //!< Max observed data size
-  static FreeList *g_freeList; //!< Buffer data container
-  static struct LocalStaticDestructor g_localStaticDestructor; //!< Local static destructor
-#endif
 };
 
 } // namespace ns3
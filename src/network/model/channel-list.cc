@@ -19,6 +19,7 @@
 #include "ns3/simulator.h"
 #include "ns3/object-vector.h"
 #include "ns3/config.h"
+#include <limits>
 #include "ns3/log.h"
 #include "ns3/assert.h"
 #include "channel-list.h"
@@ -53,6 +54,13 @@ public:
    */
   uint32_t Add (Ptr<Channel> channel);
 
+  /**
+   * \param channel channel to remove
+   *
+   * Remove a channel from this list, and dispose of it.
+   */
+  void Remove (Ptr<Channel> channel);
+
   /**
    * \returns a C++ iterator located at the beginning of this
    *          list.
@@ -68,12 +76,19 @@ public:
    * \param n index of requested channel.
    * \returns the Channel associated to index n.
    */
-  Ptr<Channel> GetChannel (uint32_t n);
+  Ptr<Channel> GetChannel (uint32_t n) const;
+
+  /**
+   * \param n index of requested channel.
+   * \returns the Channel associated to index n, or 0 if there is no
+   *          such channel.
+   */
+  Ptr<Channel> Find (uint32_t n) const;
 
   /**
    * \returns the number of channels currently in the list.
    */
-  uint32_t GetNChannels (void);
+  uint32_t GetNChannels (void) const;
 
   /**
    * \brief Get the channel list object
@@ -98,7 +113,49 @@ private:
    */
   virtual void DoDispose (void);
 
+  /// The index of the removed channels in m_index
+  static const uint32_t REMOVED = std::numeric_limits<uint32_t>::max ();
+
   std::vector<Ptr<Channel> > m_channels; //!< channel objects container
+  std::vector<uint32_t> m_index;         //!< the position of each channel id in m_channels
+};
+
+/**
+ * \ingroup network
+ * \brief Accessor of the ChannelList attribute of ChannelListPriv.
+ *
+ * The channels are indexed by their id, rather than by their position
+ * in the list.
+ */
+class ChannelListAccessor : public ObjectPtrContainerAccessor
+{
+private:
+  virtual bool DoGetN (const ObjectBase *object, std::size_t *n) const
+  {
+    const ChannelListPriv *list = dynamic_cast<const ChannelListPriv *> (object);
+    if (list == 0)
+      {
+        return false;
+      }
+    *n = list->GetNChannels ();
+    return true;
+  }
+  virtual Ptr<Object> DoGet (const ObjectBase *object, std::size_t i, std::size_t *index) const
+  {
+    const ChannelListPriv *list = static_cast<const ChannelListPriv *> (object);
+    Ptr<Channel> channel = *(list->Begin () + i);
+    *index = channel->GetId ();
+    return channel;
+  }
+  virtual Ptr<Object> DoFind (const ObjectBase *object, std::size_t index) const
+  {
+    const ChannelListPriv *list = dynamic_cast<const ChannelListPriv *> (object);
+    if (list == 0 || index > std::numeric_limits<uint32_t>::max ())
+      {
+        return 0;
+      }
+    return list->Find (index);
+  }
 };
 
 NS_OBJECT_ENSURE_REGISTERED (ChannelListPriv);
@@ -111,7 +168,7 @@ ChannelListPriv::GetTypeId (void)
     .SetGroupName("Network")
     .AddAttribute ("ChannelList", "The list of all channels created during the simulation.",
                    ObjectVectorValue (),
-                   MakeObjectVectorAccessor (&ChannelListPriv::m_channels),
+                   Ptr<const AttributeAccessor> (new ChannelListAccessor (), false),
                    MakeObjectVectorChecker<Channel> ())
   ;
   return tid;
@@ -167,6 +224,7 @@ ChannelListPriv::DoDispose (void)
       *i = 0;
     }
   m_channels.erase (m_channels.begin (), m_channels.end ());
+  m_index.clear ();
   Object::DoDispose ();
 }
 
@@ -174,12 +232,29 @@ uint32_t
 ChannelListPriv::Add (Ptr<Channel> channel)
 {
   NS_LOG_FUNCTION (this << channel);
-  uint32_t index = m_channels.size ();
+  uint32_t index = m_index.size ();
+  m_index.push_back (m_channels.size ());
   m_channels.push_back (channel);
   return index;
 
 }
 
+void
+ChannelListPriv::Remove (Ptr<Channel> channel)
+{
+  NS_LOG_FUNCTION (this << channel);
+  uint32_t id = channel->GetId ();
+  NS_ASSERT_MSG (Find (id) == channel, "Channel " << id << " is not in the list.");
+  // move the last channel to the place of the removed one
+  uint32_t position = m_index[id];
+  Ptr<Channel> last = m_channels.back ();
+  m_channels[position] = last;
+  m_index[last->GetId ()] = position;
+  m_channels.pop_back ();
+  m_index[id] = REMOVED;
+  channel->Dispose ();
+}
+
 ChannelList::Iterator 
 ChannelListPriv::Begin (void) const
 {
@@ -195,19 +270,30 @@ ChannelListPriv::End (void) const
 }
 
 uint32_t 
-ChannelListPriv::GetNChannels (void)
+ChannelListPriv::GetNChannels (void) const
 {
   NS_LOG_FUNCTION (this);
   return m_channels.size ();
 }
 
 Ptr<Channel>
-ChannelListPriv::GetChannel (uint32_t n)
+ChannelListPriv::GetChannel (uint32_t n) const
+{
+  NS_LOG_FUNCTION (this << n);
+  NS_ASSERT_MSG (n < m_index.size (), "Channel index " << n <<
+                 " is out of range (only have " << m_index.size () << " channels).");
+  return Find (n);
+}
+
+Ptr<Channel>
+ChannelListPriv::Find (uint32_t n) const
 {
   NS_LOG_FUNCTION (this << n);
-  NS_ASSERT_MSG (n < m_channels.size (), "Channel index " << n <<
-                 " is out of range (only have " << m_channels.size () << " channels).");
-  return m_channels[n];
+  if (n >= m_index.size () || m_index[n] == REMOVED)
+    {
+      return 0;
+    }
+  return m_channels[m_index[n]];
 }
 
 uint32_t
@@ -217,6 +303,13 @@ ChannelList::Add (Ptr<Channel> channel)
   return ChannelListPriv::Get ()->Add (channel);
 }
 
+void
+ChannelList::Remove (Ptr<Channel> channel)
+{
+  NS_LOG_FUNCTION (channel);
+  ChannelListPriv::Get ()->Remove (channel);
+}
+
 ChannelList::Iterator 
 ChannelList::Begin (void)
 {
@@ -34,6 +34,11 @@ class CallbackBase;
  * \brief the list of simulation channels.
  *
  * Every Channel created is automatically added to this list.
+ *
+ * As in the NodeList, a channel can be removed from the list during
+ * the simulation, and the ids of the channels are stable: the id of a
+ * removed channel is never reused.  After removals, the iterators do
+ * not walk the channels in the order of their ids.
  */
 class ChannelList
 {
@@ -49,6 +54,14 @@ public:
    * the user has little reason to call it himself.
    */
   static uint32_t Add (Ptr<Channel> channel);
+  /**
+   * \param channel channel to remove
+   *
+   * Remove a channel from this list, and dispose of it.  Its id is
+   * not reused.  The devices attached to the channel should not
+   * transmit on it anymore.
+   */
+  static void Remove (Ptr<Channel> channel);
   /**
    * \returns a C++ iterator located at the beginning of this
    *          list.
@@ -61,11 +74,18 @@ public:
   static Iterator End (void);
   /**
    * \param n index of requested channel.
-   * \returns the Channel associated to index n.
+   * \returns the Channel associated to index n, or 0 if the channel
+   *          was removed.
+   *
+   * The index of a channel is its id.
    */
   static Ptr<Channel> GetChannel (uint32_t n);
   /**
    * \returns the number of channels currently in the list.
+   *
+   * When channels were removed, the ids of the channels in the list
+   * are not all smaller than this number: walk the list with Begin
+   * and End.
    */
   static uint32_t GetNChannels (void);
 };
@@ -0,0 +1,296 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "data-pool.h"
+#include "ns3/assert.h"
+
+#include <algorithm>
+#include <atomic>
+#include <new>
+
+namespace {
+
+/** Number of size classes, from MIN_BLOCK to MAX_BLOCK bytes. */
+const uint32_t CLASSES = 11;
+/** Bytes of free blocks each thread caches per size class. */
+const uint32_t CACHE_BYTES = 256 * 1024;
+/** Minimum number of free blocks each thread caches per size class. */
+const uint32_t CACHE_BLOCKS = 8;
+
+/**
+ * Header of a free block.
+ */
+struct Block
+{
+  Block *next;       //!< Next block of the cache or batch
+  Block *nextBatch;  //!< Next batch of the global list
+  uint32_t count;    //!< Number of blocks of the batch
+};
+
+/**
+ * Free blocks cached by a thread.
+ *
+ * This is trivially destructible, so that the blocks freed by the static
+ * destructors, after the thread exit, can still be handled.
+ */
+struct Cache
+{
+  Block *head[CLASSES];     //!< Free blocks, per size class
+  uint32_t count[CLASSES];  //!< Number of free blocks, per size class
+  bool destroyed;           //!< Has the thread exited?
+};
+
+/** The free blocks of each thread. */
+thread_local Cache t_cache;
+
+/** The global lists of batches of free blocks, per size class. */
+std::atomic<Block *> g_batches[CLASSES];
+
+/** Bytes allocated from the system. */
+std::atomic<uint64_t> g_footprint (0);
+
+/**
+ * \param size the block size
+ * \returns the size class
+ */
+inline uint32_t
+GetClass (uint32_t size)
+{
+  uint32_t c = 0;
+  while ((ns3::DataPool::MIN_BLOCK << c) < size)
+    {
+      c++;
+    }
+  return c;
+}
+
+/**
+ * \param c the size class
+ * \returns the maximum number of free blocks a thread caches
+ */
+inline uint32_t
+GetCacheLimit (uint32_t c)
+{
+  return std::max (CACHE_BYTES / (ns3::DataPool::MIN_BLOCK << c), CACHE_BLOCKS);
+}
+
+/**
+ * Push batches to a global list.
+ * \param c the size class
+ * \param first the first batch
+ * \param last the last batch
+ */
+void
+PushBatches (uint32_t c, Block *first, Block *last)
+{
+  Block *head = g_batches[c].load (std::memory_order_relaxed);
+  do
+    {
+      last->nextBatch = head;
+    }
+  while (!g_batches[c].compare_exchange_weak (head, first,
+                                              std::memory_order_release,
+                                              std::memory_order_relaxed));
+}
+
+/**
+ * Pop a batch from a global list.
+ * \param c the size class
+ * \returns the batch, or 0
+ */
+Block *
+PopBatch (uint32_t c)
+{
+  // Take the whole list, which is immune to the ABA problem, and put back
+  // all the batches but the first one.
+  Block *batch = g_batches[c].exchange (0, std::memory_order_acquire);
+  if (batch != 0 && batch->nextBatch != 0)
+    {
+      Block *last = batch->nextBatch;
+      while (last->nextBatch != 0)
+        {
+          last = last->nextBatch;
+        }
+      PushBatches (c, batch->nextBatch, last);
+    }
+  return batch;
+}
+
+/**
+ * Move blocks from the cache of the thread to the global list.
+ * \param c the size class
+ * \param n the number of blocks
+ */
+void
+Flush (uint32_t c, uint32_t n)
+{
+  Block *first = t_cache.head[c];
+  Block *last = first;
+  for (uint32_t i = 1; i < n; i++)
+    {
+      last = last->next;
+    }
+  t_cache.head[c] = last->next;
+  t_cache.count[c] -= n;
+  last->next = 0;
+  first->count = n;
+  PushBatches (c, first, first);
+}
+
+/**
+ * Flush the cache of a thread when it exits.
+ */
+struct CacheFlusher
+{
+  ~CacheFlusher ()
+  {
+    for (uint32_t c = 0; c < CLASSES; c++)
+      {
+        if (t_cache.count[c] > 0)
+          {
+            Flush (c, t_cache.count[c]);
+          }
+      }
+    t_cache.destroyed = true;
+  }
+};
+
+/** Flushes the cache of each thread at exit. */
+thread_local CacheFlusher t_flusher;
+
+/**
+ * Get the cache of the current thread, making sure it is flushed when
+ * the thread exits.
+ * \returns The cache of the current thread.
+ */
+Cache &
+GetCache (void)
+{
+  static_cast<void> (&t_flusher);
+  return t_cache;
+}
+
+/**
+ * Free the global lists at the end of the program.
+ */
+struct GlobalDestructor
+{
+  ~GlobalDestructor ()
+  {
+    for (uint32_t c = 0; c < CLASSES; c++)
+      {
+        Block *batch = g_batches[c].exchange (0);
+        while (batch != 0)
+          {
+            Block *nextBatch = batch->nextBatch;
+            for (Block *block = batch; block != 0; )
+              {
+                Block *next = block->next;
+                ::operator delete (block);
+                g_footprint -= ns3::DataPool::MIN_BLOCK << c;
+                block = next;
+              }
+            batch = nextBatch;
+          }
+      }
+  }
+} g_globalDestructor; //!< Frees the global lists
+
+} // unnamed namespace
+
+namespace ns3 {
+
+uint32_t
+DataPool::GetBlockSize (uint32_t size)
+{
+  if (size > MAX_BLOCK)
+    {
+      return size;
+    }
+  uint32_t block = MIN_BLOCK;
+  while (block < size)
+    {
+      block <<= 1;
+    }
+  return block;
+}
+
+void *
+DataPool::Allocate (uint32_t size)
+{
+  if (size > MAX_BLOCK)
+    {
+      g_footprint.fetch_add (size, std::memory_order_relaxed);
+      return ::operator new (size);
+    }
+  NS_ASSERT (size == GetBlockSize (size));
+  uint32_t c = GetClass (size);
+  Cache &cache = GetCache ();
+  if (cache.head[c] == 0 && !cache.destroyed)
+    {
+      Block *batch = PopBatch (c);
+      if (batch != 0)
+        {
+          cache.head[c] = batch;
+          cache.count[c] = batch->count;
+        }
+    }
+  Block *block = cache.head[c];
+  if (block != 0)
+    {
+      cache.head[c] = block->next;
+      cache.count[c]--;
+      return block;
+    }
+  g_footprint.fetch_add (size, std::memory_order_relaxed);
+  return ::operator new (size);
+}
+
+void
+DataPool::Deallocate (void *p, uint32_t size)
+{
+  if (size > MAX_BLOCK)
+    {
+      g_footprint.fetch_sub (size, std::memory_order_relaxed);
+      ::operator delete (p);
+      return;
+    }
+  uint32_t c = GetClass (size);
+  Block *block = static_cast<Block *> (p);
+  Cache &cache = GetCache ();
+  if (cache.destroyed)
+    {
+      block->next = 0;
+      block->count = 1;
+      PushBatches (c, block, block);
+      return;
+    }
+  block->next = cache.head[c];
+  cache.head[c] = block;
+  cache.count[c]++;
+  uint32_t limit = GetCacheLimit (c);
+  if (cache.count[c] > limit)
+    {
+      Flush (c, limit / 2);
+    }
+}
+
+uint64_t
+DataPool::GetFootprint (void)
+{
+  return g_footprint.load (std::memory_order_relaxed);
+}
+
+} // namespace ns3
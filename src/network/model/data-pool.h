@@ -0,0 +1,75 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef DATA_POOL_H
+#define DATA_POOL_H
+
+#include <stdint.h>
+
+namespace ns3 {
+
+/**
+ * \ingroup packet
+ *
+ * \brief Size-classed memory pool for the Buffer and PacketMetadata data.
+ *
+ * Blocks are rounded up to a power of two between MIN_BLOCK and
+ * MAX_BLOCK bytes; larger blocks are not pooled.  Each thread keeps a
+ * bounded cache of free blocks per size class, which needs no
+ * synchronization, and keeps the blocks it frees close to the processor,
+ * and NUMA node, which touched them last.  When a cache overflows, half
+ * of it moves to a global lock-free list of batches, from which the
+ * caches of all the threads refill before allocating new blocks.
+ *
+ * The pool itself is thread-safe; the reference counts of the blocks are
+ * managed by their users.
+ */
+class DataPool
+{
+public:
+  /** Smallest pooled block, in bytes. */
+  static const uint32_t MIN_BLOCK = 64;
+  /** Largest pooled block, in bytes. */
+  static const uint32_t MAX_BLOCK = 65536;
+
+  /**
+   * \brief Get the size of the block allocated for a request.
+   * \param size the requested size, in bytes
+   * \returns the size of the block, which is at least \p size
+   */
+  static uint32_t GetBlockSize (uint32_t size);
+  /**
+   * \brief Allocate a block.
+   * \param size the size of the block, as returned by GetBlockSize()
+   * \returns the block
+   */
+  static void *Allocate (uint32_t size);
+  /**
+   * \brief Free a block.
+   * \param block the block
+   * \param size the size of the block, as returned by GetBlockSize()
+   */
+  static void Deallocate (void *block, uint32_t size);
+
+  /**
+   * \returns the number of bytes of the blocks currently allocated from
+   *          the system, whether they are in use or cached by the pool
+   */
+  static uint64_t GetFootprint (void);
+};
+
+} // namespace ns3
+
+#endif /* DATA_POOL_H */
@@ -41,4 +41,19 @@ NetDevice::~NetDevice ()
   NS_LOG_FUNCTION (this);
 }
 
+uint32_t
+NetDevice::SendBatch (const std::vector<Ptr<Packet> > &packets, const Address& dest, uint16_t protocolNumber)
+{
+  NS_LOG_FUNCTION (this << packets.size () << dest << protocolNumber);
+  uint32_t sent = 0;
+  for (const Ptr<Packet> &packet : packets)
+    {
+      if (Send (packet, dest, protocolNumber))
+        {
+          sent++;
+        }
+    }
+  return sent;
+}
+
 } // namespace ns3
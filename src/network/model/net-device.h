@@ -22,6 +22,7 @@
 #define NET_DEVICE_H
 
 #include <stdint.h>
+#include <vector>
 #include "ns3/callback.h"
 #include "ns3/object.h"
 #include "ns3/ptr.h"
@@ -246,6 +247,21 @@ public:
    * \return whether the Send operation succeeded 
    */
   virtual bool Send (Ptr<Packet> packet, const Address& dest, uint16_t protocolNumber) = 0;
+  /**
+   * \param packets packets sent from above down to Network Device
+   * \param dest mac address of the destination (already resolved)
+   * \param protocolNumber identifies the type of payload contained in
+   *        these packets. Used to call the right L3Protocol when the packets
+   *        are received.
+   *
+   *  Called from higher layer to send a batch of packets into Network Device
+   *  to the specified destination Address, as if Send was called for each
+   *  packet in turn.  Devices override it to process the batch in a single
+   *  call; the default implementation calls Send for each packet.
+   *
+   * \return the number of packets for which the Send operation succeeded
+   */
+  virtual uint32_t SendBatch (const std::vector<Ptr<Packet> > &packets, const Address& dest, uint16_t protocolNumber);
   /**
    * \param packet packet sent from above down to Network Device
    * \param source source mac address (so called "MAC spoofing")
@@ -22,6 +22,7 @@
 #include "ns3/simulator.h"
 #include "ns3/object-vector.h"
 #include "ns3/config.h"
+#include <limits>
 #include "ns3/log.h"
 #include "ns3/assert.h"
 #include "node-list.h"
@@ -55,6 +56,13 @@ public:
    */
   uint32_t Add (Ptr<Node> node);
 
+  /**
+   * \param node node to remove
+   *
+   * Remove a node from this list, and dispose of it.
+   */
+  void Remove (Ptr<Node> node);
+
   /**
    * \returns a C++ iterator located at the beginning of this
    *          list.
@@ -71,12 +79,19 @@ public:
    * \param n index of requested node.
    * \returns the Node associated to index n.
    */
-  Ptr<Node> GetNode (uint32_t n);
+  Ptr<Node> GetNode (uint32_t n) const;
+
+  /**
+   * \param n index of requested node.
+   * \returns the Node associated to index n, or 0 if there is no such
+   *          node.
+   */
+  Ptr<Node> Find (uint32_t n) const;
 
   /**
    * \returns the number of nodes currently in the list.
    */
-  uint32_t GetNNodes (void);
+  uint32_t GetNNodes (void) const;
 
   /**
    * \brief Get the node list object
@@ -101,7 +116,50 @@ private:
    */
   virtual void DoDispose (void);
 
+  /// The index of the removed nodes in m_index
+  static const uint32_t REMOVED = std::numeric_limits<uint32_t>::max ();
+
   std::vector<Ptr<Node> > m_nodes; //!< node objects container
+  std::vector<uint32_t> m_index;   //!< the position of each node id in m_nodes
+};
+
+/**
+ * \ingroup network
+ * \brief Accessor of the NodeList attribute of NodeListPriv.
+ *
+ * The nodes are indexed by their id, rather than by their position in
+ * the list, so that the config paths "/NodeList/[i]" keep matching
+ * the same node when other nodes are removed.
+ */
+class NodeListAccessor : public ObjectPtrContainerAccessor
+{
+private:
+  virtual bool DoGetN (const ObjectBase *object, std::size_t *n) const
+  {
+    const NodeListPriv *list = dynamic_cast<const NodeListPriv *> (object);
+    if (list == 0)
+      {
+        return false;
+      }
+    *n = list->GetNNodes ();
+    return true;
+  }
+  virtual Ptr<Object> DoGet (const ObjectBase *object, std::size_t i, std::size_t *index) const
+  {
+    const NodeListPriv *list = static_cast<const NodeListPriv *> (object);
+    Ptr<Node> node = *(list->Begin () + i);
+    *index = node->GetId ();
+    return node;
+  }
+  virtual Ptr<Object> DoFind (const ObjectBase *object, std::size_t index) const
+  {
+    const NodeListPriv *list = dynamic_cast<const NodeListPriv *> (object);
+    if (list == 0 || index > std::numeric_limits<uint32_t>::max ())
+      {
+        return 0;
+      }
+    return list->Find (index);
+  }
 };
 
 NS_OBJECT_ENSURE_REGISTERED (NodeListPriv);
@@ -114,7 +172,7 @@ NodeListPriv::GetTypeId (void)
     .SetGroupName("Network")
     .AddAttribute ("NodeList", "The list of all nodes created during the simulation.",
                    ObjectVectorValue (),
-                   MakeObjectVectorAccessor (&NodeListPriv::m_nodes),
+                   Ptr<const AttributeAccessor> (new NodeListAccessor (), false),
                    MakeObjectVectorChecker<Node> ())
   ;
   return tid;
@@ -168,6 +226,7 @@ NodeListPriv::DoDispose (void)
       *i = 0;
     }
   m_nodes.erase (m_nodes.begin (), m_nodes.end ());
+  m_index.clear ();
   Object::DoDispose ();
 }
 
@@ -176,12 +235,28 @@ uint32_t
 NodeListPriv::Add (Ptr<Node> node)
 {
   NS_LOG_FUNCTION (this << node);
-  uint32_t index = m_nodes.size ();
+  uint32_t index = m_index.size ();
+  m_index.push_back (m_nodes.size ());
   m_nodes.push_back (node);
   Simulator::ScheduleWithContext (index, TimeStep (0), &Node::Initialize, node);
   return index;
 
 }
+void
+NodeListPriv::Remove (Ptr<Node> node)
+{
+  NS_LOG_FUNCTION (this << node);
+  uint32_t id = node->GetId ();
+  NS_ASSERT_MSG (Find (id) == node, "Node " << id << " is not in the list.");
+  // move the last node to the place of the removed one
+  uint32_t position = m_index[id];
+  Ptr<Node> last = m_nodes.back ();
+  m_nodes[position] = last;
+  m_index[last->GetId ()] = position;
+  m_nodes.pop_back ();
+  m_index[id] = REMOVED;
+  node->Dispose ();
+}
 NodeList::Iterator 
 NodeListPriv::Begin (void) const
 {
@@ -195,19 +270,30 @@ NodeListPriv::End (void) const
   return m_nodes.end ();
 }
 uint32_t 
-NodeListPriv::GetNNodes (void)
+NodeListPriv::GetNNodes (void) const
 {
   NS_LOG_FUNCTION (this);
   return m_nodes.size ();
 }
 
 Ptr<Node>
-NodeListPriv::GetNode (uint32_t n)
+NodeListPriv::GetNode (uint32_t n) const
+{
+  NS_LOG_FUNCTION (this << n);
+  NS_ASSERT_MSG (n < m_index.size (), "Node index " << n <<
+                 " is out of range (only have " << m_index.size () << " nodes).");
+  return Find (n);
+}
+
+Ptr<Node>
+NodeListPriv::Find (uint32_t n) const
 {
   NS_LOG_FUNCTION (this << n);
-  NS_ASSERT_MSG (n < m_nodes.size (), "Node index " << n <<
-                 " is out of range (only have " << m_nodes.size () << " nodes).");
-  return m_nodes[n];
+  if (n >= m_index.size () || m_index[n] == REMOVED)
+    {
+      return 0;
+    }
+  return m_nodes[m_index[n]];
 }
 
 }
@@ -225,6 +311,12 @@ NodeList::Add (Ptr<Node> node)
   NS_LOG_FUNCTION (node);
   return NodeListPriv::Get ()->Add (node);
 }
+void
+NodeList::Remove (Ptr<Node> node)
+{
+  NS_LOG_FUNCTION (node);
+  NodeListPriv::Get ()->Remove (node);
+}
 NodeList::Iterator 
 NodeList::Begin (void)
 {
@@ -36,6 +36,16 @@ class CallbackBase;
  * \brief the list of simulation nodes.
  *
  * Every Node created is automatically added to this list.
+ *
+ * A node can be removed from the list during the simulation, for
+ * example a satellite which deorbits.  The ids of the nodes are
+ * stable: the id of a removed node is never given to another node, and
+ * the other nodes keep theirs, so that the nodes can be added and
+ * removed over the whole simulation.  The list stores the nodes
+ * contiguously, which the iterators walk, and an index from the ids
+ * to the nodes, so that both the iterations and the lookups by id
+ * are cheap.  After removals, the iterators do not walk the nodes in
+ * the order of their ids.
  */
 class NodeList
 {
@@ -51,6 +61,14 @@ public:
    * the user has little reason to call it himself.
    */
   static uint32_t Add (Ptr<Node> node);
+  /**
+   * \param node node to remove
+   *
+   * Remove a node from this list, and dispose of it.  Its id is not
+   * reused.  The node should not have pending events, and should be
+   * detached from its channels.
+   */
+  static void Remove (Ptr<Node> node);
   /**
    * \returns a C++ iterator located at the beginning of this
    *          list.
@@ -63,11 +81,17 @@ public:
   static Iterator End (void);
   /**
    * \param n index of requested node.
-   * \returns the Node associated to index n.
+   * \returns the Node associated to index n, or 0 if the node was
+   *          removed.
+   *
+   * The index of a node is its id.
    */
   static Ptr<Node> GetNode (uint32_t n);
   /**
    * \returns the number of nodes currently in the list.
+   *
+   * When nodes were removed, the ids of the nodes in the list are not
+   * all smaller than this number: walk the list with Begin and End.
    */
   static uint32_t GetNNodes (void);
 };
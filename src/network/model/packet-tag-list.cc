@@ -20,7 +20,7 @@
 
 /**
 \file   packet-tag-list.cc
-\brief  Implements a linked list of Packet tags, including copy-on-write semantics.
+\brief  Implements a flat list of Packet tags, including copy-on-write semantics.
 */
 
 #include "packet-tag-list.h"
@@ -28,232 +28,147 @@
 #include "tag.h"
 #include "ns3/fatal-error.h"
 #include "ns3/log.h"
+#include <algorithm>
 #include <cstring>
+#include <limits>
+#include <new>
 
 namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("PacketTagList");
 
-PacketTagList::TagData *
-PacketTagList::CreateTagData (size_t dataSize)
+PacketTagList::Spill *
+PacketTagList::CreateSpill (uint32_t capacity)
 {
-  NS_ASSERT_MSG (dataSize
-                 < std::numeric_limits<decltype(TagData::size)>::max (),
-                 "Requested TagData size " << dataSize
-                 << " exceeds maximum "
-                 << std::numeric_limits<decltype(TagData::size)>::max () );
-
-  void * p = std::malloc (sizeof (TagData) + dataSize - 1);
-  // The matching frees are in RemoveAll and RemoveWriter
-
-  TagData * tag = new (p) TagData;
-  tag->size = dataSize;
-  return tag;
+  void * p = std::malloc (sizeof (Spill) - 4 + capacity);
+  // The matching frees are in RemoveAll and Erase
+
+  Spill * spill = new (p) Spill;
+  spill->count = 1;
+  spill->capacity = capacity;
+  return spill;
 }
 
-bool
-PacketTagList::COWTraverse (Tag & tag, PacketTagList::COWWriter Writer)
+PacketTagList::TagData *
+PacketTagList::Find (TypeId tid) const
 {
-  TypeId tid = tag.GetInstanceTypeId ();
-  NS_LOG_FUNCTION (this << tid);
-  NS_LOG_INFO     ("looking for " << tid);
-
-  // trivial case when list is empty
-  if (m_next == 0)
+  uint8_t *records = GetRecords ();
+  for (uint32_t offset = 0; offset < m_used; )
     {
-      return false;
+      TagData *cur = reinterpret_cast<TagData *> (records + offset);
+      if (cur->tid == tid)
+        {
+          return cur;
+        }
+      offset += GetRecordSize (cur->size);
     }
+  return 0;
+}
 
-  bool found = false;
-
-  struct TagData ** prevNext = &m_next; // previous node's next pointer
-  struct TagData  * cur      =  m_next; // cursor to current node
-  struct TagData  * it = 0;             // utility
+uint8_t *
+PacketTagList::Insert (uint32_t offset, uint32_t length)
+{
+  NS_LOG_FUNCTION (this << offset << length);
+  uint32_t used = m_used + length;
+  uint8_t *records = GetRecords ();
+  if ((m_spill == 0 && used <= INLINE_SIZE)
+      || (m_spill != 0 && m_spill->count == 1 && used <= m_spill->capacity))
+    {
+      std::memmove (records + offset + length, records + offset, m_used - offset);
+    }
+  else
+    {
+      NS_LOG_LOGIC ("spill " << used << " bytes");
+      Spill *spill = CreateSpill (std::max (2 * used, 2 * INLINE_SIZE));
+      std::memcpy (spill->data, records, offset);
+      std::memcpy (spill->data + offset + length, records + offset, m_used - offset);
+      RemoveAll ();
+      m_spill = spill;
+    }
+  m_used = used;
+  return GetRecords () + offset;
+}
 
-  // Search from the head of the list until we find tid or a merge
-  while (cur != 0)
+void
+PacketTagList::Erase (uint32_t offset, uint32_t length)
+{
+  NS_LOG_FUNCTION (this << offset << length);
+  uint32_t used = m_used - length;
+  uint8_t *records = GetRecords ();
+  if (m_spill != 0 && (m_spill->count > 1 || used <= INLINE_SIZE))
     {
-      if (cur->count > 1)
-        {
-          // found merge
-          NS_LOG_INFO ("found initial merge before tid");
-          break;
-        }
-      else if (cur->tid == tid)
+      // Copy the other records out of the spill region: the region is
+      // either shared, or no longer needed.
+      Spill *spill = m_spill;
+      uint8_t *copy;
+      if (used <= INLINE_SIZE)
         {
-          NS_LOG_INFO ("found tid before initial merge, calling writer");
-          found = (this->*Writer)(tag, true, cur, prevNext);
-          break;
+          m_spill = 0;
+          copy = GetRecords ();
         }
       else
         {
-          // no merge or tid found yet, move on
-          prevNext = &cur->next;
-          cur      =  cur->next;
+          m_spill = CreateSpill (spill->capacity);
+          copy = m_spill->data;
         }
-    }  // while !found && !cow
-
-  // did we find it or run out of tags?
-  if (cur == 0 || found)
-    {
-      NS_LOG_INFO ("returning after header with found: " << found);
-      return found;
-    }
-
-  // From here on out, we have to copy the list
-  // until we find tid, then link past it
-
-  // Before we do all that work, let's make sure tid really exists
-  for (it = cur; it != 0; it = it->next)
-    {
-      if (it->tid == tid)
+      std::memcpy (copy, records, offset);
+      std::memcpy (copy + offset, records + offset + length, m_used - offset - length);
+      spill->count--;
+      if (spill->count == 0)
         {
-          break;
+          std::free (spill);
         }
     }
-  if (it == 0)
-    {
-      // got to end of list without finding tid
-      NS_LOG_INFO ("tid not found after first merge");
-      return found;
-    }
-
-  // At this point cur is a merge, but untested for tid
-  NS_ASSERT (cur != 0);
-  NS_ASSERT (cur->count > 1);
-
-  /*
-     Walk the remainder of the list, copying, until we find tid
-     As we put a copy of the cur node onto our list,
-     we move the merge point down the list.
-
-     Starting position                  End position
-       T1 is a merge                     T1.count decremented
-                                         T2 is a merge
-                                         T1' is a copy of T1
-
-          other                             other
-               \                                 \
-      Prev  ->  T1  ->  T2  -> ...                T1  ->  T2  -> ...
-           /   /                                         /|
-      pNext cur                         Prev  ->  T1' --/ |
-                                                     /    |
-                                                pNext   cur
-
-     When we reach tid, we link past it, decrement count, and we're done.
-  */
-
-  // Should normally check for null cur pointer,
-  // but since we know tid exists, we'll skip this test
-  while ( /* cur && */ cur->tid != tid)
+  else
     {
-      NS_ASSERT (cur != 0);
-      NS_ASSERT (cur->count > 1);
-      cur->count--;                       // unmerge cur
-      struct TagData * copy = CreateTagData (cur->size);
-      copy->tid = cur->tid;
-      copy->count = 1;
-      copy->size = cur->size;
-      memcpy (copy->data, cur->data, copy->size);
-      copy->next = cur->next;             // merge into tail
-      copy->next->count++;                // mark new merge
-      *prevNext = copy;                   // point prior list at copy
-      prevNext = &copy->next;             // advance
-      cur      =  copy->next;
+      std::memmove (records + offset, records + offset + length, m_used - offset - length);
     }
-  // Sanity check:
-  NS_ASSERT (cur != 0);                 // cur should be non-zero
-  NS_ASSERT (cur->tid == tid);          // cur->tid should be tid
-  NS_ASSERT (cur->count > 1);           // cur should be a merge
-
-  // link around tid, removing it from our list
-  found = (this->*Writer)(tag, false, cur, prevNext);
-  return found;
-
+  m_used = used;
 }
 
 bool
 PacketTagList::Remove (Tag & tag)
 {
-  return COWTraverse (tag, &PacketTagList::RemoveWriter);
-}
-
-// COWWriter implementing Remove
-bool
-PacketTagList::RemoveWriter (Tag & tag, bool preMerge,
-                             struct PacketTagList::TagData  * cur,
-                             struct PacketTagList::TagData ** prevNext)
-{
-  NS_LOG_FUNCTION_NOARGS ();
-
-  // found tid
-  bool found = true;
-  tag.Deserialize (TagBuffer (cur->data, cur->data + cur->size));
-  *prevNext = cur->next;            // link around cur
-
-  if (preMerge)
-    {
-      // found tid before first merge, so delete cur
-      cur->~TagData ();
-      std::free (cur);
-    }
-  else
+  TypeId tid = tag.GetInstanceTypeId ();
+  NS_LOG_FUNCTION (this << tid);
+  TagData *cur = Find (tid);
+  if (cur == 0)
     {
-      // cur is always a merge at this point
-      // unmerge cur, since we linked around it already
-      cur->count--;
-      if (cur->next != 0)
-        {
-          // there's a next, so make it a merge
-          cur->next->count++;
-        }
+      return false;
     }
-  return found;
+  tag.Deserialize (TagBuffer (cur->data, cur->data + cur->size));
+  Erase (reinterpret_cast<uint8_t *> (cur) - GetRecords (), GetRecordSize (cur->size));
+  return true;
 }
 
 bool
 PacketTagList::Replace (Tag & tag)
 {
-  bool found = COWTraverse (tag, &PacketTagList::ReplaceWriter);
-  if (!found)
+  TypeId tid = tag.GetInstanceTypeId ();
+  NS_LOG_FUNCTION (this << tid);
+  TagData *cur = Find (tid);
+  if (cur == 0)
     {
       Add (tag);
+      return false;
     }
-  return found;
-}
-
-// COWWriter implementing Replace
-bool
-PacketTagList::ReplaceWriter (Tag & tag, bool preMerge,
-                              struct PacketTagList::TagData  * cur,
-                              struct PacketTagList::TagData ** prevNext)
-{
-  NS_LOG_FUNCTION_NOARGS ();
-
-  // found tid
-  bool found = true;
-  if (preMerge)
+  uint32_t offset = reinterpret_cast<uint8_t *> (cur) - GetRecords ();
+  uint32_t size = tag.GetSerializedSize ();
+  if (GetRecordSize (size) != GetRecordSize (cur->size))
     {
-      // found tid before first merge, so just rewrite
-      tag.Serialize (TagBuffer (cur->data, cur->data + cur->size));
+      Erase (offset, GetRecordSize (cur->size));
+      Add (tag);
+      return true;
     }
-  else
+  if (m_spill != 0 && m_spill->count > 1)
     {
-      // cur is always a merge at this point
-      // need to copy, replace, and link past cur
-      cur->count--;                     // unmerge cur
-      struct TagData * copy = CreateTagData (tag.GetSerializedSize ());
-      copy->tid = tag.GetInstanceTypeId ();
-      copy->count = 1;
-      tag.Serialize (TagBuffer (copy->data, copy->data + copy->size));
-      copy->next = cur->next;           // merge into tail
-      if (copy->next != 0)
-        {
-          copy->next->count++;          // mark new merge
-        }
-      *prevNext = copy;                 // point prior list at copy
+      // Rewrite a copy of the shared spill region.
+      Insert (m_used, 0);
+      cur = reinterpret_cast<TagData *> (GetRecords () + offset);
     }
-  return found;
+  cur->size = size;
+  tag.Serialize (TagBuffer (cur->data, cur->data + cur->size));
+  return true;
 }
 
 void
@@ -261,43 +176,54 @@ PacketTagList::Add (const Tag &tag) const
 {
   NS_LOG_FUNCTION (this << tag.GetInstanceTypeId ());
   // ensure this id was not yet added
-  for (struct TagData *cur = m_next; cur != 0; cur = cur->next)
-    {
-      NS_ASSERT_MSG (cur->tid != tag.GetInstanceTypeId (),
-                     "Error: cannot add the same kind of tag twice.");
-    }
-  struct TagData * head = CreateTagData (tag.GetSerializedSize ());
-  head->count = 1;
-  head->next = 0;
+  NS_ASSERT_MSG (Find (tag.GetInstanceTypeId ()) == 0,
+                 "Error: cannot add the same kind of tag twice.");
+  uint32_t size = tag.GetSerializedSize ();
+  NS_ASSERT_MSG (size < std::numeric_limits<uint16_t>::max (),
+                 "Requested TagData size " << size
+                 << " exceeds maximum " << std::numeric_limits<uint16_t>::max ());
+
+  PacketTagList *self = const_cast<PacketTagList *> (this);
+  TagData *head = new (self->Insert (0, GetRecordSize (size))) TagData;
   head->tid = tag.GetInstanceTypeId ();
-  head->next = m_next;
+  head->size = size;
   tag.Serialize (TagBuffer (head->data, head->data + head->size));
-
-  const_cast<PacketTagList *> (this)->m_next = head;
 }
 
 bool
 PacketTagList::Peek (Tag &tag) const
 {
   NS_LOG_FUNCTION (this << tag.GetInstanceTypeId ());
-  TypeId tid = tag.GetInstanceTypeId ();
-  for (struct TagData *cur = m_next; cur != 0; cur = cur->next)
+  TagData *cur = Find (tag.GetInstanceTypeId ());
+  if (cur == 0)
     {
-      if (cur->tid == tid)
-        {
-          /* found tag */
-          tag.Deserialize (TagBuffer (cur->data, cur->data + cur->size));
-          return true;
-        }
+      /* no tag found */
+      return false;
     }
-  /* no tag found */
-  return false;
+  /* found tag */
+  tag.Deserialize (TagBuffer (cur->data, cur->data + cur->size));
+  return true;
 }
 
 const struct PacketTagList::TagData *
 PacketTagList::Head (void) const
 {
-  return m_next;
+  if (m_used == 0)
+    {
+      return 0;
+    }
+  return reinterpret_cast<const TagData *> (GetRecords ());
+}
+
+const struct PacketTagList::TagData *
+PacketTagList::Next (const struct PacketTagList::TagData *tag) const
+{
+  const uint8_t *next = reinterpret_cast<const uint8_t *> (tag) + GetRecordSize (tag->size);
+  if (next == GetRecords () + m_used)
+    {
+      return 0;
+    }
+  return reinterpret_cast<const TagData *> (next);
 }
 
 uint32_t
@@ -309,7 +235,7 @@ PacketTagList::GetSerializedSize (void) const
 
   size = 4; // numberOfTags
 
-  for (struct TagData *cur = m_next; cur != 0; cur = cur->next)
+  for (const struct TagData *cur = Head (); cur != 0; cur = Next (cur))
     {
       size += 4; // TagData -> size
 
@@ -346,7 +272,7 @@ PacketTagList::Serialize (uint32_t* buffer, uint32_t maxSize) const
       return 0;
     }
 
-  for (struct TagData *cur = m_next; cur != 0; cur = cur->next)
+  for (const struct TagData *cur = Head (); cur != 0; cur = Next (cur))
     {
       if (size + 4 <= maxSize)
         {
@@ -407,7 +333,7 @@ PacketTagList::Deserialize (const uint32_t* buffer, uint32_t size)
 
   NS_LOG_INFO("Deserializing number of tags " << numberOfTags);
 
-  struct TagData * prevTag = 0;
+  RemoveAll ();
   for (uint32_t i = 0; i < numberOfTags; ++i)
     {
       NS_ASSERT (sizeCheck >= 4);
@@ -425,10 +351,10 @@ PacketTagList::Deserialize (const uint32_t* buffer, uint32_t size)
 
       NS_LOG_INFO ("Deserializing tag of type " << tid);
 
-      struct TagData * newTag = CreateTagData (tagSize);
-      newTag->count = 1;
-      newTag->next = 0;
+      // Append, to keep the order of the tags.
+      struct TagData * newTag = new (Insert (m_used, GetRecordSize (tagSize))) TagData;
       newTag->tid = tid;
+      newTag->size = tagSize;
 
       NS_ASSERT (sizeCheck >= tagSize);
       memcpy (newTag->data, p, tagSize);
@@ -437,18 +363,6 @@ PacketTagList::Deserialize (const uint32_t* buffer, uint32_t size)
       uint32_t tagWordSize = (tagSize+3) & (~3);
       p += tagWordSize / 4;
       sizeCheck -= tagWordSize;
-
-      // Set link list pointers.
-      if (i==0)
-        {
-          m_next = newTag;
-        }
-      else
-        {
-          prevTag->next = newTag;
-        }
-
-      prevTag = newTag;
     }
 
   NS_ASSERT (sizeCheck == 0);
@@ -22,10 +22,12 @@
 
 /**
 \file   packet-tag-list.h
-\brief  Defines a linked list of Packet tags, including copy-on-write semantics.
+\brief  Defines a flat list of Packet tags, including copy-on-write semantics.
 */
 
 #include <stdint.h>
+#include <cstdlib>
+#include <cstring>
 #include <ostream>
 #include "ns3/type-id.h"
 
@@ -43,88 +45,24 @@ class Tag;
  *
  * \internal
  *
- * The implementation of this class is a bit tricky.  Refer to this
- * diagram in the discussion that follows.
+ * The tags are stored in serialized form, as a contiguous sequence of
+ * TagData records, the most recent tag first.
  *
- * \dot
- *    digraph {
- *        rankdir = "LR";
- *        clusterrank = local;
- *        node [ shape = record, fontname="FreeSans", fontsize="10" ];
- *        oth  [ label="<l> Other branch | <n> next | <c> ..." ];
- *        PTL1 [ label="<l> PacketTagList A | <n> m_next" , shape=Mrecord];
- *        PTL2 [ label="<l> PacketTagList B | <n> m_next" , shape=Mrecord];
- *        oth:n  -> T7:l ;
- *        PTL2:n -> T6:l ;
- *        PTL1:n -> T5:l ;
- *        T1   [ label="<l> T1  | <n> next | <c> count = 1" ];
- *        T2   [ label="<l> T2  | <n> next | <c> count = 1" ];
- *        T3   [ label="<l> T3  | <n> next | <c> count = 2" ];
- *        T4   [ label="<l> T4  | <n> next | <c> count = 1" ];
- *        T5   [ label="<l> T5  | <n> next | <c> count = 2" ];
- *        T6   [ label="<l> T6  | <n> next | <c> count = 1" ];
- *        T7   [ label="<l> T7  | <n> next | <c> count = 1" ];
- *        NULL [ label="0", shape = ellipse ];
- *        subgraph cluster_list {
- *          penwidth = 0;
- *          T6:n -> T5:l ;
- *          T5:n -> T4:l ;
- *          T4:n -> T3:l ;
- *          T7:n -> T3:l ;
- *          T3:n -> T2:l ;
- *          T2:n -> T1:l ;
- *          T1:n -> NULL ;
- *        };
- *      }
- * \enddot
+ *   - As long as the records fit in INLINE_SIZE bytes, they are stored
+ *     in the PacketTagList itself, and copied along with it.  The few
+ *     tags a packet usually carries thus need no allocation.
  *
- *   - Tags are stored in serialized form in a tree of TagData
- *     structures. (<tt>T1-T7</tt> in the diagram)
- *
- *   - Each TagData points (\c next pointers in the diagram)
- *     toward the root of the tree, which is a null pointer.
- *
- *   - \c count is the number of incoming pointers to this
- *     TagData.  Branch points, where branches merge or join, have
- *     <tt>count \> 1</tt> (\c T3, \c T5); successive links along
- *     a branch have <tt>count = 1</tt> (\c T1, \c T2, \c T4, \c T6, \c T7).
- *
- *   - Each PacketTagList points to a specific TagData,
- *     which is the most recent Tag added to the packet. (<tt>T5-T7</tt>)
- *
- *   - Conceptually, therefore, each Packet has a PacketTagList which
- *     points to a singly-linked list of TagData.
- *
- * \par <b> Copy-on-write </b> is implemented as follows:
- *
- *   - #Add prepends the new tag to the list (growing that branch of the tree,
- *     as \c T6). This is a constant time operation, and does not affect
- *     any other #PacketTagList's, hence this is a \c const function.
- *
- *   - Copy constructor (PacketTagList(const PacketTagList & o))
- *     and assignment (#operator=(const PacketTagList & o))
- *     simply join the tree at the same place as the original
- *     PacketTagList \c o, incrementing the \c count.
- *     For assignment, the old branch is deleted, up to
- *     the first branch point, which has its \c count decremented.
- *     (PacketTagList \c B started as a copy of PacketTagList \c A,
- *     before \c T6 was added to \c B).
- *
- *   - #Remove and #Replace are a little tricky, depending on where the
- *     target tag is found relative to the first branch point:
- *     - \e Target before <em> the first branch point: </em> \n
- *       The target is just dealt with in place (linked around and deleted,
- *       in the case of #Remove; rewritten in the case of #Replace).
- *     - \e Target at or after <em> the first branch point: </em> \n
- *       The portion of the list between the first branch and the target is
- *       shared. This portion is copied before the #Remove or #Replace is
- *       performed.
+ *   - Beyond that, the records spill into a heap region which is shared
+ *     by the copies of the PacketTagList, and reference counted.  A shared
+ *     spill region is never modified: #Add, #Remove and #Replace first
+ *     copy it, which implements copy-on-write.  When the records fit
+ *     inline again, they move back from the spill region.
  */
 class PacketTagList 
 {
 public:
   /**
-   * Tree node for sharing serialized tags.
+   * Serialized tag record.
    *
    * See PacketTagList for a discussion of the data structure.
    *
@@ -134,19 +72,19 @@ public:
    * The Item nested class can't be forward declared, so friending isn't
    * possible.
    *
-   * We use placement new so we can allocate enough room for the Tag
-   * type which will be serialized into data.  See Object::Aggregates
-   * for a similar construction.
+   * The data area is as large as the Tag serialized into it, rounded
+   * up to 4 bytes, so that the next record is aligned.
    */
   struct TagData
   {
-    struct TagData * next;      /**< Pointer to next in list */
-    uint32_t count;             /**< Number of incoming links */
     TypeId tid;                 /**< Type of the tag serialized into #data */
     uint32_t size;              /**< Size of the \c data buffer */
-    uint8_t data[1];            /**< Serialization buffer */
+    uint8_t data[4];            /**< Serialization buffer */
   };  /* struct TagData */
 
+  /** Number of bytes of records stored inline. */
+  static const uint32_t INLINE_SIZE = 64;
+
   /**
    * Create a new PacketTagList.
    */
@@ -156,8 +94,8 @@ public:
    *
    * \param [in] o The PacketTagList to copy.
    *
-   * This makes a light-weight copy by #RemoveAll, then
-   * pointing to the same \ref TagData as \pname{o}.
+   * This copies the inline records, or shares the spill region
+   * of \pname{o}.
    */
   inline PacketTagList (PacketTagList const &o);
   /**
@@ -167,18 +105,19 @@ public:
    * \returns the copied object
    *
    * This makes a light-weight copy by #RemoveAll, then
-   * pointing to the same \ref TagData as \pname{o}.
+   * copying the inline records, or sharing the spill region
+   * of \pname{o}.
    */
   inline PacketTagList &operator = (PacketTagList const &o);
   /**
    * Destructor
    *
-   * #RemoveAll's the tags up to the first merge.
+   * #RemoveAll's the tags.
    */
   inline ~PacketTagList ();
 
   /**
-   * Add a tag to the head of this branch.
+   * Add a tag to the head of the list.
    *
    * \param [in] tag The tag to add
    */
@@ -210,13 +149,18 @@ public:
    */
   bool Peek (Tag &tag) const;
   /**
-   * Remove all tags from this list (up to the first merge).
+   * Remove all tags from this list.
    */
   inline void RemoveAll (void);
   /**
-   * \returns pointer to head of tag list
+   * \returns pointer to the first tag record, or 0 if the list is empty
    */
   const struct PacketTagList::TagData *Head (void) const;
+  /**
+   * \param [in] tag A tag record of this list.
+   * \returns pointer to the next tag record, or 0 at the end of the list
+   */
+  const struct PacketTagList::TagData *Next (const struct PacketTagList::TagData *tag) const;
   /**
    * Returns number of bytes required for packet serialization.
    *
@@ -244,68 +188,58 @@ public:
 
 private:
   /**
-   * Allocate and construct a TagData struct, sizing the data area
-   * large enough to serialize dataSize bytes from a Tag.
-   *
-   * \param [in] dataSize The serialized size of the Tag.
-   * \returns The newly constructed TagData object.
+   * Shared, reference counted storage of the records which do not
+   * fit inline.
    */
-  static
-  TagData * CreateTagData (size_t dataSize);
-  
+  struct Spill
+  {
+    uint32_t count;             /**< Number of PacketTagList sharing this */
+    uint32_t capacity;          /**< Size of the \c data buffer */
+    uint8_t data[4];            /**< The records */
+  };  /* struct Spill */
+
   /**
-   * Typedef of method function pointer for copy-on-write operations
-   *
-   * \param [in] tag The tag type to operate on.
-   * \param [in] preMerge True if \pname{tag} was found before the first merge,
-   *             false otherwise.
-   * \param [in] cur Pointer to the tag.
-   * \param [in] prevNext Pointer to the struct TagData.next pointer
-   *          pointing to \pname{cur}.
-   * \returns True if operation successful, false otherwise
+   * \param [in] dataSize The serialized size of a Tag.
+   * \returns The size of its record.
    */
-  typedef bool (PacketTagList::*COWWriter)
-    (Tag       & tag, bool         preMerge,
-    struct TagData * cur, struct TagData ** prevNext);
+  static inline uint32_t GetRecordSize (uint32_t dataSize);
   /**
-   * Traverse the list implementing copy-on-write, using \pname{Writer}.
+   * Allocate a spill region.
    *
-   * \param [in] tag The tag type to operate on.
-   * \param [in] Writer The copy-on-write function to use.
-   * \returns True if \pname{tag} found, false otherwise.
+   * \param [in] capacity The size of the region.
+   * \returns The spill region, with a single reference.
+   */
+  static Spill * CreateSpill (uint32_t capacity);
+  /**
+   * \returns The records.
    */
-  bool COWTraverse   (Tag & tag, PacketTagList::COWWriter Writer);
+  inline uint8_t * GetRecords (void) const;
   /**
-   * Copy-on-write implementing Remove.
+   * Find the record of a tag type.
    *
-   * \param [in] tag The target tag type to remove.
-   * \param [in] preMerge True if \pname{tag} was found before the first merge,
-   *             false otherwise.
-   * \param [in] cur Pointer to the tag.
-   * \param [in] prevNext Pointer to the struct TagData.next pointer
-   *          pointing to \pname{cur}.
-   * \returns True, since tag will definitely be removed.
+   * \param [in] tid The tag type.
+   * \returns The record, or 0.
    */
-  bool RemoveWriter  (Tag & tag, bool preMerge,
-                      struct TagData * cur, struct TagData ** prevNext);
+  TagData * Find (TypeId tid) const;
   /**
-   * Copy-on-write implementing Replace
+   * Open a gap in the records, in storage which is not shared.
    *
-   * \param [in] tag The target tag type to replace
-   * \param [in] preMerge True if \pname{tag} was found before the first merge,
-   *          false otherwise.
-   * \param [in] cur Pointer to the tag
-   * \param [in] prevNext Pointer to the struct TagData.next pointer
-   *          pointing to \pname{cur}.
-   * \returns True, since tag value will definitely be replaced.
+   * \param [in] offset The position of the gap.
+   * \param [in] length The size of the gap.
+   * \returns Pointer to the gap.
    */
-  bool ReplaceWriter (Tag & tag, bool preMerge,
-                      struct TagData * cur, struct TagData ** prevNext);
-
+  uint8_t * Insert (uint32_t offset, uint32_t length);
   /**
-   * Pointer to first \ref TagData on the list
+   * Remove a range of the records, without modifying shared storage.
+   *
+   * \param [in] offset The position of the range.
+   * \param [in] length The size of the range.
    */
-  struct TagData *m_next;
+  void Erase (uint32_t offset, uint32_t length);
+
+  Spill *m_spill;               /**< Shared records, or 0 if inline */
+  uint32_t m_used;              /**< Number of bytes of records */
+  uint32_t m_inline[INLINE_SIZE / 4]; /**< Inline records */
 };
 
 } // namespace ns3
@@ -317,16 +251,22 @@ private:
 namespace ns3 {
 
 PacketTagList::PacketTagList ()
-  : m_next ()
+  : m_spill (0),
+    m_used (0)
 {
 }
 
 PacketTagList::PacketTagList (PacketTagList const &o)
-  : m_next (o.m_next)
+  : m_spill (o.m_spill),
+    m_used (o.m_used)
 {
-  if (m_next != 0)
+  if (m_spill != 0)
+    {
+      m_spill->count++;
+    }
+  else
     {
-      m_next->count++;
+      std::memcpy (m_inline, o.m_inline, m_used);
     }
 }
 
@@ -334,15 +274,20 @@ PacketTagList &
 PacketTagList::operator = (PacketTagList const &o)
 {
   // self assignment
-  if (m_next == o.m_next) 
+  if (this == &o)
     {
       return *this;
     }
   RemoveAll ();
-  m_next = o.m_next;
-  if (m_next != 0) 
+  m_spill = o.m_spill;
+  m_used = o.m_used;
+  if (m_spill != 0)
     {
-      m_next->count++;
+      m_spill->count++;
+    }
+  else
+    {
+      std::memcpy (m_inline, o.m_inline, m_used);
     }
   return *this;
 }
@@ -355,27 +300,29 @@ PacketTagList::~PacketTagList ()
 void
 PacketTagList::RemoveAll (void)
 {
-  struct TagData *prev = 0;
-  for (struct TagData *cur = m_next; cur != 0; cur = cur->next)
+  if (m_spill != 0)
     {
-      cur->count--;
-      if (cur->count > 0) 
-        {
-          break;
-        }
-      if (prev != 0) 
+      m_spill->count--;
+      if (m_spill->count == 0)
         {
-          prev->~TagData ();
-          std::free (prev);
+          std::free (m_spill);
         }
-      prev = cur;
+      m_spill = 0;
     }
-  if (prev != 0) 
-    {
-      prev->~TagData ();
-      std::free (prev);
-    }
-  m_next = 0;
+  m_used = 0;
+}
+
+uint32_t
+PacketTagList::GetRecordSize (uint32_t dataSize)
+{
+  return sizeof (TagData) - 4 + ((dataSize + 3) & (~3));
+}
+
+uint8_t *
+PacketTagList::GetRecords (void) const
+{
+  return m_spill != 0 ? m_spill->data
+                      : reinterpret_cast<uint8_t *> (const_cast<uint32_t *> (m_inline));
 }
 
 } // namespace ns3
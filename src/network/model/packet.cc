@@ -81,8 +81,9 @@ ByteTagIterator::ByteTagIterator (ByteTagList::Iterator i)
 }
 
 
-PacketTagIterator::PacketTagIterator (const struct PacketTagList::TagData *head)
-  : m_current (head)
+PacketTagIterator::PacketTagIterator (const PacketTagList *list)
+  : m_list (list),
+    m_current (list->Head ())
 {
 }
 bool
@@ -95,7 +96,7 @@ PacketTagIterator::Next (void)
 {
   NS_ASSERT (HasNext ());
   const struct PacketTagList::TagData *prev = m_current;
-  m_current = m_current->next;
+  m_current = m_list->Next (m_current);
   return PacketTagIterator::Item (prev);
 }
 
@@ -1013,7 +1014,7 @@ Packet::PrintPacketTags (std::ostream &os) const
 PacketTagIterator 
 Packet::GetPacketTagIterator (void) const
 {
-  return PacketTagIterator (m_packetTagList.Head ());
+  return PacketTagIterator (&m_packetTagList);
 }
 
 std::ostream& operator<< (std::ostream& os, const Packet &packet)
@@ -173,9 +173,10 @@ private:
   friend class Packet;
   /**
    * Constructor
-   * \param head head of the items
+   * \param list the list of the items
    */
-  PacketTagIterator (const struct PacketTagList::TagData *head);
+  PacketTagIterator (const PacketTagList *list);
+  const PacketTagList *m_list;  //!< the set of tags in a packet
   const struct PacketTagList::TagData *m_current;  //!< actual position over the set of tags in a packet
 };
 
@@ -288,7 +289,8 @@ public:
    * \brief Create a new packet which contains a fragment of the original
    * packet.
    *
-   * The returned packet shares the same uid as this packet.
+   * The returned packet shares the same uid as this packet, and the
+   * bytes of its buffer until either packet is modified.
    *
    * \param start offset from start of packet to start of fragment to create
    * \param length length of fragment to create
@@ -390,7 +392,8 @@ public:
    * \brief Concatenate the input packet at the end of the current
    * packet.
    *
-   * This does not alter the uid of either packet.
+   * This does not alter the uid of either packet.  Consecutive
+   * fragments of a packet are concatenated without copying their bytes.
    *
    * \param packet packet to concatenate
    */
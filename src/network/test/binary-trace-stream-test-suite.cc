@@ -0,0 +1,175 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/binary-trace-stream.h"
+#include "ns3/ethernet-header.h"
+#include "ns3/llc-snap-header.h"
+#include "ns3/mac48-address.h"
+#include "ns3/packet.h"
+#include "ns3/simulator.h"
+#include "ns3/trace-helper.h"
+
+#include <sstream>
+
+using namespace ns3;
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * Trace an event to a text stream and to a binary stream.
+ * \param text The text stream.
+ * \param binary The binary stream.
+ * \param event The event.
+ * \param context The context, or an empty string.
+ * \param p The packet.
+ */
+static void
+TraceBoth (Ptr<OutputStreamWrapper> text, Ptr<OutputStreamWrapper> binary, char event,
+           std::string context, Ptr<const Packet> p)
+{
+  for (Ptr<OutputStreamWrapper> stream : { text, binary })
+    {
+      if (context.empty ())
+        {
+          switch (event)
+            {
+            case '+': AsciiTraceHelper::DefaultEnqueueSinkWithoutContext (stream, p); break;
+            case '-': AsciiTraceHelper::DefaultDequeueSinkWithoutContext (stream, p); break;
+            case 'd': AsciiTraceHelper::DefaultDropSinkWithoutContext (stream, p); break;
+            case 'r': AsciiTraceHelper::DefaultReceiveSinkWithoutContext (stream, p); break;
+            }
+        }
+      else
+        {
+          switch (event)
+            {
+            case '+': AsciiTraceHelper::DefaultEnqueueSinkWithContext (stream, context, p); break;
+            case '-': AsciiTraceHelper::DefaultDequeueSinkWithContext (stream, context, p); break;
+            case 'd': AsciiTraceHelper::DefaultDropSinkWithContext (stream, context, p); break;
+            case 'r': AsciiTraceHelper::DefaultReceiveSinkWithContext (stream, context, p); break;
+            }
+        }
+    }
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * Check that the default ascii sinks record the events of binary streams,
+ * and that BinaryTraceReader converts them back to the same text.
+ */
+class BinaryTraceStreamTestCase : public TestCase
+{
+public:
+  BinaryTraceStreamTestCase ();
+  virtual void DoRun (void);
+};
+
+BinaryTraceStreamTestCase::BinaryTraceStreamTestCase ()
+  : TestCase ("Check that binary traces convert to the text of the default ascii sinks")
+{
+}
+
+void
+BinaryTraceStreamTestCase::DoRun (void)
+{
+  Packet::EnablePrinting ();
+  std::ostringstream text;
+  std::ostringstream binary;
+  Ptr<OutputStreamWrapper> textStream = Create<OutputStreamWrapper> (&text);
+  Ptr<OutputStreamWrapper> binaryStream = Create<OutputStreamWrapper> (&binary);
+  BinaryTraceStream::Attach (binaryStream);
+  NS_TEST_EXPECT_MSG_NE (BinaryTraceStream::Find (binaryStream), 0, "Binary stream not found");
+  NS_TEST_EXPECT_MSG_EQ (BinaryTraceStream::Find (textStream), 0, "Text stream found");
+
+  // A frame whose headers the decoder knows, and a packet without headers.
+  Ptr<Packet> frame = Create<Packet> (100);
+  LlcSnapHeader llc;
+  llc.SetType (0x88b5);
+  frame->AddHeader (llc);
+  EthernetHeader eth (false);
+  eth.SetSource (Mac48Address ("00:00:00:00:00:01"));
+  eth.SetDestination (Mac48Address ("00:00:00:00:00:02"));
+  eth.SetLengthType (frame->GetSize ());
+  frame->AddHeader (eth);
+  Ptr<Packet> payload = Create<Packet> (1000);
+
+  const char events[] = { '+', '-', 'r', 'd' };
+  for (uint32_t i = 0; i < 100; ++i)
+    {
+      std::ostringstream context;
+      if (i % 3 != 0)
+        {
+          context << "/NodeList/" << i % 7 << "/DeviceList/" << i % 2 << "/TxQueue/Enqueue";
+        }
+      Ptr<const Packet> p = i % 2 ? frame : payload;
+      Simulator::Schedule (MicroSeconds (i * 10 + 7), &TraceBoth, textStream, binaryStream,
+                           events[i % 4], context.str (), p);
+    }
+  Simulator::Run ();
+  Simulator::Destroy ();
+  NS_TEST_ASSERT_MSG_NE (text.str (), "", "No text trace");
+  NS_TEST_EXPECT_MSG_LT (binary.str ().size () * 2, text.str ().size (), "Binary trace not compact");
+
+  std::istringstream is (binary.str ());
+  std::ostringstream converted;
+  NS_TEST_EXPECT_MSG_EQ (BinaryTraceReader::ConvertToAscii (is, converted), true, "Malformed binary trace");
+  NS_TEST_EXPECT_MSG_EQ (converted.str (), text.str (), "Wrong conversion");
+
+  is.clear ();
+  is.str (binary.str ());
+  BinaryTraceReader reader (is);
+  BinaryTraceReader::Event event;
+  NS_TEST_ASSERT_MSG_EQ (reader.Read (&event), true, "No first event");
+  NS_TEST_EXPECT_MSG_EQ (event.time, MicroSeconds (7), "Wrong time");
+  NS_TEST_EXPECT_MSG_EQ (event.node, BinaryTraceReader::NO_INDEX, "Node without a context");
+  NS_TEST_EXPECT_MSG_EQ (event.uid, payload->GetUid (), "Wrong uid");
+  NS_TEST_ASSERT_MSG_EQ (reader.Read (&event), true, "No second event");
+  NS_TEST_EXPECT_MSG_EQ (event.event, '-', "Wrong event");
+  NS_TEST_EXPECT_MSG_EQ (event.node, 1, "Wrong node");
+  NS_TEST_EXPECT_MSG_EQ (event.device, 1, "Wrong device");
+  NS_TEST_EXPECT_MSG_EQ (event.uid, frame->GetUid (), "Wrong uid");
+  NS_TEST_EXPECT_MSG_EQ (event.size, frame->GetSize (), "Wrong size");
+  NS_TEST_EXPECT_MSG_EQ (event.type, "ns3::EthernetHeader", "Wrong header type");
+  NS_TEST_EXPECT_MSG_EQ (event.bytes.size (), 64, "Wrong snapshot length");
+
+  // A truncated trace is malformed.
+  is.clear ();
+  is.str (binary.str ().substr (0, binary.str ().size () - 1));
+  converted.str ("");
+  NS_TEST_EXPECT_MSG_EQ (BinaryTraceReader::ConvertToAscii (is, converted), false, "Truncated trace accepted");
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief BinaryTraceStream TestSuite
+ */
+class BinaryTraceStreamTestSuite : public TestSuite
+{
+public:
+  BinaryTraceStreamTestSuite ()
+    : TestSuite ("binary-trace-stream", UNIT)
+  {
+    AddTestCase (new BinaryTraceStreamTestCase (), TestCase::QUICK);
+  }
+};
+
+static BinaryTraceStreamTestSuite g_binaryTraceStreamTestSuite; //!< Static variable for test initialization
@@ -385,6 +385,92 @@ BufferTest::DoRun (void)
   val2 <<= 8;
   val2 |= i.ReadU8 ();
   NS_TEST_ASSERT_MSG_EQ (val1, val2, "Bad ReadNtohU16()");
+
+  // consecutive fragments are concatenated without copying their bytes
+  buffer = Buffer ();
+  buffer.AddAtStart (100);
+  i = buffer.Begin ();
+  for (uint8_t j = 0; j < 100; j++)
+    {
+      i.WriteU8 (j);
+    }
+  Buffer head = buffer.CreateFragment (0, 40);
+  Buffer tail = buffer.CreateFragment (40, 60);
+  head.AddAtEnd (tail);
+  NS_TEST_ASSERT_MSG_EQ (head.GetSize (), 100, "Bad size of linked fragments");
+  NS_TEST_EXPECT_MSG_EQ ((head.PeekData () == buffer.PeekData ()), true, "Linked fragments were copied");
+  i = head.Begin ();
+  for (uint8_t j = 0; j < 100; j++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (i.ReadU8 (), j, "Bad content of linked fragments");
+    }
+
+  // also when the fragments cut the zero area
+  buffer = Buffer (1000);
+  buffer.AddAtStart (4);
+  buffer.Begin ().WriteU32 (0x11223344);
+  buffer.AddAtEnd (2);
+  i = buffer.End ();
+  i.Prev (2);
+  i.WriteU16 (0x5566);
+  head = buffer.CreateFragment (0, 500);
+  tail = buffer.CreateFragment (500, 506);
+  Buffer middle = tail.CreateFragment (0, 300);
+  tail = tail.CreateFragment (300, 206);
+  head.AddAtEnd (middle);
+  head.AddAtEnd (tail);
+  NS_TEST_ASSERT_MSG_EQ (head.GetSize (), 1006, "Bad size of linked fragments");
+  i = head.Begin ();
+  NS_TEST_EXPECT_MSG_EQ (i.ReadU32 (), 0x11223344, "Bad start of linked fragments");
+  for (uint32_t j = 0; j < 1000; j++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (i.ReadU8 (), 0, "Bad zero area of linked fragments");
+    }
+  NS_TEST_EXPECT_MSG_EQ (i.ReadU16 (), 0x5566, "Bad end of linked fragments");
+
+  // a fragment copied to add a header keeps room for the next headers
+  buffer = Buffer ();
+  buffer.AddAtStart (100);
+  Buffer fragment = buffer.CreateFragment (50, 50);
+  fragment.AddAtStart (20);
+  uint8_t const *data = fragment.PeekData ();
+  NS_TEST_ASSERT_MSG_EQ ((data == buffer.PeekData () + 30), false, "The fragment was not copied");
+  fragment.AddAtStart (2);
+  NS_TEST_EXPECT_MSG_EQ ((fragment.PeekData () == data - 2), true, "The fragment was copied twice");
+
+  // the zero areas appended to a buffer which shares its data stay virtual
+  buffer = Buffer (1000);
+  buffer.AddAtStart (2);
+  buffer.Begin ().WriteU16 (0x1234);
+  head = buffer.CreateFragment (0, 600);
+  head.AddAtEnd (Buffer (5000));
+  NS_TEST_ASSERT_MSG_EQ (head.GetSize (), 5600, "Bad size of appended zero area");
+  NS_TEST_EXPECT_MSG_LT (head.GetSerializedSize (), 100, "The zero area was not kept virtual");
+  i = head.Begin ();
+  NS_TEST_EXPECT_MSG_EQ (i.ReadU16 (), 0x1234, "Bad content of appended zero area");
+  NS_TEST_EXPECT_MSG_EQ (buffer.Begin ().ReadU16 (), 0x1234, "The shared buffer was modified");
+
+  // the checksum skips the zero area, whatever its alignment
+  for (uint32_t start = 1; start < 4; start++)
+    {
+      Buffer virtualBuffer = Buffer (1001);
+      virtualBuffer.AddAtStart (start);
+      virtualBuffer.AddAtEnd (5);
+      Buffer realBuffer;
+      realBuffer.AddAtStart (start + 1001 + 5);
+      realBuffer.Begin ().WriteU8 (0, start + 1001 + 5);
+      for (Buffer *b : { &virtualBuffer, &realBuffer })
+        {
+          i = b->Begin ();
+          i.WriteU8 (0xab, start);
+          i = b->End ();
+          i.Prev (5);
+          i.Write ((uint8_t const *) "\x01\x02\x03\x04\x05", 5);
+        }
+      NS_TEST_EXPECT_MSG_EQ (virtualBuffer.Begin ().CalculateIpChecksum (start + 1006),
+                             realBuffer.Begin ().CalculateIpChecksum (start + 1006),
+                             "Bad checksum of a zero area after " << start << " bytes");
+    }
 }
 
 /**
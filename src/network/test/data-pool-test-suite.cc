@@ -0,0 +1,253 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/data-pool.h"
+#include "ns3/test.h"
+
+#include <cstring>
+#include <set>
+#include <thread>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * DataPool block sizes and reuse.
+ */
+class DataPoolBlockTestCase : public TestCase
+{
+public:
+  DataPoolBlockTestCase ();
+  virtual void DoRun (void);
+};
+
+DataPoolBlockTestCase::DataPoolBlockTestCase ()
+  : TestCase ("Check the DataPool block sizes and reuse")
+{
+}
+
+void
+DataPoolBlockTestCase::DoRun (void)
+{
+  NS_TEST_EXPECT_MSG_EQ (DataPool::GetBlockSize (1), DataPool::MIN_BLOCK, "Wrong block size");
+  NS_TEST_EXPECT_MSG_EQ (DataPool::GetBlockSize (64), 64, "Wrong block size");
+  NS_TEST_EXPECT_MSG_EQ (DataPool::GetBlockSize (65), 128, "Wrong block size");
+  NS_TEST_EXPECT_MSG_EQ (DataPool::GetBlockSize (1500), 2048, "Wrong block size");
+  NS_TEST_EXPECT_MSG_EQ (DataPool::GetBlockSize (DataPool::MAX_BLOCK + 1), DataPool::MAX_BLOCK + 1,
+                         "Large blocks are not rounded");
+
+  // A freed block is reused by the next allocation of its size class.
+  void *block = DataPool::Allocate (2048);
+  std::memset (block, 0xab, 2048);
+  DataPool::Deallocate (block, 2048);
+  NS_TEST_EXPECT_MSG_EQ (DataPool::Allocate (2048), block, "Block not reused");
+  DataPool::Deallocate (block, 2048);
+
+  // Overflow the cache, so that blocks go through the global list.
+  std::vector<void *> blocks;
+  std::set<void *> distinct;
+  for (uint32_t i = 0; i < 10000; i++)
+    {
+      blocks.push_back (DataPool::Allocate (256));
+      distinct.insert (blocks.back ());
+    }
+  NS_TEST_EXPECT_MSG_EQ (distinct.size (), blocks.size (), "Block allocated twice");
+  uint64_t footprint = DataPool::GetFootprint ();
+  for (uint32_t i = 0; i < blocks.size (); i++)
+    {
+      DataPool::Deallocate (blocks[i], 256);
+    }
+  for (uint32_t i = 0; i < blocks.size (); i++)
+    {
+      blocks[i] = DataPool::Allocate (256);
+    }
+  NS_TEST_EXPECT_MSG_EQ (DataPool::GetFootprint (), footprint, "Blocks not reused");
+  for (uint32_t i = 0; i < blocks.size (); i++)
+    {
+      DataPool::Deallocate (blocks[i], 256);
+    }
+
+  void *large = DataPool::Allocate (DataPool::MAX_BLOCK + 1);
+  NS_TEST_EXPECT_MSG_EQ (DataPool::GetFootprint (), footprint + DataPool::MAX_BLOCK + 1, "Wrong footprint");
+  DataPool::Deallocate (large, DataPool::MAX_BLOCK + 1);
+  NS_TEST_EXPECT_MSG_EQ (DataPool::GetFootprint (), footprint, "Wrong footprint");
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * DataPool used by several threads at once, which exchange blocks
+ * through the global lists, and whose last blocks are freed by the
+ * main thread.
+ */
+class DataPoolThreadsTestCase : public TestCase
+{
+public:
+  DataPoolThreadsTestCase ();
+  virtual void DoRun (void);
+
+private:
+  /**
+   * Allocate and free blocks.
+   * \param index The thread index.
+   */
+  void Work (uint32_t index);
+
+  static const uint32_t THREADS = 4;  //!< Number of threads
+  static const uint32_t BLOCKS = 5000; //!< Number of blocks per thread
+  std::vector<void *> m_blocks[THREADS]; //!< Blocks allocated by each thread
+  bool m_ok[THREADS];                   //!< Did each thread find its blocks intact?
+};
+
+DataPoolThreadsTestCase::DataPoolThreadsTestCase ()
+  : TestCase ("Check the DataPool with several threads")
+{
+}
+
+void
+DataPoolThreadsTestCase::Work (uint32_t index)
+{
+  m_ok[index] = true;
+  for (uint32_t round = 0; round < 20; round++)
+    {
+      m_blocks[index].clear ();
+      for (uint32_t i = 0; i < BLOCKS; i++)
+        {
+          uint32_t size = DataPool::GetBlockSize (64 + (i * 97) % 4000);
+          uint8_t *block = static_cast<uint8_t *> (DataPool::Allocate (size));
+          std::memset (block, index, size);
+          m_blocks[index].push_back (block);
+        }
+      for (uint32_t i = 0; i < BLOCKS; i++)
+        {
+          uint32_t size = DataPool::GetBlockSize (64 + (i * 97) % 4000);
+          uint8_t *block = static_cast<uint8_t *> (m_blocks[index][i]);
+          m_ok[index] = m_ok[index] && block[0] == index && block[size - 1] == index;
+          if (round < 19)
+            {
+              DataPool::Deallocate (block, size);
+            }
+        }
+    }
+}
+
+void
+DataPoolThreadsTestCase::DoRun (void)
+{
+  std::vector<std::thread> threads;
+  for (uint32_t i = 0; i < THREADS; i++)
+    {
+      threads.push_back (std::thread (&DataPoolThreadsTestCase::Work, this, i));
+    }
+  for (uint32_t i = 0; i < THREADS; i++)
+    {
+      threads[i].join ();
+    }
+  for (uint32_t i = 0; i < THREADS; i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (m_ok[i], true, "Block of thread " << i << " overwritten");
+      for (uint32_t j = 0; j < BLOCKS; j++)
+        {
+          DataPool::Deallocate (m_blocks[i][j], DataPool::GetBlockSize (64 + (j * 97) % 4000));
+        }
+    }
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * A thread which only allocates pulls a whole batch of free blocks into
+ * its cache: check that the rest of the batch is returned when it exits.
+ */
+class DataPoolAllocateOnlyTestCase : public TestCase
+{
+public:
+  DataPoolAllocateOnlyTestCase ();
+  virtual void DoRun (void);
+
+private:
+  /** Allocate one block, without freeing anything. */
+  void Work (void);
+
+  static const uint32_t SIZE = 512;    //!< Block size
+  static const uint32_t BLOCKS = 10000; //!< Number of blocks
+  void *m_block;                       //!< Block allocated by the thread
+};
+
+DataPoolAllocateOnlyTestCase::DataPoolAllocateOnlyTestCase ()
+  : TestCase ("Check the DataPool with a thread which only allocates")
+{
+}
+
+void
+DataPoolAllocateOnlyTestCase::Work (void)
+{
+  m_block = DataPool::Allocate (SIZE);
+}
+
+void
+DataPoolAllocateOnlyTestCase::DoRun (void)
+{
+  std::vector<void *> blocks;
+  for (uint32_t i = 0; i < BLOCKS; i++)
+    {
+      blocks.push_back (DataPool::Allocate (SIZE));
+    }
+  uint64_t footprint = DataPool::GetFootprint ();
+  for (uint32_t i = 0; i < BLOCKS; i++)
+    {
+      DataPool::Deallocate (blocks[i], SIZE);
+    }
+
+  std::thread thread (&DataPoolAllocateOnlyTestCase::Work, this);
+  thread.join ();
+  DataPool::Deallocate (m_block, SIZE);
+
+  for (uint32_t i = 0; i < BLOCKS; i++)
+    {
+      blocks[i] = DataPool::Allocate (SIZE);
+    }
+  NS_TEST_EXPECT_MSG_EQ (DataPool::GetFootprint (), footprint, "Blocks lost in the cache of the thread");
+  for (uint32_t i = 0; i < BLOCKS; i++)
+    {
+      DataPool::Deallocate (blocks[i], SIZE);
+    }
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief DataPool TestSuite
+ */
+class DataPoolTestSuite : public TestSuite
+{
+public:
+  DataPoolTestSuite ()
+    : TestSuite ("data-pool", UNIT)
+  {
+    AddTestCase (new DataPoolBlockTestCase (), TestCase::QUICK);
+    AddTestCase (new DataPoolThreadsTestCase (), TestCase::QUICK);
+    AddTestCase (new DataPoolAllocateOnlyTestCase (), TestCase::QUICK);
+  }
+};
+
+static DataPoolTestSuite g_dataPoolTestSuite; //!< Static variable for test initialization
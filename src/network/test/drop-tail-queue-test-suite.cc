@@ -20,6 +20,8 @@
 #include "ns3/drop-tail-queue.h"
 #include "ns3/string.h"
 
+#include <vector>
+
 using namespace ns3;
 
 /**
@@ -83,6 +85,69 @@ DropTailQueueTestCase::DoRun (void)
   NS_TEST_EXPECT_MSG_EQ ((packet == 0), true, "There are really no packets in there");
 }
 
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * DropTailQueue test of the ring buffer growth and wrap around.
+ */
+class DropTailQueueRingTestCase : public TestCase
+{
+public:
+  DropTailQueueRingTestCase ();
+  virtual void DoRun (void);
+};
+
+DropTailQueueRingTestCase::DropTailQueueRingTestCase ()
+  : TestCase ("Check the drop tail queue order across ring buffer growth and wrap around")
+{
+}
+void
+DropTailQueueRingTestCase::DoRun (void)
+{
+  Ptr<DropTailQueue<Packet> > queue = CreateObject<DropTailQueue<Packet> > ();
+  queue->SetAttribute ("MaxSize", StringValue ("1000p"));
+
+  std::vector<Ptr<Packet> > packets;
+  for (uint32_t i = 0; i < 1000; i++)
+    {
+      packets.push_back (Create<Packet> (i));
+    }
+
+  // Enqueue three and dequeue two at a time, so that the items wrap around
+  // the ring buffer while it grows.
+  uint32_t head = 0;
+  uint32_t tail = 0;
+  uint32_t bytes = 0;
+  while (tail < packets.size ())
+    {
+      for (uint32_t i = 0; i < 3 && tail < packets.size (); i++)
+        {
+          NS_TEST_EXPECT_MSG_EQ (queue->Enqueue (packets[tail]), true, "Packet dropped");
+          bytes += packets[tail++]->GetSize ();
+        }
+      for (uint32_t i = 0; i < 2; i++)
+        {
+          NS_TEST_EXPECT_MSG_EQ (queue->Peek (), packets[head], "Wrong head");
+          NS_TEST_EXPECT_MSG_EQ (queue->Dequeue (), packets[head], "Packet out of order");
+          bytes -= packets[head++]->GetSize ();
+        }
+      NS_TEST_EXPECT_MSG_EQ (queue->GetNPackets (), tail - head, "Wrong number of packets");
+      NS_TEST_EXPECT_MSG_EQ (queue->GetNBytes (), bytes, "Wrong number of bytes");
+    }
+
+  NS_TEST_EXPECT_MSG_EQ (queue->Remove (), packets[head], "Wrong packet removed");
+  head++;
+  NS_TEST_EXPECT_MSG_EQ (queue->GetTotalDroppedPacketsAfterDequeue (), 1, "Drop not counted");
+  while (head < tail)
+    {
+      NS_TEST_EXPECT_MSG_EQ (queue->Dequeue (), packets[head++], "Packet out of order");
+    }
+  NS_TEST_EXPECT_MSG_EQ (queue->IsEmpty (), true, "The queue should be empty");
+  NS_TEST_EXPECT_MSG_EQ ((queue->Dequeue () == 0), true, "There are really no packets in there");
+  NS_TEST_EXPECT_MSG_EQ ((queue->Peek () == 0), true, "There are really no packets in there");
+}
+
 /**
  * \ingroup network-test
  * \ingroup tests
@@ -96,6 +161,7 @@ public:
     : TestSuite ("drop-tail-queue", UNIT)
   {
     AddTestCase (new DropTailQueueTestCase (), TestCase::QUICK);
+    AddTestCase (new DropTailQueueRingTestCase (), TestCase::QUICK);
   }
 };
 
@@ -0,0 +1,163 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/ascii-snapshot-stream.h"
+#include "ns3/ethernet-header.h"
+#include "ns3/header-decoder.h"
+#include "ns3/llc-snap-header.h"
+#include "ns3/mac48-address.h"
+#include "ns3/packet.h"
+#include "ns3/simulator.h"
+
+#include <sstream>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * Build an Ethernet frame with an LLC/SNAP header, of an EtherType which
+ * no module registers.
+ * \param headers [out] The headers, as printed by Packet::Print.
+ * \returns The frame.
+ */
+static Ptr<Packet>
+MakeFrame (std::string *headers)
+{
+  Ptr<Packet> p = Create<Packet> (100);
+  LlcSnapHeader llc;
+  llc.SetType (0x88b5);
+  p->AddHeader (llc);
+  EthernetHeader eth (false);
+  eth.SetSource (Mac48Address ("00:00:00:00:00:01"));
+  eth.SetDestination (Mac48Address ("00:00:00:00:00:02"));
+  eth.SetLengthType (p->GetSize ());
+  p->AddHeader (eth);
+
+  std::ostringstream oss;
+  oss << "ns3::EthernetHeader (";
+  eth.Print (oss);
+  oss << ") ns3::LlcSnapHeader (";
+  llc.Print (oss);
+  oss << ")";
+  *headers = oss.str ();
+  return p;
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * HeaderDecoder unit tests.
+ */
+class HeaderDecoderTestCase : public TestCase
+{
+public:
+  HeaderDecoderTestCase ();
+  virtual void DoRun (void);
+};
+
+HeaderDecoderTestCase::HeaderDecoderTestCase ()
+  : TestCase ("Check that HeaderDecoder prints the registered headers of raw bytes")
+{
+}
+
+void
+HeaderDecoderTestCase::DoRun (void)
+{
+  std::string headers;
+  Ptr<Packet> p = MakeFrame (&headers);
+  std::vector<uint8_t> bytes (p->GetSize ());
+  p->CopyData (bytes.data (), bytes.size ());
+
+  std::ostringstream oss;
+  HeaderDecoder::Print (oss, EthernetHeader::GetTypeId (), bytes.data (), bytes.size (), bytes.size ());
+  NS_TEST_EXPECT_MSG_EQ (oss.str (), headers + " Payload (size=100)", "Wrong decoded headers");
+
+  // The LLC/SNAP header is cut short by the snapshot.
+  oss.str ("");
+  HeaderDecoder::Print (oss, EthernetHeader::GetTypeId (), bytes.data (), 20, bytes.size ());
+  NS_TEST_EXPECT_MSG_EQ (oss.str (), headers.substr (0, headers.find (" ns3::LlcSnapHeader")) + " Payload (size=108)",
+                         "Wrong decoded headers of a snapshot");
+
+  oss.str ("");
+  HeaderDecoder::Print (oss, LlcSnapHeader::GetTypeId (), bytes.data (), 0, 0);
+  NS_TEST_EXPECT_MSG_EQ (oss.str (), "", "Empty packet not empty");
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * AsciiSnapshotStream unit tests.
+ */
+class AsciiSnapshotStreamTestCase : public TestCase
+{
+public:
+  AsciiSnapshotStreamTestCase ();
+  virtual void DoRun (void);
+};
+
+AsciiSnapshotStreamTestCase::AsciiSnapshotStreamTestCase ()
+  : TestCase ("Check that AsciiSnapshotStream writes the lines of the default ascii sinks")
+{
+}
+
+void
+AsciiSnapshotStreamTestCase::DoRun (void)
+{
+  std::string headers;
+  Ptr<Packet> p = MakeFrame (&headers);
+  std::ostringstream oss;
+  Ptr<OutputStreamWrapper> stream = Create<OutputStreamWrapper> (&oss);
+  Ptr<AsciiSnapshotStream> snapshots = AsciiSnapshotStream::Get (stream, EthernetHeader::GetTypeId ());
+  NS_TEST_EXPECT_MSG_EQ (AsciiSnapshotStream::Get (stream, EthernetHeader::GetTypeId ()), snapshots,
+                         "Snapshot stream not shared");
+
+  Simulator::Schedule (Seconds (1), &AsciiSnapshotStream::SinkWithContext, snapshots, '+',
+                       std::string ("/NodeList/0"), Ptr<const Packet> (p));
+  Simulator::Schedule (Seconds (2), &AsciiSnapshotStream::SinkWithoutContext, snapshots, 'r',
+                       Ptr<const Packet> (p));
+  Simulator::Run ();
+  NS_TEST_EXPECT_MSG_EQ (oss.str (), "", "Snapshots written before the end of the batch");
+  Simulator::Destroy ();
+
+  std::string payload = " Payload (size=100)\n";
+  NS_TEST_EXPECT_MSG_EQ (oss.str (), "+ 1 /NodeList/0 " + headers + payload + "r 2 " + headers + payload,
+                         "Wrong trace lines");
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief HeaderDecoder TestSuite
+ */
+class HeaderDecoderTestSuite : public TestSuite
+{
+public:
+  HeaderDecoderTestSuite ()
+    : TestSuite ("header-decoder", UNIT)
+  {
+    AddTestCase (new HeaderDecoderTestCase (), TestCase::QUICK);
+    AddTestCase (new AsciiSnapshotStreamTestCase (), TestCase::QUICK);
+  }
+};
+
+static HeaderDecoderTestSuite g_headerDecoderTestSuite; //!< Static variable for test initialization
@@ -0,0 +1,206 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/channel-list.h"
+#include "ns3/config.h"
+#include "ns3/node.h"
+#include "ns3/node-container.h"
+#include "ns3/node-list.h"
+#include "ns3/simple-channel.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/simulator.h"
+#include "ns3/test.h"
+
+#include <set>
+#include <sstream>
+
+using namespace ns3;
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * Removal of nodes from the NodeList, with stable ids.
+ */
+class NodeListRemoveTestCase : public TestCase
+{
+public:
+  NodeListRemoveTestCase ();
+  virtual void DoRun (void);
+};
+
+NodeListRemoveTestCase::NodeListRemoveTestCase ()
+  : TestCase ("Check the removal of nodes from the NodeList")
+{
+}
+
+void
+NodeListRemoveTestCase::DoRun (void)
+{
+  NodeContainer nodes;
+  nodes.Create (5);
+  uint32_t first = nodes.Get (0)->GetId ();
+  uint32_t n = NodeList::GetNNodes ();
+
+  Ptr<Node> removed = nodes.Get (1);
+  uint32_t removedId = removed->GetId ();
+  NodeList::Remove (removed);
+  NodeList::Remove (nodes.Get (4));
+  NS_TEST_EXPECT_MSG_EQ (NodeList::GetNNodes (), n - 2, "Wrong number of nodes");
+  NS_TEST_EXPECT_MSG_EQ (NodeList::GetNode (removedId), 0, "Removed node still found");
+  NS_TEST_EXPECT_MSG_EQ (NodeList::GetNode (first), nodes.Get (0), "Wrong node");
+  NS_TEST_EXPECT_MSG_EQ (NodeList::GetNode (first + 2), nodes.Get (2), "Wrong node");
+  NS_TEST_EXPECT_MSG_EQ (NodeList::GetNode (first + 3), nodes.Get (3), "Wrong node");
+
+  // A new node gets a new id, rather than the id of a removed node.
+  Ptr<Node> added = CreateObject<Node> ();
+  NS_TEST_EXPECT_MSG_EQ (added->GetId (), first + 5, "Id reused");
+  NS_TEST_EXPECT_MSG_EQ (NodeList::GetNode (first + 5), added, "Wrong node");
+
+  // The iterators walk each node in the list once.
+  std::set<uint32_t> ids;
+  for (NodeList::Iterator i = NodeList::Begin (); i != NodeList::End (); ++i)
+    {
+      NS_TEST_EXPECT_MSG_EQ (((*i)->GetId () == removedId), false, "Removed node walked");
+      ids.insert ((*i)->GetId ());
+    }
+  NS_TEST_EXPECT_MSG_EQ (ids.size (), NodeList::GetNNodes (), "Wrong number of walked nodes");
+  NS_TEST_EXPECT_MSG_EQ (ids.count (first + 5), 1, "New node not walked");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * Config paths of the NodeList after removals.
+ */
+class NodeListConfigTestCase : public TestCase
+{
+public:
+  NodeListConfigTestCase ();
+  virtual void DoRun (void);
+};
+
+NodeListConfigTestCase::NodeListConfigTestCase ()
+  : TestCase ("Check the config paths of the NodeList after removals")
+{
+}
+
+void
+NodeListConfigTestCase::DoRun (void)
+{
+  NodeContainer nodes;
+  nodes.Create (4);
+  for (uint32_t i = 0; i < nodes.GetN (); i++)
+    {
+      nodes.Get (i)->AddDevice (CreateObject<SimpleNetDevice> ());
+    }
+  uint32_t first = nodes.Get (0)->GetId ();
+  NodeList::Remove (nodes.Get (0));
+
+  // The last node moves to the place of the removed one in the list,
+  // but its path still uses its id.
+  std::ostringstream oss;
+  oss << "/NodeList/" << first + 3;
+  Config::MatchContainer match = Config::LookupMatches (oss.str ());
+  NS_TEST_ASSERT_MSG_EQ (match.GetN (), 1, "Node not found");
+  NS_TEST_EXPECT_MSG_EQ (match.Get (0), nodes.Get (3), "Wrong node");
+  NS_TEST_EXPECT_MSG_EQ (match.GetMatchedPath (0), oss.str () + "/", "Wrong path");
+
+  oss.str ("");
+  oss << "/NodeList/" << first;
+  NS_TEST_EXPECT_MSG_EQ (Config::LookupMatches (oss.str ()).GetN (), 0, "Removed node found");
+
+  match = Config::LookupMatches ("/NodeList/*/DeviceList/0");
+  NS_TEST_EXPECT_MSG_EQ (match.GetN (), NodeList::GetNNodes (), "Wrong number of devices");
+  for (uint32_t i = 0; i < match.GetN (); i++)
+    {
+      Ptr<NetDevice> device = match.Get (i)->GetObject<NetDevice> ();
+      oss.str ("");
+      oss << "/NodeList/" << device->GetNode ()->GetId () << "/DeviceList/0/";
+      NS_TEST_EXPECT_MSG_EQ (match.GetMatchedPath (i), oss.str (), "Wrong path");
+    }
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * Removal of channels from the ChannelList, with stable ids.
+ */
+class ChannelListRemoveTestCase : public TestCase
+{
+public:
+  ChannelListRemoveTestCase ();
+  virtual void DoRun (void);
+};
+
+ChannelListRemoveTestCase::ChannelListRemoveTestCase ()
+  : TestCase ("Check the removal of channels from the ChannelList")
+{
+}
+
+void
+ChannelListRemoveTestCase::DoRun (void)
+{
+  Ptr<SimpleChannel> a = CreateObject<SimpleChannel> ();
+  Ptr<SimpleChannel> b = CreateObject<SimpleChannel> ();
+  Ptr<SimpleChannel> c = CreateObject<SimpleChannel> ();
+  uint32_t n = ChannelList::GetNChannels ();
+
+  ChannelList::Remove (a);
+  NS_TEST_EXPECT_MSG_EQ (ChannelList::GetNChannels (), n - 1, "Wrong number of channels");
+  NS_TEST_EXPECT_MSG_EQ (ChannelList::GetChannel (a->GetId ()), 0, "Removed channel still found");
+  NS_TEST_EXPECT_MSG_EQ (ChannelList::GetChannel (b->GetId ()), b, "Wrong channel");
+  NS_TEST_EXPECT_MSG_EQ (ChannelList::GetChannel (c->GetId ()), c, "Wrong channel");
+
+  Ptr<SimpleChannel> d = CreateObject<SimpleChannel> ();
+  NS_TEST_EXPECT_MSG_EQ (d->GetId (), c->GetId () + 1, "Id reused");
+
+  uint32_t walked = 0;
+  for (ChannelList::Iterator i = ChannelList::Begin (); i != ChannelList::End (); ++i)
+    {
+      NS_TEST_EXPECT_MSG_EQ ((*i == a), false, "Removed channel walked");
+      walked++;
+    }
+  NS_TEST_EXPECT_MSG_EQ (walked, ChannelList::GetNChannels (), "Wrong number of walked channels");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief NodeList and ChannelList TestSuite
+ */
+class NodeListTestSuite : public TestSuite
+{
+public:
+  NodeListTestSuite ()
+    : TestSuite ("node-list", UNIT)
+  {
+    AddTestCase (new NodeListRemoveTestCase (), TestCase::QUICK);
+    AddTestCase (new NodeListConfigTestCase (), TestCase::QUICK);
+    AddTestCase (new ChannelListRemoveTestCase (), TestCase::QUICK);
+  }
+};
+
+static NodeListTestSuite g_nodeListTestSuite; //!< Static variable for test initialization
@@ -0,0 +1,302 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/boolean.h"
+#include "ns3/enum.h"
+#include "ns3/packet.h"
+#include "ns3/pcap-file.h"
+#include "ns3/pcap-writer.h"
+#include "ns3/simulator.h"
+#include "ns3/trace-helper.h"
+#include "ns3/uinteger.h"
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \param i The index of a test packet.
+ * \returns A test packet, whose size and bytes depend on its index.
+ */
+static Ptr<Packet>
+MakePacket (uint32_t i)
+{
+  std::vector<uint8_t> bytes (10 + i % 90);
+  for (uint32_t j = 0; j < bytes.size (); ++j)
+    {
+      bytes[j] = i + j;
+    }
+  return Create<Packet> (bytes.data (), bytes.size ());
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * A pcapng block, as read back from a file.
+ */
+struct PcapNgBlock
+{
+  uint32_t type;              //!< The block type
+  std::vector<uint8_t> body;  //!< The bytes between the lengths
+};
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * Read the blocks of a pcapng file.
+ * \param filename The name of the file.
+ * \returns The blocks, with a last block of type 0 if the file is malformed.
+ */
+static std::vector<PcapNgBlock>
+ReadPcapNg (std::string filename)
+{
+  std::ifstream file (filename, std::ios::binary);
+  std::vector<uint8_t> bytes ((std::istreambuf_iterator<char> (file)), std::istreambuf_iterator<char> ());
+  std::vector<PcapNgBlock> blocks;
+  uint32_t offset = 0;
+  while (offset + 12 <= bytes.size ())
+    {
+      PcapNgBlock block;
+      uint32_t length;
+      uint32_t trailer;
+      std::memcpy (&block.type, &bytes[offset], 4);
+      std::memcpy (&length, &bytes[offset + 4], 4);
+      if (length < 12 || length % 4 != 0 || offset + length > bytes.size ())
+        {
+          break;
+        }
+      std::memcpy (&trailer, &bytes[offset + length - 4], 4);
+      if (trailer != length)
+        {
+          break;
+        }
+      block.body.assign (bytes.begin () + offset + 8, bytes.begin () + offset + length - 4);
+      blocks.push_back (block);
+      offset += length;
+    }
+  if (offset != bytes.size ())
+    {
+      blocks.push_back (PcapNgBlock {0, std::vector<uint8_t> ()});
+    }
+  return blocks;
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \param block A block.
+ * \param offset The offset of a field in its body.
+ * \returns The 32 bits field.
+ */
+static uint32_t
+GetU32 (const PcapNgBlock &block, uint32_t offset)
+{
+  uint32_t v = 0;
+  if (offset + 4 <= block.body.size ())
+    {
+      std::memcpy (&v, &block.body[offset], 4);
+    }
+  return v;
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * Write a packet at the current time.
+ * \param file The file.
+ * \param p The packet.
+ */
+static void
+WriteNow (Ptr<PcapFileWrapper> file, Ptr<Packet> p)
+{
+  file->Write (Simulator::Now (), p);
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * Check that the pcap files of a PcapWriter read back with PcapFile.
+ */
+class PcapWriterPcapTestCase : public TestCase
+{
+public:
+  PcapWriterPcapTestCase ();
+  virtual void DoRun (void);
+};
+
+PcapWriterPcapTestCase::PcapWriterPcapTestCase ()
+  : TestCase ("Check that PcapWriter writes pcap files that PcapFile reads back")
+{
+}
+
+void
+PcapWriterPcapTestCase::DoRun (void)
+{
+  std::string filename = CreateTempDirFilename ("pcap-writer.pcap");
+  Ptr<PcapWriter> writer = CreateObject<PcapWriter> ();
+  // Small buffers, so that the I/O thread writes most of them while the
+  // next ones are filled.
+  writer->SetAttribute ("BufferSize", UintegerValue (256));
+  writer->SetAttribute ("CaptureSize", UintegerValue (64));
+  NS_TEST_ASSERT_MSG_EQ (writer->Open (filename), true, "Unable to open " << filename);
+  uint32_t interface = writer->AddInterface ("eth0", PcapHelper::DLT_EN10MB);
+  const uint32_t n = 1000;
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      writer->Write (interface, MicroSeconds (1000001 * i), MakePacket (i));
+    }
+  writer->Close ();
+  NS_TEST_EXPECT_MSG_EQ (writer->Fail (), false, "Write failed");
+
+  PcapFile file;
+  file.Open (filename, std::ios::in);
+  NS_TEST_ASSERT_MSG_EQ (file.Fail (), false, "Unable to read " << filename);
+  NS_TEST_EXPECT_MSG_EQ (file.GetDataLinkType (), PcapHelper::DLT_EN10MB, "Wrong data link type");
+  NS_TEST_EXPECT_MSG_EQ (file.GetSnapLen (), 64, "Wrong snapshot length");
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      uint8_t data[128];
+      uint32_t tsSec, tsUsec, inclLen, origLen, readLen;
+      file.Read (data, sizeof (data), tsSec, tsUsec, inclLen, origLen, readLen);
+      NS_TEST_ASSERT_MSG_EQ (file.Fail (), false, "Record " << i << " missing");
+      Ptr<Packet> p = MakePacket (i);
+      uint8_t expected[128];
+      uint32_t size = p->CopyData (expected, 64);
+      NS_TEST_EXPECT_MSG_EQ (tsSec * 1000000ULL + tsUsec, 1000001ULL * i, "Wrong time of record " << i);
+      NS_TEST_EXPECT_MSG_EQ (origLen, p->GetSize (), "Wrong size of record " << i);
+      NS_TEST_ASSERT_MSG_EQ (inclLen, size, "Wrong capture length of record " << i);
+      NS_TEST_EXPECT_MSG_EQ (std::memcmp (data, expected, size), 0, "Wrong bytes in record " << i);
+    }
+  uint8_t data[128];
+  uint32_t tsSec, tsUsec, inclLen, origLen, readLen;
+  file.Read (data, sizeof (data), tsSec, tsUsec, inclLen, origLen, readLen);
+  NS_TEST_EXPECT_MSG_EQ (file.Eof (), true, "Extra records");
+  file.Close ();
+  std::remove (filename.c_str ());
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * Check the pcapng files of a PcapWriter, and of PcapHelper::EnableSharedFile.
+ */
+class PcapWriterPcapNgTestCase : public TestCase
+{
+public:
+  PcapWriterPcapNgTestCase ();
+  virtual void DoRun (void);
+};
+
+PcapWriterPcapNgTestCase::PcapWriterPcapNgTestCase ()
+  : TestCase ("Check that PcapWriter writes the interfaces and packets of pcapng files")
+{
+}
+
+void
+PcapWriterPcapNgTestCase::DoRun (void)
+{
+  std::string filename = CreateTempDirFilename ("pcap-writer.pcapng");
+  Ptr<PcapWriter> writer = CreateObject<PcapWriter> ();
+  writer->SetAttribute ("Format", EnumValue (PcapWriter::PCAPNG));
+  writer->SetAttribute ("NanosecMode", BooleanValue (true));
+  NS_TEST_ASSERT_MSG_EQ (writer->Open (filename), true, "Unable to open " << filename);
+  uint32_t eth = writer->AddInterface ("eth", PcapHelper::DLT_EN10MB);
+  uint32_t ppp = writer->AddInterface ("ppp0", PcapHelper::DLT_PPP, 30);
+  writer->Write (eth, NanoSeconds (5), MakePacket (1));
+  writer->Write (ppp, Seconds (5000), MakePacket (60));
+  writer->Close ();
+
+  std::vector<PcapNgBlock> blocks = ReadPcapNg (filename);
+  NS_TEST_ASSERT_MSG_EQ (blocks.size (), 5, "Wrong number of blocks");
+  NS_TEST_EXPECT_MSG_EQ (blocks[0].type, 0x0A0D0D0A, "No section header");
+  NS_TEST_EXPECT_MSG_EQ (GetU32 (blocks[0], 0), 0x1A2B3C4D, "Wrong byte order magic");
+  NS_TEST_EXPECT_MSG_EQ (blocks[1].type, 1, "No first interface");
+  NS_TEST_EXPECT_MSG_EQ (GetU32 (blocks[1], 0), PcapHelper::DLT_EN10MB, "Wrong data link type");
+  NS_TEST_EXPECT_MSG_EQ (GetU32 (blocks[1], 4), 65535, "Wrong snapshot length");
+  NS_TEST_EXPECT_MSG_EQ (std::string (blocks[1].body.begin () + 12, blocks[1].body.begin () + 15), "eth",
+                         "Wrong interface name");
+  NS_TEST_EXPECT_MSG_EQ (blocks[2].type, 1, "No second interface");
+  NS_TEST_EXPECT_MSG_EQ (GetU32 (blocks[2], 0), PcapHelper::DLT_PPP, "Wrong data link type");
+  NS_TEST_EXPECT_MSG_EQ (GetU32 (blocks[2], 4), 30, "Wrong snapshot length");
+
+  NS_TEST_EXPECT_MSG_EQ (blocks[3].type, 6, "No first packet");
+  NS_TEST_EXPECT_MSG_EQ (GetU32 (blocks[3], 0), eth, "Wrong interface");
+  NS_TEST_EXPECT_MSG_EQ (GetU32 (blocks[3], 8), 5, "Wrong time");
+  NS_TEST_EXPECT_MSG_EQ (GetU32 (blocks[3], 12), 11, "Wrong capture length");
+  NS_TEST_EXPECT_MSG_EQ (GetU32 (blocks[3], 16), 11, "Wrong size");
+  NS_TEST_EXPECT_MSG_EQ (blocks[3].body[20 + 10], 11, "Wrong bytes");
+
+  uint64_t ts = 5000000000000ULL;
+  NS_TEST_EXPECT_MSG_EQ (blocks[4].type, 6, "No second packet");
+  NS_TEST_EXPECT_MSG_EQ (GetU32 (blocks[4], 0), ppp, "Wrong interface");
+  NS_TEST_EXPECT_MSG_EQ (GetU32 (blocks[4], 4), static_cast<uint32_t> (ts >> 32), "Wrong time");
+  NS_TEST_EXPECT_MSG_EQ (GetU32 (blocks[4], 8), static_cast<uint32_t> (ts), "Wrong time");
+  NS_TEST_EXPECT_MSG_EQ (GetU32 (blocks[4], 12), 30, "Wrong capture length");
+  NS_TEST_EXPECT_MSG_EQ (GetU32 (blocks[4], 16), 70, "Wrong size");
+  std::remove (filename.c_str ());
+
+  // The pcap files of PcapHelper, as interfaces of a single file.
+  PcapHelper::EnableSharedFile (filename);
+  PcapHelper helper;
+  Ptr<PcapFileWrapper> a = helper.CreateFile ("a.pcap", std::ios::out, PcapHelper::DLT_EN10MB);
+  Ptr<PcapFileWrapper> b = helper.CreateFile ("b.pcap", std::ios::out, PcapHelper::DLT_RAW);
+  PcapHelper::EnableSharedFile ("");
+  Simulator::Schedule (Seconds (1), &WriteNow, b, MakePacket (2));
+  Simulator::Schedule (Seconds (2), &WriteNow, a, MakePacket (3));
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  blocks = ReadPcapNg (filename);
+  NS_TEST_ASSERT_MSG_EQ (blocks.size (), 5, "Wrong number of blocks in the shared file");
+  NS_TEST_EXPECT_MSG_EQ (std::string (blocks[1].body.begin () + 12, blocks[1].body.begin () + 13), "a",
+                         "Wrong interface name");
+  NS_TEST_EXPECT_MSG_EQ (GetU32 (blocks[2], 0), PcapHelper::DLT_RAW, "Wrong data link type");
+  NS_TEST_EXPECT_MSG_EQ (GetU32 (blocks[3], 0), 1, "Wrong interface of the first packet");
+  NS_TEST_EXPECT_MSG_EQ (GetU32 (blocks[4], 0), 0, "Wrong interface of the second packet");
+  std::remove (filename.c_str ());
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief PcapWriter TestSuite
+ */
+class PcapWriterTestSuite : public TestSuite
+{
+public:
+  PcapWriterTestSuite ()
+    : TestSuite ("pcap-writer", UNIT)
+  {
+    AddTestCase (new PcapWriterPcapTestCase (), TestCase::QUICK);
+    AddTestCase (new PcapWriterPcapNgTestCase (), TestCase::QUICK);
+  }
+};
+
+static PcapWriterTestSuite g_pcapWriterTestSuite; //!< Static variable for test initialization
@@ -52,12 +52,10 @@ public:
   virtual Ptr<const Item> Peek (void) const;
 
 private:
-  using Queue<Item>::begin;
-  using Queue<Item>::end;
-  using Queue<Item>::DoEnqueue;
-  using Queue<Item>::DoDequeue;
-  using Queue<Item>::DoRemove;
-  using Queue<Item>::DoPeek;
+  using Queue<Item>::DoEnqueueTail;
+  using Queue<Item>::DoDequeueHead;
+  using Queue<Item>::DoRemoveHead;
+  using Queue<Item>::DoPeekHead;
 
   NS_LOG_TEMPLATE_DECLARE;     //!< redefinition of the log component
 };
@@ -105,7 +103,7 @@ DropTailQueue<Item>::Enqueue (Ptr<Item> item)
 {
   NS_LOG_FUNCTION (this << item);
 
-  return DoEnqueue (end (), item);
+  return DoEnqueueTail (item);
 }
 
 template <typename Item>
@@ -114,7 +112,7 @@ DropTailQueue<Item>::Dequeue (void)
 {
   NS_LOG_FUNCTION (this);
 
-  Ptr<Item> item = DoDequeue (begin ());
+  Ptr<Item> item = DoDequeueHead ();
 
   NS_LOG_LOGIC ("Popped " << item);
 
@@ -127,7 +125,7 @@ DropTailQueue<Item>::Remove (void)
 {
   NS_LOG_FUNCTION (this);
 
-  Ptr<Item> item = DoRemove (begin ());
+  Ptr<Item> item = DoRemoveHead ();
 
   NS_LOG_LOGIC ("Removed " << item);
 
@@ -140,7 +138,7 @@ DropTailQueue<Item>::Peek (void) const
 {
   NS_LOG_FUNCTION (this);
 
-  return DoPeek (begin ());
+  return DoPeekHead ();
 }
 
 // The following explicit template instantiation declarations prevent all the
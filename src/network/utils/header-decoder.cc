@@ -0,0 +1,194 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "header-decoder.h"
+#include "ethernet-header.h"
+#include "llc-snap-header.h"
+#include "ns3/assert.h"
+#include "ns3/buffer.h"
+#include "ns3/log.h"
+
+#include <map>
+#include <utility>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("HeaderDecoder");
+
+namespace {
+
+/** The registered headers. */
+typedef std::map<TypeId, HeaderDecoder::NextHeaderCallback> Headers;
+/** The registered protocol numbers, by table and number. */
+typedef std::map<std::pair<std::string, uint32_t>, TypeId> Protocols;
+
+/**
+ * \returns The registered headers.
+ */
+Headers &
+GetHeaders (void)
+{
+  static Headers headers;
+  return headers;
+}
+
+/**
+ * \returns The registered protocol numbers.
+ */
+Protocols &
+GetProtocols (void)
+{
+  static Protocols protocols;
+  return protocols;
+}
+
+/**
+ * Zero bytes appended to the decoded bytes, so that a header cut short
+ * by a snapshot can be deserialized before it is found not to fit.
+ * This covers the largest registered headers, with their options.
+ */
+const uint32_t PADDING = 128;
+
+/**
+ * Tell which header follows an Ethernet header.
+ * \param [in] header The EthernetHeader.
+ * \param [out] tid The TypeId of the next header.
+ * \returns \c true if a known header follows.
+ */
+bool
+EthernetNext (const Header &header, TypeId *tid)
+{
+  uint16_t lengthType = static_cast<const EthernetHeader &> (header).GetLengthType ();
+  if (lengthType <= 1500)
+    {
+      *tid = LlcSnapHeader::GetTypeId ();
+      return true;
+    }
+  return HeaderDecoder::LookupProtocol ("ethertype", lengthType, tid);
+}
+
+/**
+ * Tell which header follows an LLC/SNAP header.
+ * \param [in] header The LlcSnapHeader.
+ * \param [out] tid The TypeId of the next header.
+ * \returns \c true if a known header follows.
+ */
+bool
+LlcSnapNext (const Header &header, TypeId *tid)
+{
+  LlcSnapHeader llc = static_cast<const LlcSnapHeader &> (header);
+  return HeaderDecoder::LookupProtocol ("ethertype", llc.GetType (), tid);
+}
+
+/**
+ * Register the headers of the network module.
+ */
+struct NetworkHeaders
+{
+  NetworkHeaders ()
+  {
+    HeaderDecoder::RegisterHeader (EthernetHeader::GetTypeId (), MakeCallback (&EthernetNext));
+    HeaderDecoder::RegisterHeader (LlcSnapHeader::GetTypeId (), MakeCallback (&LlcSnapNext));
+  }
+} g_networkHeaders; //!< Registers the headers of the network module
+
+} // unnamed namespace
+
+
+void
+HeaderDecoder::RegisterHeader (TypeId tid, NextHeaderCallback next)
+{
+  NS_LOG_FUNCTION (tid);
+  NS_ASSERT_MSG (tid.HasConstructor (), "Header " << tid.GetName () << " has no constructor");
+  GetHeaders ()[tid] = next;
+}
+
+void
+HeaderDecoder::RegisterProtocol (std::string table, uint32_t number, TypeId tid)
+{
+  NS_LOG_FUNCTION (table << number << tid);
+  GetProtocols ()[std::make_pair (table, number)] = tid;
+}
+
+bool
+HeaderDecoder::LookupProtocol (std::string table, uint32_t number, TypeId *tid)
+{
+  Protocols &protocols = GetProtocols ();
+  Protocols::const_iterator i = protocols.find (std::make_pair (table, number));
+  if (i == protocols.end ())
+    {
+      return false;
+    }
+  *tid = i->second;
+  return true;
+}
+
+void
+HeaderDecoder::Print (std::ostream &os, TypeId first,
+                      const uint8_t *data, uint32_t size, uint32_t packetSize)
+{
+  NS_LOG_FUNCTION (&os << first << size << packetSize);
+  NS_ASSERT (size <= packetSize);
+  Buffer buffer;
+  buffer.AddAtStart (size + PADDING);
+  Buffer::Iterator bytes = buffer.Begin ();
+  bytes.Write (data, size);
+  bytes.WriteU8 (0, PADDING);
+  Headers &headers = GetHeaders ();
+  uint32_t offset = 0;
+  TypeId tid = first;
+  bool more = true;
+  while (more)
+    {
+      Headers::const_iterator i = headers.find (tid);
+      if (i == headers.end ())
+        {
+          NS_LOG_LOGIC ("header " << tid.GetName () << " not registered");
+          break;
+        }
+      Header *header = dynamic_cast<Header *> (tid.GetConstructor () ());
+      NS_ASSERT (header != 0);
+      Buffer::Iterator start = buffer.Begin ();
+      start.Next (offset);
+      uint32_t n = header->Deserialize (start);
+      if (n == 0 || n > size - offset)
+        {
+          NS_LOG_LOGIC ("header " << tid.GetName () << " does not fit");
+          delete header;
+          break;
+        }
+      if (offset > 0)
+        {
+          os << " ";
+        }
+      os << tid.GetName () << " (";
+      header->Print (os);
+      os << ")";
+      offset += n;
+      more = !i->second.IsNull () && i->second (*header, &tid);
+      delete header;
+    }
+  if (packetSize > offset)
+    {
+      if (offset > 0)
+        {
+          os << " ";
+        }
+      os << "Payload (size=" << packetSize - offset << ")";
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,107 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef HEADER_DECODER_H
+#define HEADER_DECODER_H
+
+#include "ns3/callback.h"
+#include "ns3/header.h"
+#include "ns3/type-id.h"
+
+#include <ostream>
+#include <stdint.h>
+#include <string>
+
+namespace ns3 {
+
+/**
+ * \ingroup network
+ *
+ * \brief Print the headers of raw packet bytes, without packet metadata.
+ *
+ * Packet::Print relies on the packet metadata, which is only recorded
+ * once Packet::EnablePrinting has been called, for every packet of the
+ * simulation.  The decoder instead parses the bytes of a packet with
+ * the registered headers: starting from the header of the device, each
+ * registered header tells which header follows it, typically from a
+ * protocol number looked up in a table of protocols, such as the
+ * EtherTypes.  The bytes left after the last known header are printed
+ * as the payload.
+ *
+ * Headers are registered by the module which defines them.  The network
+ * module registers EthernetHeader and LlcSnapHeader, and the internet
+ * module registers its IP, ARP, ICMP, UDP and TCP headers, as well as
+ * their EtherTypes and IP protocol numbers:
+ * \code
+ *   HeaderDecoder::RegisterHeader (Ipv4Header::GetTypeId (), MakeCallback (&Ipv4Next));
+ *   HeaderDecoder::RegisterProtocol ("ethertype", 0x0800, Ipv4Header::GetTypeId ());
+ * \endcode
+ *
+ * Trailers are not decoded: they are printed as part of the payload.
+ */
+class HeaderDecoder
+{
+public:
+  /**
+   * Callback telling which header follows a decoded header.
+   * It returns \c false if the payload follows, and \c true otherwise,
+   * after setting the TypeId of the next header.
+   */
+  typedef Callback<bool, const Header &, TypeId *> NextHeaderCallback;
+
+  /**
+   * Register a header.
+   * \param [in] tid The TypeId of the header, which must have a constructor.
+   * \param [in] next Tells which header follows, or null if the
+   *             payload always follows the header.
+   */
+  static void RegisterHeader (TypeId tid, NextHeaderCallback next);
+  /**
+   * Register the header of a protocol number.
+   * \param [in] table The name of the table of protocol numbers,
+   *             such as "ethertype" or "ip".
+   * \param [in] number The protocol number.
+   * \param [in] tid The TypeId of the header.
+   */
+  static void RegisterProtocol (std::string table, uint32_t number, TypeId tid);
+  /**
+   * Look up the header of a protocol number.
+   * \param [in] table The name of the table of protocol numbers.
+   * \param [in] number The protocol number.
+   * \param [out] tid The TypeId of the header.
+   * \returns \c true if the protocol number is registered.
+   */
+  static bool LookupProtocol (std::string table, uint32_t number, TypeId *tid);
+
+  /**
+   * Print the headers of a packet, in the format of Packet::Print.
+   *
+   * The bytes may be a prefix of the packet: decoding stops at the first
+   * header which does not fit.
+   *
+   * \param [in,out] os The output stream.
+   * \param [in] first The TypeId of the first header.
+   * \param [in] data The first bytes of the packet.
+   * \param [in] size The number of bytes in \p data.
+   * \param [in] packetSize The size of the whole packet.
+   */
+  static void Print (std::ostream &os, TypeId first,
+                     const uint8_t *data, uint32_t size, uint32_t packetSize);
+};
+
+} // namespace ns3
+
+#endif /* HEADER_DECODER_H */
@@ -54,6 +54,7 @@ NetDeviceQueue::~NetDeviceQueue ()
 
   m_queueLimits = 0;
   m_wakeCallback.Nullify ();
+  m_wouldOverflow.Nullify ();
   m_device = 0;
 }
 
@@ -64,6 +65,24 @@ NetDeviceQueue::IsStopped (void) const
   return m_stoppedByDevice || m_stoppedByQueueLimits;
 }
 
+bool
+NetDeviceQueue::WouldStop (uint32_t nPackets, uint32_t nBytes) const
+{
+  NS_LOG_FUNCTION (this << nPackets << nBytes);
+
+  if (IsStopped () || m_wouldOverflow.IsNull () || !m_device)
+    {
+      return true;
+    }
+  // Byte Queue Limits stop the queue when the queued bytes exceed the limit
+  if (m_queueLimits && m_queueLimits->Available () < static_cast<int32_t> (nBytes))
+    {
+      return true;
+    }
+  // PacketEnqueued stops the queue when it could not store another packet
+  return m_wouldOverflow (nPackets + 1, nBytes + m_device->GetMtu ());
+}
+
 void
 NetDeviceQueue::Start (void)
 {
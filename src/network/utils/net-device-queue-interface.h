@@ -93,6 +93,21 @@ public:
    */
   virtual bool IsStopped (void) const;
 
+  /**
+   * \brief Tell whether a batch of packets would stop the device transmission queue.
+   * \param nPackets the number of packets in the batch
+   * \param nBytes the number of bytes in the batch
+   * \return true if the device transmission queue is stopped, or would be stopped
+   *         once the batch is enqueued in the device queue.
+   *
+   * Called by queue discs to bound the number of packets they dequeue at once
+   * and send to the device with NetDevice::SendBatch. The device queue is only
+   * known if the device connected its traces with ConnectQueueTraces, otherwise
+   * every batch is deemed to stop the transmission queue.
+   * This is the analogous to the qdisc_avail_bulklimit function of the Linux kernel.
+   */
+  virtual bool WouldStop (uint32_t nPackets, uint32_t nBytes) const;
+
   /**
    * \brief Notify this NetDeviceQueue that the NetDeviceQueueInterface was
    *        aggregated to an object.
@@ -197,7 +212,7 @@ public:
    *        for flow control and dynamic queue limits. A queue can be any object providing:
    *        - "Enqueue", "Dequeue", "DropBeforeEnqueue" traces
    *        - an ItemType typedef for the type of stored items
-   *        - GetCurrentSize and GetMaxSize methods
+   *        - GetCurrentSize, GetMaxSize and WouldOverflow methods
    * \param queue the queue
    */
   template <typename QueueType>
@@ -208,6 +223,7 @@ private:
   bool m_stoppedByQueueLimits;    //!< True if the queue has been stopped by a queue limits object
   Ptr<QueueLimits> m_queueLimits; //!< Queue limits object
   WakeCallback m_wakeCallback;    //!< Wake callback
+  Callback<bool, uint32_t, uint32_t> m_wouldOverflow; //!< The WouldOverflow method of the device queue
   Ptr<NetDevice> m_device;        //!< the netdevice aggregated to the NetDeviceQueueInterface
 
   NS_LOG_TEMPLATE_DECLARE;        //!< redefinition of the log component
@@ -326,6 +342,7 @@ NetDeviceQueue::ConnectQueueTraces (Ptr<QueueType> queue)
 {
   NS_ASSERT (queue != 0);
 
+  m_wouldOverflow = MakeCallback (&QueueType::WouldOverflow, PeekPointer (queue));
   queue->TraceConnectWithoutContext ("Enqueue",
                                      MakeCallback (&NetDeviceQueue::PacketEnqueued<QueueType>, this)
                                      .Bind (PeekPointer (queue)));
@@ -52,6 +52,7 @@ PcapFileWrapper::GetTypeId (void)
 
 
 PcapFileWrapper::PcapFileWrapper ()
+  : m_interface (0)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -66,6 +67,10 @@ bool
 PcapFileWrapper::Fail (void) const
 {
   NS_LOG_FUNCTION (this);
+  if (m_writer)
+    {
+      return m_writer->Fail ();
+    }
   return m_file.Fail ();
 }
 
@@ -86,6 +91,7 @@ void
 PcapFileWrapper::Close (void)
 {
   NS_LOG_FUNCTION (this);
+  m_writer = 0;
   m_file.Close ();
 }
 
@@ -115,10 +121,23 @@ PcapFileWrapper::Init (uint32_t dataLinkType, uint32_t snapLen, int32_t tzCorrec
     } 
 }
 
+void
+PcapFileWrapper::SetWriter (Ptr<PcapWriter> writer, uint32_t interface)
+{
+  NS_LOG_FUNCTION (this << writer << interface);
+  m_writer = writer;
+  m_interface = interface;
+}
+
 void
 PcapFileWrapper::Write (Time t, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (this << t << p);
+  if (m_writer)
+    {
+      m_writer->Write (m_interface, t, p);
+      return;
+    }
   if (m_file.IsNanoSecMode())
     {
       uint64_t current = t.GetNanoSeconds ();
@@ -139,6 +158,11 @@ void
 PcapFileWrapper::Write (Time t, const Header &header, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (this << t << &header << p);
+  if (m_writer)
+    {
+      m_writer->Write (m_interface, t, header, p);
+      return;
+    }
   if (m_file.IsNanoSecMode())
     {
       uint64_t current = t.GetNanoSeconds ();
@@ -159,6 +183,11 @@ void
 PcapFileWrapper::Write (Time t, uint8_t const *buffer, uint32_t length)
 {
   NS_LOG_FUNCTION (this << t << &buffer << length);
+  if (m_writer)
+    {
+      m_writer->Write (m_interface, t, buffer, length);
+      return;
+    }
   if (m_file.IsNanoSecMode())
     {
       uint64_t current = t.GetNanoSeconds ();
@@ -27,6 +27,7 @@
 #include "ns3/object.h"
 #include "ns3/nstime.h"
 #include "pcap-file.h"
+#include "pcap-writer.h"
 
 namespace ns3 {
 
@@ -109,6 +110,18 @@ public:
              uint32_t snapLen = std::numeric_limits<uint32_t>::max (), 
              int32_t tzCorrection = PcapFile::ZONE_DEFAULT);
 
+  /**
+   * \brief Write the packets to an interface of a PcapWriter instead of to
+   * the file of this wrapper, which must not be opened.
+   *
+   * The reading methods and the file header getters do not apply to such a
+   * wrapper.
+   *
+   * \param writer The writer.
+   * \param interface The interface of the writer.
+   */
+  void SetWriter (Ptr<PcapWriter> writer, uint32_t interface);
+
   /**
    * \brief Write the next packet to file
    * 
@@ -224,6 +237,8 @@ private:
   PcapFile m_file; //!< Pcap file
   uint32_t m_snapLen; //!< max length of saved packets
   bool     m_nanosecMode; //!< Timestamps in nanosecond mode
+  Ptr<PcapWriter> m_writer; //!< The writer of the packets, if any
+  uint32_t m_interface; //!< The interface of the packets in m_writer
 };
 
 } // namespace ns3
@@ -0,0 +1,484 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "pcap-writer.h"
+#include "pcap-file.h"
+#include "ns3/abort.h"
+#include "ns3/assert.h"
+#include "ns3/boolean.h"
+#include "ns3/buffer.h"
+#include "ns3/enum.h"
+#include "ns3/header.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/uinteger.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("PcapWriter");
+
+NS_OBJECT_ENSURE_REGISTERED (PcapWriter);
+
+/**
+ * \ingroup network
+ *
+ * The I/O thread shared by all the PcapWriter instances, which writes
+ * the buffers they submit in turn.
+ */
+class PcapWriterThread
+{
+public:
+  /**
+   * \returns The I/O thread, started on first use.
+   */
+  static PcapWriterThread &Get (void);
+
+  PcapWriterThread ();
+  ~PcapWriterThread ();
+
+  /**
+   * Queue the pending buffer of a writer, whose m_busy flag is set.
+   * \param writer The writer.
+   */
+  void Post (PcapWriter *writer);
+
+  /**
+   * Wait until a writer's pending buffer has been written.
+   * \param writer The writer.
+   */
+  void Wait (PcapWriter *writer);
+
+  /**
+   * \param writer The writer.
+   * \returns Whether a write of the writer failed.
+   */
+  bool Failed (const PcapWriter *writer);
+
+private:
+  /** Write the queued buffers until the thread is stopped. */
+  void Run (void);
+
+  std::mutex m_mutex;              //!< Protects the queue and the m_busy flags
+  std::condition_variable m_work;  //!< Signals a queued buffer
+  std::condition_variable m_done;  //!< Signals a written buffer
+  std::deque<PcapWriter *> m_queue; //!< The writers whose pending buffer is queued
+  bool m_stop;                     //!< Whether the thread must exit
+  std::thread m_thread;            //!< The thread
+};
+
+PcapWriterThread &
+PcapWriterThread::Get (void)
+{
+  static PcapWriterThread thread;
+  return thread;
+}
+
+PcapWriterThread::PcapWriterThread ()
+  : m_stop (false),
+    m_thread (&PcapWriterThread::Run, this)
+{
+}
+
+PcapWriterThread::~PcapWriterThread ()
+{
+  {
+    std::lock_guard<std::mutex> lock (m_mutex);
+    m_stop = true;
+  }
+  m_work.notify_one ();
+  m_thread.join ();
+}
+
+void
+PcapWriterThread::Post (PcapWriter *writer)
+{
+  {
+    std::lock_guard<std::mutex> lock (m_mutex);
+    writer->m_busy = true;
+    m_queue.push_back (writer);
+  }
+  m_work.notify_one ();
+}
+
+void
+PcapWriterThread::Wait (PcapWriter *writer)
+{
+  std::unique_lock<std::mutex> lock (m_mutex);
+  m_done.wait (lock, [writer] { return !writer->m_busy; });
+}
+
+bool
+PcapWriterThread::Failed (const PcapWriter *writer)
+{
+  std::lock_guard<std::mutex> lock (m_mutex);
+  return writer->m_failed;
+}
+
+void
+PcapWriterThread::Run (void)
+{
+  std::unique_lock<std::mutex> lock (m_mutex);
+  while (true)
+    {
+      m_work.wait (lock, [this] { return m_stop || !m_queue.empty (); });
+      if (m_queue.empty ())
+        {
+          return;
+        }
+      PcapWriter *writer = m_queue.front ();
+      m_queue.pop_front ();
+      lock.unlock ();
+      writer->WritePending ();
+      lock.lock ();
+      writer->m_failed |= writer->m_file.fail ();
+      writer->m_busy = false;
+      m_done.notify_all ();
+    }
+}
+
+
+namespace {
+
+/** The magic number of a pcap file. */
+const uint32_t PCAP_MAGIC = 0xa1b2c3d4;
+/** The magic number of a pcap file with nanosecond timestamps. */
+const uint32_t PCAP_NS_MAGIC = 0xa1b23c4d;
+/** The major version of the pcap format. */
+const uint16_t PCAP_VERSION_MAJOR = 2;
+/** The minor version of the pcap format. */
+const uint16_t PCAP_VERSION_MINOR = 4;
+/** The type of a pcapng section header block. */
+const uint32_t PCAPNG_SHB = 0x0A0D0D0A;
+/** The type of a pcapng interface description block. */
+const uint32_t PCAPNG_IDB = 1;
+/** The type of a pcapng enhanced packet block. */
+const uint32_t PCAPNG_EPB = 6;
+/** The byte order magic of a pcapng section. */
+const uint32_t PCAPNG_BYTE_ORDER = 0x1A2B3C4D;
+/** The if_name option of a pcapng interface. */
+const uint16_t PCAPNG_IF_NAME = 2;
+/** The if_tsresol option of a pcapng interface. */
+const uint16_t PCAPNG_IF_TSRESOL = 9;
+
+/**
+ * Store a value in host byte order, without alignment.
+ * \param [in,out] p Where to store it, advanced past it.
+ * \param [in] v The value.
+ */
+template <typename T>
+void
+Put (uint8_t *&p, T v)
+{
+  std::memcpy (p, &v, sizeof (v));
+  p += sizeof (v);
+}
+
+/**
+ * \param size A number of bytes.
+ * \returns The size padded to 32 bits, as pcapng blocks are.
+ */
+uint32_t
+Pad (uint32_t size)
+{
+  return (size + 3) & ~3U;
+}
+
+} // unnamed namespace
+
+
+TypeId
+PcapWriter::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::PcapWriter")
+    .SetParent<Object> ()
+    .SetGroupName ("Network")
+    .AddConstructor<PcapWriter> ()
+    .AddAttribute ("Format",
+                   "The format of the file.",
+                   EnumValue (PcapWriter::PCAP),
+                   MakeEnumAccessor (&PcapWriter::m_format),
+                   MakeEnumChecker (PcapWriter::PCAP, "Pcap",
+                                    PcapWriter::PCAPNG, "PcapNg"))
+    .AddAttribute ("CaptureSize",
+                   "Maximum length of captured packets, for all the interfaces (cf. pcap snaplen)",
+                   UintegerValue (PcapFile::SNAPLEN_DEFAULT),
+                   MakeUintegerAccessor (&PcapWriter::m_captureSize),
+                   MakeUintegerChecker<uint32_t> (0, PcapFile::SNAPLEN_DEFAULT))
+    .AddAttribute ("BufferSize",
+                   "The number of bytes buffered before they are handed to the I/O thread.",
+                   UintegerValue (64 << 10),
+                   MakeUintegerAccessor (&PcapWriter::m_bufferSize),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("NanosecMode",
+                   "Whether packet timestamps are nanoseconds or microseconds(default).",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&PcapWriter::m_nanosecMode),
+                   MakeBooleanChecker ())
+  ;
+  return tid;
+}
+
+PcapWriter::PcapWriter ()
+  : m_busy (false),
+    m_failed (false)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+PcapWriter::~PcapWriter ()
+{
+  NS_LOG_FUNCTION (this);
+  Close ();
+}
+
+void
+PcapWriter::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  Close ();
+  Object::DoDispose ();
+}
+
+bool
+PcapWriter::Open (std::string filename)
+{
+  NS_LOG_FUNCTION (this << filename);
+  NS_ASSERT_MSG (!m_file.is_open (), "PcapWriter already open");
+  m_file.open (filename, std::ios::out | std::ios::binary | std::ios::trunc);
+  m_failed = !m_file.is_open ();
+  if (m_failed)
+    {
+      return false;
+    }
+  m_buffer.reserve (m_bufferSize);
+  m_pending.reserve (m_bufferSize);
+  m_interfaces.clear ();
+  if (m_format == PCAPNG)
+    {
+      uint32_t size = 28;
+      uint8_t *p = Append (size);
+      Put (p, PCAPNG_SHB);
+      Put (p, size);
+      Put (p, PCAPNG_BYTE_ORDER);
+      Put<uint16_t> (p, 1);
+      Put<uint16_t> (p, 0);
+      Put<int64_t> (p, -1);
+      Put (p, size);
+    }
+  return true;
+}
+
+uint32_t
+PcapWriter::AddInterface (std::string name, uint32_t dataLinkType, uint32_t snapLen, int32_t tzCorrection)
+{
+  NS_LOG_FUNCTION (this << name << dataLinkType << snapLen << tzCorrection);
+  NS_ASSERT_MSG (m_file.is_open (), "PcapWriter not open");
+  NS_ABORT_MSG_IF (m_format == PCAP && !m_interfaces.empty (),
+                   "A pcap file holds a single interface, use the pcapng format");
+  Interface interface;
+  interface.snapLen = std::min (snapLen, m_captureSize);
+  if (m_format == PCAP)
+    {
+      uint8_t *p = Append (24);
+      Put (p, m_nanosecMode ? PCAP_NS_MAGIC : PCAP_MAGIC);
+      Put (p, PCAP_VERSION_MAJOR);
+      Put (p, PCAP_VERSION_MINOR);
+      Put (p, tzCorrection);
+      Put<uint32_t> (p, 0);    // sigfigs
+      Put (p, interface.snapLen);
+      Put (p, dataLinkType);
+    }
+  else
+    {
+      uint32_t nameSize = std::min<uint32_t> (name.size (), 0xffff);
+      uint32_t size = 20 + 4 + Pad (nameSize) + (m_nanosecMode ? 8 : 0) + 4;
+      uint8_t *p = Append (size);
+      Put (p, PCAPNG_IDB);
+      Put (p, size);
+      Put<uint16_t> (p, dataLinkType);
+      Put<uint16_t> (p, 0);
+      Put (p, interface.snapLen);
+      Put (p, PCAPNG_IF_NAME);
+      Put<uint16_t> (p, nameSize);
+      std::memcpy (p, name.data (), nameSize);
+      std::memset (p + nameSize, 0, Pad (nameSize) - nameSize);
+      p += Pad (nameSize);
+      if (m_nanosecMode)
+        {
+          Put (p, PCAPNG_IF_TSRESOL);
+          Put<uint16_t> (p, 1);
+          Put<uint32_t> (p, 9);  // 10^-9, in the first byte: the rest is padding
+        }
+      Put<uint32_t> (p, 0);    // opt_endofopt
+      Put (p, size);
+    }
+  m_interfaces.push_back (interface);
+  return m_interfaces.size () - 1;
+}
+
+uint32_t
+PcapWriter::GetCaptureLength (uint32_t interface, uint32_t size) const
+{
+  NS_ASSERT_MSG (interface < m_interfaces.size (), "Unknown interface " << interface);
+  return std::min (size, m_interfaces[interface].snapLen);
+}
+
+uint8_t *
+PcapWriter::Append (uint32_t size)
+{
+  if (!m_buffer.empty () && m_buffer.size () + size > m_bufferSize)
+    {
+      Submit ();
+    }
+  size_t offset = m_buffer.size ();
+  m_buffer.resize (offset + size);
+  return m_buffer.data () + offset;
+}
+
+uint8_t *
+PcapWriter::AppendRecord (uint32_t interface, Time t, uint32_t size)
+{
+  uint32_t inclLen = GetCaptureLength (interface, size);
+  uint64_t ts = m_nanosecMode ? t.GetNanoSeconds () : t.GetMicroSeconds ();
+  if (m_format == PCAP)
+    {
+      uint64_t unit = m_nanosecMode ? 1000000000 : 1000000;
+      uint8_t *p = Append (16 + inclLen);
+      Put<uint32_t> (p, ts / unit);
+      Put<uint32_t> (p, ts % unit);
+      Put (p, inclLen);
+      Put (p, size);
+      return p;
+    }
+  uint32_t blockSize = 28 + Pad (inclLen) + 4;
+  uint8_t *p = Append (blockSize);
+  Put (p, PCAPNG_EPB);
+  Put (p, blockSize);
+  Put (p, interface);
+  Put<uint32_t> (p, ts >> 32);
+  Put<uint32_t> (p, ts);
+  Put (p, inclLen);
+  Put (p, size);
+  std::memset (p + inclLen, 0, Pad (inclLen) - inclLen);
+  uint8_t *end = p + Pad (inclLen);
+  Put (end, blockSize);
+  return p;
+}
+
+void
+PcapWriter::Write (uint32_t interface, Time t, Ptr<const Packet> p)
+{
+  NS_LOG_FUNCTION (this << interface << t << p);
+  uint32_t size = p->GetSize ();
+  uint8_t *data = AppendRecord (interface, t, size);
+  p->CopyData (data, GetCaptureLength (interface, size));
+}
+
+void
+PcapWriter::Write (uint32_t interface, Time t, const Header &header, Ptr<const Packet> p)
+{
+  NS_LOG_FUNCTION (this << interface << t << &header << p);
+  uint32_t headerSize = header.GetSerializedSize ();
+  uint32_t size = headerSize + p->GetSize ();
+  uint8_t *data = AppendRecord (interface, t, size);
+  uint32_t inclLen = GetCaptureLength (interface, size);
+
+  Buffer headerBuffer;
+  headerBuffer.AddAtStart (headerSize);
+  header.Serialize (headerBuffer.Begin ());
+  uint32_t toCopy = std::min (headerSize, inclLen);
+  headerBuffer.CopyData (data, toCopy);
+  p->CopyData (data + toCopy, inclLen - toCopy);
+}
+
+void
+PcapWriter::Write (uint32_t interface, Time t, const uint8_t *data, uint32_t length)
+{
+  NS_LOG_FUNCTION (this << interface << t << &data << length);
+  uint8_t *p = AppendRecord (interface, t, length);
+  std::memcpy (p, data, GetCaptureLength (interface, length));
+}
+
+void
+PcapWriter::Submit (void)
+{
+  NS_LOG_FUNCTION (this << m_buffer.size ());
+  PcapWriterThread &thread = PcapWriterThread::Get ();
+  thread.Wait (this);
+  // The pending buffer was emptied by the I/O thread but kept its capacity.
+  m_buffer.swap (m_pending);
+  thread.Post (this);
+}
+
+void
+PcapWriter::WritePending (void)
+{
+  m_file.write (reinterpret_cast<const char *> (m_pending.data ()), m_pending.size ());
+  m_file.flush ();
+  m_pending.clear ();
+}
+
+void
+PcapWriter::Flush (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (!m_file.is_open ())
+    {
+      return;
+    }
+  if (!m_buffer.empty ())
+    {
+      Submit ();
+    }
+  PcapWriterThread::Get ().Wait (this);
+}
+
+void
+PcapWriter::Close (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (!m_file.is_open ())
+    {
+      return;
+    }
+  Flush ();
+  m_file.close ();
+  m_buffer = std::vector<uint8_t> ();
+  m_pending = std::vector<uint8_t> ();
+}
+
+bool
+PcapWriter::Fail (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return PcapWriterThread::Get ().Failed (this);
+}
+
+void
+PcapWriter::Sink (Ptr<PcapWriter> writer, uint32_t interface, Ptr<const Packet> p)
+{
+  NS_LOG_FUNCTION (writer << interface << p);
+  writer->Write (interface, Simulator::Now (), p);
+}
+
+} // namespace ns3
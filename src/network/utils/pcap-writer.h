@@ -0,0 +1,218 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef PCAP_WRITER_H
+#define PCAP_WRITER_H
+
+#include "ns3/object.h"
+#include "ns3/nstime.h"
+#include "ns3/packet.h"
+
+#include <fstream>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace ns3 {
+
+class Header;
+
+/**
+ * \ingroup network
+ *
+ * \brief Write packet captures in the pcap or the pcapng format, through
+ * large buffers written out by a background thread.
+ *
+ * The records are serialized into an in-memory buffer of "BufferSize"
+ * bytes.  When it is full, the buffer is handed to an I/O thread shared
+ * by all the writers, and the records go to a second buffer while the
+ * first one is written out, so the simulation only waits when the disk
+ * cannot keep up with it.  The bytes of a packet are copied once, from
+ * the packet to the buffer, and only up to the capture length.
+ *
+ * A pcapng writer can hold the captures of several interfaces, each with
+ * its own data link type and capture length, in a single file; a pcap
+ * writer holds exactly one.  The records are written in the byte order
+ * of the host, which both formats announce in their file headers.
+ *
+ * The records are only on disk after Flush or Close: the writer closes
+ * itself when it is disposed or destroyed.
+ */
+class PcapWriter : public Object
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  /** The file formats. */
+  enum Format
+  {
+    PCAP,   //!< The classic pcap format, with a single interface
+    PCAPNG  //!< The pcapng format, with any number of interfaces
+  };
+
+  PcapWriter ();
+  ~PcapWriter ();
+
+  /**
+   * Create the file and write its header.
+   *
+   * \param filename The name of the file.
+   * \returns \c false if the file could not be created.
+   */
+  bool Open (std::string filename);
+
+  /**
+   * Declare an interface whose packets will be written to the file.
+   *
+   * \param name The name of the interface, which pcapng readers show.
+   * \param dataLinkType The pcap data link type of the packets.
+   * \param snapLen The capture length of the interface, itself capped
+   *        by the "CaptureSize" attribute.
+   * \param tzCorrection The time zone of a pcap file.
+   * \returns The index of the interface, to pass to Write.
+   */
+  uint32_t AddInterface (std::string name, uint32_t dataLinkType,
+                         uint32_t snapLen = std::numeric_limits<uint32_t>::max (),
+                         int32_t tzCorrection = 0);
+
+  /**
+   * Write a packet.
+   *
+   * \param interface The interface of the packet.
+   * \param t The time of the capture.
+   * \param p The packet.
+   */
+  void Write (uint32_t interface, Time t, Ptr<const Packet> p);
+
+  /**
+   * Write a header followed by a packet, without adding the header to the
+   * packet.
+   *
+   * \param interface The interface of the packet.
+   * \param t The time of the capture.
+   * \param header The header.
+   * \param p The packet.
+   */
+  void Write (uint32_t interface, Time t, const Header &header, Ptr<const Packet> p);
+
+  /**
+   * Write raw packet bytes.
+   *
+   * \param interface The interface of the packet.
+   * \param t The time of the capture.
+   * \param data The bytes.
+   * \param length The number of bytes.
+   */
+  void Write (uint32_t interface, Time t, const uint8_t *data, uint32_t length);
+
+  /**
+   * Write out all the buffered records and wait until they are in the file.
+   */
+  void Flush (void);
+
+  /**
+   * Flush and close the file.
+   */
+  void Close (void);
+
+  /**
+   * \returns \c true if the file could not be created or written.
+   */
+  bool Fail (void) const;
+
+  /**
+   * A trace sink which writes the packet at the current simulation time.
+   *
+   * \param writer The writer.
+   * \param interface The interface of the packet.
+   * \param p The packet.
+   */
+  static void Sink (Ptr<PcapWriter> writer, uint32_t interface, Ptr<const Packet> p);
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  friend class PcapWriterThread;
+
+  /** The properties of an interface. */
+  struct Interface
+  {
+    uint32_t snapLen;  //!< The capture length
+  };
+
+  /**
+   * Make room at the end of the buffer, handing it to the I/O thread
+   * first if it is full.
+   *
+   * \param size The number of bytes to append.
+   * \returns Where to write them.
+   */
+  uint8_t *Append (uint32_t size);
+
+  /**
+   * Write the header of a packet record.
+   *
+   * \param interface The interface of the packet.
+   * \param t The time of the capture.
+   * \param size The size of the packet.
+   * \returns Where to write the captured bytes, whose number is
+   *          GetCaptureLength (interface, size).
+   */
+  uint8_t *AppendRecord (uint32_t interface, Time t, uint32_t size);
+
+  /**
+   * \param interface The interface of the packet.
+   * \param size The size of the packet.
+   * \returns The number of bytes captured from the packet.
+   */
+  uint32_t GetCaptureLength (uint32_t interface, uint32_t size) const;
+
+  /**
+   * Hand the buffer to the I/O thread, once it is done with the previous
+   * one.
+   */
+  void Submit (void);
+
+  /**
+   * Write the pending buffer to the file.  Called by the I/O thread.
+   */
+  void WritePending (void);
+
+  /** Format attribute. */
+  Format m_format;
+  /** CaptureSize attribute. */
+  uint32_t m_captureSize;
+  /** BufferSize attribute. */
+  uint32_t m_bufferSize;
+  /** NanosecMode attribute. */
+  bool m_nanosecMode;
+
+  std::ofstream m_file;                //!< The file, written by the I/O thread
+  std::vector<Interface> m_interfaces; //!< The interfaces
+  std::vector<uint8_t> m_buffer;       //!< The buffer being filled
+  std::vector<uint8_t> m_pending;      //!< The buffer being written out
+  bool m_busy;                         //!< Whether m_pending is being written out
+  bool m_failed;                       //!< Whether a write failed
+};
+
+} // namespace ns3
+
+#endif /* PCAP_WRITER_H */
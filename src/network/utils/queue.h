@@ -33,6 +33,7 @@
 #include <string>
 #include <sstream>
 #include <list>
+#include <vector>
 
 namespace ns3 {
 
@@ -246,6 +247,14 @@ private:
  * methods in doing so, to ensure that appropriate trace sources are called
  * and statistics are maintained.
  *
+ * The DoEnqueue, DoDequeue, DoRemove and DoPeek methods take an iterator
+ * and store the items in a list, so that iterators remain valid while other
+ * items are enqueued and dequeued.  FIFO subclasses, which only enqueue at
+ * the tail and dequeue, remove or peek at the head, should rather use the
+ * DoEnqueueTail, DoDequeueHead, DoRemoveHead and DoPeekHead methods, which
+ * store the items contiguously in a growable ring buffer and do not
+ * allocate memory per item.  A subclass uses one family or the other.
+ *
  * Users of the Queue template class usually hold a queue through a smart pointer,
  * hence forward declaration is recommended to avoid pulling the implementation
  * of the templates included in this file. Thus, do not include queue.h but add
@@ -417,6 +426,31 @@ protected:
    */
   Ptr<const Item> DoPeek (ConstIterator pos) const;
 
+  /**
+   * Push an item at the tail of the FIFO queue
+   * \param item the item to enqueue
+   * \return true if success, false if the packet has been dropped.
+   */
+  bool DoEnqueueTail (Ptr<Item> item);
+
+  /**
+   * Pull the item at the head of the FIFO queue to dequeue it
+   * \return 0 if the queue is empty; the item otherwise.
+   */
+  Ptr<Item> DoDequeueHead (void);
+
+  /**
+   * Pull the item at the head of the FIFO queue to drop it
+   * \return 0 if the queue is empty; the item otherwise.
+   */
+  Ptr<Item> DoRemoveHead (void);
+
+  /**
+   * Peek the item at the head of the FIFO queue
+   * \return 0 if the queue is empty; the item otherwise.
+   */
+  Ptr<const Item> DoPeekHead (void) const;
+
   /**
    * \brief Drop a packet before enqueue
    * \param item item that was dropped
@@ -440,8 +474,30 @@ protected:
   void DoDispose (void) override;
 
 private:
+  /**
+   * Check that an item fits in the queue, or drop it
+   * \param item the item to enqueue
+   * \return true if the item fits in the queue
+   */
+  bool CheckEnqueue (Ptr<Item> item);
+
+  /**
+   * Count and trace an item which has been stored in the queue
+   * \param item the enqueued item
+   */
+  void Enqueued (Ptr<Item> item);
+
+  /**
+   * Count and trace an item which has been taken from the queue
+   * \param item the dequeued item
+   */
+  void Dequeued (Ptr<Item> item);
+
   std::list<Ptr<Item> > m_packets;          //!< the items in the queue
   NS_LOG_TEMPLATE_DECLARE;                  //!< the log component
+  std::vector<Ptr<Item> > m_ring;           //!< the items in the FIFO queue
+  uint32_t m_ringHead;                      //!< index of the head of the FIFO queue
+  uint32_t m_ringSize;                      //!< number of items in the FIFO queue
 
   /// Traced callback: fired when a packet is enqueued
   TracedCallback<Ptr<const Item> > m_traceEnqueue;
@@ -489,7 +545,9 @@ Queue<Item>::GetTypeId (void)
 
 template <typename Item>
 Queue<Item>::Queue ()
-  : NS_LOG_TEMPLATE_DEFINE ("Queue")
+  : NS_LOG_TEMPLATE_DEFINE ("Queue"),
+    m_ringHead (0),
+    m_ringSize (0)
 {
 }
 
@@ -511,16 +569,35 @@ bool
 Queue<Item>::DoEnqueue (ConstIterator pos, Ptr<Item> item, Iterator& ret)
 {
   NS_LOG_FUNCTION (this << item);
+  NS_ASSERT_MSG (m_ringSize == 0, "Positional and FIFO operations are mixed");
 
+  if (!CheckEnqueue (item))
+    {
+      return false;
+    }
+
+  ret = m_packets.insert (pos, item);
+  Enqueued (item);
+  return true;
+}
+
+template <typename Item>
+bool
+Queue<Item>::CheckEnqueue (Ptr<Item> item)
+{
   if (GetCurrentSize () + item > GetMaxSize ())
     {
       NS_LOG_LOGIC ("Queue full -- dropping pkt");
       DropBeforeEnqueue (item);
       return false;
     }
+  return true;
+}
 
-  ret = m_packets.insert (pos, item);
-
+template <typename Item>
+void
+Queue<Item>::Enqueued (Ptr<Item> item)
+{
   uint32_t size = item->GetSize ();
   m_nBytes += size;
   m_nTotalReceivedBytes += size;
@@ -530,8 +607,20 @@ Queue<Item>::DoEnqueue (ConstIterator pos, Ptr<Item> item, Iterator& ret)
 
   NS_LOG_LOGIC ("m_traceEnqueue (p)");
   m_traceEnqueue (item);
+}
 
-  return true;
+template <typename Item>
+void
+Queue<Item>::Dequeued (Ptr<Item> item)
+{
+  NS_ASSERT (m_nBytes.Get () >= item->GetSize ());
+  NS_ASSERT (m_nPackets.Get () > 0);
+
+  m_nBytes -= item->GetSize ();
+  m_nPackets--;
+
+  NS_LOG_LOGIC ("m_traceDequeue (p)");
+  m_traceDequeue (item);
 }
 
 template <typename Item>
@@ -551,14 +640,7 @@ Queue<Item>::DoDequeue (ConstIterator pos)
 
   if (item != 0)
     {
-      NS_ASSERT (m_nBytes.Get () >= item->GetSize ());
-      NS_ASSERT (m_nPackets.Get () > 0);
-
-      m_nBytes -= item->GetSize ();
-      m_nPackets--;
-
-      NS_LOG_LOGIC ("m_traceDequeue (p)");
-      m_traceDequeue (item);
+      Dequeued (item);
     }
   return item;
 }
@@ -580,21 +662,94 @@ Queue<Item>::DoRemove (ConstIterator pos)
 
   if (item != 0)
     {
-      NS_ASSERT (m_nBytes.Get () >= item->GetSize ());
-      NS_ASSERT (m_nPackets.Get () > 0);
+      // packets are first dequeued and then dropped
+      Dequeued (item);
+      DropAfterDequeue (item);
+    }
+  return item;
+}
 
-      m_nBytes -= item->GetSize ();
-      m_nPackets--;
+template <typename Item>
+bool
+Queue<Item>::DoEnqueueTail (Ptr<Item> item)
+{
+  NS_LOG_FUNCTION (this << item);
+  NS_ASSERT_MSG (m_packets.empty (), "Positional and FIFO operations are mixed");
 
-      // packets are first dequeued and then dropped
-      NS_LOG_LOGIC ("m_traceDequeue (p)");
-      m_traceDequeue (item);
+  if (!CheckEnqueue (item))
+    {
+      return false;
+    }
+
+  if (m_ringSize == m_ring.size ())
+    {
+      // Grow to the next power of two, unwrapping the items
+      std::vector<Ptr<Item> > ring (m_ring.empty () ? 16 : 2 * m_ring.size ());
+      for (uint32_t i = 0; i < m_ringSize; i++)
+        {
+          ring[i] = m_ring[(m_ringHead + i) & (m_ring.size () - 1)];
+        }
+      m_ring.swap (ring);
+      m_ringHead = 0;
+    }
+  m_ring[(m_ringHead + m_ringSize) & (m_ring.size () - 1)] = item;
+  m_ringSize++;
+
+  Enqueued (item);
+  return true;
+}
+
+template <typename Item>
+Ptr<Item>
+Queue<Item>::DoDequeueHead (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  if (m_ringSize == 0)
+    {
+      NS_LOG_LOGIC ("Queue empty");
+      return 0;
+    }
 
+  Ptr<Item> item = m_ring[m_ringHead];
+  m_ring[m_ringHead] = 0;
+  m_ringHead = (m_ringHead + 1) & (m_ring.size () - 1);
+  m_ringSize--;
+
+  Dequeued (item);
+  return item;
+}
+
+template <typename Item>
+Ptr<Item>
+Queue<Item>::DoRemoveHead (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  Ptr<Item> item = DoDequeueHead ();
+  if (item != 0)
+    {
+      // packets are first dequeued and then dropped
       DropAfterDequeue (item);
     }
   return item;
 }
 
+template <typename Item>
+Ptr<const Item>
+Queue<Item>::DoPeekHead (void) const
+{
+  NS_LOG_FUNCTION (this);
+
+  if (m_ringSize == 0)
+    {
+      NS_LOG_LOGIC ("Queue empty");
+      return 0;
+    }
+
+  return m_ring[m_ringHead];
+}
+
 template <typename Item>
 void
 Queue<Item>::Flush (void)
@@ -612,6 +767,9 @@ Queue<Item>::DoDispose (void)
 {
   NS_LOG_FUNCTION (this);
   m_packets.clear ();
+  m_ring.clear ();
+  m_ringHead = 0;
+  m_ringSize = 0;
   Object::DoDispose ();
 }
 
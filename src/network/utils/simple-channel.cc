@@ -60,21 +60,48 @@ SimpleChannel::Send (Ptr<Packet> p, uint16_t protocol,
   for (std::vector<Ptr<SimpleNetDevice> >::const_iterator i = m_devices.begin (); i != m_devices.end (); ++i)
     {
       Ptr<SimpleNetDevice> tmp = *i;
-      if (tmp == sender)
+      if (IsBlocked (sender, tmp))
         {
           continue;
         }
-      if (m_blackListedDevices.find (tmp) != m_blackListedDevices.end ())
+      Simulator::ScheduleWithContext (tmp->GetNode ()->GetId (), m_delay,
+                                      &SimpleNetDevice::Receive, tmp, p->Copy (), protocol, to, from);
+    }
+}
+
+void
+SimpleChannel::SendBatch (const std::vector<Ptr<Packet> > &packets, Ptr<SimpleNetDevice> sender)
+{
+  NS_LOG_FUNCTION (this << packets.size () << sender);
+  for (std::vector<Ptr<SimpleNetDevice> >::const_iterator i = m_devices.begin (); i != m_devices.end (); ++i)
+    {
+      Ptr<SimpleNetDevice> tmp = *i;
+      if (IsBlocked (sender, tmp))
         {
-          if (find (m_blackListedDevices[tmp].begin (), m_blackListedDevices[tmp].end (), sender) !=
-              m_blackListedDevices[tmp].end () )
-            {
-              continue;
-            }
+          continue;
+        }
+      std::vector<Ptr<Packet> > copies;
+      copies.reserve (packets.size ());
+      for (const Ptr<Packet> &p : packets)
+        {
+          copies.push_back (p->Copy ());
         }
       Simulator::ScheduleWithContext (tmp->GetNode ()->GetId (), m_delay,
-                                      &SimpleNetDevice::Receive, tmp, p->Copy (), protocol, to, from);
+                                      &SimpleNetDevice::ReceiveBatch, tmp, copies);
+    }
+}
+
+bool
+SimpleChannel::IsBlocked (Ptr<SimpleNetDevice> sender, Ptr<SimpleNetDevice> receiver)
+{
+  if (receiver == sender)
+    {
+      return true;
     }
+  std::map<Ptr<SimpleNetDevice>, std::vector<Ptr<SimpleNetDevice> > >::const_iterator it =
+    m_blackListedDevices.find (receiver);
+  return it != m_blackListedDevices.end ()
+         && find (it->second.begin (), it->second.end (), sender) != it->second.end ();
 }
 
 void
@@ -68,6 +68,17 @@ public:
   virtual void Send (Ptr<Packet> p, uint16_t protocol, Mac48Address to, Mac48Address from,
                      Ptr<SimpleNetDevice> sender);
 
+  /**
+   * A train of packets is sent by a net device.  A single receive event
+   * is scheduled for all net device connected to the channel other
+   * than the net device who sent the packets
+   *
+   * \param packets packets to be sent, tagged with their addresses
+   *        and protocol number
+   * \param sender netdevice who sent the packets
+   */
+  virtual void SendBatch (const std::vector<Ptr<Packet> > &packets, Ptr<SimpleNetDevice> sender);
+
   /**
    * Attached a net device to the channel.
    *
@@ -98,6 +109,13 @@ public:
   virtual Ptr<NetDevice> GetDevice (std::size_t i) const;
 
 private:
+  /**
+   * \param sender netdevice who sends a packet
+   * \param receiver netdevice connected to the channel
+   * \return whether the receiver must not receive the packets of the sender
+   */
+  bool IsBlocked (Ptr<SimpleNetDevice> sender, Ptr<SimpleNetDevice> receiver);
+
   Time m_delay; //!< The assigned speed-of-light delay of the channel
   std::vector<Ptr<SimpleNetDevice> > m_devices; //!< devices connected by the channel
   std::map<Ptr<SimpleNetDevice>, std::vector<Ptr<SimpleNetDevice> > > m_blackListedDevices; //!< devices blocked on a device
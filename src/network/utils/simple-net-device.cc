@@ -27,6 +27,7 @@
 #include "ns3/trace-source-accessor.h"
 #include "ns3/boolean.h"
 #include "ns3/string.h"
+#include "ns3/uinteger.h"
 #include "ns3/tag.h"
 #include "ns3/simulator.h"
 #include "ns3/queue.h"
@@ -210,6 +211,12 @@ SimpleNetDevice::GetTypeId (void)
                    DataRateValue (DataRate ("0b/s")),
                    MakeDataRateAccessor (&SimpleNetDevice::m_bps),
                    MakeDataRateChecker ())
+    .AddAttribute ("TxBatchSize",
+                   "The maximum number of queued packets transmitted as a single train, "
+                   "delivered by the channel in a single event. One disables the trains",
+                   UintegerValue (1),
+                   MakeUintegerAccessor (&SimpleNetDevice::m_txBatchSize),
+                   MakeUintegerChecker<uint32_t> (1))
     .AddTraceSource ("PhyRxDrop",
                      "Trace source indicating a packet has been dropped "
                      "by the device during reception",
@@ -270,6 +277,18 @@ SimpleNetDevice::Receive (Ptr<Packet> packet, uint16_t protocol,
     }
 }
 
+void
+SimpleNetDevice::ReceiveBatch (std::vector<Ptr<Packet> > packets)
+{
+  NS_LOG_FUNCTION (this << packets.size ());
+  for (Ptr<Packet> &packet : packets)
+    {
+      SimpleTag tag;
+      packet->RemovePacketTag (tag);
+      Receive (packet, tag.GetProto (), tag.GetDst (), tag.GetSrc ());
+    }
+}
+
 void 
 SimpleNetDevice::SetChannel (Ptr<SimpleChannel> channel)
 {
@@ -436,14 +455,7 @@ SimpleNetDevice::SendFrom (Ptr<Packet> p, const Address& source, const Address&
   Mac48Address to = Mac48Address::ConvertFrom (dest);
   Mac48Address from = Mac48Address::ConvertFrom (source);
 
-  SimpleTag tag;
-  tag.SetSrc (from);
-  tag.SetDst (to);
-  tag.SetProto (protocolNumber);
-
-  p->AddPacketTag (tag);
-
-  if (m_queue->Enqueue (p))
+  if (Enqueue (p, from, to, protocolNumber))
     {
       if (m_queue->GetNPackets () == 1 && !FinishTransmissionEvent.IsRunning ())
         {
@@ -455,6 +467,43 @@ SimpleNetDevice::SendFrom (Ptr<Packet> p, const Address& source, const Address&
   return false;
 }
 
+uint32_t
+SimpleNetDevice::SendBatch (const std::vector<Ptr<Packet> > &packets, const Address& dest, uint16_t protocolNumber)
+{
+  NS_LOG_FUNCTION (this << packets.size () << dest << protocolNumber);
+  Mac48Address to = Mac48Address::ConvertFrom (dest);
+
+  uint32_t sent = 0;
+  for (const Ptr<Packet> &p : packets)
+    {
+      if (p->GetSize () <= GetMtu () && Enqueue (p, m_address, to, protocolNumber))
+        {
+          sent++;
+        }
+    }
+  // start the transmission once the whole batch is queued, so that it can
+  // be transmitted as a single train
+  if (sent > 0 && !FinishTransmissionEvent.IsRunning ())
+    {
+      StartTransmission ();
+    }
+  return sent;
+}
+
+bool
+SimpleNetDevice::Enqueue (Ptr<Packet> p, Mac48Address from, Mac48Address to, uint16_t protocolNumber)
+{
+  NS_LOG_FUNCTION (this << p << from << to << protocolNumber);
+  SimpleTag tag;
+  tag.SetSrc (from);
+  tag.SetDst (to);
+  tag.SetProto (protocolNumber);
+
+  p->AddPacketTag (tag);
+
+  return m_queue->Enqueue (p);
+}
+
 void
 SimpleNetDevice::StartTransmission ()
 {
@@ -466,6 +515,27 @@ SimpleNetDevice::StartTransmission ()
                  "Tried to transmit a packet while another transmission was in progress");
   Ptr<Packet> packet = m_queue->Dequeue ();
 
+  if (m_txBatchSize > 1 && m_queue->GetNPackets () > 0)
+    {
+      // transmit the queued packets back to back, as a single train
+      std::vector<Ptr<Packet> > packets (1, packet);
+      while (packets.size () < m_txBatchSize && m_queue->GetNPackets () > 0)
+        {
+          packets.push_back (m_queue->Dequeue ());
+        }
+      Time txTime = Time (0);
+      if (m_bps > DataRate (0))
+        {
+          for (const Ptr<Packet> &p : packets)
+            {
+              txTime += m_bps.CalculateBytesTxTime (p->GetSize ());
+            }
+        }
+      FinishTransmissionEvent = Simulator::Schedule (txTime, &SimpleNetDevice::FinishBatchTransmission,
+                                                     this, packets);
+      return;
+    }
+
   /**
    * SimpleChannel will deliver the packet to the far end(s) of the link as soon as Send is called
    * (or after its fixed delay, if one is configured). So we have to handle the rate of the link here,
@@ -503,6 +573,17 @@ SimpleNetDevice::FinishTransmission (Ptr<Packet> packet)
   return;
 }
 
+void
+SimpleNetDevice::FinishBatchTransmission (std::vector<Ptr<Packet> > packets)
+{
+  NS_LOG_FUNCTION (this << packets.size ());
+
+  // the packets keep their tags, which the receivers remove
+  m_channel->SendBatch (packets, this);
+
+  StartTransmission ();
+}
+
 Ptr<Node> 
 SimpleNetDevice::GetNode (void) const
 {
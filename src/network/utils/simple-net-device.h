@@ -49,6 +49,12 @@ class ErrorModel;
  *
  * By default the device is in Broadcast mode, with infinite bandwidth.
  *
+ * The TxBatchSize attribute lets the device transmit the packets waiting in
+ * its queue as a single train: the channel delivers the whole train in one
+ * event when its last packet is received.  With an infinite bandwidth, the
+ * packets of a train share the same timestamp, and are delivered at the same
+ * time as they would be one by one.
+ *
  * \brief simple net device for simple things and testing
  */
 class SimpleNetDevice : public NetDevice
@@ -72,6 +78,15 @@ public:
    * \param from address packet was sent from
    */
   void Receive (Ptr<Packet> packet, uint16_t protocol, Mac48Address to, Mac48Address from);
+
+  /**
+   * Receive a train of packets from a connected SimpleChannel, each
+   * packet being forwarded as by Receive.
+   *
+   * \param packets Packets received on the channel, tagged with their
+   *        addresses and protocol number
+   */
+  void ReceiveBatch (std::vector<Ptr<Packet> > packets);
   
   /**
    * Attach a channel to this net device.  This will be the 
@@ -124,6 +139,7 @@ public:
   virtual bool IsPointToPoint (void) const;
   virtual bool IsBridge (void) const;
   virtual bool Send (Ptr<Packet> packet, const Address& dest, uint16_t protocolNumber);
+  virtual uint32_t SendBatch (const std::vector<Ptr<Packet> > &packets, const Address& dest, uint16_t protocolNumber);
   virtual bool SendFrom (Ptr<Packet> packet, const Address& source, const Address& dest, uint16_t protocolNumber);
   virtual Ptr<Node> GetNode (void) const;
   virtual void SetNode (Ptr<Node> node);
@@ -158,6 +174,16 @@ private:
    */
   TracedCallback<Ptr<const Packet> > m_phyRxDropTrace;
 
+  /**
+   * Tag a packet with its addresses and protocol number, and enqueue it.
+   * \param packet The packet
+   * \param from The source address
+   * \param to The destination address
+   * \param protocolNumber The protocol number
+   * \return whether the packet was enqueued
+   */
+  bool Enqueue (Ptr<Packet> packet, Mac48Address from, Mac48Address to, uint16_t protocolNumber);
+
   /**
    * The StartTransmission method is used internally to start the process
    * of sending a packet out on the channel, by scheduling the
@@ -173,6 +199,13 @@ private:
    */
   void FinishTransmission (Ptr<Packet> packet);
 
+  /**
+   * The FinishBatchTransmission method is used internally to finish the
+   * process of sending a train of packets out on the channel.
+   * \param packets The packets to send on the channel
+   */
+  void FinishBatchTransmission (std::vector<Ptr<Packet> > packets);
+
   bool m_linkUp; //!< Flag indicating whether or not the link is up
 
   /**
@@ -183,6 +216,7 @@ private:
 
   Ptr<Queue<Packet> > m_queue; //!< The Queue for outgoing packets.
   DataRate m_bps; //!< The device nominal Data rate. Zero means infinite
+  uint32_t m_txBatchSize; //!< Maximum number of packets transmitted as a train
   EventId FinishTransmissionEvent; //!< the Tx Complete event
 
   /**
@@ -106,6 +106,33 @@ PointToPointChannel::TransmitStart (
   return true;
 }
 
+bool
+PointToPointChannel::TransmitBatch (
+  const std::vector<Ptr<Packet> > &packets,
+  Ptr<PointToPointNetDevice> src,
+  Time txTime)
+{
+  NS_LOG_FUNCTION (this << packets.size () << src);
+
+  NS_ASSERT (m_link[0].m_state != INITIALIZING);
+  NS_ASSERT (m_link[1].m_state != INITIALIZING);
+
+  uint32_t wire = src == m_link[0].m_src ? 0 : 1;
+
+  std::vector<Ptr<Packet> > copies;
+  copies.reserve (packets.size ());
+  for (const Ptr<Packet> &p : packets)
+    {
+      copies.push_back (p->Copy ());
+      // Call the tx anim callback on the net device
+      m_txrxPointToPoint (p, src, m_link[wire].m_dst, txTime, txTime + m_delay);
+    }
+  Simulator::ScheduleWithContext (m_link[wire].m_dst->GetNode ()->GetId (),
+                                  txTime + m_delay, &PointToPointNetDevice::ReceiveBatch,
+                                  m_link[wire].m_dst, copies);
+  return true;
+}
+
 std::size_t
 PointToPointChannel::GetNDevices (void) const
 {
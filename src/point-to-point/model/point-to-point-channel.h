@@ -20,6 +20,7 @@
 #define POINT_TO_POINT_CHANNEL_H
 
 #include <list>
+#include <vector>
 #include "ns3/channel.h"
 #include "ns3/ptr.h"
 #include "ns3/nstime.h"
@@ -80,6 +81,17 @@ public:
    */
   virtual bool TransmitStart (Ptr<const Packet> p, Ptr<PointToPointNetDevice> src, Time txTime);
 
+  /**
+   * \brief Transmit a train of packets over this channel, received at once
+   * by the peer device when the last bit of the train has arrived
+   * \param packets Packets to transmit
+   * \param src Source PointToPointNetDevice
+   * \param txTime Transmit time of the whole train
+   * \returns true if successful (currently always true)
+   */
+  virtual bool TransmitBatch (const std::vector<Ptr<Packet> > &packets, Ptr<PointToPointNetDevice> src,
+                              Time txTime);
+
   /**
    * \brief Get number of devices on this channel
    * \returns number of devices on this channel
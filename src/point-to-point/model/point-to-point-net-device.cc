@@ -63,6 +63,13 @@ PointToPointNetDevice::GetTypeId (void)
                          TimeValue (Seconds (0.0)),
                          MakeTimeAccessor (&PointToPointNetDevice::m_tInterframeGap),
                          MakeTimeChecker ())
+          .AddAttribute ("TxBatchSize",
+                         "The maximum number of queued packets transmitted back to back "
+                         "as a single train, received at once by the peer device. "
+                         "One disables the trains",
+                         UintegerValue (1),
+                         MakeUintegerAccessor (&PointToPointNetDevice::m_txBatchSize),
+                         MakeUintegerChecker<uint32_t> (1))
 
           //
           // Transmit queueing discipline for the device which includes its own set
@@ -203,6 +210,7 @@ PointToPointNetDevice::DoDispose ()
   m_channel = 0;
   m_receiveErrorModel = 0;
   m_currentPkt = 0;
+  m_currentTrain.clear ();
   m_queue = 0;
   NetDevice::DoDispose ();
 }
@@ -238,6 +246,10 @@ PointToPointNetDevice::TransmitStart (Ptr<Packet> p)
   // NetDevice Ĵ״̬READY״̬һҪREADY״̬
   NS_ASSERT_MSG (m_txMachineState == READY, "Must be READY to transmit");
   m_txMachineState = BUSY;
+  if (m_txBatchSize > 1 && !m_queue->IsEmpty ())
+    {
+      return TransmitTrain (p);
+    }
   // pŵm_currentPkt֮
   m_currentPkt = p;
   // ݰڽϿʼʱtrace,ns3::Packet::TracedCallBack
@@ -260,6 +272,52 @@ PointToPointNetDevice::TransmitStart (Ptr<Packet> p)
   return result;
 }
 
+bool
+PointToPointNetDevice::TransmitTrain (Ptr<Packet> p)
+{
+  NS_LOG_FUNCTION (this << p);
+
+  m_currentPkt = p;
+  m_currentTrain.assign (1, p);
+  while (m_currentTrain.size () < m_txBatchSize)
+    {
+      Ptr<Packet> next = m_queue->Dequeue ();
+      if (next == 0)
+        {
+          break;
+        }
+      m_snifferTrace (next);
+      m_promiscSnifferTrace (next);
+      m_currentTrain.push_back (next);
+    }
+
+  //
+  // The packets are sent back to back, each followed by an interframe gap,
+  // so that the train ends when the last one would have.
+  //
+  Time txTime = Time (0);
+  for (const Ptr<Packet> &packet : m_currentTrain)
+    {
+      m_phyTxBeginTrace (packet);
+      txTime += m_bps.CalculateBytesTxTime (packet->GetSize ()) + m_tInterframeGap;
+    }
+  txTime -= m_tInterframeGap;
+  Time txCompleteTime = txTime + m_tInterframeGap;
+
+  NS_LOG_LOGIC ("Schedule TransmitCompleteEvent of " << m_currentTrain.size ()
+                << " packets in " << txCompleteTime.As (Time::S));
+  Simulator::Schedule (txCompleteTime, &PointToPointNetDevice::TransmitComplete, this);
+  bool result = m_channel->TransmitBatch (m_currentTrain, this, txTime);
+  if (result == false)
+    {
+      for (const Ptr<Packet> &packet : m_currentTrain)
+        {
+          m_phyTxDropTrace (packet);
+        }
+    }
+  return result;
+}
+
 void
 PointToPointNetDevice::TransmitComplete (void)
 {
@@ -276,7 +334,18 @@ PointToPointNetDevice::TransmitComplete (void)
 
   NS_ASSERT_MSG (m_currentPkt != 0, "PointToPointNetDevice::TransmitComplete(): m_currentPkt zero");
 
-  m_phyTxEndTrace (m_currentPkt);
+  if (m_currentTrain.empty ())
+    {
+      m_phyTxEndTrace (m_currentPkt);
+    }
+  else
+    {
+      for (const Ptr<Packet> &packet : m_currentTrain)
+        {
+          m_phyTxEndTrace (packet);
+        }
+      m_currentTrain.clear ();
+    }
   m_currentPkt = 0;
 
   Ptr<Packet> p = m_queue->Dequeue ();
@@ -377,6 +446,16 @@ PointToPointNetDevice::Receive (Ptr<Packet> packet)
     }
 }
 
+void
+PointToPointNetDevice::ReceiveBatch (std::vector<Ptr<Packet> > packets)
+{
+  NS_LOG_FUNCTION (this << packets.size ());
+  for (Ptr<Packet> &packet : packets)
+    {
+      Receive (packet);
+    }
+}
+
 Ptr<Queue<Packet>>
 PointToPointNetDevice::GetQueue (void) const
 {
@@ -552,6 +631,50 @@ PointToPointNetDevice::Send (Ptr<Packet> packet, const Address &dest, uint16_t p
   return false;
 }
 
+uint32_t
+PointToPointNetDevice::SendBatch (const std::vector<Ptr<Packet> > &packets, const Address &dest,
+                                  uint16_t protocolNumber)
+{
+  NS_LOG_FUNCTION (this << packets.size () << dest << protocolNumber);
+
+  if (IsLinkUp () == false)
+    {
+      for (const Ptr<Packet> &packet : packets)
+        {
+          m_macTxDropTrace (packet);
+        }
+      return 0;
+    }
+
+  //
+  // Enqueue the whole batch before starting the transmission, so that the
+  // packets can be transmitted as a single train.
+  //
+  uint32_t sent = 0;
+  for (const Ptr<Packet> &packet : packets)
+    {
+      AddHeader (packet, protocolNumber);
+      m_macTxTrace (packet);
+      if (m_queue->Enqueue (packet))
+        {
+          sent++;
+        }
+      else
+        {
+          m_macTxDropTrace (packet);
+        }
+    }
+
+  if (sent > 0 && m_txMachineState == READY)
+    {
+      Ptr<Packet> packet = m_queue->Dequeue ();
+      m_snifferTrace (packet);
+      m_promiscSnifferTrace (packet);
+      TransmitStart (packet);
+    }
+  return sent;
+}
+
 bool
 PointToPointNetDevice::SendFrom (Ptr<Packet> packet, const Address &source, const Address &dest,
                                  uint16_t protocolNumber)
@@ -58,6 +58,14 @@ class ErrorModel;
  * Key parameters or objects that can be specified for this device 
  * include a queue, data rate, and interframe transmission gap (the 
  * propagation delay is set in the PointToPointChannel).
+ *
+ * The TxBatchSize attribute lets the device transmit the packets waiting
+ * in its queue back to back, as a single train: a single event ends the
+ * transmission of the train, and the peer device receives the whole train
+ * in a single event, when the last bit of its last packet arrives.  The
+ * packets of a train are thus delivered together, as by the interrupt
+ * coalescing of real network cards, instead of one transmission time
+ * apart.
  */
 class PointToPointNetDevice : public NetDevice
 {
@@ -149,6 +157,14 @@ public:
    */
   void Receive (Ptr<Packet> p);
 
+  /**
+   * Receive a train of packets from a connected PointToPointChannel, each
+   * packet being forwarded as by Receive.
+   *
+   * \param packets The received packets.
+   */
+  void ReceiveBatch (std::vector<Ptr<Packet> > packets);
+
   // The remaining methods are documented in ns3::NetDevice*
 
   virtual void SetIfIndex (const uint32_t index);
@@ -176,6 +192,7 @@ public:
   virtual bool IsBridge (void) const;
 
   virtual bool Send (Ptr<Packet> packet, const Address &dest, uint16_t protocolNumber);
+  virtual uint32_t SendBatch (const std::vector<Ptr<Packet> > &packets, const Address &dest, uint16_t protocolNumber);
   virtual bool SendFrom (Ptr<Packet> packet, const Address& source, const Address& dest, uint16_t protocolNumber);
 
   virtual Ptr<Node> GetNode (void) const;
@@ -267,6 +284,19 @@ private:
    */
   bool TransmitStart (Ptr<Packet> p);
 
+  /**
+   * Start Sending a Train of Packets Down the Wire.
+   *
+   * Called by TransmitStart when packets are waiting in the queue and
+   * trains are enabled: up to TxBatchSize packets, starting with the given
+   * one, are sent to the channel at once.
+   *
+   * \see PointToPointChannel::TransmitBatch ()
+   * \param p the first packet of the train
+   * \returns true if success, false on failure
+   */
+  bool TransmitTrain (Ptr<Packet> p);
+
   /**
    * Stop Sending a Packet Down the Wire and Begin the Interframe Gap.
    *
@@ -456,6 +486,8 @@ private:
   uint32_t m_mtu;
 
   Ptr<Packet> m_currentPkt; //!< Current packet processed
+  uint32_t m_txBatchSize;   //!< Maximum number of packets transmitted as a train
+  std::vector<Ptr<Packet> > m_currentTrain; //!< Current train of packets processed, if any
 
   /**
    * \brief PPP to Ethernet protocol number mapping
@@ -73,4 +73,26 @@ PointToPointRemoteChannel::TransmitStart (
   return true;
 }
 
+bool
+PointToPointRemoteChannel::TransmitBatch (
+  const std::vector<Ptr<Packet> > &packets,
+  Ptr<PointToPointNetDevice> src,
+  Time txTime)
+{
+  NS_LOG_FUNCTION (this << packets.size () << src);
+
+  IsInitialized ();
+
+  uint32_t wire = src == GetSource (0) ? 0 : 1;
+  Ptr<PointToPointNetDevice> dst = GetDestination (wire);
+
+  // The whole train is received when its last bit arrives
+  Time rxTime = Simulator::Now () + txTime + GetDelay ();
+  for (const Ptr<Packet> &p : packets)
+    {
+      MpiInterface::SendPacket (p->Copy (), rxTime, dst->GetNode ()->GetId (), dst->GetIfIndex ());
+    }
+  return true;
+}
+
 } // namespace ns3
@@ -68,6 +68,17 @@ public:
    */
   virtual bool TransmitStart (Ptr<const Packet> p, Ptr<PointToPointNetDevice> src,
                               Time txTime);
+
+  /**
+   * \brief Transmit a train of packets, each sent to the remote process
+   *
+   * \param packets Packets to transmit
+   * \param src Source PointToPointNetDevice
+   * \param txTime Transmit time of the whole train
+   * \returns true if successful (currently always true)
+   */
+  virtual bool TransmitBatch (const std::vector<Ptr<Packet> > &packets, Ptr<PointToPointNetDevice> src,
+                              Time txTime);
 };
 
 } // namespace ns3
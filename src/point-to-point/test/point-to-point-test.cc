@@ -24,8 +24,11 @@
 #include "ns3/point-to-point-net-device.h"
 #include "ns3/point-to-point-channel.h"
 #include "ns3/net-device-queue-interface.h"
+#include "ns3/uinteger.h"
 
+#include <algorithm>
 #include <string>
+#include <vector>
 
 using namespace ns3;
 
@@ -130,6 +133,114 @@ PointToPointTest::DoRun (void)
   Simulator::Destroy ();
 }
 
+/**
+ * \brief Test class for the trains of the PointToPoint model
+ *
+ * It sends a batch of packets from one NetDevice to another, which
+ * receives them in trains.
+ */
+class PointToPointBatchTest : public TestCase
+{
+public:
+  /**
+   * \brief Create the test
+   */
+  PointToPointBatchTest ();
+
+  /**
+   * \brief Run the test
+   */
+  virtual void DoRun (void);
+
+private:
+  std::vector<uint64_t> m_uids; //!< uids of the received packets
+  std::vector<Time> m_times;    //!< receive times of the packets
+
+  /**
+   * \brief Send a batch of packets to the device specified
+   *
+   * \param device NetDevice to send to.
+   * \param packets The packets.
+   */
+  void SendBatch (Ptr<PointToPointNetDevice> device, std::vector<Ptr<Packet> > packets);
+  /**
+   * \brief Callback function which records the received packets
+   *
+   * \param dev The receiving device.
+   * \param pkt The received packet.
+   * \param mode The protocol mode used.
+   * \param sender The sender address.
+   *
+   * \return A boolean indicating packet handled properly.
+   */
+  bool RxPacket (Ptr<NetDevice> dev, Ptr<const Packet> pkt, uint16_t mode, const Address &sender);
+};
+
+PointToPointBatchTest::PointToPointBatchTest ()
+  : TestCase ("PointToPoint trains")
+{
+}
+
+void
+PointToPointBatchTest::SendBatch (Ptr<PointToPointNetDevice> device, std::vector<Ptr<Packet> > packets)
+{
+  uint32_t sent = device->SendBatch (packets, device->GetBroadcast (), 0x800);
+  NS_TEST_EXPECT_MSG_EQ (sent, packets.size (), "Packets dropped");
+}
+
+bool
+PointToPointBatchTest::RxPacket (Ptr<NetDevice> dev, Ptr<const Packet> pkt, uint16_t mode, const Address &sender)
+{
+  m_uids.push_back (pkt->GetUid ());
+  m_times.push_back (Simulator::Now ());
+  return true;
+}
+
+void
+PointToPointBatchTest::DoRun (void)
+{
+  Ptr<Node> a = CreateObject<Node> ();
+  Ptr<Node> b = CreateObject<Node> ();
+  Ptr<PointToPointNetDevice> devA = CreateObject<PointToPointNetDevice> ();
+  Ptr<PointToPointNetDevice> devB = CreateObject<PointToPointNetDevice> ();
+  Ptr<PointToPointChannel> channel = CreateObject<PointToPointChannel> ();
+
+  devA->Attach (channel);
+  devA->SetAddress (Mac48Address::Allocate ());
+  devA->SetQueue (CreateObject<DropTailQueue<Packet> > ());
+  devA->SetDataRate (DataRate ("8Mbps"));
+  devA->SetAttribute ("TxBatchSize", UintegerValue (4));
+  devB->Attach (channel);
+  devB->SetAddress (Mac48Address::Allocate ());
+  devB->SetQueue (CreateObject<DropTailQueue<Packet> > ());
+
+  a->AddDevice (devA);
+  b->AddDevice (devB);
+
+  devB->SetReceiveCallback (MakeCallback (&PointToPointBatchTest::RxPacket, this));
+
+  // 998 bytes and the PPP header take 1ms at 8Mbps
+  std::vector<Ptr<Packet> > packets;
+  for (uint32_t i = 0; i < 10; i++)
+    {
+      packets.push_back (Create<Packet> (998));
+    }
+  Simulator::Schedule (Seconds (1.0), &PointToPointBatchTest::SendBatch, this, devA, packets);
+
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_uids.size (), packets.size (), "Packets not received");
+  for (uint32_t i = 0; i < packets.size (); i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (m_uids[i], packets[i]->GetUid (), "Packets reordered");
+      // The trains of 4, 4 and 2 packets are received when their last packet is
+      uint32_t last = std::min<uint32_t> (i / 4 * 4 + 4, packets.size ());
+      NS_TEST_EXPECT_MSG_EQ (m_times[i], Seconds (1.0) + MilliSeconds (last), "Wrong receive time");
+    }
+
+  Simulator::Destroy ();
+}
+
 /**
  * \brief TestSuite for PointToPoint module
  */
@@ -146,6 +257,7 @@ PointToPointTestSuite::PointToPointTestSuite ()
   : TestSuite ("devices-point-to-point", UNIT)
 {
   AddTestCase (new PointToPointTest, TestCase::QUICK);
+  AddTestCase (new PointToPointBatchTest, TestCase::QUICK);
 }
 
 static PointToPointTestSuite g_pointToPointTestSuite; //!< The testsuite
@@ -269,6 +269,11 @@ TypeId QueueDisc::GetTypeId (void)
                    MakeUintegerAccessor (&QueueDisc::SetQuota,
                                          &QueueDisc::GetQuota),
                    MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("BatchSize", "The maximum number of packets dequeued and sent to the device "
+                   "at once in a qdisc run (with NetDevice::SendBatch). One disables the batches",
+                   UintegerValue (1),
+                   MakeUintegerAccessor (&QueueDisc::m_batchSize),
+                   MakeUintegerChecker<uint32_t> (1))
     .AddAttribute ("InternalQueueList", "The list of internal queues.",
                    ObjectVectorValue (),
                    MakeObjectVectorAccessor (&QueueDisc::m_queues),
@@ -387,6 +392,7 @@ QueueDisc::DoDispose (void)
   m_classes.clear ();
   m_devQueueIface = 0;
   m_send = nullptr;
+  m_sendBatch = nullptr;
   m_requeued = 0;
   m_internalQueueDbeFunctor = nullptr;
   m_internalQueueDadFunctor = nullptr;
@@ -561,6 +567,20 @@ QueueDisc::GetSendCallback (void) const
   return m_send;
 }
 
+void
+QueueDisc::SetSendBatchCallback (SendBatchCallback func)
+{
+  NS_LOG_FUNCTION (this);
+  m_sendBatch = func;
+}
+
+QueueDisc::SendBatchCallback
+QueueDisc::GetSendBatchCallback (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_sendBatch;
+}
+
 void
 QueueDisc::SetQuota (const uint32_t quota)
 {
@@ -1001,9 +1021,56 @@ QueueDisc::Restart (void)
       return false;
     }
 
+  if (m_batchSize > 1 && m_sendBatch)
+    {
+      std::vector<Ptr<QueueDiscItem> > items = BulkDequeue (item);
+      if (items.size () > 1)
+        {
+          return TransmitBatch (items);
+        }
+    }
+
   return Transmit (item);
 }
 
+std::vector<Ptr<QueueDiscItem> >
+QueueDisc::BulkDequeue (Ptr<QueueDiscItem> item)
+{
+  NS_LOG_FUNCTION (this << item);
+
+  std::vector<Ptr<QueueDiscItem> > items (1, item);
+  Ptr<NetDeviceQueue> txq;
+  if (m_devQueueIface)
+    {
+      txq = m_devQueueIface->GetTxQueue (item->GetTxQueueIndex ());
+    }
+  uint32_t nBytes = item->GetSize ();
+
+  while (items.size () < m_batchSize)
+    {
+      // stop before the packets already in the batch would stop the device queue
+      if (txq && txq->WouldStop (items.size (), nBytes))
+        {
+          break;
+        }
+      // the packet dequeued by DequeuePacket was not requeued, so that the packet
+      // peeked now is a new packet, whose header is still to be added
+      NS_ASSERT (!m_requeued);
+      Ptr<const QueueDiscItem> next = Peek ();
+      if (!next || next->GetTxQueueIndex () != item->GetTxQueueIndex ()
+          || next->GetAddress () != item->GetAddress () || next->GetProtocol () != item->GetProtocol ())
+        {
+          break;
+        }
+      Ptr<QueueDiscItem> nextItem = Dequeue ();
+      nextItem->AddHeader ();
+      nBytes += nextItem->GetSize ();
+      items.push_back (nextItem);
+    }
+  NS_LOG_LOGIC ("Dequeued a batch of " << items.size () << " packets");
+  return items;
+}
+
 Ptr<QueueDiscItem>
 QueueDisc::DequeuePacket ()
 {
@@ -1025,9 +1092,11 @@ QueueDisc::DequeuePacket ()
               {
                 // If the packet was requeued because a peek operation was requested
                 // we need to explicitly call PacketDequeued to update statistics
-                // about dequeued packets and fire the dequeue trace.
+                // about dequeued packets and fire the dequeue trace. Such a packet
+                // (e.g., peeked by BulkDequeue) has no header yet.
                 m_peeked = false;
                 PacketDequeued (item);
+                item->AddHeader ();
               }
           }
     }
@@ -1067,6 +1136,37 @@ QueueDisc::Requeue (Ptr<QueueDiscItem> item)
   m_traceRequeue (item);
 }
 
+bool
+QueueDisc::TransmitBatch (const std::vector<Ptr<QueueDiscItem> > &items)
+{
+  NS_LOG_FUNCTION (this << items.size ());
+
+  // BulkDequeue does not build batches for stopped device queues
+  uint32_t txq = items.front ()->GetTxQueueIndex ();
+  NS_ASSERT (!m_devQueueIface || !m_devQueueIface->GetTxQueue (txq)->IsStopped ());
+
+  // a single queue device makes no use of the priority tag
+  // a device that does not install a device queue interface likely makes no use of it as well
+  if (!m_devQueueIface || m_devQueueIface->GetNTxQueues () == 1)
+    {
+      for (const Ptr<QueueDiscItem> &item : items)
+        {
+          SocketPriorityTag priorityTag;
+          item->GetPacket ()->RemovePacketTag (priorityTag);
+        }
+    }
+  m_sendBatch (items);
+
+  // as in Transmit, the packets are assumed to be consumed by the netdevice
+  if (GetNPackets () == 0 ||
+      (m_devQueueIface && m_devQueueIface->GetTxQueue (txq)->IsStopped ()))
+    {
+      return false;
+    }
+
+  return true;
+}
+
 bool
 QueueDisc::Transmit (Ptr<QueueDiscItem> item)
 {
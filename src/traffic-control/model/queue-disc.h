@@ -376,6 +376,24 @@ public:
    */
   SendCallback GetSendCallback (void) const;
 
+  /// Callback invoked to send a batch of packets to the receiving object when Run is called
+  typedef std::function<void (const std::vector<Ptr<QueueDiscItem> > &)> SendBatchCallback;
+
+  /**
+   * \param func the callback to send a batch of packets to the receiving object.
+   *
+   * Set the callback used by the Run method to send the packets it dequeues
+   * at once when the BatchSize attribute is greater than one.  The packets of
+   * a batch share the transmission queue, the destination address and the
+   * protocol number.
+   */
+  void SetSendBatchCallback (SendBatchCallback func);
+
+  /**
+   * \return the callback to send a batch of packets to the receiving object.
+   */
+  SendBatchCallback GetSendBatchCallback (void) const;
+
   /**
    * \brief Set the maximum number of dequeue operations following a packet enqueue
    * \param quota the maximum number of dequeue operations following a packet enqueue.
@@ -638,10 +656,22 @@ private:
   /**
    * Modelled after the Linux function qdisc_restart (net/sched/sch_generic.c)
    * Dequeue a packet (by calling DequeuePacket) and send it to the device (by calling Transmit).
+   * If batches are enabled, the packets following it are dequeued as well (by calling
+   * BulkDequeue) and sent to the device at once (by calling TransmitBatch).
    * \return true if a packet is successfully sent to the device.
    */
   bool Restart (void);
 
+  /**
+   * Modelled after the Linux function try_bulk_dequeue_skb (net/sched/sch_generic.c)
+   * Dequeue the packets following a dequeued packet, as long as they share its
+   * transmission queue, destination address and protocol number, the batch does
+   * not exceed BatchSize packets and the device transmission queue has room for them.
+   * \param item the packet dequeued by DequeuePacket
+   * \return the batch of packets, starting with the given packet
+   */
+  std::vector<Ptr<QueueDiscItem> > BulkDequeue (Ptr<QueueDiscItem> item);
+
   /**
    * Modelled after the Linux function dequeue_skb (net/sched/sch_generic.c)
    * \return the requeued packet, if any, or the packet dequeued by the queue disc, otherwise.
@@ -664,6 +694,13 @@ private:
    */
   bool Transmit (Ptr<QueueDiscItem> item);
 
+  /**
+   * Sends a batch of packets returned by BulkDequeue to the device.
+   * \param items the packets to transmit
+   * \return true if the device queue is not stopped and the queue disc is not empty
+   */
+  bool TransmitBatch (const std::vector<Ptr<QueueDiscItem> > &items);
+
   /**
    *  \brief Perform the actions required when the queue disc is notified of
    *         a packet enqueue
@@ -693,6 +730,8 @@ private:
   uint32_t m_quota;                 //!< Maximum number of packets dequeued in a qdisc run
   Ptr<NetDeviceQueueInterface> m_devQueueIface;   //!< NetDevice queue interface
   SendCallback m_send;              //!< Callback used to send a packet to the receiving object
+  uint32_t m_batchSize;             //!< Maximum number of packets sent to the receiving object at once
+  SendBatchCallback m_sendBatch;    //!< Callback used to send a batch of packets to the receiving object
   bool m_running;                   //!< The queue disc is performing multiple dequeue operations
   Ptr<QueueDiscItem> m_requeued;    //!< The last packet that failed to be transmitted
   bool m_peeked;                    //!< A packet was dequeued because Peek was called
@@ -199,6 +199,17 @@ TrafficControlLayer::ScanDevices (void)
               q->SetNetDeviceQueueInterface (ndqi);
               q->SetSendCallback ([dev] (Ptr<QueueDiscItem> item)
                                   { dev->Send (item->GetPacket (), item->GetAddress (), item->GetProtocol ()); });
+              q->SetSendBatchCallback ([dev] (const std::vector<Ptr<QueueDiscItem> > &items)
+                                       {
+                                         std::vector<Ptr<Packet> > packets;
+                                         packets.reserve (items.size ());
+                                         for (const Ptr<QueueDiscItem> &item : items)
+                                           {
+                                             packets.push_back (item->GetPacket ());
+                                           }
+                                         dev->SendBatch (packets, items.front ()->GetAddress (),
+                                                         items.front ()->GetProtocol ());
+                                       });
             }
         }
     }
@@ -263,6 +274,7 @@ TrafficControlLayer::DeleteRootQueueDiscOnDevice (Ptr<NetDevice> device)
     {
       q->SetNetDeviceQueueInterface (nullptr);
       q->SetSendCallback (nullptr);
+      q->SetSendBatchCallback (nullptr);
     }
   ndi->second.m_queueDiscsToWake.clear ();
 
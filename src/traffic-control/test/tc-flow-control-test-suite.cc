@@ -21,6 +21,7 @@
 
 #include <algorithm>
 #include <string>
+#include <vector>
 
 #include "ns3/test.h"
 #include "ns3/uinteger.h"
@@ -360,6 +361,151 @@ TcFlowControlTestCase::DoRun (void)
   Simulator::Destroy ();
 }
 
+/**
+ * \ingroup traffic-control-test
+ * \ingroup tests
+ *
+ * \brief Traffic Control Batch Test Case
+ *
+ * Check that the batches of the queue disc respect the flow control of the
+ * device and do not change the transmissions, and that the trains of the
+ * device are delivered at once.
+ */
+class TcBatchTestCase : public TestCase
+{
+public:
+  TcBatchTestCase ();
+  virtual ~TcBatchTestCase ();
+private:
+  virtual void DoRun (void);
+  /**
+   * Send packets through a queue disc and a SimpleNetDevice
+   * \param qdiscBatchSize the BatchSize of the queue disc
+   * \param txBatchSize the TxBatchSize of the device
+   * \param rxTimes the receive times of the packets
+   * \return the number of packets dropped by the device queue
+   */
+  uint32_t Transmit (uint32_t qdiscBatchSize, uint32_t txBatchSize, std::vector<Time> *rxTimes);
+  /**
+   * Record the receive time of a packet
+   * \param rxTimes the receive times
+   * \param dev the receiving device
+   * \param p the packet
+   * \param protocol the protocol number
+   * \param from the sender address
+   * \return true
+   */
+  static bool Receive (std::vector<Time> *rxTimes, Ptr<NetDevice> dev, Ptr<const Packet> p,
+                       uint16_t protocol, const Address &from);
+  /**
+   * Count a dropped packet
+   * \param drops the number of drops
+   * \param p the packet
+   */
+  static void Drop (uint32_t *drops, Ptr<const Packet> p);
+
+  static const uint32_t TOTAL_PACKETS = 20; //!< the number of packets to transmit
+};
+
+TcBatchTestCase::TcBatchTestCase ()
+  : TestCase ("Test the batches of the queue disc and the trains of the device")
+{
+}
+
+TcBatchTestCase::~TcBatchTestCase ()
+{
+}
+
+bool
+TcBatchTestCase::Receive (std::vector<Time> *rxTimes, Ptr<NetDevice> dev, Ptr<const Packet> p,
+                          uint16_t protocol, const Address &from)
+{
+  rxTimes->push_back (Simulator::Now ());
+  return true;
+}
+
+void
+TcBatchTestCase::Drop (uint32_t *drops, Ptr<const Packet> p)
+{
+  (*drops)++;
+}
+
+uint32_t
+TcBatchTestCase::Transmit (uint32_t qdiscBatchSize, uint32_t txBatchSize, std::vector<Time> *rxTimes)
+{
+  NodeContainer n;
+  n.Create (2);
+
+  n.Get (0)->AggregateObject (CreateObject<TrafficControlLayer> ());
+
+  SimpleNetDeviceHelper simple;
+  NetDeviceContainer rxDevC = simple.Install (n.Get (1));
+  // the test items are addressed to the null address
+  rxDevC.Get (0)->SetAddress (Mac48Address ());
+  rxDevC.Get (0)->SetReceiveCallback (MakeBoundCallback (&TcBatchTestCase::Receive, rxTimes));
+
+  simple.SetDeviceAttribute ("DataRate", DataRateValue (DataRate ("1Mb/s")));
+  simple.SetDeviceAttribute ("TxBatchSize", UintegerValue (txBatchSize));
+  simple.SetQueue ("ns3::DropTailQueue", "MaxSize", StringValue ("5p"));
+  Ptr<NetDevice> txDev = simple.Install (n.Get (0), DynamicCast<SimpleChannel> (rxDevC.Get (0)->GetChannel ())).Get (0);
+  txDev->SetMtu (2500);
+
+  uint32_t drops = 0;
+  PointerValue ptr;
+  txDev->GetAttribute ("TxQueue", ptr);
+  ptr.Get<Queue<Packet> > ()->TraceConnectWithoutContext ("Drop", MakeBoundCallback (&TcBatchTestCase::Drop, &drops));
+
+  TrafficControlHelper tch = TrafficControlHelper::Default ();
+  tch.Install (txDev);
+  Ptr<TrafficControlLayer> tc = n.Get (0)->GetObject<TrafficControlLayer> ();
+  tc->GetRootQueueDiscOnDevice (txDev)->SetAttribute ("BatchSize", UintegerValue (qdiscBatchSize));
+
+  for (uint32_t i = 0; i < TOTAL_PACKETS; i++)
+    {
+      Simulator::Schedule (Seconds (0), &TrafficControlLayer::Send, tc, txDev,
+                           Create<QueueDiscTestItem> (Create<Packet> (1000)));
+    }
+  Simulator::Run ();
+  Simulator::Destroy ();
+  return drops;
+}
+
+void
+TcBatchTestCase::DoRun (void)
+{
+  std::vector<Time> rxTimes;
+  NS_TEST_EXPECT_MSG_EQ (Transmit (1, 1, &rxTimes), 0, "The device queue must not drop packets");
+  NS_TEST_ASSERT_MSG_EQ (rxTimes.size (), TOTAL_PACKETS, "All the packets must be received");
+  // The transmission of each packet takes 1000B/1Mbps = 8ms
+  for (uint32_t i = 0; i < TOTAL_PACKETS; i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (rxTimes[i], MilliSeconds (8 * (i + 1)), "Wrong receive time");
+    }
+
+  // The queue disc batches are bounded by the room in the device queue and
+  // do not change the transmissions
+  std::vector<Time> batchRxTimes;
+  NS_TEST_EXPECT_MSG_EQ (Transmit (4, 1, &batchRxTimes), 0, "The device queue must not drop packets");
+  NS_TEST_EXPECT_MSG_EQ ((batchRxTimes == rxTimes), true, "The batches must not change the transmissions");
+
+  // The trains of the device are received at once, when their last packet is
+  // received, and the queue disc refills the device queue with batches
+  std::vector<Time> trainRxTimes;
+  NS_TEST_EXPECT_MSG_EQ (Transmit (4, 4, &trainRxTimes), 0, "The device queue must not drop packets");
+  NS_TEST_ASSERT_MSG_EQ (trainRxTimes.size (), TOTAL_PACKETS, "All the packets must be received");
+  uint32_t trains = 0;
+  for (uint32_t i = 0; i < TOTAL_PACKETS; i++)
+    {
+      if (i + 1 == TOTAL_PACKETS || trainRxTimes[i + 1] != trainRxTimes[i])
+        {
+          trains++;
+          // a train is received when its last packet would have been received
+          NS_TEST_EXPECT_MSG_EQ (trainRxTimes[i], rxTimes[i], "Wrong receive time of train " << trains);
+        }
+    }
+  NS_TEST_EXPECT_MSG_EQ (trains, 6, "The packets after the first one must be received in trains of 4");
+}
+
 /**
  * \ingroup traffic-control-test
  * \ingroup tests
@@ -385,5 +531,6 @@ public:
     // TODO: Right now, this test only works for 5000B and 10 packets (it's hard coded). Should
     // also be made parametric.
     AddTestCase (new TcFlowControlTestCase (QueueSizeUnit::BYTES, 5000, 10), TestCase::QUICK);
+    AddTestCase (new TcBatchTestCase (), TestCase::QUICK);
   }
 } g_tcFlowControlTestSuite; ///< the test suite
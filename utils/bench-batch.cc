@@ -0,0 +1,117 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program benchmarks the batches of packets moved by the queue discs
+// and the trains of packets transmitted by the point-to-point devices:
+// saturated TCP bulk-send flows cross point-to-point links, each flow
+// on its own link, with the given queue disc BatchSize and device
+// TxBatchSize.  The batch sizes of 1 give the per-packet path.
+// Sample usage:  ./ns3 run 'bench-batch --flows=20 --batch=1'
+//                ./ns3 run 'bench-batch --flows=20 --batch=8'
+
+#include "ns3/applications-module.h"
+#include "ns3/command-line.h"
+#include "ns3/config.h"
+#include "ns3/internet-module.h"
+#include "ns3/network-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/traffic-control-module.h"
+
+#include <iostream>
+
+using namespace ns3;
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t flows = 10;
+  uint32_t batch = 1;
+  double stop = 5;
+  std::string rate = "1Gbps";
+  std::string delay = "1ms";
+
+  CommandLine cmd (__FILE__);
+  cmd.Usage ("Benchmark the batches of the queue discs and the trains of the\n"
+             "point-to-point devices with saturated TCP bulk-send flows.");
+  cmd.AddValue ("flows", "number of flows, each on its own link", flows);
+  cmd.AddValue ("batch", "queue disc BatchSize and device TxBatchSize", batch);
+  cmd.AddValue ("stop", "simulated time (s)", stop);
+  cmd.AddValue ("rate", "data rate of the links", rate);
+  cmd.AddValue ("delay", "delay of the links", delay);
+  cmd.Parse (argc, argv);
+
+  Config::SetDefault ("ns3::QueueDisc::BatchSize", UintegerValue (batch));
+  Config::SetDefault ("ns3::PointToPointNetDevice::TxBatchSize", UintegerValue (batch));
+  Config::SetDefault ("ns3::TcpSocket::SndBufSize", UintegerValue (1 << 22));
+  Config::SetDefault ("ns3::TcpSocket::RcvBufSize", UintegerValue (1 << 22));
+  Config::SetDefault ("ns3::TcpSocket::SegmentSize", UintegerValue (1448));
+
+  SystemWallClockMs time;
+  time.Start ();
+
+  NodeContainer senders;
+  NodeContainer receivers;
+  senders.Create (flows);
+  receivers.Create (flows);
+  InternetStackHelper stack;
+  stack.Install (senders);
+  stack.Install (receivers);
+
+  PointToPointHelper p2p;
+  p2p.SetDeviceAttribute ("DataRate", StringValue (rate));
+  p2p.SetChannelAttribute ("Delay", StringValue (delay));
+  Ipv4AddressHelper address ("10.0.0.0", "255.255.255.252");
+  ApplicationContainer sinks;
+  uint16_t port = 9;
+  for (uint32_t i = 0; i < flows; i++)
+    {
+      NetDeviceContainer devices = p2p.Install (senders.Get (i), receivers.Get (i));
+      Ipv4InterfaceContainer interfaces = address.Assign (devices);
+      address.NewNetwork ();
+
+      BulkSendHelper source ("ns3::TcpSocketFactory",
+                             InetSocketAddress (interfaces.GetAddress (1), port));
+      source.SetAttribute ("MaxBytes", UintegerValue (0));
+      source.Install (senders.Get (i)).Start (Seconds (0.01 * (i % 10)));
+      PacketSinkHelper sink ("ns3::TcpSocketFactory",
+                             InetSocketAddress (Ipv4Address::GetAny (), port));
+      sinks.Add (sink.Install (receivers.Get (i)));
+    }
+  int64_t setup = time.End ();
+
+  time.Start ();
+  Simulator::Stop (Seconds (stop));
+  Simulator::Run ();
+  int64_t ms = std::max<int64_t> (time.End (), 1);
+  uint64_t events = Simulator::GetEventCount ();
+
+  uint64_t bytes = 0;
+  for (uint32_t i = 0; i < sinks.GetN (); i++)
+    {
+      bytes += DynamicCast<PacketSink> (sinks.Get (i))->GetTotalRx ();
+    }
+  Simulator::Destroy ();
+
+  std::cout << cmd.GetName () << ": flows=" << flows << " batch=" << batch
+            << " rate=" << rate << std::endl;
+  std::cout << "  setup:      " << setup << " ms" << std::endl;
+  std::cout << "  run:        " << ms << " ms" << std::endl;
+  std::cout << "  events:     " << events << std::endl;
+  std::cout << "  goodput:    " << bytes * 8 / stop / flows / 1e6 << " Mbps per flow" << std::endl;
+  std::cout << "  rate:       " << (bytes / 1448 * 1000.0 / ms) << " segments per second" << std::endl;
+  return 0;
+}
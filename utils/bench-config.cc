@@ -0,0 +1,140 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program benchmarks the setup time of connecting trace sinks to
+// every device of a large topology through Config paths, the way the
+// ascii trace helpers do.
+// Sample usage:  ./ns3 run 'bench-config --n=10000'
+
+#include "ns3/core-module.h"
+#include "ns3/node.h"
+#include "ns3/node-container.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/queue.h"
+#include "ns3/packet.h"
+
+#include <iostream>
+#include <sstream>
+#include <string>
+
+using namespace ns3;
+
+/// Number of trace sink invocations, to keep the sinks from being optimized out.
+static uint64_t g_count = 0;
+
+/**
+ * Trace sink connected to every trace source.
+ * \param context The trace context.
+ * \param p The traced packet.
+ */
+static void
+Sink (std::string context, Ptr<const Packet> p)
+{
+  g_count++;
+}
+
+/**
+ * Connect the four ascii trace sinks of one device, one Config path each.
+ * \param prefix The device path, up to and including the device type.
+ */
+static void
+ConnectOneByOne (std::string prefix)
+{
+  Config::Connect (prefix + "/TxQueue/Enqueue", MakeCallback (&Sink));
+  Config::Connect (prefix + "/TxQueue/Dequeue", MakeCallback (&Sink));
+  Config::Connect (prefix + "/TxQueue/Drop", MakeCallback (&Sink));
+  Config::Connect (prefix + "/PhyRxDrop", MakeCallback (&Sink));
+}
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t n = 10000;
+  std::string mode = "compiled";
+
+  CommandLine cmd (__FILE__);
+  cmd.Usage ("Benchmark connecting trace sinks through Config paths.\n"
+             "\n"
+             "Modes:\n"
+             "  index:    one Config::Connect per trace source and device,\n"
+             "            with exact indices, such as /NodeList/3/DeviceList/0\n"
+             "  range:    as index, with /NodeList/[3-3]/DeviceList/[0-0], which\n"
+             "            enumerates every container on the path\n"
+             "  compiled: one Config::CompiledPath for all the devices and one\n"
+             "            for all the queues, connected in bulk");
+  cmd.AddValue ("n", "number of nodes, each with one device", n);
+  cmd.AddValue ("mode", "index, range or compiled", mode);
+  cmd.Parse (argc, argv);
+
+  SystemWallClockMs time;
+
+  time.Start ();
+  NodeContainer nodes;
+  nodes.Create (n);
+  ObjectFactory queueFactory ("ns3::DropTailQueue<Packet>");
+  for (NodeContainer::Iterator i = nodes.Begin (); i != nodes.End (); ++i)
+    {
+      Ptr<SimpleNetDevice> device = CreateObject<SimpleNetDevice> ();
+      device->SetQueue (queueFactory.Create<Queue<Packet> > ());
+      (*i)->AddDevice (device);
+    }
+  int64_t create = time.End ();
+
+  time.Start ();
+  if (mode == "index" || mode == "range")
+    {
+      for (NodeContainer::Iterator i = nodes.Begin (); i != nodes.End (); ++i)
+        {
+          uint32_t nodeId = (*i)->GetId ();
+          std::ostringstream oss;
+          if (mode == "index")
+            {
+              oss << "/NodeList/" << nodeId << "/DeviceList/0";
+            }
+          else
+            {
+              oss << "/NodeList/[" << nodeId << "-" << nodeId << "]/DeviceList/[0-0]";
+            }
+          oss << "/$ns3::SimpleNetDevice";
+          ConnectOneByOne (oss.str ());
+        }
+    }
+  else if (mode == "compiled")
+    {
+      Config::CompiledPath devicePath ("/NodeList/*/DeviceList/*/$ns3::SimpleNetDevice");
+      Config::MatchContainer devices = devicePath.LookupMatches ();
+      devices.Connect ("PhyRxDrop", MakeCallback (&Sink));
+
+      Config::CompiledPath queuePath ("/NodeList/*/DeviceList/*/$ns3::SimpleNetDevice/TxQueue");
+      Config::MatchContainer queues = queuePath.LookupMatches ();
+      queues.Connect ("Enqueue", MakeCallback (&Sink));
+      queues.Connect ("Dequeue", MakeCallback (&Sink));
+      queues.Connect ("Drop", MakeCallback (&Sink));
+    }
+  else
+    {
+      NS_FATAL_ERROR ("Unknown mode " << mode);
+    }
+  int64_t connect = time.End ();
+
+  std::cout << cmd.GetName () << ": mode=" << mode << " nodes=" << n << std::endl;
+  std::cout << "  create:  " << create << " ms" << std::endl;
+  std::cout << "  connect: " << connect << " ms ("
+            << (connect * 1000.0 / (4.0 * n)) << " us per trace source)" << std::endl;
+
+  Simulator::Destroy ();
+  return 0;
+}
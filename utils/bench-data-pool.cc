@@ -0,0 +1,211 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program benchmarks the memory pool of the packet buffers and
+// metadata.  The forwarding workload models a router forwarding a
+// given packet rate with a given latency: the packets in flight are
+// copied and get a new header at each hop.  The threads workload
+// allocates and frees blocks in several threads, from the pool or
+// from the system allocator.
+// Sample usage:  ./ns3 run 'bench-data-pool --packets=10000000'
+//                ./ns3 run 'bench-data-pool --threads=4 --pool=0'
+
+#include "ns3/command-line.h"
+#include "ns3/data-pool.h"
+#include "ns3/header.h"
+#include "ns3/packet.h"
+#include "ns3/system-wall-clock-ms.h"
+
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * A 20 byte header added at each hop.
+ */
+class HopHeader : public Header
+{
+public:
+  /**
+   * Register this type.
+   * \return The TypeId.
+   */
+  static TypeId GetTypeId (void)
+  {
+    static TypeId tid = TypeId ("ns3::HopHeader")
+      .SetParent<Header> ()
+      .SetGroupName ("Utils")
+      .HideFromDocumentation ()
+      .AddConstructor<HopHeader> ()
+    ;
+    return tid;
+  }
+  virtual TypeId GetInstanceTypeId (void) const
+  {
+    return GetTypeId ();
+  }
+  virtual void Print (std::ostream &os) const
+  {}
+  virtual uint32_t GetSerializedSize (void) const
+  {
+    return 20;
+  }
+  virtual void Serialize (Buffer::Iterator start) const
+  {
+    start.WriteU8 (0, 20);
+  }
+  virtual uint32_t Deserialize (Buffer::Iterator start)
+  {
+    start.Next (20);
+    return 20;
+  }
+};
+
+/**
+ * Forward packets.
+ * \param packets The number of packets to forward.
+ * \param inFlight The number of packets in flight.
+ * \param hops The number of hops of each packet.
+ * \param [out] peak The peak footprint of the pool.
+ */
+static void
+Forward (uint32_t packets, uint32_t inFlight, uint32_t hops, uint64_t &peak)
+{
+  static const uint32_t sizes[] = { 40, 576, 1460, 1460 };
+  std::vector<Ptr<Packet> > window (inFlight);
+  HopHeader header;
+  for (uint32_t i = 0; i < packets; i++)
+    {
+      // Each packet of the window is replaced every hops passes.
+      Ptr<Packet> &packet = window[i % inFlight];
+      if ((i / inFlight) % hops == 0)
+        {
+          packet = Create<Packet> (sizes[i % 4]);
+        }
+      else
+        {
+          Ptr<Packet> copy = packet->Copy ();
+          copy->RemoveHeader (header);
+          packet = copy;
+        }
+      packet->AddHeader (header);
+      if (i % 1024 == 0)
+        {
+          peak = std::max (peak, DataPool::GetFootprint ());
+        }
+    }
+}
+
+/**
+ * Allocate and free blocks.
+ * \param blocks The number of blocks to allocate.
+ * \param inFlight The number of blocks allocated at once.
+ * \param pool Use the pool rather than the system allocator.
+ */
+static void
+Churn (uint32_t blocks, uint32_t inFlight, bool pool)
+{
+  static const uint32_t sizes[] = { 128, 1024, 2048, 2048 };
+  std::vector<void *> window (inFlight, (void *)0);
+  for (uint32_t i = 0; i < blocks; i++)
+    {
+      uint32_t slot = i % inFlight;
+      uint32_t size = sizes[slot % 4];
+      if (window[slot] != 0)
+        {
+          if (pool)
+            {
+              DataPool::Deallocate (window[slot], size);
+            }
+          else
+            {
+              ::operator delete (window[slot]);
+            }
+        }
+      window[slot] = pool ? DataPool::Allocate (size) : ::operator new (size);
+      static_cast<uint8_t *> (window[slot])[0] = 0;
+    }
+  for (uint32_t slot = 0; slot < inFlight; slot++)
+    {
+      if (pool)
+        {
+          DataPool::Deallocate (window[slot], sizes[slot % 4]);
+        }
+      else
+        {
+          ::operator delete (window[slot]);
+        }
+    }
+}
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t packets = 10000000;
+  double rate = 1e6;
+  double latency = 0.01;
+  uint32_t hops = 4;
+  uint32_t threads = 0;
+  bool pool = true;
+
+  CommandLine cmd (__FILE__);
+  cmd.Usage ("Benchmark the memory pool of the packet buffers and metadata.\n"
+             "\n"
+             "Without threads, forward packets at the given rate and latency,\n"
+             "i.e. with rate x latency packets in flight.  With threads, each\n"
+             "thread allocates and frees as many blocks.");
+  cmd.AddValue ("packets", "number of packets, or blocks per thread", packets);
+  cmd.AddValue ("rate", "forwarded packets per second", rate);
+  cmd.AddValue ("latency", "latency of the packets, in seconds", latency);
+  cmd.AddValue ("hops", "number of hops of each packet", hops);
+  cmd.AddValue ("threads", "number of threads allocating blocks", threads);
+  cmd.AddValue ("pool", "with threads, use the pool rather than the system allocator", pool);
+  cmd.Parse (argc, argv);
+
+  uint32_t inFlight = std::max<uint32_t> (rate * latency, 1);
+  hops = std::max<uint32_t> (hops, 1);
+  SystemWallClockMs time;
+  time.Start ();
+  uint64_t peak = 0;
+  if (threads == 0)
+    {
+      Forward (packets, inFlight, hops, peak);
+    }
+  else
+    {
+      std::vector<std::thread> workers;
+      for (uint32_t i = 0; i < threads; i++)
+        {
+          workers.push_back (std::thread (&Churn, packets, inFlight, pool));
+        }
+      for (uint32_t i = 0; i < threads; i++)
+        {
+          workers[i].join ();
+        }
+      peak = DataPool::GetFootprint ();
+    }
+  int64_t ms = std::max<int64_t> (time.End (), 1);
+
+  std::cout << cmd.GetName () << ": in flight=" << inFlight << " threads=" << threads
+            << " pool=" << pool << std::endl;
+  std::cout << "  time:      " << ms << " ms" << std::endl;
+  std::cout << "  rate:      " << (packets * 1000.0 * std::max<uint32_t> (threads, 1) / ms)
+            << (threads == 0 ? " packets" : " blocks") << " per second" << std::endl;
+  std::cout << "  footprint: " << peak / 1024 << " KiB peak" << std::endl;
+  return 0;
+}
@@ -0,0 +1,154 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program benchmarks the endpoint demultiplexers of TCP and UDP
+// on a server terminating many connections: a listening endpoint and
+// the endpoints of the connections share the server port, the packets
+// of the connections are demultiplexed to their endpoints, then the
+// connections are closed.  It also measures the allocation of the
+// ephemeral ports of the clients.
+// Sample usage:  ./ns3 run 'bench-end-point-demux --endpoints=100000'
+//                ./ns3 run 'bench-end-point-demux --ipv6=1'
+
+#include "ns3/command-line.h"
+#include "ns3/ipv4-end-point.h"
+#include "ns3/ipv4-end-point-demux.h"
+#include "ns3/ipv4-interface.h"
+#include "ns3/ipv6-end-point.h"
+#include "ns3/ipv6-end-point-demux.h"
+#include "ns3/ipv6-interface.h"
+#include "ns3/system-wall-clock-ms.h"
+
+#include <iostream>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * Print a measure
+ * \param name the name of the measure
+ * \param operations the number of operations
+ * \param ms the duration of the operations, in milliseconds
+ */
+static void
+Print (const char *name, uint32_t operations, int64_t ms)
+{
+  ms = std::max<int64_t> (ms, 1);
+  std::cout << "  " << name << ms << " ms, " << operations / 1000.0 / ms << " Mops/s" << std::endl;
+}
+
+/**
+ * Benchmark a demultiplexer
+ * \tparam Demux the demultiplexer
+ * \tparam Address the address type
+ * \tparam Interface the interface type
+ * \param server the address of the server
+ * \param clients the addresses of the clients
+ * \param lookups the number of lookups
+ */
+template <typename Demux, typename Address, typename Interface>
+static void
+Bench (Address server, const std::vector<Address> &clients, uint32_t lookups)
+{
+  Demux demux;
+  Ptr<Interface> interface = CreateObject<Interface> ();
+  uint32_t endPoints = clients.size ();
+
+  SystemWallClockMs time;
+  time.Start ();
+  demux.Allocate (0, Address::GetAny (), 80);
+  for (uint32_t i = 0; i < endPoints; i++)
+    {
+      demux.Allocate (0, server, 80, clients[i], 1024 + i % 50000);
+    }
+  Print ("allocations:   ", endPoints, time.End ());
+
+  time.Start ();
+  uint32_t found = 0;
+  for (uint32_t i = 0; i < lookups; i++)
+    {
+      uint32_t j = (i * 7919) % endPoints;
+      found += demux.Lookup (server, 80, clients[j], 1024 + j % 50000, interface).size ();
+    }
+  Print ("lookups:       ", lookups, time.End ());
+  std::cout << "  found:         " << found << std::endl;
+
+  time.Start ();
+  for (uint32_t i = 0; i < lookups; i++)
+    {
+      uint32_t j = (i * 7919) % endPoints;
+      found += demux.Lookup (server, 80, clients[j], 2, interface).size ();
+    }
+  Print ("new flows:     ", lookups, time.End ());
+
+  // closing the connections, in the order of their opening
+  time.Start ();
+  for (uint32_t i = 0; i < endPoints; i++)
+    {
+      typename Demux::EndPoints endPoint =
+        demux.Lookup (server, 80, clients[i], 1024 + i % 50000, interface);
+      demux.DeAllocate (endPoint.front ());
+    }
+  Print ("deallocations: ", endPoints, time.End ());
+
+  uint32_t ports = 16000;
+  time.Start ();
+  for (uint32_t i = 0; i < ports; i++)
+    {
+      demux.Allocate ();
+    }
+  Print ("ephemeral:     ", ports, time.End ());
+}
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t endPoints = 100000;
+  uint32_t lookups = 1000000;
+  bool ipv6 = false;
+
+  CommandLine cmd (__FILE__);
+  cmd.Usage ("Benchmark the endpoint demultiplexers of TCP and UDP.");
+  cmd.AddValue ("endpoints", "number of connections", endPoints);
+  cmd.AddValue ("lookups", "number of lookups", lookups);
+  cmd.AddValue ("ipv6", "benchmark Ipv6EndPointDemux", ipv6);
+  cmd.Parse (argc, argv);
+
+  std::cout << cmd.GetName () << ": " << (ipv6 ? "ipv6" : "ipv4") << " endpoints=" << endPoints
+            << " lookups=" << lookups << std::endl;
+  if (ipv6)
+    {
+      std::vector<Ipv6Address> clients;
+      for (uint32_t i = 0; i < endPoints; i++)
+        {
+          uint8_t address[16] = { 0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0, 0, 0, 0, 0,
+                                  static_cast<uint8_t> (i >> 24), static_cast<uint8_t> (i >> 16),
+                                  static_cast<uint8_t> (i >> 8), static_cast<uint8_t> (i) };
+          clients.push_back (Ipv6Address (address));
+        }
+      Bench<Ipv6EndPointDemux, Ipv6Address, Ipv6Interface> ("2001:db8:1::1", clients, lookups);
+    }
+  else
+    {
+      std::vector<Ipv4Address> clients;
+      for (uint32_t i = 0; i < endPoints; i++)
+        {
+          clients.push_back (Ipv4Address (0x0b000000 + i / 2));
+        }
+      Bench<Ipv4EndPointDemux, Ipv4Address, Ipv4Interface> ("10.0.0.1", clients, lookups);
+    }
+  return 0;
+}
@@ -0,0 +1,248 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program benchmarks the route lookups of Ipv4StaticRouting and
+// Ipv4GlobalRouting, or of Ipv6StaticRouting, with large routing
+// tables, as installed by the global routing on large topologies: a
+// node with a few interfaces gets a host route to each of the other
+// nodes and a network route to each of their links, then looks up the
+// routes of packets to random destinations among them.
+// Sample usage:  ./ns3 run 'bench-forwarding --hosts=5000 --lookups=1000000'
+//                ./ns3 run 'bench-forwarding --ipv6=1'
+
+#include "ns3/command-line.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4.h"
+#include "ns3/ipv4-global-routing.h"
+#include "ns3/ipv4-static-routing.h"
+#include "ns3/ipv6.h"
+#include "ns3/ipv6-route.h"
+#include "ns3/ipv6-static-routing.h"
+#include "ns3/node.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/simulator.h"
+#include "ns3/system-wall-clock-ms.h"
+
+#include <iostream>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * Look up the routes of packets to destinations
+ * \param routing the routing protocol
+ * \param destinations the destinations
+ * \param lookups the number of lookups
+ * \returns the number of routes found
+ */
+static uint32_t
+Lookup (Ptr<Ipv4RoutingProtocol> routing, const std::vector<Ipv4Address> &destinations,
+        uint32_t lookups)
+{
+  Ptr<Packet> packet = Create<Packet> (100);
+  Ipv4Header header;
+  Socket::SocketErrno error;
+  uint32_t found = 0;
+  for (uint32_t i = 0; i < lookups; i++)
+    {
+      header.SetDestination (destinations[(i * 7919) % destinations.size ()]);
+      found += routing->RouteOutput (packet, header, 0, error) != 0;
+    }
+  return found;
+}
+
+/**
+ * Look up the routes of packets to IPv6 destinations
+ * \param routing the routing protocol
+ * \param destinations the destinations
+ * \param lookups the number of lookups
+ * \returns the number of routes found
+ */
+static uint32_t
+Lookup (Ptr<Ipv6RoutingProtocol> routing, const std::vector<Ipv6Address> &destinations,
+        uint32_t lookups)
+{
+  Ptr<Packet> packet = Create<Packet> (100);
+  Ipv6Header header;
+  Socket::SocketErrno error;
+  uint32_t found = 0;
+  for (uint32_t i = 0; i < lookups; i++)
+    {
+      header.SetDestination (destinations[(i * 7919) % destinations.size ()]);
+      found += routing->RouteOutput (packet, header, 0, error) != 0;
+    }
+  return found;
+}
+
+/**
+ * Benchmark the route lookups of Ipv6StaticRouting
+ * \param node the node
+ * \param hosts the number of host routes, and of network routes
+ * \param interfaces the number of interfaces of the node
+ * \param lookups the number of lookups
+ */
+static void
+BenchIpv6 (Ptr<Node> node, uint32_t hosts, uint32_t interfaces, uint32_t lookups)
+{
+  Ptr<Ipv6> ipv6 = node->GetObject<Ipv6> ();
+  for (uint32_t i = 0; i < interfaces; i++)
+    {
+      Ptr<NetDevice> device = node->GetDevice (i);
+      uint32_t interface = ipv6->AddInterface (device);
+      uint8_t address[16] = { 0x20, 0x01, 0, static_cast<uint8_t> (i), 0, 0, 0, 0,
+                              0, 0, 0, 0, 0, 0, 0, 1 };
+      ipv6->AddAddress (interface, Ipv6InterfaceAddress (Ipv6Address (address), Ipv6Prefix (64)));
+      ipv6->SetUp (interface);
+    }
+
+  // the hosts are 2001:db8:x:y::1, on the links 2001:db8:x:y::/64
+  std::vector<Ipv6Address> destinations;
+  for (uint32_t i = 0; i < hosts; i++)
+    {
+      uint8_t address[16] = { 0x20, 0x01, 0x0d, 0xb8, static_cast<uint8_t> (i >> 24),
+                              static_cast<uint8_t> (i >> 16), static_cast<uint8_t> (i >> 8),
+                              static_cast<uint8_t> (i), 0, 0, 0, 0, 0, 0, 0, 1 };
+      destinations.push_back (Ipv6Address (address));
+    }
+
+  Ptr<Ipv6StaticRouting> staticRouting = CreateObject<Ipv6StaticRouting> ();
+  staticRouting->SetIpv6 (ipv6);
+
+  SystemWallClockMs time;
+  time.Start ();
+  for (uint32_t i = 0; i < hosts; i++)
+    {
+      uint32_t interface = 1 + i % interfaces;
+      uint8_t gateway[16] = { 0x20, 0x01, 0, static_cast<uint8_t> (interface - 1), 0, 0, 0, 0,
+                              0, 0, 0, 0, 0, 0, 0, 2 };
+      staticRouting->AddHostRouteTo (destinations[i], Ipv6Address (gateway), interface);
+      staticRouting->AddNetworkRouteTo (destinations[i].CombinePrefix (Ipv6Prefix (64)),
+                                        Ipv6Prefix (64), Ipv6Address (gateway), interface);
+    }
+  int64_t setup = time.End ();
+
+  time.Start ();
+  uint32_t found = Lookup (staticRouting, destinations, lookups);
+  int64_t ms = std::max<int64_t> (time.End (), 1);
+
+  std::cout << "bench-forwarding: ipv6 hosts=" << hosts << " interfaces=" << interfaces
+            << " lookups=" << lookups << std::endl;
+  std::cout << "  static setup:   " << setup << " ms" << std::endl;
+  std::cout << "  static lookups: " << ms << " ms, " << found << " found, "
+            << lookups / 1000.0 / ms << " Mlookups/s" << std::endl;
+  std::cout << "  static index:   " << staticRouting->GetIndexMemoryUsage () << " bytes, "
+            << staticRouting->GetIndexMemoryUsage () / staticRouting->GetNRoutes ()
+            << " bytes per route" << std::endl;
+}
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t hosts = 5000;
+  uint32_t interfaces = 4;
+  uint32_t lookups = 1000000;
+  bool ipv6 = false;
+
+  CommandLine cmd (__FILE__);
+  cmd.Usage ("Benchmark the route lookups of Ipv4StaticRouting and Ipv4GlobalRouting,\n"
+             "or of Ipv6StaticRouting.");
+  cmd.AddValue ("hosts", "number of host routes, and of network routes", hosts);
+  cmd.AddValue ("interfaces", "number of interfaces of the node", interfaces);
+  cmd.AddValue ("lookups", "number of route lookups", lookups);
+  cmd.AddValue ("ipv6", "benchmark Ipv6StaticRouting", ipv6);
+  cmd.Parse (argc, argv);
+
+  Ptr<Node> node = CreateObject<Node> ();
+  InternetStackHelper stack;
+  stack.Install (node);
+  for (uint32_t i = 0; i < interfaces; i++)
+    {
+      Ptr<SimpleNetDevice> device = CreateObject<SimpleNetDevice> ();
+      device->SetAddress (Mac48Address::Allocate ());
+      node->AddDevice (device);
+    }
+  if (ipv6)
+    {
+      BenchIpv6 (node, hosts, interfaces, lookups);
+      Simulator::Destroy ();
+      return 0;
+    }
+
+  Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
+  for (uint32_t i = 0; i < interfaces; i++)
+    {
+      Ptr<NetDevice> device = node->GetDevice (i);
+      uint32_t interface = ipv4->AddInterface (device);
+      ipv4->AddAddress (interface, Ipv4InterfaceAddress (Ipv4Address (0x0a000001 + (i << 8)),
+                                                         Ipv4Mask ("/24")));
+      ipv4->SetUp (interface);
+    }
+
+  // the hosts are 11.x.y.1, on the links 11.x.y.0/30
+  std::vector<Ipv4Address> destinations;
+  for (uint32_t i = 0; i < hosts; i++)
+    {
+      destinations.push_back (Ipv4Address (0x0b000001 + (i << 2)));
+    }
+
+  Ptr<Ipv4StaticRouting> staticRouting = CreateObject<Ipv4StaticRouting> ();
+  staticRouting->SetIpv4 (ipv4);
+  Ptr<Ipv4GlobalRouting> globalRouting = CreateObject<Ipv4GlobalRouting> ();
+  globalRouting->SetIpv4 (ipv4);
+
+  SystemWallClockMs time;
+  time.Start ();
+  for (uint32_t i = 0; i < hosts; i++)
+    {
+      uint32_t interface = 1 + i % interfaces;
+      Ipv4Address gateway (0x0a000002 + ((interface - 1) << 8));
+      staticRouting->AddHostRouteTo (destinations[i], gateway, interface);
+      staticRouting->AddNetworkRouteTo (destinations[i].CombineMask (Ipv4Mask ("/30")),
+                                        Ipv4Mask ("/30"), gateway, interface);
+    }
+  int64_t staticSetup = time.End ();
+
+  time.Start ();
+  for (uint32_t i = 0; i < hosts; i++)
+    {
+      uint32_t interface = 1 + i % interfaces;
+      Ipv4Address gateway (0x0a000002 + ((interface - 1) << 8));
+      globalRouting->AddHostRouteTo (destinations[i], gateway, interface);
+      globalRouting->AddNetworkRouteTo (destinations[i].CombineMask (Ipv4Mask ("/30")),
+                                        Ipv4Mask ("/30"), gateway, interface);
+    }
+  int64_t globalSetup = time.End ();
+
+  time.Start ();
+  uint32_t staticFound = Lookup (staticRouting, destinations, lookups);
+  int64_t staticMs = std::max<int64_t> (time.End (), 1);
+
+  time.Start ();
+  uint32_t globalFound = Lookup (globalRouting, destinations, lookups);
+  int64_t globalMs = std::max<int64_t> (time.End (), 1);
+
+  Simulator::Destroy ();
+
+  std::cout << cmd.GetName () << ": hosts=" << hosts << " interfaces=" << interfaces
+            << " lookups=" << lookups << std::endl;
+  std::cout << "  static setup:   " << staticSetup << " ms" << std::endl;
+  std::cout << "  static lookups: " << staticMs << " ms, " << staticFound << " found, "
+            << lookups / 1000.0 / staticMs << " Mlookups/s" << std::endl;
+  std::cout << "  global setup:   " << globalSetup << " ms" << std::endl;
+  std::cout << "  global lookups: " << globalMs << " ms, " << globalFound << " found, "
+            << lookups / 1000.0 / globalMs << " Mlookups/s" << std::endl;
+  return 0;
+}
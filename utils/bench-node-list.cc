@@ -0,0 +1,127 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program benchmarks the NodeList of a population of nodes which
+// evolves, as the satellites of a constellation which launch and
+// deorbit: each round removes some nodes and creates as many, then the
+// nodes are looked up by id, walked, and looked up with config paths.
+// Sample usage:  ./ns3 run 'bench-node-list --nodes=10000 --rounds=1000'
+
+#include "ns3/command-line.h"
+#include "ns3/config.h"
+#include "ns3/node.h"
+#include "ns3/node-list.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/simulator.h"
+#include "ns3/system-wall-clock-ms.h"
+
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * Create a node with a device
+ * \returns the node
+ */
+static Ptr<Node>
+CreateNode (void)
+{
+  Ptr<Node> node = CreateObject<Node> ();
+  node->AddDevice (CreateObject<SimpleNetDevice> ());
+  return node;
+}
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t nodes = 10000;
+  uint32_t rounds = 1000;
+  uint32_t churn = 10;
+  uint32_t lookups = 1000000;
+  uint32_t paths = 10000;
+
+  CommandLine cmd (__FILE__);
+  cmd.Usage ("Benchmark the NodeList of a population of nodes which evolves.");
+  cmd.AddValue ("nodes", "number of nodes", nodes);
+  cmd.AddValue ("rounds", "number of rounds of removals and creations", rounds);
+  cmd.AddValue ("churn", "number of nodes removed and created by each round", churn);
+  cmd.AddValue ("lookups", "number of lookups by id", lookups);
+  cmd.AddValue ("paths", "number of config path lookups", paths);
+  cmd.Parse (argc, argv);
+
+  std::vector<Ptr<Node> > live;
+  for (uint32_t i = 0; i < nodes; i++)
+    {
+      live.push_back (CreateNode ());
+    }
+
+  SystemWallClockMs time;
+  time.Start ();
+  uint32_t next = 0;
+  for (uint32_t r = 0; r < rounds; r++)
+    {
+      for (uint32_t i = 0; i < churn; i++)
+        {
+          // remove the nodes in a pseudo random order
+          next = (next + 7919) % live.size ();
+          NodeList::Remove (live[next]);
+          live[next] = CreateNode ();
+        }
+    }
+  int64_t churnMs = time.End ();
+
+  time.Start ();
+  uint32_t found = 0;
+  for (uint32_t i = 0; i < lookups; i++)
+    {
+      found += NodeList::GetNode (live[(i * 7919) % live.size ()]->GetId ()) != 0;
+    }
+  int64_t lookupMs = time.End ();
+
+  time.Start ();
+  uint64_t devices = 0;
+  for (uint32_t i = 0; i < 100; i++)
+    {
+      for (NodeList::Iterator j = NodeList::Begin (); j != NodeList::End (); ++j)
+        {
+          devices += (*j)->GetNDevices ();
+        }
+    }
+  int64_t walkMs = time.End ();
+
+  time.Start ();
+  uint32_t matched = 0;
+  for (uint32_t i = 0; i < paths; i++)
+    {
+      std::ostringstream oss;
+      oss << "/NodeList/" << live[(i * 7919) % live.size ()]->GetId () << "/DeviceList/0";
+      matched += Config::LookupMatches (oss.str ()).GetN ();
+    }
+  int64_t pathMs = time.End ();
+  Simulator::Destroy ();
+
+  std::cout << cmd.GetName () << ": nodes=" << nodes << " rounds=" << rounds
+            << " churn=" << churn << std::endl;
+  std::cout << "  churn:     " << churnMs << " ms for " << rounds * churn
+            << " removals and creations" << std::endl;
+  std::cout << "  lookups:   " << lookupMs << " ms for " << found << " lookups by id" << std::endl;
+  std::cout << "  walks:     " << walkMs << " ms for 100 walks of " << devices / 100
+            << " devices" << std::endl;
+  std::cout << "  paths:     " << pathMs << " ms for " << matched << " config paths" << std::endl;
+  return 0;
+}
@@ -0,0 +1,175 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program benchmarks the packet tags.  Each packet gets a few
+// tags, as added by the socket, the traffic control and the MAC layers,
+// is copied and has a tag replaced at each hop, and its tags are
+// peeked at and removed by the receiver.
+// Sample usage:  ./ns3 run 'bench-packet-tags --packets=1000000 --tags=5'
+
+#include "ns3/command-line.h"
+#include "ns3/packet.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/tag.h"
+
+#include <iostream>
+#include <sstream>
+
+using namespace ns3;
+
+/**
+ * A tag of N bytes.
+ */
+template <int N>
+class BenchTag : public Tag
+{
+public:
+  /**
+   * Register this type.
+   * \return The TypeId.
+   */
+  static TypeId GetTypeId (void)
+  {
+    static TypeId tid = TypeId (GetName ())
+      .SetParent<Tag> ()
+      .SetGroupName ("Utils")
+      .HideFromDocumentation ()
+      .AddConstructor<BenchTag<N> > ()
+    ;
+    return tid;
+  }
+  virtual TypeId GetInstanceTypeId (void) const
+  {
+    return GetTypeId ();
+  }
+  virtual uint32_t GetSerializedSize (void) const
+  {
+    return N;
+  }
+  virtual void Serialize (TagBuffer buf) const
+  {
+    for (int i = 0; i < N; i++)
+      {
+        buf.WriteU8 (m_value);
+      }
+  }
+  virtual void Deserialize (TagBuffer buf)
+  {
+    for (int i = 0; i < N; i++)
+      {
+        m_value = buf.ReadU8 ();
+      }
+  }
+  virtual void Print (std::ostream &os) const
+  {
+    os << N << "=" << (uint32_t)m_value;
+  }
+
+  uint8_t m_value {0};  //!< The tag value
+
+private:
+  /**
+   * \return The name of this type.
+   */
+  static std::string GetName (void)
+  {
+    std::ostringstream oss;
+    oss << "ns3::BenchTag<" << N << ">";
+    return oss.str ();
+  }
+};
+
+/**
+ * Tag, copy and untag packets.
+ * \param packets The number of packets.
+ * \param tags The number of tags of each packet, up to 5.
+ * \param hops The number of hops of each packet.
+ * \returns A checksum of the tag values.
+ */
+static uint32_t
+Run (uint32_t packets, uint32_t tags, uint32_t hops)
+{
+  BenchTag<1> t1;
+  BenchTag<4> t4;
+  BenchTag<8> t8;
+  BenchTag<2> t2;
+  BenchTag<16> t16;
+  uint32_t sum = 0;
+  for (uint32_t i = 0; i < packets; i++)
+    {
+      Ptr<Packet> packet = Create<Packet> (100);
+      t1.m_value = i;
+      packet->AddPacketTag (t1);
+      if (tags > 1)
+        {
+          packet->AddPacketTag (t4);
+        }
+      if (tags > 2)
+        {
+          packet->AddPacketTag (t8);
+        }
+      if (tags > 3)
+        {
+          packet->AddPacketTag (t2);
+        }
+      if (tags > 4)
+        {
+          packet->AddPacketTag (t16);
+        }
+      for (uint32_t hop = 0; hop < hops; hop++)
+        {
+          Ptr<Packet> copy = packet->Copy ();
+          packet->PeekPacketTag (t1);
+          t1.m_value++;
+          copy->ReplacePacketTag (t1);
+          packet = copy;
+        }
+      if (tags > 2)
+        {
+          packet->PeekPacketTag (t8);
+          packet->RemovePacketTag (t8);
+        }
+      packet->PeekPacketTag (t1);
+      sum += t1.m_value;
+      packet->RemovePacketTag (t1);
+    }
+  return sum;
+}
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t packets = 1000000;
+  uint32_t tags = 5;
+  uint32_t hops = 4;
+
+  CommandLine cmd (__FILE__);
+  cmd.Usage ("Benchmark the packet tags.");
+  cmd.AddValue ("packets", "number of packets", packets);
+  cmd.AddValue ("tags", "number of tags per packet, 1 to 5", tags);
+  cmd.AddValue ("hops", "number of hops of each packet", hops);
+  cmd.Parse (argc, argv);
+
+  SystemWallClockMs time;
+  time.Start ();
+  uint32_t sum = Run (packets, tags, hops);
+  int64_t ms = std::max<int64_t> (time.End (), 1);
+
+  std::cout << cmd.GetName () << ": tags=" << tags << " hops=" << hops << " (checksum " << sum << ")" << std::endl;
+  std::cout << "  time: " << ms << " ms" << std::endl;
+  std::cout << "  rate: " << (packets * 1000.0 / ms) << " packets per second" << std::endl;
+  return 0;
+}
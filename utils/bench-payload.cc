@@ -0,0 +1,129 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program benchmarks the virtual payloads of bulk flows: saturated
+// TCP bulk-send flows, or UDP on-off flows, cross point-to-point links of
+// 10 Gbps, each flow on its own link.  The applications send packets
+// whose payload is made of the virtual zero bytes of Packet, which the
+// stack should never allocate: the memory of the packet data pool
+// stays small whatever the rate and the buffer sizes, also with the
+// checksums enabled.
+// Sample usage:  ./ns3 run 'bench-payload --flows=4 --checksum=1'
+//                ./ns3 run 'bench-payload --udp=1 --rate=40Gbps'
+
+#include "ns3/applications-module.h"
+#include "ns3/core-module.h"
+#include "ns3/data-pool.h"
+#include "ns3/internet-module.h"
+#include "ns3/network-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/system-wall-clock-ms.h"
+
+#include <iostream>
+#include <sys/resource.h>
+
+using namespace ns3;
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t flows = 4;
+  double stop = 0.1;
+  bool udp = false;
+  bool checksum = false;
+  std::string rate = "10Gbps";
+
+  CommandLine cmd (__FILE__);
+  cmd.Usage ("Benchmark the virtual payloads of TCP bulk-send or UDP on-off flows\n"
+             "over 10 Gbps point-to-point links.");
+  cmd.AddValue ("flows", "number of flows, each on its own link", flows);
+  cmd.AddValue ("stop", "simulated time (s)", stop);
+  cmd.AddValue ("udp", "send UDP on-off flows rather than TCP bulk-send flows", udp);
+  cmd.AddValue ("checksum", "enable the checksums", checksum);
+  cmd.AddValue ("rate", "data rate of the links", rate);
+  cmd.Parse (argc, argv);
+
+  GlobalValue::Bind ("ChecksumEnabled", BooleanValue (checksum));
+  Config::SetDefault ("ns3::TcpSocket::SndBufSize", UintegerValue (1 << 22));
+  Config::SetDefault ("ns3::TcpSocket::RcvBufSize", UintegerValue (1 << 22));
+  Config::SetDefault ("ns3::TcpSocket::SegmentSize", UintegerValue (1448));
+
+  NodeContainer senders;
+  NodeContainer receivers;
+  senders.Create (flows);
+  receivers.Create (flows);
+  InternetStackHelper stack;
+  stack.Install (senders);
+  stack.Install (receivers);
+
+  PointToPointHelper p2p;
+  p2p.SetDeviceAttribute ("DataRate", StringValue (rate));
+  p2p.SetChannelAttribute ("Delay", StringValue ("1ms"));
+  Ipv4AddressHelper address ("10.0.0.0", "255.255.255.252");
+  std::string factory = udp ? "ns3::UdpSocketFactory" : "ns3::TcpSocketFactory";
+  ApplicationContainer sinks;
+  uint16_t port = 9;
+  for (uint32_t i = 0; i < flows; i++)
+    {
+      NetDeviceContainer devices = p2p.Install (senders.Get (i), receivers.Get (i));
+      Ipv4InterfaceContainer interfaces = address.Assign (devices);
+      address.NewNetwork ();
+
+      InetSocketAddress remote (interfaces.GetAddress (1), port);
+      ApplicationContainer source;
+      if (udp)
+        {
+          OnOffHelper onoff (factory, remote);
+          onoff.SetConstantRate (DataRate (rate), 1472);
+          source = onoff.Install (senders.Get (i));
+        }
+      else
+        {
+          BulkSendHelper bulk (factory, remote);
+          bulk.SetAttribute ("MaxBytes", UintegerValue (0));
+          bulk.SetAttribute ("SendSize", UintegerValue (1 << 16));
+          source = bulk.Install (senders.Get (i));
+        }
+      source.Start (Seconds (0.001 * i));
+      PacketSinkHelper sink (factory, InetSocketAddress (Ipv4Address::GetAny (), port));
+      sinks.Add (sink.Install (receivers.Get (i)));
+    }
+
+  SystemWallClockMs time;
+  time.Start ();
+  Simulator::Stop (Seconds (stop));
+  Simulator::Run ();
+  int64_t ms = std::max<int64_t> (time.End (), 1);
+
+  uint64_t bytes = 0;
+  for (uint32_t i = 0; i < sinks.GetN (); i++)
+    {
+      bytes += DynamicCast<PacketSink> (sinks.Get (i))->GetTotalRx ();
+    }
+  uint64_t footprint = DataPool::GetFootprint ();
+  Simulator::Destroy ();
+  struct rusage usage;
+  getrusage (RUSAGE_SELF, &usage);
+
+  std::cout << cmd.GetName () << ": flows=" << flows << " " << (udp ? "udp" : "tcp")
+            << " rate=" << rate << " checksum=" << checksum << std::endl;
+  std::cout << "  run:        " << ms << " ms" << std::endl;
+  std::cout << "  goodput:    " << bytes * 8 / stop / flows / 1e9 << " Gbps per flow" << std::endl;
+  std::cout << "  rate:       " << bytes * 8 / 1e6 / ms << " simulated Gbps per second" << std::endl;
+  std::cout << "  pool:       " << footprint / 1024 << " KB" << std::endl;
+  std::cout << "  max rss:    " << usage.ru_maxrss / 1024 << " MB" << std::endl;
+  return 0;
+}
@@ -0,0 +1,111 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program benchmarks the pcap traces of many devices: the packets
+// are written in turn to the pcap file of each device, created by
+// PcapHelper as it would be by the device helpers.  The files are
+// written directly, buffered by PcapWriter, or as the interfaces of a
+// single pcapng file.
+// Sample usage:  ./ns3 run 'bench-pcap --devices=500 --mode=buffered'
+//                ./ns3 run 'bench-pcap --mode=shared --snapLen=96'
+
+#include "ns3/command-line.h"
+#include "ns3/config.h"
+#include "ns3/packet.h"
+#include "ns3/simulator.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/trace-helper.h"
+#include "ns3/uinteger.h"
+
+#include <cstdio>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+using namespace ns3;
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t packets = 2000000;
+  uint32_t devices = 200;
+  uint32_t snapLen = 65535;
+  std::string mode = "buffered";
+  std::string prefix = "bench-pcap";
+
+  CommandLine cmd (__FILE__);
+  cmd.Usage ("Benchmark the pcap traces of many devices.\n"
+             "\n"
+             "The mode is direct (PcapFileWrapper), buffered (PcapWriter) or\n"
+             "shared (one pcapng file).  The files are removed at the end.");
+  cmd.AddValue ("packets", "number of packets", packets);
+  cmd.AddValue ("devices", "number of traced devices", devices);
+  cmd.AddValue ("snapLen", "capture length of the files", snapLen);
+  cmd.AddValue ("mode", "direct, buffered or shared", mode);
+  cmd.AddValue ("prefix", "prefix of the files", prefix);
+  cmd.Parse (argc, argv);
+
+  Config::SetDefault ("ns3::PcapFileWrapper::CaptureSize", UintegerValue (snapLen));
+  Config::SetDefault ("ns3::PcapWriter::CaptureSize", UintegerValue (snapLen));
+  std::string shared = prefix + ".pcapng";
+  if (mode == "buffered")
+    {
+      PcapHelper::EnableBufferedFiles (true);
+    }
+  else if (mode == "shared")
+    {
+      PcapHelper::EnableSharedFile (shared);
+    }
+  else if (mode != "direct")
+    {
+      std::cerr << "Unknown mode " << mode << std::endl;
+      return 1;
+    }
+
+  SystemWallClockMs time;
+  time.Start ();
+  PcapHelper helper;
+  std::vector<std::string> filenames;
+  std::vector<Ptr<PcapFileWrapper> > files;
+  for (uint32_t i = 0; i < devices; i++)
+    {
+      std::ostringstream oss;
+      oss << prefix << "-" << i << ".pcap";
+      filenames.push_back (oss.str ());
+      files.push_back (helper.CreateFile (oss.str (), std::ios::out, PcapHelper::DLT_EN10MB));
+    }
+  static const uint32_t sizes[] = { 54, 590, 1514, 1514 };
+  for (uint32_t i = 0; i < packets; i++)
+    {
+      Ptr<Packet> p = Create<Packet> (sizes[i % 4]);
+      files[i % devices]->Write (MicroSeconds (i), p);
+    }
+  files.clear ();
+  Simulator::Destroy ();
+  int64_t ms = std::max<int64_t> (time.End (), 1);
+
+  for (uint32_t i = 0; i < devices; i++)
+    {
+      std::remove (filenames[i].c_str ());
+    }
+  std::remove (shared.c_str ());
+
+  std::cout << cmd.GetName () << ": mode=" << mode << " devices=" << devices
+            << " snapLen=" << snapLen << std::endl;
+  std::cout << "  time:      " << ms << " ms" << std::endl;
+  std::cout << "  rate:      " << (packets * 1000.0 / ms) << " packets per second" << std::endl;
+  return 0;
+}
@@ -0,0 +1,128 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program benchmarks the enqueue and dequeue operations of a FIFO
+// packet queue, storing the items either in the ring buffer used by
+// DropTailQueue or in the list used by the positional Queue methods.
+// Sample usage:  ./ns3 run 'bench-queue --ring=0 --depth=1000'
+// Cache misses can be counted with:
+//   perf stat -e cache-references,cache-misses build/utils/ns3.36.1-bench-queue-debug
+
+#include "ns3/command-line.h"
+#include "ns3/drop-tail-queue.h"
+#include "ns3/packet.h"
+#include "ns3/system-wall-clock-ms.h"
+
+#include <iostream>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * A FIFO queue storing its items in a list, as DropTailQueue used to.
+ */
+class ListQueue : public Queue<Packet>
+{
+public:
+  virtual bool Enqueue (Ptr<Packet> item)
+  {
+    return DoEnqueue (end (), item);
+  }
+  virtual Ptr<Packet> Dequeue (void)
+  {
+    return DoDequeue (begin ());
+  }
+  virtual Ptr<Packet> Remove (void)
+  {
+    return DoRemove (begin ());
+  }
+  virtual Ptr<const Packet> Peek (void) const
+  {
+    return DoPeek (begin ());
+  }
+};
+
+/**
+ * Run the benchmark.
+ * \param queue The queue.
+ * \param packets The packets to enqueue, in turn.
+ * \param depth The number of packets kept in the queue.
+ * \param n The number of enqueue and dequeue pairs.
+ * \returns The elapsed time, in ms.
+ */
+static int64_t
+Bench (Ptr<Queue<Packet> > queue, const std::vector<Ptr<Packet> > &packets, uint32_t depth, uint32_t n)
+{
+  SystemWallClockMs time;
+  time.Start ();
+  uint32_t next = 0;
+  for (uint32_t i = 0; i < depth; i++)
+    {
+      queue->Enqueue (packets[next]);
+      next = (next + 1) % packets.size ();
+    }
+  for (uint32_t i = 0; i < n; i++)
+    {
+      queue->Enqueue (packets[next]);
+      next = (next + 1) % packets.size ();
+      queue->Dequeue ();
+    }
+  queue->Flush ();
+  return time.End ();
+}
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t n = 10000000;
+  uint32_t depth = 100;
+  bool ring = true;
+
+  CommandLine cmd (__FILE__);
+  cmd.Usage ("Benchmark the enqueue and dequeue operations of a FIFO packet queue.\n"
+             "\n"
+             "The queue is filled to the given depth, then each enqueue is followed\n"
+             "by a dequeue.");
+  cmd.AddValue ("n", "number of enqueue and dequeue pairs", n);
+  cmd.AddValue ("depth", "number of packets kept in the queue", depth);
+  cmd.AddValue ("ring", "use the ring buffer of DropTailQueue, rather than a list", ring);
+  cmd.Parse (argc, argv);
+
+  std::vector<Ptr<Packet> > packets;
+  for (uint32_t i = 0; i < depth + 1; i++)
+    {
+      packets.push_back (Create<Packet> (1000));
+    }
+
+  Ptr<Queue<Packet> > queue;
+  if (ring)
+    {
+      queue = CreateObject<DropTailQueue<Packet> > ();
+    }
+  else
+    {
+      queue = CreateObject<ListQueue> ();
+    }
+  queue->SetMaxSize (QueueSize (QueueSizeUnit::PACKETS, depth + 1));
+
+  int64_t ms = Bench (queue, packets, depth, n);
+
+  std::cout << cmd.GetName () << ": depth=" << depth << " ring=" << ring << std::endl;
+  std::cout << "  time: " << ms << " ms" << std::endl;
+  std::cout << "  rate: " << (n * 1000.0 / std::max<int64_t> (ms, 1)) << " enqueue/dequeue pairs per second"
+            << std::endl;
+  return 0;
+}
@@ -0,0 +1,127 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program benchmarks the cost of retransmission timers, which are
+// re-armed on every acknowledgment and almost never expire, for a large
+// number of concurrent TCP-like connections.
+// Sample usage:  ./ns3 run 'bench-timer --n=100000 --wheel=1'
+
+#include "ns3/core-module.h"
+
+#include <iostream>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * The timers of one connection.
+ */
+class Connection
+{
+public:
+  /**
+   * Constructor.
+   * \param rto The retransmission timeout.
+   */
+  Connection (Time rto)
+    : m_rto (Timer::CANCEL_ON_DESTROY),
+      m_acks (0),
+      m_timeouts (0)
+  {
+    m_rto.SetFunction (&Connection::Timeout, this);
+    m_rto.SetDelay (rto);
+  }
+  /** An acknowledgment arrived: re-arm the retransmission timer. */
+  void Ack (void)
+  {
+    m_acks++;
+    m_rto.Cancel ();
+    m_rto.Schedule ();
+  }
+  /** The retransmission timer expired. */
+  void Timeout (void)
+  {
+    m_timeouts++;
+  }
+
+  Timer m_rto;          //!< Retransmission timer.
+  uint64_t m_acks;      //!< Number of acknowledgments.
+  uint64_t m_timeouts;  //!< Number of timeouts.
+};
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t n = 100000;
+  double duration = 10;
+  bool wheel = true;
+
+  CommandLine cmd (__FILE__);
+  cmd.Usage ("Benchmark retransmission timers of many concurrent connections.\n"
+             "\n"
+             "Each connection receives one acknowledgment per round-trip time,\n"
+             "between 10 and 20 ms, and re-arms its 200 ms retransmission Timer.");
+  cmd.AddValue ("n", "number of connections", n);
+  cmd.AddValue ("duration", "simulated time, in seconds", duration);
+  cmd.AddValue ("wheel", "use the timer wheel", wheel);
+  cmd.Parse (argc, argv);
+
+  if (wheel)
+    {
+      TimerWheel::Enable ();
+    }
+
+  SystemWallClockMs time;
+  time.Start ();
+  std::vector<Connection *> connections;
+  connections.reserve (n);
+  for (uint32_t i = 0; i < n; i++)
+    {
+      Connection *connection = new Connection (MilliSeconds (200));
+      connections.push_back (connection);
+      connection->m_rto.Schedule ();
+      PeriodicEvent::Schedule (MicroSeconds (10000 + 100 * (i % 100)), &Connection::Ack, connection);
+    }
+  int64_t setup = time.End ();
+
+  time.Start ();
+  Simulator::Stop (Seconds (duration));
+  Simulator::Run ();
+  int64_t run = time.End ();
+
+  uint64_t acks = 0;
+  uint64_t timeouts = 0;
+  for (std::vector<Connection *>::const_iterator i = connections.begin (); i != connections.end (); ++i)
+    {
+      acks += (*i)->m_acks;
+      timeouts += (*i)->m_timeouts;
+    }
+  uint64_t events = Simulator::GetEventCount ();
+  Simulator::Destroy ();
+  for (std::vector<Connection *>::const_iterator i = connections.begin (); i != connections.end (); ++i)
+    {
+      delete *i;
+    }
+
+  std::cout << cmd.GetName () << ": connections=" << n << " wheel=" << wheel << std::endl;
+  std::cout << "  setup:    " << setup << " ms" << std::endl;
+  std::cout << "  run:      " << run << " ms ("
+            << (run * 1e6 / std::max<uint64_t> (acks, 1)) << " ns per re-arm)" << std::endl;
+  std::cout << "  re-arms:  " << acks << std::endl;
+  std::cout << "  timeouts: " << timeouts << std::endl;
+  std::cout << "  events:   " << events << std::endl;
+  return 0;
+}
@@ -0,0 +1,71 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file
+ * \ingroup utils
+ * Convert the binary trace files written with
+ * AsciiTraceHelper::EnableBinaryFormat to the text of the ascii traces.
+ *
+ * The program links all the modules, so that the headers they register
+ * with HeaderDecoder are decoded.
+ * Sample usage:  ./ns3 run 'binary-trace-to-ascii --input=trace.tr --output=trace.txt'
+ */
+
+#include "ns3/binary-trace-stream.h"
+#include "ns3/command-line.h"
+
+#include <fstream>
+#include <iostream>
+
+using namespace ns3;
+
+int
+main (int argc, char *argv[])
+{
+  std::string input;
+  std::string output;
+
+  CommandLine cmd (__FILE__);
+  cmd.Usage ("Convert a binary trace file to the text of the ascii traces.");
+  cmd.AddValue ("input", "binary trace file", input);
+  cmd.AddValue ("output", "text file, or the standard output if empty", output);
+  cmd.Parse (argc, argv);
+
+  std::ifstream is (input, std::ios::in | std::ios::binary);
+  if (!is)
+    {
+      std::cerr << "Unable to open " << input << std::endl;
+      return 1;
+    }
+  std::ofstream file;
+  if (!output.empty ())
+    {
+      file.open (output);
+      if (!file)
+        {
+          std::cerr << "Unable to open " << output << std::endl;
+          return 1;
+        }
+    }
+  std::ostream &os = output.empty () ? std::cout : file;
+  if (!BinaryTraceReader::ConvertToAscii (is, os))
+    {
+      std::cerr << input << " is not a complete binary trace" << std::endl;
+      return 1;
+    }
+  return 0;
+}